@@ -1,12 +1,50 @@
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
 #include <Magnum/MeshTools/Compile.h>
+#include <Magnum/Platform/GLContext.h>
 #include <Magnum/Platform/Sdl2Application.h>
 #include <Magnum/Primitives/Cube.h>
 #include <Magnum/Shaders/Phong.h>
 #include <Magnum/Trade/MeshData3D.h>
 #include <Magnum/Math/Quaternion.h>
+#include <Magnum/Animation/Track.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/Timeline.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "externals/entt.hpp"
 
@@ -45,6 +83,797 @@ struct Drawable {
     Color4 color;
 };
 
+// Smallest-three, the index of the dropped component in the lowest 2 bits
+// followed by the remaining three at 15 bits each, 48 bits in total
+struct PackedQuaternion {
+    UnsignedShort data[3];
+};
+
+// Each axis normalized to 16 bits within the range of its track
+struct PackedPosition {
+    UnsignedShort data[3];
+};
+
+struct CompressedAnimationClip {
+    std::vector<Float> positionKeys;
+    std::vector<PackedPosition> positions;
+    Vector3 positionMin;
+    Vector3 positionScale;
+
+    std::vector<Float> orientationKeys;
+    std::vector<PackedQuaternion> orientations;
+};
+
+// Keyframes are shared between every entity playing the same clip
+//
+// Once compressed, the full precision tracks may be cleared
+// and sampling happens off of `compressed` alone.
+struct AnimationClip {
+    std::string name;
+    Animation::Track<Float, Vector3> position;
+    Animation::Track<Float, Quaternion> orientation;
+    CompressedAnimationClip compressed;
+};
+
+struct Animated {
+    std::shared_ptr<const AnimationClip> clip;
+    Float time;
+
+    // Search hints, so sampling consecutive frames doesn't start from the first key
+    std::size_t positionHint;
+    std::size_t orientationHint;
+};
+
+// Distances are measured from the eye, past `far` entities stop animating
+struct AnimationLod {
+    Vector3 eye;
+    Float near;
+    Float far;
+    UnsignedInt reducedInterval;
+};
+
+// Lives in the registry context, reset on every call to AnimationSystem
+struct AnimationStatistics {
+    UnsignedLong frame;
+    UnsignedInt sampled;
+    UnsignedInt reduced;
+    UnsignedInt frozen;
+};
+
+// A joint's Position, Orientation and Scale are relative to its parent
+struct Joint {
+    entt::entity parent;
+    Matrix4 inverseBind;
+    Matrix4 world;
+};
+
+// Joints are ordered such that parents come before their children
+struct Skin {
+    std::vector<entt::entity> joints;
+    std::vector<Matrix4> palette;
+};
+
+// Up to 4 joint influences per vertex, unused ones having zero weight
+//
+// The skinned result is written to `positions` and `normals` each
+// frame, and streamed into `buffer` (when created) by SkinUploadSystem.
+struct SkinnedMesh {
+    entt::entity skin;
+
+    std::vector<Vector3> bindPositions;
+    std::vector<Vector3> bindNormals;
+    std::vector<Math::Vector4<UnsignedShort>> jointIndices;
+    std::vector<Vector4> jointWeights;
+
+    std::vector<Vector3> positions;
+    std::vector<Vector3> normals;
+    GL::Buffer buffer{ NoCreate };
+};
+
+// Components per page of the transform pools
+constexpr std::size_t TransformPage = 4096;
+
+// Shared by the transform pools, which are the largest in the world.
+// Pages are carved out of chunks backed by huge pages. Synchronized,
+// a background save may release pages on its own thread
+inline std::pmr::memory_resource* TransformResource() {
+    static entt::huge_page_resource huge{};
+    static std::pmr::synchronized_pool_resource resource{ std::pmr::pool_options{ 0, TransformPage*sizeof(Orientation) }, &huge };
+    return &resource;
+}
+
+}}
+
+// Back the transform pools with huge pages, to cut TLB misses
+// during the big view iterations. Paged pools are also what lets
+// a clone share them with the original until either one writes
+namespace entt {
+
+template<>
+struct storage_traits<Magnum::Examples::Position> {
+    static constexpr std::size_t instance_page = Magnum::Examples::TransformPage;
+    static std::pmr::memory_resource* resource() { return Magnum::Examples::TransformResource(); }
+};
+
+template<>
+struct storage_traits<Magnum::Examples::Orientation> {
+    static constexpr std::size_t instance_page = Magnum::Examples::TransformPage;
+    static std::pmr::memory_resource* resource() { return Magnum::Examples::TransformResource(); }
+};
+
+template<>
+struct storage_traits<Magnum::Examples::Scale> {
+    static constexpr std::size_t instance_page = Magnum::Examples::TransformPage;
+    static std::pmr::memory_resource* resource() { return Magnum::Examples::TransformResource(); }
+};
+
+}
+
+namespace Magnum { namespace Examples {
+
+// ---------------------------------------------------------
+//
+// Threading
+//
+// ---------------------------------------------------------
+
+// A fixed set of threads for systems to split their work across
+class Workers {
+public:
+    explicit Workers(UnsignedInt count = Math::max(std::thread::hardware_concurrency(), 2u) - 1) {
+        for (UnsignedInt i = 0; i != count; ++i) {
+            _threads.emplace_back([this] { run(); });
+        }
+    }
+
+    ~Workers() {
+        {
+            std::lock_guard<std::mutex> lock{ _mutex };
+            _quit = true;
+        }
+
+        _wake.notify_all();
+        for (auto& thread : _threads) thread.join();
+    }
+
+    Workers(const Workers&) = delete;
+    Workers& operator=(const Workers&) = delete;
+
+    std::size_t size() const { return _threads.size() + 1; }
+
+    // Calls `func(i)` for every i in [0, count), the calling thread included,
+    // and returns once all of them have finished
+    void parallelFor(std::size_t count, std::function<void(std::size_t)> func) {
+        if (count == 0) return;
+
+        {
+            // A worker can still be inside work() for the previous call, having
+            // claimed an index past its end. Resetting the counters under it
+            // would let it run an index of this call a second time
+            std::unique_lock<std::mutex> lock{ _mutex };
+            _done.wait(lock, [this] { return _active == 0; });
+            _func = std::move(func);
+            _count = count;
+            _next = 0;
+            _pending = count;
+            ++_generation;
+        }
+
+        _wake.notify_all();
+        work();
+
+        std::unique_lock<std::mutex> lock{ _mutex };
+        _done.wait(lock, [this] { return _pending == 0; });
+        _func = nullptr;
+    }
+
+private:
+    void run() {
+        std::size_t seen = 0;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock{ _mutex };
+                _wake.wait(lock, [&] { return _quit || _generation != seen; });
+                if (_quit) return;
+                seen = _generation;
+                ++_active;
+            }
+
+            work();
+
+            std::lock_guard<std::mutex> lock{ _mutex };
+            if (--_active == 0) _done.notify_all();
+        }
+    }
+
+    void work() {
+        std::size_t finished = 0;
+
+        for (std::size_t i; (i = _next.fetch_add(1)) < _count; ++finished) {
+            _func(i);
+        }
+
+        if (finished && _pending.fetch_sub(finished) == finished) {
+            std::lock_guard<std::mutex> lock{ _mutex };
+            _done.notify_all();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    std::function<void(std::size_t)> _func;
+    std::size_t _generation{};
+    std::size_t _active{};
+    std::atomic<std::size_t> _count{};
+    std::atomic<std::size_t> _next{};
+    std::atomic<std::size_t> _pending{};
+    bool _quit{};
+};
+
+// Fixed capacity queue between exactly one producing and one consuming
+// thread, each side only ever writes its own index
+template<class T, std::size_t Capacity>
+class SpscRing {
+public:
+    bool push(const T& value) {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == Capacity) return false;
+
+        _slots[tail % Capacity] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) return false;
+
+        value = _slots[head % Capacity];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T _slots[Capacity]{};
+    alignas(64) std::atomic<std::size_t> _head{};
+    alignas(64) std::atomic<std::size_t> _tail{};
+};
+
+// Everything the render thread needs to draw a frame without
+// touching the registry. Position, Orientation, Scale and color are
+// published into a packet once per frame, the render thread reads
+// frame N from it while the simulation computes frame N+1
+struct DrawCommand {
+    GL::Mesh* mesh;
+    Shaders::Phong* shader;
+    Matrix4 transform;
+    Color4 color;
+};
+
+struct BufferUpload {
+    GL::Buffer* buffer;
+    std::vector<Vector3> data;
+};
+
+struct FramePacket {
+    Matrix4 projection;
+    std::vector<BufferUpload> uploads;
+    std::vector<DrawCommand> commands;
+};
+
+// ---------------------------------------------------------
+//
+// Animation compression
+//
+// ---------------------------------------------------------
+
+static PackedQuaternion packQuaternion(const Quaternion& quaternion) {
+    const Quaternion q = quaternion.normalized();
+    const Float components[]{ q.vector().x(), q.vector().y(), q.vector().z(), q.scalar() };
+
+    UnsignedInt largest = 0;
+    for (UnsignedInt i = 1; i != 4; ++i) {
+        if (Math::abs(components[i]) > Math::abs(components[largest])) largest = i;
+    }
+
+    // q and -q are the same rotation, keep the dropped component positive
+    const Float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    UnsignedLong bits = largest;
+    for (UnsignedInt i = 0, shift = 2; i != 4; ++i) {
+        if (i == largest) continue;
+
+        // The three smallest components are within [-1/sqrt(2), 1/sqrt(2)]
+        const Float normalized = sign * components[i] * Constants::sqrt2() * 0.5f + 0.5f;
+        bits |= UnsignedLong(Math::round(Math::clamp(normalized, 0.0f, 1.0f) * 32767.0f)) << shift;
+        shift += 15;
+    }
+
+    return {{ UnsignedShort(bits), UnsignedShort(bits >> 16), UnsignedShort(bits >> 32) }};
+}
+
+static inline Quaternion unpackQuaternion(const PackedQuaternion& packed) {
+    const UnsignedLong bits = UnsignedLong(packed.data[0]) |
+                              UnsignedLong(packed.data[1]) << 16 |
+                              UnsignedLong(packed.data[2]) << 32;
+    const UnsignedInt largest = bits & 0x3;
+
+    Float components[4];
+    Float sum = 0.0f;
+
+    for (UnsignedInt i = 0, shift = 2; i != 4; ++i) {
+        if (i == largest) continue;
+
+        const Float normalized = Float((bits >> shift) & 0x7fff) / 32767.0f;
+        components[i] = (normalized - 0.5f) * 2.0f / Constants::sqrt2();
+        sum += components[i] * components[i];
+        shift += 15;
+    }
+
+    components[largest] = std::sqrt(Math::max(0.0f, 1.0f - sum));
+    return Quaternion{ { components[0], components[1], components[2] }, components[3] };
+}
+
+static inline Vector3 unpackPosition(const CompressedAnimationClip& clip, const PackedPosition& packed) {
+    return clip.positionMin + clip.positionScale * Vector3{
+        Float(packed.data[0]), Float(packed.data[1]), Float(packed.data[2]) };
+}
+
+// Index of the last key at or before `time`, resuming from `hint`
+static inline std::size_t findKey(const std::vector<Float>& keys, Float time, std::size_t& hint) {
+    std::size_t i = hint < keys.size() && keys[hint] <= time ? hint : 0;
+    while (i + 1 < keys.size() && keys[i + 1] <= time) ++i;
+    return hint = i;
+}
+
+static inline Vector3 samplePosition(const CompressedAnimationClip& clip, Float time, std::size_t& hint) {
+    const auto& keys = clip.positionKeys;
+    const std::size_t i = findKey(keys, time, hint);
+    const Vector3 a = unpackPosition(clip, clip.positions[i]);
+    if (i + 1 == keys.size() || time <= keys[i]) return a;
+
+    const Float t = (time - keys[i]) / (keys[i + 1] - keys[i]);
+    return Math::lerp(a, unpackPosition(clip, clip.positions[i + 1]), t);
+}
+
+static inline Quaternion sampleOrientation(const CompressedAnimationClip& clip, Float time, std::size_t& hint) {
+    const auto& keys = clip.orientationKeys;
+    const std::size_t i = findKey(keys, time, hint);
+    const Quaternion a = unpackQuaternion(clip.orientations[i]);
+    if (i + 1 == keys.size() || time <= keys[i]) return a;
+
+    const Float t = (time - keys[i]) / (keys[i + 1] - keys[i]);
+    return Math::slerpShortestPath(a, unpackQuaternion(clip.orientations[i + 1]), t);
+}
+
+// Greedily drop keys that linear interpolation between their kept
+// neighbours reproduces to within `tolerance`, first and last are always kept
+template<class T, class Interpolate, class Error>
+static std::vector<std::size_t> reduceKeys(Containers::StridedArrayView<const Float> keys,
+                                           Containers::StridedArrayView<const T> values,
+                                           Float tolerance, Interpolate interpolate, Error error)
+{
+    std::vector<std::size_t> kept;
+    if (!keys.size()) return kept;
+
+    kept.push_back(0);
+
+    for (std::size_t candidate = 1; candidate + 1 < keys.size(); ++candidate) {
+        const std::size_t from = kept.back();
+        const std::size_t to = candidate + 1;
+        bool droppable = true;
+
+        for (std::size_t i = from + 1; i < to && droppable; ++i) {
+            const Float t = (keys[i] - keys[from]) / (keys[to] - keys[from]);
+            droppable = error(interpolate(values[from], values[to], t), values[i]) <= tolerance;
+        }
+
+        if (!droppable) kept.push_back(candidate);
+    }
+
+    if (keys.size() > 1) kept.push_back(keys.size() - 1);
+    return kept;
+}
+
+// Tolerance is in world units for positions and radians for orientations
+static void compressAnimationClip(AnimationClip& clip, Float tolerance) {
+    CompressedAnimationClip compressed;
+
+    const auto positionError = [](const Vector3& a, const Vector3& b) { return (a - b).length(); };
+    const auto orientationError = [](const Quaternion& a, const Quaternion& b) {
+        return Float(Math::angle(a.normalized(), Math::dot(a, b) < 0.0f ? -b.normalized() : b.normalized()));
+    };
+
+    if (clip.position.size()) {
+        const auto keys = clip.position.keys();
+        const auto values = clip.position.values();
+
+        Vector3 min = values[0], max = values[0];
+        for (const Vector3& value : values) {
+            min = Math::min(min, value);
+            max = Math::max(max, value);
+        }
+
+        compressed.positionMin = min;
+        compressed.positionScale = (max - min) / 65535.0f;
+
+        for (std::size_t i : reduceKeys(keys, values, tolerance, Math::lerp<Vector3, Float>, positionError)) {
+            const Vector3 normalized = (values[i] - min) / Math::max(max - min, Vector3{ 1.0e-6f });
+            const Vector3 rounded = Math::round(Math::clamp(normalized, 0.0f, 1.0f) * 65535.0f);
+
+            compressed.positionKeys.push_back(keys[i]);
+            compressed.positions.push_back({{ UnsignedShort(rounded.x()), UnsignedShort(rounded.y()), UnsignedShort(rounded.z()) }});
+        }
+    }
+
+    if (clip.orientation.size()) {
+        const auto keys = clip.orientation.keys();
+        const auto values = clip.orientation.values();
+
+        const auto slerp = [](const Quaternion& a, const Quaternion& b, Float t) {
+            return Math::slerpShortestPath(a.normalized(), b.normalized(), t);
+        };
+
+        for (std::size_t i : reduceKeys(keys, values, tolerance, slerp, orientationError)) {
+            compressed.orientationKeys.push_back(keys[i]);
+            compressed.orientations.push_back(packQuaternion(values[i]));
+        }
+    }
+
+    clip.compressed = std::move(compressed);
+}
+
+// Compares the compressed clip against the full precision tracks
+// at every original key and halfway in between
+static void AnimationCompressionReport(const AnimationClip& clip) {
+    const CompressedAnimationClip& compressed = clip.compressed;
+
+    const std::size_t original =
+        clip.position.size() * (sizeof(Float) + sizeof(Vector3)) +
+        clip.orientation.size() * (sizeof(Float) + sizeof(Quaternion));
+    const std::size_t packed =
+        compressed.positionKeys.size() * (sizeof(Float) + sizeof(PackedPosition)) + 2 * sizeof(Vector3) +
+        compressed.orientationKeys.size() * (sizeof(Float) + sizeof(PackedQuaternion));
+
+    Float positionError = 0.0f;
+    Float orientationError = 0.0f;
+    std::size_t hint{};
+
+    for (std::size_t i = 0; i < clip.position.size(); ++i) {
+        for (Float t : { 0.0f, 0.5f }) {
+            if (t > 0.0f && i + 1 == clip.position.size()) break;
+            const Float time = Math::lerp(clip.position.keys()[i], clip.position.keys()[Math::min(i + 1, clip.position.size() - 1)], t);
+            const Vector3 error = clip.position.at(time) - samplePosition(compressed, time, hint);
+            positionError = Math::max(positionError, error.length());
+        }
+    }
+
+    hint = {};
+
+    for (std::size_t i = 0; i < clip.orientation.size(); ++i) {
+        for (Float t : { 0.0f, 0.5f }) {
+            if (t > 0.0f && i + 1 == clip.orientation.size()) break;
+            const Float time = Math::lerp(clip.orientation.keys()[i], clip.orientation.keys()[Math::min(i + 1, clip.orientation.size() - 1)], t);
+            const Quaternion a = clip.orientation.at(time).normalized();
+            const Quaternion b = sampleOrientation(compressed, time, hint);
+            orientationError = Math::max(orientationError, Float(Math::angle(a, Math::dot(a, b) < 0.0f ? -b : b)));
+        }
+    }
+
+    Debug() << clip.name.c_str() << "compressed" << original << "->" << packed << "bytes, ratio"
+            << (packed ? Float(original) / Float(packed) : 0.0f)
+            << "max position error" << positionError
+            << "max orientation error" << Float(Deg(Rad(orientationError))) << "degrees";
+}
+
+// ---------------------------------------------------------
+//
+// World files
+//
+// ---------------------------------------------------------
+
+// A read-only view of a whole file, paged in by the OS as it is touched
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) {
+#ifdef _WIN32
+        _file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (_file == INVALID_HANDLE_VALUE) return;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(_file, &size) || !size.QuadPart) return;
+
+        _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!_mapping) return;
+
+        _data = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (_data) _size = std::size_t(size.QuadPart);
+#else
+        _file = open(path, O_RDONLY);
+        if (_file == -1) return;
+
+        struct stat info;
+        if (fstat(_file, &info) != 0 || !info.st_size) return;
+
+        void* data = mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, _file, 0);
+        if (data == MAP_FAILED) return;
+
+        _data = data;
+        _size = std::size_t(info.st_size);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (_data) UnmapViewOfFile(_data);
+        if (_mapping) CloseHandle(_mapping);
+        if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+#else
+        if (_data) munmap(const_cast<void*>(_data), _size);
+        if (_file != -1) close(_file);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    explicit operator bool() const { return _data != nullptr; }
+    const void* data() const { return _data; }
+    std::size_t size() const { return _size; }
+
+private:
+#ifdef _WIN32
+    HANDLE _file{ INVALID_HANDLE_VALUE };
+    HANDLE _mapping{};
+#else
+    int _file{ -1 };
+#endif
+    const void* _data{};
+    std::size_t _size{};
+};
+
+// Transforms are trivially copyable, so each pool is written as
+// a block of entities followed by a block of components
+static bool SaveWorld(const entt::registry& registry, const char* path) {
+    std::ofstream file{ path, std::ios::binary };
+    if (!file) return false;
+
+    entt::binary_output_archive archive{ file };
+    registry.snapshot()
+        .entities(archive)
+        .destroyed(archive)
+        .component<Position, Orientation, Scale>(archive);
+
+    return bool(file);
+}
+
+// The transform pools adopt their pages straight from the mapped file,
+// they're copied only once written to. The mapping lives as long as any
+// page still refers to it
+static bool LoadWorld(entt::registry& registry, const char* path) {
+    auto file = std::make_shared<MappedFile>(path);
+    if (!*file) return false;
+
+    entt::memory_input_archive archive{ std::shared_ptr<const void>{ file, file->data() }, file->size() };
+    registry.loader()
+        .entities(archive)
+        .destroyed(archive)
+        .component<Position, Orientation, Scale>(archive)
+        .orphans();
+
+    return archive && archive.remaining() == 0;
+}
+
+// Serialization moves to another thread, against a frozen copy. The
+// clone shares the transform pages with the registry and systems copy
+// a page only the first time they write to it, so the main thread pays
+// for the entity arrays and for the pages modified while saving
+static std::future<bool> BackgroundSave(const entt::registry& registry, std::string path) {
+    return std::async(std::launch::async,
+        [frozen = registry.clone<Position, Orientation, Scale>(), path = std::move(path)] {
+            return SaveWorld(frozen, path.c_str());
+        });
+}
+
+// Journal of the transforms, one entry per call. The first entry is a
+// full snapshot, each one after that carries what changed since the one
+// before. Entries are encoded on the calling thread, at the cost of the
+// pages written to since the previous entry, then appended in background
+class Autosave {
+public:
+    explicit Autosave(const entt::registry& registry, std::string path) :
+        _delta{ registry }, _path{ std::move(path) } {}
+
+    // Never more than one write in flight, a slow disk only delays the next entry
+    bool ready() const {
+        return !_write.valid() || _write.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready;
+    }
+
+    // Waits for the last entry to be written
+    bool flush() {
+        return !_write.valid() || _write.get();
+    }
+
+    void save() {
+        // An entry lost on the way makes the journal start over
+        if (!flush()) {
+            Warning() << "Autosave failed";
+            _entries = 0;
+        }
+
+        // So does every so many entries, such that it doesn't grow forever
+        const bool full = _entries++ % Compaction == 0;
+
+        std::ostringstream entry;
+        entt::binary_output_archive archive{ entry };
+        _delta.entities(archive, full ? 0 : _delta.baseline())
+            .component<Position, Orientation, Scale>(archive);
+
+        _write = std::async(std::launch::async, [path = _path, bytes = entry.str(), full] {
+            std::ofstream file{ path, std::ios::binary | (full ? std::ios::trunc : std::ios::app) };
+            file.write(bytes.data(), std::streamsize(bytes.size()));
+            return bool(file);
+        });
+    }
+
+private:
+    static constexpr std::size_t Compaction = 20;
+
+    entt::delta_snapshot _delta;
+    std::string _path;
+    std::future<bool> _write;
+    std::size_t _entries{};
+};
+
+// Replays a journal written by Autosave, the entities get new identifiers
+static bool LoadAutosave(entt::registry& registry, const char* path) {
+    std::ifstream file{ path, std::ios::binary };
+    if (!file) return false;
+
+    entt::binary_input_archive archive{ file };
+    entt::continuous_loader loader{ registry };
+
+    while (file.peek() != std::ifstream::traits_type::eof()) {
+        loader.delta_entities(archive).delta_component<Position, Orientation, Scale>(archive);
+        if (!archive || !loader.good()) return false;
+    }
+
+    return true;
+}
+
+// Pools are only known to the registry by their runtime type
+static const char* ComponentName(const entt::registry& registry, ENTT_ID_TYPE type) {
+    const std::pair<entt::component, const char*> names[]{
+        { registry.type<Identity>(), "Identity" },
+        { registry.type<Position>(), "Position" },
+        { registry.type<Orientation>(), "Orientation" },
+        { registry.type<Scale>(), "Scale" },
+        { registry.type<Drawable>(), "Drawable" },
+        { registry.type<Animated>(), "Animated" },
+        { registry.type<Joint>(), "Joint" },
+        { registry.type<Skin>(), "Skin" },
+        { registry.type<SkinnedMesh>(), "SkinnedMesh" }
+    };
+
+    for (const auto& name : names) {
+        if (entt::to_integer(name.first) == type) return name.second;
+    }
+
+    return nullptr;
+}
+
+// One JSON object per line, such that the file can be appended to
+// for the whole session and charted afterwards
+static void WriteStatistics(const entt::registry& registry, Double time, std::ostream& out) {
+    const auto stats = registry.statistics();
+    out << "{\"time\":" << time
+        << ",\"entities\":" << stats.entities
+        << ",\"alive\":" << stats.alive
+        << ",\"entity_bytes\":" << stats.entity_bytes
+        << ",\"groups\":" << stats.groups
+        << ",\"context\":" << stats.context
+        << ",\"divergence\":{\"Orientation\":" << registry.divergence<Orientation, Position>()
+        << ",\"Scale\":" << registry.divergence<Scale, Position>()
+        << ",\"Identity\":" << registry.divergence<Identity, Position>() << '}'
+        << ",\"pools\":[";
+
+    bool first = true;
+    registry.statistics([&](const entt::pool_statistics& pool) {
+        const char* name = ComponentName(registry, pool.type);
+
+        out << (first ? "{" : ",{") << "\"type\":";
+        if (name) out << '"' << name << '"';
+        else out << pool.type;
+
+        out << ",\"size\":" << pool.size
+            << ",\"capacity\":" << pool.capacity
+            << ",\"dense_bytes\":" << pool.dense_bytes
+            << ",\"slack_bytes\":" << pool.slack_bytes
+            << ",\"page_size\":" << pool.page_size
+            << ",\"sparse_pages\":" << pool.sparse_pages
+            << ",\"sparse_empty\":" << pool.sparse_empty
+            << ",\"sparse_bytes\":" << pool.sparse_bytes
+            << ",\"on_construct\":" << pool.on_construct
+            << ",\"on_replace\":" << pool.on_replace
+            << ",\"on_destroy\":" << pool.on_destroy
+            << ",\"owned\":" << (pool.owned ? "true" : "false") << '}';
+        first = false;
+    });
+
+    out << "]}\n";
+    out.flush();
+}
+
+// ---------------------------------------------------------
+//
+// Chunks
+//
+// ---------------------------------------------------------
+
+// Whole multiple of the SIMD width in elements, for all components. Pools
+// are aligned to ENTT_INSTANCE_ALIGNMENT and 256 elements of any size are a
+// multiple of it, so every chunk starts on an aligned address
+constexpr std::size_t ChunkSize = 256;
+static_assert(ChunkSize % ENTT_INSTANCE_ALIGNMENT == 0);
+
+template<class Func, class Tuple, std::size_t ...i>
+static void callWithArrayViews(Func& func, const Tuple& args, std::index_sequence<i...>) {
+    const std::size_t count = std::get<sizeof...(i)>(args);
+    func(Containers::arrayView(std::get<i>(args), count)...);
+}
+
+// Hands a view or an owning group over to `func` one chunk at a time, as
+// array views of the entities and of each component, such that batch
+// kernels can run plain loops over them
+template<class View, class Func>
+static void EachChunk(const View& view, Func func, std::size_t chunk = ChunkSize) {
+    for (const auto& args : view.chunks(chunk)) {
+        callWithArrayViews(func, args, std::make_index_sequence<std::tuple_size_v<std::decay_t<decltype(args)>> - 1>{});
+    }
+}
+
+// ---------------------------------------------------------
+//
+// Exports
+//
+// ---------------------------------------------------------
+
+// A pool, the instances owned by a group or one member of either, as
+// returned by `registry.strided<T>()`, `group.strided<T>()` and
+// `.member(&T::field)`, without copying them. Paged pools come a page at a
+// time
+template<class T>
+static Containers::StridedArrayView<T> Strided(entt::strided_view<T> view) {
+    return { view.data(), view.size(), view.stride() };
+}
+
+inline void writeInterleaved(Containers::ArrayView<char>, std::size_t, std::size_t) {}
+
+template<class T, class ...U>
+static void writeInterleaved(Containers::ArrayView<char> out, std::size_t stride, std::size_t offset, Containers::StridedArrayView<T> first, Containers::StridedArrayView<U>... next) {
+    for (std::size_t i = 0; i != first.size(); ++i) {
+        std::memcpy(out.data() + i*stride + offset, &first[i], sizeof(T));
+    }
+
+    writeInterleaved(out, stride, offset + sizeof(T), next...);
+}
+
+// Writes the views into `out` one vertex after the other, such as into a
+// vertex buffer or a mapped buffer for per-instance attributes. All views
+// must have the same size and `out` must have room for all of them
+template<class ...T>
+static void InterleaveInto(Containers::ArrayView<char> out, Containers::StridedArrayView<T>... views) {
+    constexpr std::size_t stride = (0 + ... + sizeof(T));
+    const std::size_t sizes[]{ views.size()... };
+    CORRADE_ASSERT(std::all_of(std::begin(sizes), std::end(sizes), [&](std::size_t size) { return size == sizes[0]; }) &&
+        out.size() >= sizes[0]*stride, "InterleaveInto(): views of different sizes or not enough room", );
+
+    writeInterleaved(out, stride, 0, views...);
+}
+
 // ---------------------------------------------------------
 //
 // Systems
@@ -52,12 +881,13 @@ struct Drawable {
 // ---------------------------------------------------------
 
 static void MouseMoveSystem(entt::registry& registry, Vector2 distance) {
-    registry.view<Orientation>().each([distance](auto& ori) {
-        ori = (
-            Quaternion::rotation(Rad{ distance.y() }, Vector3(1.0f, 0, 0)) *
-            ori *
-            Quaternion::rotation(Rad{ distance.x() }, Vector3(0, 1.0f, 0))
-        ).normalized();
+    const Quaternion pitch = Quaternion::rotation(Rad{ distance.y() }, Vector3(1.0f, 0, 0));
+    const Quaternion yaw = Quaternion::rotation(Rad{ distance.x() }, Vector3(0, 1.0f, 0));
+
+    EachChunk(registry.view<Orientation>(), [&](Containers::ArrayView<const entt::entity>, Containers::ArrayView<Orientation> orientations) {
+        for (Orientation& ori : orientations) {
+            ori = (pitch * ori * yaw).normalized();
+        }
     });
 }
 
@@ -67,53 +897,725 @@ static void MouseReleaseSystem(entt::registry& registry) {
     });
 }
 
-static void AnimationSystem(entt::registry& registry) {
-    Debug() << "Animating..";
+// Entities are updated at one of three rates, depending on where they are
+//
+//  - Every frame, when visible and closer than `lod.near`
+//  - Every Nth frame, when visible and closer than `lod.far`
+//  - Never, otherwise
+//
+// Time keeps advancing for every entity, such that one coming back into
+// view resumes where it would have been had it been animated all along.
+// Reduced entities are spread across N buckets by their entity index,
+// such that an equal share of them is sampled on each frame.
+static void AnimationSystem(entt::registry& registry, Float delta, const Matrix4& projection, const AnimationLod& lod) {
+    auto& stats = registry.ctx_or_set<AnimationStatistics>();
+    const UnsignedLong frame = stats.frame + 1;
+    stats = { frame, 0, 0, 0 };
+
+    const UnsignedInt interval = Math::max(lod.reducedInterval, 1u);
+    const UnsignedInt bucket = UnsignedInt(frame % interval);
+
+    // Pass 1: advance time and pick what is due this frame
+    static std::vector<entt::entity> due;
+    due.clear();
+
+    registry.view<Animated, Position>().each([&](auto entity, auto& animated, auto& pos) {
+        const AnimationClip& clip = *animated.clip;
+        const Float duration = Math::max({
+            clip.position.duration().max(),
+            clip.orientation.duration().max(),
+            clip.compressed.positionKeys.empty() ? 0.0f : clip.compressed.positionKeys.back(),
+            clip.compressed.orientationKeys.empty() ? 0.0f : clip.compressed.orientationKeys.back()
+        });
+        animated.time += delta;
+
+        if (duration > 0.0f && animated.time > duration) {
+            animated.time = std::fmod(animated.time, duration);
+        }
+
+        const Vector4 clipSpace = projection * Vector4{ pos, 1.0f };
+        const bool visible = Math::abs(clipSpace.x()) <= clipSpace.w() &&
+                             Math::abs(clipSpace.y()) <= clipSpace.w() &&
+                             Math::abs(clipSpace.z()) <= clipSpace.w();
+        const Float distance = (pos - lod.eye).length();
+
+        if (visible && distance < lod.near) {
+            due.push_back(entity);
+        }
+        else if (visible && distance < lod.far) {
+            if (entt::to_integer(registry.entity(entity)) % interval == bucket) {
+                due.push_back(entity);
+            }
+            else {
+                ++stats.reduced;
+            }
+        }
+        else {
+            ++stats.frozen;
+        }
+    });
+
+    // Pass 2: sample everything that's due in one go
+    for (auto entity : due) {
+        auto& animated = registry.get<Animated>(entity);
+        const AnimationClip& clip = *animated.clip;
+        const CompressedAnimationClip& compressed = clip.compressed;
+
+        if (!compressed.positions.empty()) {
+            registry.get<Position>(entity) = samplePosition(compressed, animated.time, animated.positionHint);
+        }
+        else if (clip.position.size()) {
+            registry.get<Position>(entity) = clip.position.at(animated.time, animated.positionHint);
+        }
+
+        if (!registry.has<Orientation>(entity)) continue;
+
+        if (!compressed.orientations.empty()) {
+            registry.get<Orientation>(entity) = sampleOrientation(compressed, animated.time, animated.orientationHint);
+        }
+        else if (clip.orientation.size()) {
+            registry.get<Orientation>(entity) = clip.orientation.at(animated.time, animated.orientationHint);
+        }
+    }
+
+    stats.sampled = UnsignedInt(due.size());
 }
 
 static void PhysicsSystem(entt::registry& registry) {
     Debug() << "Simulating..";
 }
 
-static void RenderSystem(entt::registry& registry, Matrix4 projection) {
-    Debug() << "Rendering..";
+// Computes joint world matrices down each hierarchy, then the palette of
+// joint matrices that take bind pose vertices into their animated pose
+static void SkeletonSystem(entt::registry& registry) {
+    registry.view<Skin>().each([&registry](auto& skin) {
+        skin.palette.resize(skin.joints.size());
+
+        for (std::size_t i = 0; i < skin.joints.size(); ++i) {
+            const entt::entity entity = skin.joints[i];
+            auto& joint = registry.get<Joint>(entity);
+
+            const Orientation& ori = registry.get<Orientation>(entity);
+            const Matrix4 local =
+                Matrix4::translation(registry.get<Position>(entity)) *
+                Matrix4::from(ori.toMatrix(), {}) *
+                Matrix4::scaling(registry.get<Scale>(entity));
+
+            joint.world = joint.parent == entt::null
+                ? local
+                : registry.get<Joint>(joint.parent).world * local;
+
+            skin.palette[i] = joint.world * joint.inverseBind;
+        }
+    });
+}
+
+// Blends the matrices of up to 4 joints and transforms [first, last)
+static void skinVertices(const Matrix4* palette, SkinnedMesh& mesh, std::size_t first, std::size_t last) {
+#ifdef __AVX__
+    for (std::size_t i = first; i < last; ++i) {
+        const auto& joints = mesh.jointIndices[i];
+        const Vector4& weights = mesh.jointWeights[i];
+
+        // Two columns per register, such that the blend is 2 x 4 multiply-adds
+        __m256 lo = _mm256_setzero_ps();
+        __m256 hi = _mm256_setzero_ps();
+
+        for (UnsignedInt k = 0; k != 4; ++k) {
+            if (weights[k] == 0.0f) continue;
+
+            const Float* matrix = palette[joints[k]].data();
+            const __m256 weight = _mm256_set1_ps(weights[k]);
+            lo = _mm256_add_ps(lo, _mm256_mul_ps(_mm256_loadu_ps(matrix), weight));
+            hi = _mm256_add_ps(hi, _mm256_mul_ps(_mm256_loadu_ps(matrix + 8), weight));
+        }
+
+        const Vector3& p = mesh.bindPositions[i];
+        const Vector3& n = mesh.bindNormals[i];
+
+        // x * c0 + y * c1 + z * c2 + w * c3, w being 1 for positions and 0 for normals
+        const __m256 position = _mm256_add_ps(
+            _mm256_mul_ps(lo, _mm256_setr_ps(p.x(), p.x(), p.x(), p.x(), p.y(), p.y(), p.y(), p.y())),
+            _mm256_mul_ps(hi, _mm256_setr_ps(p.z(), p.z(), p.z(), p.z(), 1.0f, 1.0f, 1.0f, 1.0f)));
+        const __m256 normal = _mm256_add_ps(
+            _mm256_mul_ps(lo, _mm256_setr_ps(n.x(), n.x(), n.x(), n.x(), n.y(), n.y(), n.y(), n.y())),
+            _mm256_mul_ps(hi, _mm256_setr_ps(n.z(), n.z(), n.z(), n.z(), 0.0f, 0.0f, 0.0f, 0.0f)));
+
+        alignas(16) Float out[8];
+        _mm_store_ps(out, _mm_add_ps(_mm256_castps256_ps128(position), _mm256_extractf128_ps(position, 1)));
+        _mm_store_ps(out + 4, _mm_add_ps(_mm256_castps256_ps128(normal), _mm256_extractf128_ps(normal, 1)));
+
+        mesh.positions[i] = { out[0], out[1], out[2] };
+        mesh.normals[i] = Vector3{ out[4], out[5], out[6] }.normalized();
+    }
+#else
+    for (std::size_t i = first; i < last; ++i) {
+        const auto& joints = mesh.jointIndices[i];
+        const Vector4& weights = mesh.jointWeights[i];
+
+        Matrix4 blended{ Math::ZeroInit };
+        for (UnsignedInt k = 0; k != 4; ++k) {
+            if (weights[k] != 0.0f) blended += palette[joints[k]] * weights[k];
+        }
+
+        mesh.positions[i] = blended.transformPoint(mesh.bindPositions[i]);
+        mesh.normals[i] = blended.transformVector(mesh.bindNormals[i]).normalized();
+    }
+#endif
+}
+
+// Meshes are cut into ranges of vertices, such that a few large meshes
+// spread across workers as evenly as many small ones do
+static void SkinningSystem(entt::registry& registry, Workers& workers) {
+    constexpr std::size_t RangeSize = 4096;
+
+    struct Range {
+        const Matrix4* palette;
+        SkinnedMesh* mesh;
+        std::size_t first;
+        std::size_t last;
+    };
+
+    static std::vector<Range> ranges;
+    ranges.clear();
+
+    registry.view<SkinnedMesh>().each([&](auto& mesh) {
+        const auto& skin = registry.get<Skin>(mesh.skin);
+        const std::size_t count = mesh.bindPositions.size();
 
-    registry.view<Identity, Position, Orientation, Scale, Drawable>().each(
-        [projection](auto& id, auto& pos, auto& ori, auto& scale, auto& drawable)
+        mesh.positions.resize(count);
+        mesh.normals.resize(count);
+
+        for (std::size_t first = 0; first < count; first += RangeSize) {
+            ranges.push_back({ skin.palette.data(), &mesh, first, Math::min(first + RangeSize, count) });
+        }
+    });
+
+    workers.parallelFor(ranges.size(), [](std::size_t i) {
+        const Range& range = ranges[i];
+        skinVertices(range.palette, *range.mesh, range.first, range.last);
+    });
+}
+
+static void interleave(const SkinnedMesh& mesh, std::vector<Vector3>& interleaved) {
+    const std::size_t count = mesh.positions.size();
+    interleaved.resize(count * 2);
+    InterleaveInto({ reinterpret_cast<char*>(interleaved.data()), interleaved.size()*sizeof(Vector3) },
+        Containers::StridedArrayView<const Vector3>{ mesh.positions.data(), count, sizeof(Vector3) },
+        Containers::StridedArrayView<const Vector3>{ mesh.normals.data(), count, sizeof(Vector3) });
+}
+
+// Interleaves skinned positions and normals into each mesh's buffer
+static void SkinUploadSystem(entt::registry& registry) {
+    static std::vector<Vector3> interleaved;
+
+    registry.view<SkinnedMesh>().each([](auto& mesh) {
+        if (!mesh.buffer.id()) return;
+
+        interleave(mesh, interleaved);
+        mesh.buffer.setData(interleaved, GL::BufferUsage::StreamDraw);
+    });
+}
+
+// Same, but recorded into a packet for the render thread to upload,
+// reusing the memory of whichever packet was recycled
+static void SkinUploadSystem(entt::registry& registry, FramePacket& packet) {
+    std::size_t count = 0;
+
+    registry.view<SkinnedMesh>().each([&](auto& mesh) {
+        if (!mesh.buffer.id()) return;
+
+        if (count == packet.uploads.size()) packet.uploads.emplace_back();
+        BufferUpload& upload = packet.uploads[count++];
+        upload.buffer = &mesh.buffer;
+        interleave(mesh, upload.data);
+    });
+
+    packet.uploads.resize(count);
+}
+
+// Spreads the lowest 10 bits of `v` such that there are two zero bits
+// between each of them
+static UnsignedInt spreadBits(UnsignedInt v) {
+    v = (v*0x00010001u) & 0xFF0000FFu;
+    v = (v*0x00000101u) & 0x0F00F00Fu;
+    v = (v*0x00000011u) & 0xC30C30C3u;
+    v = (v*0x00000005u) & 0x49249249u;
+    return v;
+}
+
+// Sort function object for registry.sort, ordering a pool by precomputed
+// codes indexed by position in the pool. The comparison is ignored
+struct MortonSort {
+    template<class It, class Compare>
+    void operator()(It first, It last, Compare, const std::vector<UnsignedInt>& codes, bool full) const {
+        if (full) {
+            entt::radix_sort<10, 30>{}(first, last, [&codes](std::size_t pos) { return codes[pos]; });
+        }
+        else {
+            entt::insertion_sort{}(first, last, [&codes](std::size_t lhs, std::size_t rhs) { return codes[lhs] < codes[rhs]; });
+        }
+    }
+};
+
+// Keeps Position in Z-order, such that entities close in space are close
+// in memory too. Codes are recomputed every frame within the bounds of the
+// scene and the pool is radix sorted when out of order, otherwise insertion
+// sort fixes the few entities that moved to a different cell
+static void MortonSortSystem(entt::registry& registry) {
+    static std::vector<UnsignedInt> codes;
+
+    // Read only, pages still shared with a background save stay shared
+    const auto view = registry.view<const Position>();
+    const std::size_t count = view.size();
+    if (count < 2) return;
+
+    Vector3 min{Constants::inf()};
+    Vector3 max{-Constants::inf()};
+    EachChunk(view, [&](Containers::ArrayView<const entt::entity>, Containers::ArrayView<const Position> positions) {
+        for (const Position& position : positions) {
+            min = Math::min(min, position);
+            max = Math::max(max, position);
+        }
+    });
+
+    const Vector3 scale = 1023.0f/Math::max(max - min, Vector3{1.0e-6f});
+    codes.resize(count);
+
+    // Sorted pools iterate from the back, so codes are expected to decrease
+    std::size_t unordered = 0;
+    std::size_t i = 0;
+    EachChunk(view, [&](Containers::ArrayView<const entt::entity>, Containers::ArrayView<const Position> positions) {
+        for (const Position& position : positions) {
+            const Vector3ui cell{(position - min)*scale};
+            codes[i] = (spreadBits(cell.x()) << 2) | (spreadBits(cell.y()) << 1) | spreadBits(cell.z());
+            if (i && codes[i] > codes[i - 1]) ++unordered;
+            ++i;
+        }
+    });
+
+    if (!unordered) return;
+
+    registry.sort<Position>([](entt::entity, entt::entity) { return false; }, MortonSort{}, codes, unordered > count/64);
+}
+
+// Entities visited per pool and frame, a fraction of a millisecond
+constexpr std::size_t CoSortBudget = 4096;
+
+// Brings the pools read by EachDrawable in the order of Position a little
+// at a time, such that iterating them walks memory front to back and
+// spatial neighbors stay adjacent in all of them. Drawable is left out,
+// the render thread may still be drawing through pointers into it
+static void CoSortSystem(entt::registry& registry) {
+    registry.converge<Orientation, Position>(CoSortBudget);
+    registry.converge<Scale, Position>(CoSortBudget);
+    registry.converge<Identity, Position>(CoSortBudget);
+}
+
+static void draw(GL::Mesh& mesh, Shaders::Phong& shader, const Matrix4& transform, const Color4& color, const Matrix4& projection) {
+    // Problem area 1: Shader program with function and data combined
+    // Ideal solution: Uniforms a separate component
+    shader.setLightPosition({7.0f, 7.0f, 2.5f})
+          .setLightColor(Color3{1.0f})
+          .setDiffuseColor(color)
+          .setAmbientColor(Color3::fromHsv({color.hue(), 1.0f, 0.3f}))
+          .setTransformationMatrix(transform)
+          .setNormalMatrix(transform.rotationScaling())
+          .setProjectionMatrix(projection);
+
+    // Problem area 2: Vertex data and rendering function combined
+    // Ideal solution: Vertex data a separate component, shader takes mesh as component
+    mesh.draw(shader);
+}
+
+// Hands each drawable to the given function along with its transform.
+// The query is kept up to date by the registry, iterating it doesn't
+// look anything up in the pools
+template<class Func>
+static void EachDrawable(entt::registry& registry, Func func) {
+    registry.query<const Identity, const Position, const Orientation, const Scale, Drawable>().each(
+        [&func](auto, auto&, auto& pos, auto& ori, auto& scale, auto& drawable)
     {
-        auto transform = (
+        func(drawable,
             Matrix4::scaling(scale) *
             Matrix4::rotation(ori.angle(), ori.axis().normalized()) *
-            Matrix4::translation(pos)
-        );
-
-        // Problem area 1: Shader program with function and data combined
-        // Ideal solution: Uniforms a separate component
-        drawable.shader.setLightPosition({7.0f, 7.0f, 2.5f})
-                       .setLightColor(Color3{1.0f})
-                       .setDiffuseColor(drawable.color)
-                       .setAmbientColor(Color3::fromHsv({drawable.color.hue(), 1.0f, 0.3f}))
-                       .setTransformationMatrix(transform)
-                       .setNormalMatrix(transform.rotationScaling())
-                       .setProjectionMatrix(projection);
-
-        // Problem area 2: Vertex data and rendering function combined
-        // Ideal solution: Vertex data a separate component, shader takes mesh as component
-        drawable.mesh.draw(drawable.shader);
+            Matrix4::translation(pos));
+    });
+}
+
+static void RenderSystem(entt::registry& registry, const Matrix4& projection) {
+    Debug() << "Rendering..";
+
+    EachDrawable(registry, [&projection](Drawable& drawable, const Matrix4& transform) {
+        draw(drawable.mesh, drawable.shader, transform, drawable.color, projection);
+    });
+}
+
+// Like RenderSystem, but records the draws for the render thread. The
+// packet is the only copy of the frame that the render thread reads
+static void SubmitSystem(entt::registry& registry, const Matrix4& projection, FramePacket& packet) {
+    packet.projection = projection;
+    packet.commands.clear();
+
+    EachDrawable(registry, [&packet](Drawable& drawable, const Matrix4& transform) {
+        packet.commands.push_back({ &drawable.mesh, &drawable.shader, transform, drawable.color });
     });
 }
 
 // ---------------------------------------------------------
 //
-// Implementation
+// Render thread
+//
+// ---------------------------------------------------------
+
+// Owns the window's GL context for as long as it runs. Two packets go
+// back and forth, one recorded by the main thread while the other is
+// drawn, such that there is never more than one frame in flight.
+//
+// Packets point into the Drawable and SkinnedMesh pools, call wait()
+// before creating, destroying, sorting or otherwise reordering either
+// of them.
+class RenderThread {
+public:
+    explicit RenderThread(SDL_Window* window) :
+        _window{ window },
+        _context{ SDL_GL_GetCurrentContext() }
+    {
+        SDL_GL_MakeCurrent(_window, nullptr);
+
+        for (FramePacket& packet : _packets) _recycled.push(&packet);
+        _thread = std::thread{ [this] { run(); } };
+    }
+
+    ~RenderThread() {
+        wait();
+        _quit = true;
+        _thread.join();
+
+        // Hand the context back, GL objects are destroyed on this thread
+        SDL_GL_MakeCurrent(_window, _context);
+    }
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Blocks until the frame before the one in flight has been recycled
+    FramePacket& begin() {
+        while (!_recycled.pop(_current)) std::this_thread::yield();
+        return *_current;
+    }
+
+    void submit() {
+        _submitted.push(_current);
+        _current = nullptr;
+    }
+
+    // Blocks until every submitted frame has been drawn
+    void wait() {
+        FramePacket* packets[2];
+        for (FramePacket*& packet : packets) while (!_recycled.pop(packet)) std::this_thread::yield();
+        for (FramePacket* packet : packets) _recycled.push(packet);
+    }
+
+private:
+    void run() {
+        SDL_GL_MakeCurrent(_window, _context);
+
+        {
+            // Magnum tracks GL state per thread
+            Platform::GLContext context;
+
+            for (FramePacket* packet; !_quit; ) {
+                if (!_submitted.pop(packet)) {
+                    std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+                    continue;
+                }
+
+                execute(*packet);
+
+                // The packet is reused only once the GPU is done with its frame
+                GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+                glDeleteSync(fence);
+
+                _recycled.push(packet);
+            }
+        }
+
+        SDL_GL_MakeCurrent(_window, nullptr);
+    }
+
+    void execute(const FramePacket& packet) {
+        GL::defaultFramebuffer.clear(
+            GL::FramebufferClear::Color | GL::FramebufferClear::Depth);
+
+        for (const BufferUpload& upload : packet.uploads) {
+            upload.buffer->setData(upload.data, GL::BufferUsage::StreamDraw);
+        }
+
+        for (const DrawCommand& command : packet.commands) {
+            draw(*command.mesh, *command.shader, command.transform, command.color, packet.projection);
+        }
+
+        SDL_GL_SwapWindow(_window);
+    }
+
+    SDL_Window* _window;
+    SDL_GLContext _context;
+    FramePacket _packets[2];
+    FramePacket* _current{};
+    SpscRing<FramePacket*, 2> _submitted;
+    SpscRing<FramePacket*, 2> _recycled;
+    std::atomic<bool> _quit{};
+    std::thread _thread;
+};
+
+// ---------------------------------------------------------
+//
+// Benchmarks
 //
 // ---------------------------------------------------------
 
 using namespace Magnum::Math::Literals;
 
+// Runs without a window or GL context, `PrimitivesExample --benchmark`
+static int Benchmark() {
+    using Clock = std::chrono::high_resolution_clock;
+    constexpr UnsignedInt Iterations = 100;
+
+    Workers workers;
+    entt::registry registry;
+
+    {
+        constexpr UnsignedInt Meshes = 64;
+        constexpr UnsignedInt Vertices = 20000;
+        constexpr UnsignedInt Bones = 32;
+
+        // One chain of joints, each bent a little relative to its parent
+        auto skeleton = registry.create();
+        auto& skin = registry.assign<Skin>(skeleton);
+        entt::entity parent = entt::null;
+
+        for (UnsignedInt i = 0; i != Bones; ++i) {
+            auto joint = registry.create();
+            registry.assign<Position>(joint, 0.0f, 1.0f, 0.0f);
+            registry.assign<Orientation>(joint, Quaternion::rotation(5.0_degf, Vector3::xAxis()));
+            registry.assign<Scale>(joint, 1.0f);
+            registry.assign<Joint>(joint, parent, Matrix4::translation(Vector3::yAxis(-Float(i))), Matrix4{});
+            skin.joints.push_back(joint);
+            parent = joint;
+        }
+
+        for (UnsignedInt m = 0; m != Meshes; ++m) {
+            SkinnedMesh mesh;
+            mesh.skin = skeleton;
+
+            for (UnsignedInt v = 0; v != Vertices; ++v) {
+                const Float height = Float(v % Bones) + Float(v) / Float(Vertices);
+                const UnsignedShort bone = UnsignedShort(v % Bones);
+
+                mesh.bindPositions.push_back({ 0.5f, height, 0.0f });
+                mesh.bindNormals.push_back(Vector3::xAxis());
+                mesh.jointIndices.push_back({ bone, UnsignedShort(Math::min(bone + 1u, Bones - 1)), 0, 0 });
+                mesh.jointWeights.push_back({ 0.75f, 0.25f, 0.0f, 0.0f });
+            }
+
+            registry.assign<SkinnedMesh>(registry.create(), std::move(mesh));
+        }
+
+        const auto start = Clock::now();
+
+        for (UnsignedInt i = 0; i != Iterations; ++i) {
+            SkeletonSystem(registry);
+            SkinningSystem(registry, workers);
+        }
+
+        const std::chrono::duration<Double, std::milli> elapsed = Clock::now() - start;
+        Debug() << "Skinning" << Meshes << "x" << Vertices << "vertices on" << workers.size()
+                << "threads:" << elapsed.count() / Iterations << "ms per frame";
+    }
+
+    {
+        constexpr UnsignedInt Entities = 1000000;
+        const char* path = "benchmark.world";
+
+        entt::registry world;
+
+        for (UnsignedInt i = 0; i != Entities; ++i) {
+            auto entity = world.create();
+            world.assign<Position>(entity, Float(i % 1000), 0.0f, Float(i / 1000));
+            world.assign<Orientation>(entity, Quaternion::rotation(Deg(Float(i % 360)), Vector3::yAxis()));
+            world.assign<Scale>(entity, 1.0f);
+        }
+
+        auto start = Clock::now();
+        const bool saved = SaveWorld(world, path);
+        const std::chrono::duration<Double, std::milli> save = Clock::now() - start;
+
+        entt::registry loaded;
+        start = Clock::now();
+        const bool restored = saved && LoadWorld(loaded, path);
+        const std::chrono::duration<Double, std::milli> load = Clock::now() - start;
+
+        std::remove(path);
+
+        if (!restored || loaded.size<Position>() != Entities) {
+            Error() << "World round trip failed";
+            return 1;
+        }
+
+        Debug() << "World of" << Entities << "entities saved in" << save.count()
+                << "ms, loaded in" << load.count() << "ms";
+
+        start = Clock::now();
+        auto background = BackgroundSave(world, path);
+        const std::chrono::duration<Double, std::milli> stall = Clock::now() - start;
+        const bool written = background.get();
+        std::remove(path);
+
+        Debug() << "Background save stalled the caller for" << stall.count() << "ms"
+                << (written ? "" : "(and failed)");
+
+        // Autosaves only look at the pages written to since the previous
+        // one, in place writes included
+        const char* journal = "benchmark.journal";
+        Autosave autosave{ world, journal };
+
+        start = Clock::now();
+        autosave.save();
+        const std::chrono::duration<Double, std::milli> first = Clock::now() - start;
+
+        // A cluster of 1% of the world moves
+        for (UnsignedInt i = 0; i != Entities/100; ++i) {
+            world.get<Position>(entt::entity(i)) += Vector3::yAxis();
+        }
+
+        start = Clock::now();
+        autosave.save();
+        const std::chrono::duration<Double, std::milli> second = Clock::now() - start;
+
+        entt::registry replayed;
+        const bool journaled = autosave.flush() && LoadAutosave(replayed, journal) &&
+            replayed.size<Position>() == world.size<Position>();
+        std::remove(journal);
+
+        Debug() << "Autosave stalled the caller for" << first.count() << "ms, then"
+                << second.count() << "ms after moving 1% of the world"
+                << (journaled ? "" : "(and the journal failed to replay)");
+    }
+
+    {
+        constexpr UnsignedInt Entities = 100000;
+
+        // The render query over entities that all have the same components,
+        // sparse sets against tables of columns
+        entt::registry sparse;
+        entt::archetype_registry archetype;
+
+        for (UnsignedInt i = 0; i != Entities; ++i) {
+            const Position position{ Float(i % 1000), 0.0f, Float(i / 1000) };
+            const Orientation orientation = Quaternion::rotation(Deg(Float(i % 360)), Vector3::yAxis());
+            const Color color{ 0.4f, 0.2f, 0.9f };
+
+            auto a = sparse.create();
+            sparse.assign<Identity>(a, "Box");
+            sparse.assign<Position>(a, position);
+            sparse.assign<Orientation>(a, orientation);
+            sparse.assign<Scale>(a, 1.0f);
+            sparse.assign<Color>(a, color);
+
+            auto b = archetype.create();
+            archetype.assign<Identity>(b, "Box");
+            archetype.assign<Position>(b, position);
+            archetype.assign<Orientation>(b, orientation);
+            archetype.assign<Scale>(b, 1.0f);
+            archetype.assign<Color>(b, color);
+        }
+
+        const auto render = [](auto& registry) {
+            Matrix4 sum{ Math::ZeroInit };
+
+            registry.template view<Identity, Position, Orientation, Scale, Color>().each(
+                [&sum](auto&, auto& pos, auto& ori, auto& scale, auto& color)
+            {
+                sum += Matrix4::scaling(scale) *
+                       Matrix4::rotation(ori.angle(), ori.axis().normalized()) *
+                       Matrix4::translation(pos) * color.a();
+            });
+
+            return sum;
+        };
+
+        const auto rotate = [](auto& registry) {
+            registry.template view<Orientation>().each([](auto& ori) {
+                ori = (Quaternion::rotation(0.01_radf, Vector3::xAxis()) * ori).normalized();
+            });
+        };
+
+        const auto time = [&](auto&& func) {
+            const auto start = Clock::now();
+            for (UnsignedInt i = 0; i != Iterations; ++i) func();
+            const std::chrono::duration<Double, std::milli> elapsed = Clock::now() - start;
+            return elapsed.count() / Iterations;
+        };
+
+        // Kept around so that the work isn't optimized away
+        volatile Float sink = 0.0f;
+        const Double sparseRender = time([&] { sink = sink + render(sparse)[3][3]; });
+        const Double archetypeRender = time([&] { sink = sink + render(archetype)[3][3]; });
+        const Double sparseRotate = time([&] { rotate(sparse); });
+        const Double archetypeRotate = time([&] { rotate(archetype); });
+
+        Debug() << "Render query over" << Entities << "entities:" << sparseRender << "ms sparse,"
+                << archetypeRender << "ms archetype";
+        Debug() << "Rotation over" << Entities << "entities:" << sparseRotate << "ms sparse,"
+                << archetypeRotate << "ms archetype";
+
+        // Per-instance attributes for a single draw call, positions and
+        // colors interleaved straight out of the pools of an owning group
+        // against copying them entity by entity
+        const auto instances = sparse.group<Position, Color>();
+        constexpr std::size_t InstanceStride = sizeof(Position) + sizeof(Color);
+        std::vector<char> exported(instances.size()*InstanceStride);
+        std::vector<char> copied(exported.size());
+
+        const Double strided = time([&] {
+            // Position is paged, runs end where its pages do
+            for (std::size_t pos = 0, count = 0; pos < instances.size(); pos += count) {
+                const auto positions = Strided(instances.strided<const Position>(pos));
+                count = positions.size();
+                InterleaveInto({ exported.data() + pos*InstanceStride, count*InstanceStride },
+                    positions, Strided(instances.strided<const Color>(pos)).prefix(count));
+            }
+        });
+
+        const Double perEntity = time([&] {
+            // Groups visit the packed arrays from the back
+            char* out = copied.data() + copied.size();
+            instances.each([&out](const Position& position, const Color& color) {
+                out -= InstanceStride;
+                std::memcpy(out, &position, sizeof(Position));
+                std::memcpy(out + sizeof(Position), &color, sizeof(Color));
+            });
+        });
+
+        Debug() << "Instance export of" << instances.size() << "entities:" << strided << "ms strided,"
+                << perEntity << "ms per entity"
+                << (exported == copied ? "" : "(and the results differ)");
+    }
+
+    return 0;
+}
+
+// ---------------------------------------------------------
+//
+// Implementation
+//
+// ---------------------------------------------------------
+
 class ECSExample : public Platform::Application {
 public:
-    explicit ECSExample(const Arguments& arguments);
+    explicit ECSExample(const Arguments& arguments, bool renderThread, bool statistics, bool autosave);
 
 private:
     void drawEvent() override;
@@ -127,19 +1629,35 @@ private:
 
     Matrix4 _projection;
     Vector2i _previousMousePosition;
+
+    Timeline _timeline;
+    AnimationLod _animationLod;
+    Workers _workers;
+
+    std::unique_ptr<Autosave> _autosave;
+    Float _autosaveTime{};
+
+    std::ofstream _statistics;
+    Float _statisticsTime{};
+    Double _elapsed{};
+
+    // Declared last, such that it gives the GL context back first
+    std::unique_ptr<RenderThread> _renderThread;
 };
 
-ECSExample::ECSExample(const Arguments& arguments) :
+ECSExample::ECSExample(const Arguments& arguments, bool renderThread, bool statistics, bool autosave) :
     Platform::Application{ arguments, Configuration{}
         .setTitle("Magnum Primitives Example") }
 {
     GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
     GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
 
+    _animationLod = { Vector3::zAxis(10.0f), 25.0f, 60.0f, 4 };
+
     _projection =
         Matrix4::perspectiveProjection(
             35.0_degf, Vector2{ windowSize() }.aspectRatio(), 0.01f, 100.0f) *
-        Matrix4::translation(Vector3::zAxis(-10.0f));
+        Matrix4::translation(-_animationLod.eye);
 
     // Create entities
     auto box = _registry.create();
@@ -154,16 +1672,75 @@ ECSExample::ECSExample(const Arguments& arguments) :
         Shaders::Phong{},
         Color4(.4f, .2f, .9f)
     );
+
+    auto bob = std::make_shared<AnimationClip>(AnimationClip{
+        "bob",
+        Animation::Track<Float, Vector3>{{
+            { 0.0f, Vector3{ 0.0f, 0.0f, 0.0f } },
+            { 1.0f, Vector3{ 0.0f, 0.5f, 0.0f } },
+            { 2.0f, Vector3{ 0.0f, 0.0f, 0.0f } }
+        }, Animation::Interpolation::Linear},
+        Animation::Track<Float, Quaternion>{},
+        {}
+    });
+
+    compressAnimationClip(*bob, 0.001f);
+    AnimationCompressionReport(*bob);
+
+    _registry.assign<Animated>(box, std::move(bob), 0.0f, std::size_t{}, std::size_t{});
+
+    // Appended to across runs, such that they can be charted together
+    if (statistics) _statistics.open("registry-stats.jsonl", std::ios::app);
+
+    // Appended to every 30 seconds, only when asked for
+    if (autosave) _autosave = std::make_unique<Autosave>(_registry, "autosave.journal");
+
+    // From here on, GL calls only happen on the render thread
+    if (renderThread) _renderThread = std::make_unique<RenderThread>(window());
+
+    _timeline.start();
 }
 
 void ECSExample::drawEvent() {
-    GL::defaultFramebuffer.clear(
-        GL::FramebufferClear::Color | GL::FramebufferClear::Depth);
+    AnimationSystem(_registry, _timeline.previousFrameDuration(), _projection, _animationLod);
+    SkeletonSystem(_registry);
+    SkinningSystem(_registry, _workers);
 
     // Should the system take _projection as argument?
-    RenderSystem(_registry, _projection);
+    MortonSortSystem(_registry);
+    CoSortSystem(_registry);
+
+    if (_renderThread) {
+        FramePacket& packet = _renderThread->begin();
+        SkinUploadSystem(_registry, packet);
+        SubmitSystem(_registry, _projection, packet);
+        _renderThread->submit();
+    }
+    else {
+        GL::defaultFramebuffer.clear(
+            GL::FramebufferClear::Color | GL::FramebufferClear::Depth);
+
+        SkinUploadSystem(_registry);
+        RenderSystem(_registry, _projection);
+        swapBuffers();
+    }
 
-    swapBuffers();
+    _timeline.nextFrame();
+
+    _autosaveTime += _timeline.previousFrameDuration();
+    if (_autosaveTime > 30.0f && _autosave && _autosave->ready()) {
+        _autosave->save();
+        _autosaveTime = 0.0f;
+    }
+
+    _elapsed += _timeline.previousFrameDuration();
+    _statisticsTime += _timeline.previousFrameDuration();
+    if (_statisticsTime > 10.0f && _statistics.is_open()) {
+        WriteStatistics(_registry, _elapsed, _statistics);
+        _statisticsTime = 0.0f;
+    }
+
+    if (!_registry.empty<Animated>()) redraw();
 }
 
 void ECSExample::mousePressEvent(MouseEvent& event) {
@@ -203,4 +1780,25 @@ void ECSExample::mouseMoveEvent(MouseMoveEvent& event) {
 
 }}
 
-MAGNUM_APPLICATION_MAIN(Magnum::Examples::ECSExample)
\ No newline at end of file
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0) {
+        return Magnum::Examples::Benchmark();
+    }
+
+    // Not among Magnum's own options, so they are taken out before those are parsed
+    const auto take = [&argc, argv](const char* option) {
+        char** last = std::remove_if(argv + 1, argv + argc, [option](const char* arg) {
+            return std::strcmp(arg, option) == 0;
+        });
+        const bool found = last != argv + argc;
+        argc = int(last - argv);
+        return found;
+    };
+
+    const bool renderThread = take("--render-thread");
+    const bool statistics = take("--statistics");
+    const bool autosave = take("--autosave");
+
+    Magnum::Examples::ECSExample app({ argc, argv }, renderThread, statistics, autosave);
+    return app.exec();
+}
\ No newline at end of file
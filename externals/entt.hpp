@@ -51,6 +51,11 @@
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -727,6 +732,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -1305,6 +1315,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -1320,7 +1335,10 @@ namespace entt {
 #define ENTT_ENTITY_REGISTRY_HPP
 
 
+#include <array>
 #include <tuple>
+#include <atomic>
+#include <limits>
 #include <vector>
 #include <memory>
 #include <utility>
@@ -1375,6 +1393,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -1671,6 +1694,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -2250,6 +2278,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -3062,9 +3095,20 @@ namespace entt {
 #include <utility>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <unordered_map>
 #include <cstddef>
 #include <numeric>
+#include <cstdint>
+#include <limits>
+#include <array>
 #include <type_traits>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 // #include "../config/config.h"
 
 // #include "../core/algorithm.hpp"
@@ -3264,6 +3308,10 @@ namespace entt {
     template <typename>
     class basic_registry;
 
+    /*! @struct storage_traits */
+    template<typename, typename = void>
+    struct storage_traits;
+
     /*! @class basic_view */
     template<typename, typename...>
     class basic_view;
@@ -3276,10 +3324,18 @@ namespace entt {
     template<typename...>
     class basic_group;
 
+    /*! @class basic_query */
+    template<typename, typename...>
+    class basic_query;
+
     /*! @class basic_observer */
     template<typename>
     class basic_observer;
 
+    /*! @class basic_concurrent_observer */
+    template<typename>
+    class basic_concurrent_observer;
+
     /*! @class basic_actor */
     template <typename>
     struct basic_actor;
@@ -3300,6 +3356,18 @@ namespace entt {
     template<typename>
     class basic_continuous_loader;
 
+    /*! @class basic_delta_snapshot */
+    template<typename>
+    class basic_delta_snapshot;
+
+    /*! @class basic_archetype_registry */
+    template<typename>
+    class basic_archetype_registry;
+
+    /*! @class basic_archetype_view */
+    template<typename, typename...>
+    class basic_archetype_view;
+
     /*! @brief Alias declaration for the most common use case. */
     ENTT_OPAQUE_TYPE(entity, ENTT_ID_TYPE)
 
@@ -3312,6 +3380,9 @@ namespace entt {
     /*! @brief Alias declaration for the most common use case. */
     using observer = basic_observer<entity>;
 
+    /*! @brief Alias declaration for the most common use case. */
+    using concurrent_observer = basic_concurrent_observer<entity>;
+
     /*! @brief Alias declaration for the most common use case. */
     using actor = basic_actor<entity>;
 
@@ -3327,6 +3398,19 @@ namespace entt {
     /*! @brief Alias declaration for the most common use case. */
     using continuous_loader = basic_continuous_loader<entity>;
 
+    /*! @brief Alias declaration for the most common use case. */
+    using delta_snapshot = basic_delta_snapshot<entity>;
+
+    /*! @brief Alias declaration for the most common use case. */
+    using archetype_registry = basic_archetype_registry<entity>;
+
+    /**
+     * @brief Alias declaration for the most common use case.
+     * @tparam Types Types of components iterated by the view.
+     */
+    template<typename... Types>
+    using archetype_view = basic_archetype_view<entity, Types...>;
+
     /**
      * @brief Alias declaration for the most common use case.
      * @tparam Component Types of components iterated by the view.
@@ -3355,6 +3439,125 @@ namespace entt {
 namespace entt {
 
 
+    /**
+     * @cond TURN_OFF_DOXYGEN
+     * Internal details not to be documented.
+     */
+
+
+    namespace internal {
+
+
+        template<typename, typename = std::void_t<>>
+        struct instance_page : std::integral_constant<std::size_t, 0> {};
+
+
+        template<typename Type>
+        struct instance_page<Type, std::void_t<decltype(storage_traits<Type>::instance_page)>>
+            : std::integral_constant<std::size_t, storage_traits<Type>::instance_page> {};
+
+
+        template<typename Type>
+        constexpr auto instance_page_v = instance_page<Type>::value;
+
+
+        template<typename, typename = std::void_t<>>
+        struct instance_alignment : std::integral_constant<std::size_t, ENTT_INSTANCE_ALIGNMENT> {};
+
+
+        template<typename Type>
+        struct instance_alignment<Type, std::void_t<decltype(storage_traits<Type>::instance_alignment)>>
+            : std::integral_constant<std::size_t, storage_traits<Type>::instance_alignment> {};
+
+
+        template<typename Type>
+        constexpr auto instance_alignment_v = (std::max)(alignof(Type), instance_alignment<Type>::value);
+
+
+        template<typename, typename = std::void_t<>>
+        struct sparse_page : std::integral_constant<std::size_t, ENTT_PAGE_SIZE> {};
+
+
+        template<typename Type>
+        struct sparse_page<Type, std::void_t<decltype(storage_traits<Type>::sparse_page)>>
+            : std::integral_constant<std::size_t, storage_traits<Type>::sparse_page> {};
+
+
+        template<typename Type>
+        constexpr auto sparse_page_v = sparse_page<Type>::value;
+
+
+        template<typename, typename = std::void_t<>>
+        struct presence : std::false_type {};
+
+
+        template<typename Type>
+        struct presence<Type, std::void_t<decltype(storage_traits<Type>::presence)>>
+            : std::bool_constant<storage_traits<Type>::presence> {};
+
+
+        template<typename Type>
+        constexpr auto presence_v = presence<Type>::value;
+
+
+        inline unsigned int lowest_bit(const std::uint64_t word) ENTT_NOEXCEPT {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long pos;
+            _BitScanForward64(&pos, word);
+            return static_cast<unsigned int>(pos);
+#else
+            return static_cast<unsigned int>(__builtin_ctzll(word));
+#endif
+        }
+
+
+        inline std::atomic<std::uint64_t>& write_clock() ENTT_NOEXCEPT {
+            // ticked by delta snapshots, storage classes stamp their writes with it
+            static std::atomic<std::uint64_t> clock{ 1u };
+            return clock;
+        }
+
+
+        class write_stamp {
+        public:
+            write_stamp() ENTT_NOEXCEPT = default;
+
+            write_stamp(const write_stamp& other) ENTT_NOEXCEPT
+                : value{ other.get() }
+            {}
+
+            write_stamp& operator=(const write_stamp& other) ENTT_NOEXCEPT {
+                value.store(other.get(), std::memory_order_relaxed);
+                return *this;
+            }
+
+            void touch() ENTT_NOEXCEPT {
+                const auto now = write_clock().load(std::memory_order_relaxed);
+
+                // parallel writers mostly find it up to date and only read it
+                if (value.load(std::memory_order_relaxed) != now) {
+                    value.store(now, std::memory_order_relaxed);
+                }
+            }
+
+            std::uint64_t get() const ENTT_NOEXCEPT {
+                return value.load(std::memory_order_relaxed);
+            }
+
+        private:
+            std::atomic<std::uint64_t> value{};
+        };
+
+
+    }
+
+
+    /**
+     * Internal details not to be documented.
+     * @endcond TURN_OFF_DOXYGEN
+     */
+
+
     /**
      * @brief Basic sparse set implementation.
      *
@@ -3387,12 +3590,11 @@ namespace entt {
         using traits_type = entt_traits<std::underlying_type_t<Entity>>;
 
         static_assert(ENTT_PAGE_SIZE && ((ENTT_PAGE_SIZE& (ENTT_PAGE_SIZE - 1)) == 0));
-        static constexpr auto entt_per_page = ENTT_PAGE_SIZE / sizeof(typename traits_type::entity_type);
 
         class iterator {
             friend class sparse_set<Entity>;
 
-            using direct_type = const std::vector<Entity>;
+            using direct_type = const std::pmr::vector<Entity>;
             using index_type = typename traits_type::difference_type;
 
             iterator(direct_type* ref, const index_type idx) ENTT_NOEXCEPT
@@ -3490,23 +3692,153 @@ namespace entt {
             index_type index;
         };
 
+        struct page_deleter {
+            void operator()(Entity* page) const {
+                resource->deallocate(page, length * sizeof(Entity), alignof(Entity));
+            }
+
+            std::pmr::memory_resource* resource{};
+            std::size_t length{};
+        };
+
+        struct page_type {
+            std::shared_ptr<Entity> data{};
+            // copies share the page until either of them writes to it
+            mutable bool exclusive{};
+        };
+
+        using identifier_type = typename traits_type::entity_type;
+
+        // empty pages kept around at least, so that toggling a component doesn't churn them
+        static constexpr std::size_t spare_pages = 4u;
+
+        static auto identifier(const Entity entt) ENTT_NOEXCEPT {
+            return identifier_type(to_integer(entt) & traits_type::entity_mask);
+        }
+
+        std::shared_ptr<Entity> allocate() {
+            auto* mem = resource();
+            return { static_cast<entity_type*>(mem->allocate(per_page * sizeof(entity_type), alignof(entity_type))), page_deleter{ mem, per_page }, std::pmr::polymorphic_allocator<std::byte>{ mem } };
+        }
+
         void assure(const std::size_t page) {
             if (!(page < reverse.size())) {
                 reverse.resize(page + 1);
+                occupancy.resize(page + 1);
             }
 
-            if (!reverse[page]) {
-                reverse[page] = std::make_unique<entity_type[]>(entt_per_page);
+            if (!reverse[page].data) {
+                reverse[page] = page_type{ allocate(), true };
                 // null is safe in all cases for our purposes
-                std::fill_n(reverse[page].get(), entt_per_page, null);
+                std::fill_n(reverse[page].data.get(), per_page, null);
+            }
+        }
+
+        Entity* writable(const std::size_t page) {
+            auto& elem = reverse[page];
+
+            if (!elem.exclusive) {
+                auto data = allocate();
+                std::copy_n(elem.data.get(), per_page, data.get());
+                elem = page_type{ std::move(data), true };
+            }
+
+            return elem.data.get();
+        }
+
+        const Entity* slot(const Entity entt) const ENTT_NOEXCEPT {
+            const auto id = identifier(entt);
+
+            if (per_page) {
+                const auto page = size_type(id >> page_shift);
+                return (page < reverse.size() && reverse[page].data) ? (reverse[page].data.get() + (id & (per_page - 1))) : nullptr;
+            }
+
+            const auto it = compact.find(id);
+            return it == compact.cend() ? nullptr : &it->second;
+        }
+
+        Entity& slot_of(const Entity entt) {
+            const auto id = identifier(entt);
+            return per_page ? writable(size_type(id >> page_shift))[id & (per_page - 1)] : compact.find(id)->second;
+        }
+
+        void mark(const std::size_t id) {
+            const auto word = id / 64u;
+
+            if (!(word < words.size())) {
+                words.resize(word + 1u);
+                summary.resize(word / 64u + 1u);
+            }
+
+            words[word] |= std::uint64_t{ 1u } << (id % 64u);
+            summary[word / 64u] |= std::uint64_t{ 1u } << (word % 64u);
+        }
+
+        void unmark(const std::size_t id) {
+            const auto word = id / 64u;
+
+            if (!(words[word] &= ~(std::uint64_t{ 1u } << (id % 64u)))) {
+                summary[word / 64u] &= ~(std::uint64_t{ 1u } << (word % 64u));
+            }
+        }
+
+        Entity& occupy(const Entity entt) {
+            const auto id = identifier(entt);
+
+            if (tracking) {
+                mark(size_type(id));
+            }
+
+            if (per_page) {
+                const auto page = size_type(id >> page_shift);
+                const bool fresh = !(page < reverse.size() && reverse[page].data);
+                assure(page);
+
+                if (!occupancy[page]++ && !fresh) {
+                    --vacant;
+                }
+
+                return writable(page)[id & (per_page - 1)];
+            }
+
+            return compact[id];
+        }
+
+        void release(const Entity entt) {
+            const auto id = identifier(entt);
+
+            if (tracking) {
+                unmark(size_type(id));
+            }
+
+            if (per_page) {
+                const auto page = size_type(id >> page_shift);
+                writable(page)[id & (per_page - 1)] = null;
+
+                // rare components on far apart entities would otherwise pin their pages
+                if (!--occupancy[page] && ++vacant > std::max(spare_pages, reverse.size() / 8u)) {
+                    reclaim();
+                }
+            }
+            else {
+                compact.erase(id);
             }
         }
 
-        auto map(const Entity entt) const ENTT_NOEXCEPT {
-            const auto identifier = to_integer(entt) & traits_type::entity_mask;
-            const auto page = size_type(identifier / entt_per_page);
-            const auto offset = size_type(identifier & (entt_per_page - 1));
-            return std::make_pair(page, offset);
+        void reclaim() {
+            for (size_type pos{}, last = reverse.size(); pos < last; ++pos) {
+                if (reverse[pos].data && !occupancy[pos]) {
+                    reverse[pos] = {};
+                }
+            }
+
+            while (!reverse.empty() && !reverse.back().data) {
+                reverse.pop_back();
+            }
+
+            occupancy.resize(reverse.size());
+            vacant = {};
         }
 
     public:
@@ -3518,21 +3850,70 @@ namespace entt {
         using iterator_type = iterator;
 
         /*! @brief Default constructor. */
-        sparse_set() = default;
+        sparse_set()
+            : sparse_set{ std::pmr::get_default_resource() }
+        {}
+
+        /**
+         * @brief Constructs an empty sparse set that allocates from a resource.
+         *
+         * Both the sparse pages and the packed array are obtained from the given
+         * memory resource, that must outlive the sparse set.
+         *
+         * Sparse pages are `page` bytes large, that must be a power of two. A page
+         * size of zero selects the compact mode instead, where the sparse array is
+         * replaced by a hash table. It suits very sparse sets the elements of which
+         * are scattered across far apart entities.
+         *
+         * @param resource A valid memory resource.
+         * @param page Size in bytes of a sparse page, zero for the compact mode.
+         */
+        explicit sparse_set(std::pmr::memory_resource* resource, const size_type page = ENTT_PAGE_SIZE)
+            : reverse{ resource },
+            occupancy{ resource },
+            compact{ resource },
+            direct{ resource },
+            words{ resource },
+            summary{ resource },
+            per_page{ page / sizeof(entity_type) },
+            page_shift{},
+            vacant{},
+            tracking{}
+        {
+            ENTT_ASSERT(!page || (per_page && (per_page & (per_page - 1)) == 0));
+
+            while ((size_type{ 1u } << page_shift) < per_page) {
+                ++page_shift;
+            }
+        }
 
         /**
          * @brief Copy constructor.
+         *
+         * The copy allocates from the same memory resource and has the same page
+         * size as the original. Sparse pages are shared with the original until
+         * either of the two writes to them.
+         *
          * @param other The instance to copy from.
          */
         sparse_set(const sparse_set& other)
-            : reverse{},
-            direct{ other.direct }
+            : reverse{ other.reverse, other.resource() },
+            occupancy{ other.occupancy, other.resource() },
+            compact{ other.compact, other.resource() },
+            direct{ other.direct, other.resource() },
+            words{ other.words, other.resource() },
+            summary{ other.summary, other.resource() },
+            per_page{ other.per_page },
+            page_shift{ other.page_shift },
+            vacant{ other.vacant },
+            tracking{ other.tracking }
         {
-            for (size_type pos{}, last = other.reverse.size(); pos < last; ++pos) {
-                if (other.reverse[pos]) {
-                    assure(pos);
-                    std::copy_n(other.reverse[pos].get(), entt_per_page, reverse[pos].get());
-                }
+            for (auto&& page : reverse) {
+                page.exclusive = false;
+            }
+
+            for (auto&& page : other.reverse) {
+                page.exclusive = false;
             }
         }
 
@@ -3559,6 +3940,14 @@ namespace entt {
         /*! @brief Default move assignment operator. @return This sparse set. */
         sparse_set& operator=(sparse_set&&) = default;
 
+        /**
+         * @brief Returns the memory resource used by a sparse set.
+         * @return The memory resource in use.
+         */
+        std::pmr::memory_resource* resource() const ENTT_NOEXCEPT {
+            return direct.get_allocator().resource();
+        }
+
         /**
          * @brief Increases the capacity of a sparse set.
          *
@@ -3580,15 +3969,24 @@ namespace entt {
             return direct.capacity();
         }
 
-        /*! @brief Requests the removal of unused capacity. */
+        /**
+         * @brief Requests the removal of unused capacity.
+         *
+         * Sparse pages that become empty are released as soon as there are more
+         * than a few of them (an eighth of the sparse array at least), so that
+         * adding and removing the same entities over and over doesn't allocate
+         * and release a page every time. This function releases all the empty
+         * pages left and trims the trailing slots of the sparse array that don't
+         * refer to any page.
+         */
         void shrink_to_fit() {
-            // conservative approach
-            if (direct.empty()) {
-                reverse.clear();
-            }
-
+            reclaim();
             reverse.shrink_to_fit();
+            occupancy.shrink_to_fit();
+            compact.rehash(0);
             direct.shrink_to_fit();
+            words.shrink_to_fit();
+            summary.shrink_to_fit();
         }
 
         /**
@@ -3597,12 +3995,58 @@ namespace entt {
          * The extent of a sparse set is also the size of the internal sparse array.
          * There is no guarantee that the internal packed array has the same size.
          * Usually the size of the internal sparse array is equal or greater than
-         * the one of the internal packed array.
+         * the one of the internal packed array.<br/>
+         * In compact mode, the extent is the number of slots of the hash table.
          *
          * @return Extent of the sparse set.
          */
         size_type extent() const ENTT_NOEXCEPT {
-            return reverse.size() * entt_per_page;
+            return per_page ? (reverse.size() * per_page) : compact.bucket_count();
+        }
+
+        /**
+         * @brief Returns the size in bytes of the sparse pages.
+         * @return Size of a sparse page, zero in compact mode.
+         */
+        size_type page_size() const ENTT_NOEXCEPT {
+            return per_page * sizeof(entity_type);
+        }
+
+        /**
+         * @brief Returns the number of sparse pages currently allocated.
+         * @return Number of sparse pages, zero in compact mode.
+         */
+        size_type pages() const ENTT_NOEXCEPT {
+            return size_type(std::count_if(reverse.cbegin(), reverse.cend(), [](const auto& page) { return page.data != nullptr; }));
+        }
+
+        /**
+         * @brief Returns the number of sparse pages allocated but empty.
+         *
+         * Empty pages don't refer to any entity. They are released once there
+         * are too many of them or on the next call to `shrink_to_fit`.
+         *
+         * @return Number of empty sparse pages, zero in compact mode.
+         */
+        size_type empty_pages() const ENTT_NOEXCEPT {
+            return vacant;
+        }
+
+        /**
+         * @brief Returns the memory used by the sparse array.
+         *
+         * In compact mode, the value is an estimate that accounts for the nodes
+         * and the buckets of the hash table.
+         *
+         * @return Size in bytes of the sparse array and its bookkeeping.
+         */
+        size_type sparse_bytes() const ENTT_NOEXCEPT {
+            return pages() * page_size()
+                + reverse.capacity() * sizeof(page_type)
+                + occupancy.capacity() * sizeof(size_type)
+                + compact.size() * (sizeof(typename decltype(compact)::value_type) + sizeof(void*))
+                + compact.bucket_count() * sizeof(void*)
+                + (words.capacity() + summary.capacity()) * sizeof(std::uint64_t);
         }
 
         /**
@@ -3683,60 +4127,145 @@ namespace entt {
         }
 
         /**
-         * @brief Finds an entity.
-         * @param entt A valid entity identifier.
-         * @return An iterator to the given entity if it's found, past the end
-         * iterator otherwise.
+         * @brief Enables or disables the presence bitset of a sparse set.
+         *
+         * The presence bitset has a bit for each entity identifier, that is set
+         * when the sparse set contains the entity. A second level has a bit for
+         * each word of the first one, that is set when the word isn't empty.<br/>
+         * Multi-component views and groups intersect the bitsets of their pools
+         * a word at a time and skip the empty ranges as a whole, as long as all
+         * the pools involved track their presence. Negative lookups through
+         * `has` also resolve with a single load.
+         *
+         * @param enable True to maintain the presence bitset, false otherwise.
          */
-        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
-            return has(entt) ? --(end() - index(entt)) : end();
+        void track_presence(const bool enable) {
+            words.clear();
+            summary.clear();
+
+            if ((tracking = enable)) {
+                for (const auto entt : direct) {
+                    mark(size_type(identifier(entt)));
+                }
+            }
         }
 
         /**
-         * @brief Checks if a sparse set contains an entity.
-         * @param entt A valid entity identifier.
-         * @return True if the sparse set contains the entity, false otherwise.
+         * @brief Checks whether a sparse set maintains its presence bitset.
+         * @return True if the presence bitset is available, false otherwise.
          */
-        bool has(const entity_type entt) const ENTT_NOEXCEPT {
-            auto [page, offset] = map(entt);
-            // testing against null permits to avoid accessing the direct vector
-            return (page < reverse.size() && reverse[page] && reverse[page][offset] != null);
+        bool tracks_presence() const ENTT_NOEXCEPT {
+            return tracking;
         }
 
         /**
-         * @brief Returns the position of an entity in a sparse set.
+         * @brief Direct access to the presence bitset.
          *
-         * @warning
-         * Attempting to get the position of an entity that doesn't belong to the
-         * sparse set results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * sparse set doesn't contain the given entity.
+         * Bit `id % 64` of word `id / 64` is set if the sparse set contains the
+         * entity with identifier `id`. The returned pointer is such that range
+         * `[presence(), presence() + presence_size()]` is always a valid range.
          *
-         * @param entt A valid entity identifier.
-         * @return The position of the entity in the sparse set.
+         * @return A pointer to the words of the presence bitset.
          */
-        size_type index(const entity_type entt) const ENTT_NOEXCEPT {
-            ENTT_ASSERT(has(entt));
-            auto [page, offset] = map(entt);
-            return size_type(reverse[page][offset]);
+        const std::uint64_t* presence() const ENTT_NOEXCEPT {
+            return words.data();
         }
 
         /**
-         * @brief Assigns an entity to a sparse set.
+         * @brief Returns the number of words of the presence bitset.
+         * @return Number of words, zero if the bitset isn't maintained.
+         */
+        size_type presence_size() const ENTT_NOEXCEPT {
+            return words.size();
+        }
+
+        /**
+         * @brief Direct access to the summary of the presence bitset.
          *
-         * @warning
-         * Attempting to assign an entity that already belongs to the sparse set
-         * results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * sparse set already contains the given entity.
+         * Bit `pos % 64` of word `pos / 64` is set if word `pos` of the presence
+         * bitset isn't empty.
+         *
+         * @return A pointer to the words of the summary.
+         */
+        const std::uint64_t* presence_summary() const ENTT_NOEXCEPT {
+            return summary.data();
+        }
+
+        /**
+         * @brief Returns the entity of a sparse set with the given identifier.
+         * @param id An entity identifier, version excluded.
+         * @return The entity with the given identifier if any, the null entity
+         * otherwise.
+         */
+        entity_type resolve(const size_type id) const ENTT_NOEXCEPT {
+            if (const auto* elem = slot(entity_type(id)); elem && *elem != null) {
+                return direct[size_type(*elem)];
+            }
+
+            return null;
+        }
+
+        /**
+         * @brief Finds an entity.
+         * @param entt A valid entity identifier.
+         * @return An iterator to the given entity if it's found, past the end
+         * iterator otherwise.
+         */
+        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
+            return has(entt) ? --(end() - index(entt)) : end();
+        }
+
+        /**
+         * @brief Checks if a sparse set contains an entity.
+         * @param entt A valid entity identifier.
+         * @return True if the sparse set contains the entity, false otherwise.
+         */
+        bool has(const entity_type entt) const ENTT_NOEXCEPT {
+            if (tracking) {
+                const auto id = size_type(identifier(entt));
+
+                // a clear bit spares the lookup into the sparse array
+                if (!(id / 64u < words.size()) || !(words[id / 64u] & (std::uint64_t{ 1u } << (id % 64u)))) {
+                    return false;
+                }
+            }
+
+            const auto* elem = slot(entt);
+            // testing against null permits to avoid accessing the direct vector
+            return elem && *elem != null;
+        }
+
+        /**
+         * @brief Returns the position of an entity in a sparse set.
+         *
+         * @warning
+         * Attempting to get the position of an entity that doesn't belong to the
+         * sparse set results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * sparse set doesn't contain the given entity.
+         *
+         * @param entt A valid entity identifier.
+         * @return The position of the entity in the sparse set.
+         */
+        size_type index(const entity_type entt) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(has(entt));
+            return size_type(*slot(entt));
+        }
+
+        /**
+         * @brief Assigns an entity to a sparse set.
+         *
+         * @warning
+         * Attempting to assign an entity that already belongs to the sparse set
+         * results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * sparse set already contains the given entity.
          *
          * @param entt A valid entity identifier.
          */
         void construct(const entity_type entt) {
             ENTT_ASSERT(!has(entt));
-            auto [page, offset] = map(entt);
-            assure(page);
-            reverse[page][offset] = entity_type(direct.size());
+            occupy(entt) = entity_type(direct.size());
             direct.push_back(entt);
         }
 
@@ -3757,9 +4286,7 @@ namespace entt {
         void batch(It first, It last) {
             std::for_each(first, last, [this, next = direct.size()](const auto entt) mutable {
                 ENTT_ASSERT(!has(entt));
-                auto [page, offset] = map(entt);
-                assure(page);
-                reverse[page][offset] = entity_type(next++);
+                occupy(entt) = entity_type(next++);
             });
 
             direct.insert(direct.end(), first, last);
@@ -3778,11 +4305,10 @@ namespace entt {
          */
         void destroy(const entity_type entt) {
             ENTT_ASSERT(has(entt));
-            auto [from_page, from_offset] = map(entt);
-            auto [to_page, to_offset] = map(direct.back());
-            direct[size_type(reverse[from_page][from_offset])] = entity_type(direct.back());
-            reverse[to_page][to_offset] = reverse[from_page][from_offset];
-            reverse[from_page][from_offset] = null;
+            const auto pos = slot_of(entt);
+            direct[size_type(pos)] = entity_type(direct.back());
+            slot_of(direct.back()) = pos;
+            release(entt);
             direct.pop_back();
         }
 
@@ -3801,12 +4327,10 @@ namespace entt {
          * @param lhs A valid position within the sparse set.
          * @param rhs A valid position within the sparse set.
          */
-        virtual void swap(const size_type lhs, const size_type rhs) ENTT_NOEXCEPT {
+        virtual void swap(const size_type lhs, const size_type rhs) {
             ENTT_ASSERT(lhs < direct.size());
             ENTT_ASSERT(rhs < direct.size());
-            auto [src_page, src_offset] = map(direct[lhs]);
-            auto [dst_page, dst_offset] = map(direct[rhs]);
-            std::swap(reverse[src_page][src_offset], reverse[dst_page][dst_offset]);
+            std::swap(slot_of(direct[lhs]), slot_of(direct[rhs]));
             std::swap(direct[lhs], direct[rhs]);
         }
 
@@ -3921,15 +4445,134 @@ namespace entt {
          */
         void reset() {
             reverse.clear();
+            occupancy.clear();
+            vacant = {};
+            compact.clear();
             direct.clear();
+            words.clear();
+            summary.clear();
         }
 
     private:
-        std::vector<std::unique_ptr<entity_type[]>> reverse;
-        std::vector<entity_type> direct;
+        std::pmr::vector<page_type> reverse;
+        std::pmr::vector<size_type> occupancy;
+        std::pmr::unordered_map<identifier_type, entity_type> compact;
+        std::pmr::vector<entity_type> direct;
+        std::pmr::vector<std::uint64_t> words;
+        std::pmr::vector<std::uint64_t> summary;
+        size_type per_page;
+        size_type page_shift;
+        size_type vacant;
+        bool tracking;
     };
 
 
+    /**
+     * @cond TURN_OFF_DOXYGEN
+     * Internal details not to be documented.
+     */
+
+
+    namespace internal {
+
+
+        template<typename Entity, std::size_t Get, std::size_t Exclude, typename Func>
+        void intersect_presence(const std::array<const sparse_set<Entity>*, Get>& get, const std::array<const sparse_set<Entity>*, Exclude>& exclude, Func func) {
+            static_assert(Get != 0);
+            std::size_t count = std::numeric_limits<std::size_t>::max();
+
+            for (const auto* cpool : get) {
+                count = (std::min)(count, cpool->presence_size());
+            }
+
+            // pointers are read again for every word since the function object can add components
+            const auto word_at = [&get, &exclude](const std::size_t pos) {
+                auto word = ~std::uint64_t{};
+
+                for (const auto* cpool : get) {
+                    word &= cpool->presence()[pos];
+                }
+
+                for (const auto* cpool : exclude) {
+                    if (pos < cpool->presence_size()) {
+                        word &= ~cpool->presence()[pos];
+                    }
+                }
+
+                return word;
+            };
+
+            const auto visit = [&func](const std::size_t base, std::uint64_t word) {
+                while (word) {
+                    func(base + lowest_bit(word));
+                    word &= word - 1u;
+                }
+            };
+
+            for (std::size_t block{}, last = (count + 63u) / 64u; block < last; ++block) {
+                auto live = ~std::uint64_t{};
+
+                for (const auto* cpool : get) {
+                    live &= cpool->presence_summary()[block];
+                }
+
+                if (const auto tail = count - block * 64u; tail < 64u) {
+                    live &= (std::uint64_t{ 1u } << tail) - 1u;
+                }
+
+                while (live) {
+                    // words are combined four at a time, the width of a 256 bit register
+                    const auto first = lowest_bit(live) & ~3u;
+                    const auto base = block * 64u + first;
+                    auto quad = (live >> first) & 0xFu;
+                    live &= ~(std::uint64_t{ 0xFu } << first);
+
+#ifdef __AVX2__
+                    if (base + 4u <= count && std::all_of(exclude.cbegin(), exclude.cend(), [base](const auto* cpool) { return cpool->presence_size() <= base || base + 4u <= cpool->presence_size(); })) {
+                        auto acc = _mm256_set1_epi64x(-1);
+
+                        for (const auto* cpool : get) {
+                            acc = _mm256_and_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cpool->presence() + base)));
+                        }
+
+                        for (const auto* cpool : exclude) {
+                            if (base < cpool->presence_size()) {
+                                acc = _mm256_andnot_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cpool->presence() + base)), acc);
+                            }
+                        }
+
+                        if (!_mm256_testz_si256(acc, acc)) {
+                            alignas(32) std::uint64_t lanes[4];
+                            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+
+                            for (std::size_t pos{}; pos < 4u; ++pos) {
+                                visit((base + pos) * 64u, lanes[pos]);
+                            }
+                        }
+
+                        continue;
+                    }
+#endif
+
+                    for (std::size_t pos{}; quad; ++pos, quad >>= 1u) {
+                        if (quad & 1u) {
+                            visit((base + pos) * 64u, word_at(base + pos));
+                        }
+                    }
+                }
+            }
+        }
+
+
+    }
+
+
+    /**
+     * Internal details not to be documented.
+     * @endcond TURN_OFF_DOXYGEN
+     */
+
+
 }
 
 
@@ -4191,7 +4834,14 @@ namespace entt {
 
 
 #include <array>
+#include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <istream>
+#include <algorithm>
+#include <ostream>
 #include <utility>
 #include <iterator>
 #include <type_traits>
@@ -4208,2335 +4858,2757 @@ namespace entt {
 
 
     /**
-     * @brief Utility class to create snapshots from a registry.
+     * @brief Output archive that writes values as raw bytes to a stream.
      *
-     * A _snapshot_ can be either a dump of the entire registry or a narrower
-     * selection of components of interest.<br/>
-     * This type can be used in both cases if provided with a correctly configured
-     * output archive.
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * Trivially copyable values only. When used with a snapshot, pools of
+     * trivially copyable components are written as two contiguous blocks (the
+     * packed entities and the packed instances) instead of element by element.
      */
-    template<typename Entity>
-    class basic_snapshot {
-        /*! @brief A registry is allowed to create snapshots. */
-        friend class basic_registry<Entity>;
-
-        using follow_fn_type = Entity(const basic_registry<Entity>&, const Entity);
-        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
-
-        basic_snapshot(const basic_registry<Entity>* source, Entity init, follow_fn_type* fn) ENTT_NOEXCEPT
-            : reg{ source },
-            seed{ init },
-            follow{ fn }
+    class binary_output_archive {
+    public:
+        /**
+         * @brief Constructs an archive that writes to the given stream.
+         * @param output A valid reference to an output stream.
+         */
+        binary_output_archive(std::ostream& output) ENTT_NOEXCEPT
+            : stream{ &output }
         {}
 
-        template<typename Component, typename Archive, typename It>
-        void get(Archive& archive, std::size_t sz, It first, It last) const {
-            archive(typename traits_type::entity_type(sz));
-
-            while (first != last) {
-                const auto entt = *(first++);
+        /**
+         * @brief Writes the given values in order.
+         * @tparam Type Types of values to write.
+         * @param value Values to write.
+         */
+        template<typename... Type>
+        void operator()(const Type& ... value) {
+            (block(&value, 1u), ...);
+        }
 
-                if (reg->template has<Component>(entt)) {
-                    if constexpr (std::is_empty_v<Component>) {
-                        archive(entt);
-                    }
-                    else {
-                        archive(entt, reg->template get<Component>(entt));
-                    }
-                }
-            }
+        /**
+         * @brief Writes a contiguous array of values at once.
+         * @tparam Type Type of values to write.
+         * @param data A pointer to the first element of the array.
+         * @param count Number of elements to write.
+         */
+        template<typename Type>
+        void block(const Type* data, const std::size_t count) {
+            static_assert(std::is_trivially_copyable_v<Type>);
+            stream->write(reinterpret_cast<const char*>(data), std::streamsize(sizeof(Type) * count));
+            offset += sizeof(Type) * count;
         }
 
-        template<typename... Component, typename Archive, typename It, std::size_t... Indexes>
-        void component(Archive& archive, It first, It last, std::index_sequence<Indexes...>) const {
-            std::array<std::size_t, sizeof...(Indexes)> size{};
-            auto begin = first;
+        /**
+         * @brief Pads the output up to a multiple of the given alignment.
+         *
+         * Offsets are counted from the construction of the archive. Snapshots pad
+         * blocks of instances to the alignment of their pools, so that a memory
+         * mapped file can be adopted as is if it's mapped at a suitably aligned
+         * address.
+         *
+         * @param alignment Alignment in bytes, a power of two.
+         */
+        void align(const std::size_t alignment) {
+            static constexpr char zero[64]{};
 
-            while (begin != last) {
-                const auto entt = *(begin++);
-                ((reg->template has<Component>(entt) ? ++size[Indexes] : size[Indexes]), ...);
+            for (auto pad = (alignment - offset % alignment) % alignment; pad;) {
+                const auto length = (std::min)(pad, sizeof(zero));
+                block(zero, length);
+                pad -= length;
             }
-
-            (get<Component>(archive, size[Indexes], first, last), ...);
         }
 
-    public:
-        /*! @brief Default move constructor. */
-        basic_snapshot(basic_snapshot&&) = default;
+    private:
+        std::ostream* stream;
+        std::size_t offset{};
+    };
 
-        /*! @brief Default move assignment operator. @return This snapshot. */
-        basic_snapshot& operator=(basic_snapshot&&) = default;
 
+    /**
+     * @brief Input archive that reads values written by a binary output archive.
+     *
+     * @sa binary_output_archive
+     */
+    class binary_input_archive {
+    public:
         /**
-         * @brief Puts aside all the entities that are still in use.
-         *
-         * Entities are serialized along with their versions. Destroyed entities are
-         * not taken in consideration by this function.
-         *
-         * @tparam Archive Type of output archive.
-         * @param archive A valid reference to an output archive.
-         * @return An object of this type to continue creating the snapshot.
+         * @brief Constructs an archive that reads from the given stream.
+         * @param input A valid reference to an input stream.
          */
-        template<typename Archive>
-        const basic_snapshot& entities(Archive& archive) const {
-            archive(typename traits_type::entity_type(reg->alive()));
-            reg->each([&archive](const auto entt) { archive(entt); });
-            return *this;
-        }
+        binary_input_archive(std::istream& input) ENTT_NOEXCEPT
+            : stream{ &input }
+        {}
 
         /**
-         * @brief Puts aside destroyed entities.
-         *
-         * Entities are serialized along with their versions. Entities that are
-         * still in use are not taken in consideration by this function.
-         *
-         * @tparam Archive Type of output archive.
-         * @param archive A valid reference to an output archive.
-         * @return An object of this type to continue creating the snapshot.
+         * @brief Reads the given values in order.
+         * @tparam Type Types of values to read.
+         * @param value Values to fill.
          */
-        template<typename Archive>
-        const basic_snapshot& destroyed(Archive& archive) const {
-            auto size = reg->size() - reg->alive();
-            archive(typename traits_type::entity_type(size));
+        template<typename... Type>
+        void operator()(Type& ... value) {
+            (block(&value, 1u), ...);
+        }
 
-            if (size) {
-                auto curr = seed;
-                archive(curr);
+        /**
+         * @brief Reads a contiguous array of values at once.
+         * @tparam Type Type of values to read.
+         * @param data A pointer to the first element of the array to fill.
+         * @param count Number of elements to read.
+         */
+        template<typename Type>
+        void block(Type* data, const std::size_t count) {
+            static_assert(std::is_trivially_copyable_v<Type>);
+            stream->read(reinterpret_cast<char*>(data), std::streamsize(sizeof(Type) * count));
+            offset += sizeof(Type) * count;
+        }
 
-                for (--size; size; --size) {
-                    curr = follow(*reg, curr);
-                    archive(curr);
-                }
-            }
+        /**
+         * @brief Skips the padding written by a binary output archive.
+         * @param alignment Alignment in bytes, a power of two.
+         */
+        void align(const std::size_t alignment) {
+            const auto pad = (alignment - offset % alignment) % alignment;
+            stream->ignore(std::streamsize(pad));
+            offset += pad;
+        }
 
-            return *this;
+        /*! @brief Fails the archive, as loaders do when data are malformed. */
+        void fail() {
+            stream->setstate(std::ios_base::failbit);
         }
 
         /**
-         * @brief Puts aside the given components.
-         *
-         * Each instance is serialized together with the entity to which it belongs.
-         * Entities are serialized along with their versions.
-         *
-         * @tparam Component Types of components to serialize.
-         * @tparam Archive Type of output archive.
-         * @param archive A valid reference to an output archive.
-         * @return An object of this type to continue creating the snapshot.
+         * @brief Checks whether all the reads so far succeeded.
+         * @return False if the underlying stream failed, true otherwise.
          */
-        template<typename... Component, typename Archive>
-        const basic_snapshot& component(Archive& archive) const {
-            if constexpr (sizeof...(Component) == 1) {
-                const auto sz = reg->template size<Component...>();
-                const auto* entities = reg->template data<Component...>();
+        explicit operator bool() const {
+            return !stream->fail();
+        }
 
-                archive(typename traits_type::entity_type(sz));
-
-                for (std::remove_const_t<decltype(sz)> pos{}; pos < sz; ++pos) {
-                    const auto entt = entities[pos];
-
-                    if constexpr (std::is_empty_v<Component...>) {
-                        archive(entt);
-                    }
-                    else {
-                        archive(entt, reg->template get<Component...>(entt));
-                    }
-                };
-            }
-            else {
-                (component<Component>(archive), ...);
-            }
-
-            return *this;
-        }
-
-        /**
-         * @brief Puts aside the given components for the entities in a range.
-         *
-         * Each instance is serialized together with the entity to which it belongs.
-         * Entities are serialized along with their versions.
-         *
-         * @tparam Component Types of components to serialize.
-         * @tparam Archive Type of output archive.
-         * @tparam It Type of input iterator.
-         * @param archive A valid reference to an output archive.
-         * @param first An iterator to the first element of the range to serialize.
-         * @param last An iterator past the last element of the range to serialize.
-         * @return An object of this type to continue creating the snapshot.
-         */
-        template<typename... Component, typename Archive, typename It>
-        const basic_snapshot& component(Archive& archive, It first, It last) const {
-            component<Component...>(archive, first, last, std::make_index_sequence<sizeof...(Component)>{});
-            return *this;
-        }
-
-    private:
-        const basic_registry<Entity>* reg;
-        const Entity seed;
-        follow_fn_type* follow;
-    };
+    private:
+        std::istream* stream;
+        std::size_t offset{};
+    };
 
 
     /**
-     * @brief Utility class to restore a snapshot as a whole.
+     * @brief Input archive that reads values from a contiguous block of memory.
      *
-     * A snapshot loader requires that the destination registry be empty and loads
-     * all the data at once while keeping intact the identifiers that the entities
-     * originally had.<br/>
-     * An example of use is the implementation of a save/restore utility.
+     * Meant to be used on top of a memory mapped file written by a binary output
+     * archive. Pools of trivially copyable components are not copied into
+     * temporary buffers. Instead, loaders construct the components directly from
+     * the mapped memory, that is paged in by the operating system on demand.
      *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * Archives constructed from a shared block of memory also hand out arrays
+     * that keep the block alive. Paged storage classes adopt them as pages that
+     * are copied only when first modified, so that loading a pool doesn't copy
+     * its components at all. Sparse sets are still built while loading.
+     *
+     * Reads never go past the end of the memory. A read that would do so fails
+     * the archive, that returns zeroed values and no views from then on. Check
+     * the archive after loading to detect truncated or corrupted data.
+     *
+     * @sa binary_output_archive
      */
-    template<typename Entity>
-    class basic_snapshot_loader {
-        /*! @brief A registry is allowed to create snapshot loaders. */
-        friend class basic_registry<Entity>;
-
-        using force_fn_type = void(basic_registry<Entity>&, const Entity, const bool);
-        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+    class memory_input_archive {
+    public:
+        /**
+         * @brief Constructs an archive that reads from the given memory.
+         * @param data A pointer to the first byte of the memory to read.
+         * @param size Size of the memory in bytes.
+         */
+        memory_input_archive(const void* data, const std::size_t size) ENTT_NOEXCEPT
+            : base{ static_cast<const char*>(data) },
+            first{ base },
+            last{ base + size }
+        {}
 
-        basic_snapshot_loader(basic_registry<Entity>* source, force_fn_type* fn) ENTT_NOEXCEPT
-            : reg{ source },
-            force{ fn }
+        /**
+         * @brief Constructs an archive that reads from the given shared memory.
+         *
+         * The memory must not be modified as long as arrays obtained through
+         * `share` or the pools that adopted them are around.
+         *
+         * @param data A pointer to the first byte of the memory to read.
+         * @param size Size of the memory in bytes.
+         */
+        memory_input_archive(std::shared_ptr<const void> data, const std::size_t size) ENTT_NOEXCEPT
+            : memory_input_archive{ data.get(), size }
         {
-            // to restore a snapshot as a whole requires a clean registry
-            ENTT_ASSERT(reg->empty());
+            owner = std::move(data);
         }
 
-        template<typename Archive>
-        void assure(Archive& archive, bool discard) const {
-            typename traits_type::entity_type length{};
-            archive(length);
-
-            while (length--) {
-                Entity entt{};
-                archive(entt);
-                force(*reg, entt, discard);
-            }
+        /**
+         * @brief Reads the given values in order.
+         * @tparam Type Types of values to read.
+         * @param value Values to fill.
+         */
+        template<typename... Type>
+        void operator()(Type& ... value) {
+            (block(&value, 1u), ...);
         }
 
-        template<typename Type, typename Archive, typename... Args>
-        void assign(Archive& archive, Args... args) const {
-            typename traits_type::entity_type length{};
-            archive(length);
-
-            while (length--) {
-                static constexpr auto discard = false;
-                Entity entt{};
+        /**
+         * @brief Reads a contiguous array of values at once.
+         * @tparam Type Type of values to read.
+         * @param data A pointer to the first element of the array to fill.
+         * @param count Number of elements to read.
+         */
+        template<typename Type>
+        void block(Type* data, const std::size_t count) {
+            static_assert(std::is_trivially_copyable_v<Type>);
+            const auto length = sizeof(Type) * count;
 
-                if constexpr (std::is_empty_v<Type>) {
-                    archive(entt);
-                    force(*reg, entt, discard);
-                    reg->template assign<Type>(args..., entt);
-                }
-                else {
-                    Type instance{};
-                    archive(entt, instance);
-                    force(*reg, entt, discard);
-                    reg->template assign<Type>(args..., entt, std::as_const(instance));
-                }
+            if (fits<Type>(count)) {
+                std::memcpy(data, first, length);
+                first += length;
+            }
+            else if (length) {
+                std::memset(static_cast<void*>(data), 0, length);
             }
         }
 
-    public:
-        /*! @brief Default move constructor. */
-        basic_snapshot_loader(basic_snapshot_loader&&) = default;
-
-        /*! @brief Default move assignment operator. @return This loader. */
-        basic_snapshot_loader& operator=(basic_snapshot_loader&&) = default;
-
         /**
-         * @brief Restores entities that were in use during serialization.
+         * @brief Returns a pointer to a contiguous array of values in place.
          *
-         * This function restores the entities that were in use during serialization
-         * and gives them the versions they originally had.
+         * The archive is advanced only if the array is suitably aligned for the
+         * given type, otherwise a null pointer is returned and the values must be
+         * read through `block`.<br/>
+         * A null pointer is also returned if the archive doesn't contain enough
+         * bytes, in which case the archive fails.
          *
-         * @tparam Archive Type of input archive.
-         * @param archive A valid reference to an input archive.
-         * @return A valid loader to continue restoring data.
+         * @tparam Type Type of values to read.
+         * @param count Number of elements to read.
+         * @return A pointer to the first element of the array, if any.
          */
-        template<typename Archive>
-        const basic_snapshot_loader& entities(Archive& archive) const {
-            static constexpr auto discard = false;
-            assure(archive, discard);
-            return *this;
+        template<typename Type>
+        const Type* view(const std::size_t count) ENTT_NOEXCEPT {
+            static_assert(std::is_trivially_copyable_v<Type>);
+            const Type* data = nullptr;
+
+            if (reinterpret_cast<std::uintptr_t>(first) % alignof(Type) == 0 && fits<Type>(count)) {
+                data = reinterpret_cast<const Type*>(first);
+                first += sizeof(Type) * count;
+            }
+
+            return data;
         }
 
         /**
-         * @brief Restores entities that were destroyed during serialization.
+         * @brief Returns a contiguous array of values in place that shares the
+         * ownership of the memory.
          *
-         * This function restores the entities that were destroyed during
-         * serialization and gives them the versions they originally had.
+         * Same as `view`, except that a null pointer is also returned without
+         * advancing the archive if it wasn't constructed from shared memory.
          *
-         * @tparam Archive Type of input archive.
-         * @param archive A valid reference to an input archive.
-         * @return A valid loader to continue restoring data.
+         * @tparam Type Type of values to read.
+         * @param count Number of elements to read.
+         * @return A pointer to the first element of the array, if any.
          */
-        template<typename Archive>
-        const basic_snapshot_loader& destroyed(Archive& archive) const {
-            static constexpr auto discard = true;
-            assure(archive, discard);
-            return *this;
+        template<typename Type>
+        std::shared_ptr<const Type> share(const std::size_t count) {
+            const Type* data = owner ? view<Type>(count) : nullptr;
+            return data ? std::shared_ptr<const Type>{ owner, data } : nullptr;
         }
 
         /**
-         * @brief Restores components and assigns them to the right entities.
+         * @brief Skips the padding written by a binary output archive.
          *
-         * The template parameter list must be exactly the same used during
-         * serialization. In the event that the entity to which the component is
-         * assigned doesn't exist yet, the loader will take care to create it with
-         * the version it originally had.
+         * Offsets are counted from the beginning of the memory. Arrays of
+         * instances returned by `view` and `share` are therefore aligned as their
+         * pools if the memory itself is, as it happens for memory mapped files.
          *
-         * @tparam Component Types of components to restore.
-         * @tparam Archive Type of input archive.
-         * @param archive A valid reference to an input archive.
-         * @return A valid loader to continue restoring data.
+         * @param alignment Alignment in bytes, a power of two.
          */
-        template<typename... Component, typename Archive>
-        const basic_snapshot_loader& component(Archive& archive) const {
-            (assign<Component>(archive), ...);
-            return *this;
+        void align(const std::size_t alignment) ENTT_NOEXCEPT {
+            const auto pad = (alignment - std::size_t(first - base) % alignment) % alignment;
+
+            if (fits<char>(pad)) {
+                first += pad;
+            }
+        }
+
+        /*! @brief Fails the archive, as loaders do when data are malformed. */
+        void fail() ENTT_NOEXCEPT {
+            failed = true;
+            first = last;
         }
 
         /**
-         * @brief Destroys those entities that have no components.
-         *
-         * In case all the entities were serialized but only part of the components
-         * was saved, it could happen that some of the entities have no components
-         * once restored.<br/>
-         * This functions helps to identify and destroy those entities.
-         *
-         * @return A valid loader to continue restoring data.
+         * @brief Checks whether all the reads so far succeeded.
+         * @return False if a read went past the end of the memory or the data
+         * were malformed, true otherwise.
          */
-        const basic_snapshot_loader& orphans() const {
-            reg->orphans([this](const auto entt) {
-                reg->destroy(entt);
-            });
+        explicit operator bool() const ENTT_NOEXCEPT {
+            return !failed;
+        }
 
-            return *this;
+        /**
+         * @brief Returns the number of bytes not yet read.
+         * @return Number of bytes left in the archive.
+         */
+        std::size_t remaining() const ENTT_NOEXCEPT {
+            return std::size_t(last - first);
         }
 
     private:
-        basic_registry<Entity>* reg;
-        force_fn_type* force;
+        template<typename Type>
+        bool fits(const std::size_t count) ENTT_NOEXCEPT {
+            if (!failed && count > std::size_t(last - first) / sizeof(Type)) {
+                // nothing is read past a truncated or corrupted block
+                failed = true;
+                first = last;
+            }
+
+            return !failed;
+        }
+
+        std::shared_ptr<const void> owner{};
+        const char* base;
+        const char* first;
+        const char* last;
+        bool failed{};
     };
 
 
     /**
-     * @brief Utility class for _continuous loading_.
-     *
-     * A _continuous loader_ is designed to load data from a source registry to a
-     * (possibly) non-empty destination. The loader can accomodate in a registry
-     * more than one snapshot in a sort of _continuous loading_ that updates the
-     * destination one step at a time.<br/>
-     * Identifiers that entities originally had are not transferred to the target.
-     * Instead, the loader maps remote identifiers to local ones while restoring a
-     * snapshot.<br/>
-     * An example of use is the implementation of a client-server applications with
-     * the requirement of transferring somehow parts of the representation side to
-     * side.
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * @cond TURN_OFF_DOXYGEN
+     * Internal details not to be documented.
      */
-    template<typename Entity>
-    class basic_continuous_loader {
-        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
 
-        void destroy(Entity entt) {
-            const auto it = remloc.find(entt);
 
-            if (it == remloc.cend()) {
-                const auto local = reg->create();
-                remloc.emplace(entt, std::make_pair(local, true));
-                reg->destroy(local);
+    namespace internal {
+
+
+        template<typename, typename, typename = std::void_t<>>
+        struct has_block : std::false_type {};
+
+
+        template<typename Archive, typename Type>
+        struct has_block<Archive, Type, std::void_t<decltype(std::declval<Archive&>().block(std::declval<Type*>(), std::size_t{}))>> : std::true_type {};
+
+
+        template<typename Archive, typename Type>
+        constexpr auto is_block_v = !std::is_empty_v<Type> && std::is_trivially_copyable_v<Type> && has_block<Archive, Type>::value;
+
+
+        template<typename, typename, typename = std::void_t<>>
+        struct has_view : std::false_type {};
+
+
+        template<typename Archive, typename Type>
+        struct has_view<Archive, Type, std::void_t<decltype(std::declval<Archive&>().template view<Type>(std::size_t{}))>> : std::true_type {};
+
+
+        template<typename, typename, typename = std::void_t<>>
+        struct has_share : std::false_type {};
+
+
+        template<typename Archive, typename Type>
+        struct has_share<Archive, Type, std::void_t<decltype(std::declval<Archive&>().template share<Type>(std::size_t{}))>> : std::true_type {};
+
+
+        template<typename, typename = std::void_t<>>
+        struct has_align : std::false_type {};
+
+
+        template<typename Archive>
+        struct has_align<Archive, std::void_t<decltype(std::declval<Archive&>().align(std::size_t{}))>> : std::true_type {};
+
+
+        template<typename Archive>
+        void align([[maybe_unused]] Archive& archive, [[maybe_unused]] const std::size_t alignment) {
+            // archives that can't pad blocks don't expect padding either
+            if constexpr (has_align<Archive>::value) {
+                archive.align(alignment);
             }
         }
 
-        void restore(Entity entt) {
-            const auto it = remloc.find(entt);
 
-            if (it == remloc.cend()) {
-                const auto local = reg->create();
-                remloc.emplace(entt, std::make_pair(local, true));
+        template<typename, typename = std::void_t<>>
+        struct has_remaining : std::false_type {};
+
+
+        template<typename Archive>
+        struct has_remaining<Archive, std::void_t<decltype(std::declval<const Archive&>().remaining())>> : std::true_type {};
+
+
+        template<typename, typename = std::void_t<>>
+        struct has_fail : std::false_type {};
+
+
+        template<typename Archive>
+        struct has_fail<Archive, std::void_t<decltype(std::declval<Archive&>().fail())>> : std::true_type {};
+
+
+        template<typename Archive>
+        void fail([[maybe_unused]] Archive& archive) {
+            if constexpr (has_fail<Archive>::value) {
+                archive.fail();
             }
             else {
-                remloc[entt].first = reg->valid(remloc[entt].first) ? remloc[entt].first : reg->create();
-                // set the dirty flag
-                remloc[entt].second = true;
+                ENTT_ASSERT(false);
             }
         }
 
-        template<typename Other, typename Type, typename Member>
-        void update(Other& instance, Member Type::* member) {
-            if constexpr (!std::is_same_v<Other, Type>) {
-                return;
-            }
-            else if constexpr (std::is_same_v<Member, Entity>) {
-                instance.*member = map(instance.*member);
+
+        template<typename Archive>
+        bool good([[maybe_unused]] const Archive& archive) {
+            if constexpr (std::is_constructible_v<bool, const Archive&>) {
+                return static_cast<bool>(archive);
             }
             else {
-                // maybe a container? let's try...
-                for (auto& entt : instance.*member) {
-                    entt = map(entt);
-                }
+                return true;
             }
         }
 
-        template<typename Archive>
-        void assure(Archive& archive, void(basic_continuous_loader::* member)(Entity)) {
-            typename traits_type::entity_type length{};
-            archive(length);
 
-            while (length--) {
-                Entity entt{};
-                archive(entt);
-                (this->*member)(entt);
+        template<typename Type, typename Archive>
+        bool fits(Archive& archive, [[maybe_unused]] const std::size_t count, [[maybe_unused]] const std::size_t extra = 0u) {
+            // lengths come from the archive, never allocate for more than it holds
+            if constexpr (has_remaining<Archive>::value) {
+                if (count > archive.remaining() / (sizeof(Type) + extra)) {
+                    fail(archive);
+                    return false;
+                }
             }
+
+            return good(archive);
         }
 
-        template<typename Component>
-        void reset() {
-            for (auto&& ref : remloc) {
-                const auto local = ref.second.first;
 
-                if (reg->valid(local)) {
-                    reg->template reset<Component>(local);
+        template<typename Type, typename Archive>
+        const Type* block_data(Archive& archive, const std::size_t count, std::vector<Type>& buffer) {
+            if constexpr (has_view<Archive, Type>::value) {
+                // a failed archive has nothing to offer, not even through a buffer
+                if (const auto* data = archive.template view<Type>(count); data || !archive) {
+                    return data;
                 }
             }
+
+            buffer.resize(count);
+            archive.block(buffer.data(), count);
+            return buffer.data();
         }
 
-        template<typename Other, typename Archive, typename... Type, typename... Member>
-        void assign(Archive& archive, [[maybe_unused]] Member Type::* ... member) {
-            typename traits_type::entity_type length{};
-            archive(length);
 
-            while (length--) {
-                Entity entt{};
+        template<typename Type>
+        constexpr ENTT_ID_TYPE block_type() ENTT_NOEXCEPT {
+            if constexpr (is_named_type_v<Type>) {
+                return named_type_traits<Type>::value;
+            }
+            else {
+                // the signature spells out the type, it's stable as long as the compiler is the same
+#if defined(_MSC_VER)
+                return hashed_string::to_value(__FUNCSIG__);
+#else
+                return hashed_string::to_value(__PRETTY_FUNCTION__);
+#endif
+            }
+        }
 
-                if constexpr (std::is_empty_v<Other>) {
-                    archive(entt);
-                    restore(entt);
-                    reg->template assign_or_replace<Other>(map(entt));
-                }
-                else {
-                    Other instance{};
-                    archive(entt, instance);
-                    (update(instance, member), ...);
-                    restore(entt);
-                    reg->template assign_or_replace<Other>(map(entt), std::as_const(instance));
-                }
+
+        template<typename Archive, typename Type>
+        void write_block(Archive& archive, const Type* data, const std::size_t count) {
+            if constexpr (has_block<Archive, Type>::value) {
+                archive.block(data, count);
+            }
+            else {
+                std::for_each(data, data + count, [&archive](const auto& value) { archive(value); });
             }
         }
 
-    public:
-        /*! @brief Underlying entity identifier. */
-        using entity_type = Entity;
 
-        /**
-         * @brief Constructs a loader that is bound to a given registry.
-         * @param source A valid reference to a registry.
-         */
-        basic_continuous_loader(basic_registry<entity_type>& source) ENTT_NOEXCEPT
-            : reg{ &source }
-        {}
+        template<typename Archive, typename Type>
+        void read_block(Archive& archive, Type* data, const std::size_t count) {
+            if constexpr (has_block<Archive, Type>::value) {
+                archive.block(data, count);
+            }
+            else {
+                std::for_each(data, data + count, [&archive](auto& value) { archive(value); });
+            }
+        }
 
-        /*! @brief Default move constructor. */
-        basic_continuous_loader(basic_continuous_loader&&) = default;
 
-        /*! @brief Default move assignment operator. @return This loader. */
-        basic_continuous_loader& operator=(basic_continuous_loader&&) = default;
+        inline void write_varint(std::vector<std::uint8_t>& out, std::size_t value) {
+            for (; value >= 0x80; value >>= 7) {
+                out.push_back(std::uint8_t(value | 0x80));
+            }
 
-        /**
-         * @brief Restores entities that were in use during serialization.
-         *
-         * This function restores the entities that were in use during serialization
-         * and creates local counterparts for them if required.
-         *
-         * @tparam Archive Type of input archive.
-         * @param archive A valid reference to an input archive.
-         * @return A non-const reference to this loader.
-         */
-        template<typename Archive>
-        basic_continuous_loader& entities(Archive& archive) {
-            assure(archive, &basic_continuous_loader::restore);
-            return *this;
+            out.push_back(std::uint8_t(value));
         }
 
-        /**
-         * @brief Restores entities that were destroyed during serialization.
-         *
-         * This function restores the entities that were destroyed during
-         * serialization and creates local counterparts for them if required.
-         *
-         * @tparam Archive Type of input archive.
-         * @param archive A valid reference to an input archive.
-         * @return A non-const reference to this loader.
-         */
-        template<typename Archive>
-        basic_continuous_loader& destroyed(Archive& archive) {
-            assure(archive, &basic_continuous_loader::destroy);
-            return *this;
-        }
 
-        /**
-         * @brief Restores components and assigns them to the right entities.
-         *
-         * The template parameter list must be exactly the same used during
-         * serialization. In the event that the entity to which the component is
-         * assigned doesn't exist yet, the loader will take care to create a local
-         * counterpart for it.<br/>
-         * Members can be either data members of type entity_type or containers of
-         * entities. In both cases, the loader will visit them and update the
-         * entities by replacing each one with its local counterpart.
-         *
-         * @tparam Component Type of component to restore.
-         * @tparam Archive Type of input archive.
-         * @tparam Type Types of components to update with local counterparts.
-         * @tparam Member Types of members to update with their local counterparts.
-         * @param archive A valid reference to an input archive.
-         * @param member Members to update with their local counterparts.
-         * @return A non-const reference to this loader.
-         */
-        template<typename... Component, typename Archive, typename... Type, typename... Member>
-        basic_continuous_loader& component(Archive& archive, Member Type::* ... member) {
-            (reset<Component>(), ...);
-            (assign<Component>(archive, member...), ...);
-            return *this;
+        inline bool read_varint(const std::uint8_t*& in, const std::uint8_t* last, std::size_t& value) ENTT_NOEXCEPT {
+            value = {};
+
+            for (std::size_t shift{}; in != last && shift < std::numeric_limits<std::size_t>::digits; shift += 7) {
+                const auto byte = *(in++);
+                value |= std::size_t(byte & 0x7F) << shift;
+
+                if (!(byte & 0x80)) {
+                    return true;
+                }
+            }
+
+            return false;
         }
 
-        /**
-         * @brief Helps to purge entities that no longer have a conterpart.
-         *
-         * Users should invoke this member function after restoring each snapshot,
-         * unless they know exactly what they are doing.
-         *
-         * @return A non-const reference to this loader.
-         */
-        basic_continuous_loader& shrink() {
-            auto it = remloc.begin();
 
-            while (it != remloc.cend()) {
-                const auto local = it->second.first;
-                bool& dirty = it->second.second;
+        // runs of unchanged bytes are skipped, runs of changed ones are stored XORed
+        inline void encode_delta(const std::uint8_t* prev, const std::uint8_t* curr, const std::size_t size, std::vector<std::uint8_t>& out) {
+            for (std::size_t pos{}; pos < size;) {
+                const auto first = pos;
 
-                if (dirty) {
-                    dirty = false;
-                    ++it;
+                while (pos < size && prev[pos] == curr[pos]) {
+                    ++pos;
                 }
-                else {
-                    if (reg->valid(local)) {
-                        reg->destroy(local);
-                    }
 
-                    it = remloc.erase(it);
+                const auto skip = pos - first;
+
+                while (pos < size && prev[pos] != curr[pos]) {
+                    ++pos;
                 }
-            }
 
-            return *this;
+                write_varint(out, skip);
+                write_varint(out, pos - first - skip);
+
+                for (auto next = first + skip; next < pos; ++next) {
+                    out.push_back(std::uint8_t(prev[next] ^ curr[next]));
+                }
+            }
         }
 
-        /**
-         * @brief Destroys those entities that have no components.
-         *
-         * In case all the entities were serialized but only part of the components
-         * was saved, it could happen that some of the entities have no components
-         * once restored.<br/>
-         * This functions helps to identify and destroy those entities.
-         *
-         * @return A non-const reference to this loader.
-         */
-        basic_continuous_loader& orphans() {
-            reg->orphans([this](const auto entt) {
-                reg->destroy(entt);
-            });
 
-            return *this;
-        }
+        // the whole delta is validated first, so that a malformed one leaves the data untouched
+        inline bool decode_delta(const std::uint8_t*& in, const std::uint8_t* last, std::uint8_t* data, const std::size_t size) ENTT_NOEXCEPT {
+            const auto* next = in;
 
-        /**
-         * @brief Tests if a loader knows about a given entity.
-         * @param entt An entity identifier.
-         * @return True if `entity` is managed by the loader, false otherwise.
-         */
-        bool has(entity_type entt) const ENTT_NOEXCEPT {
-            return (remloc.find(entt) != remloc.cend());
-        }
+            for (std::size_t pos{}, skip{}, length{}; pos < size; pos += skip + length, next += length) {
+                if (!read_varint(next, last, skip) || !read_varint(next, last, length)
+                    || !(skip + length) || skip > size - pos || length > size - pos - skip || length > std::size_t(last - next))
+                {
+                    return false;
+                }
+            }
 
-        /**
-         * @brief Returns the identifier to which an entity refers.
-         * @param entt An entity identifier.
-         * @return The local identifier if any, the null entity otherwise.
-         */
-        entity_type map(entity_type entt) const ENTT_NOEXCEPT {
-            const auto it = remloc.find(entt);
-            entity_type other = null;
+            for (std::size_t pos{}, skip{}, length{}; pos < size;) {
+                read_varint(in, last, skip);
+                read_varint(in, last, length);
 
-            if (it != remloc.cend()) {
-                other = it->second.first;
+                for (pos += skip; length; --length) {
+                    data[pos++] ^= *(in++);
+                }
             }
 
-            return other;
+            return true;
         }
 
-    private:
-        std::unordered_map<entity_type, std::pair<entity_type, bool>> remloc;
-        basic_registry<entity_type>* reg;
-    };
-
 
-}
+        template<typename Entity>
+        struct delta_baseline {
+            using traits_type = entt_traits<std::underlying_type_t<Entity>>;
 
+            bool contains(const Entity entt) const ENTT_NOEXCEPT {
+                const auto pos = std::size_t(to_integer(entt) & traits_type::entity_mask);
+                return pos < owner.size() && owner[pos] == entt;
+            }
 
-#endif // ENTT_ENTITY_SNAPSHOT_HPP
+            // returns the bytes of the given entity, zeroed if it wasn't there yet
+            std::uint8_t* assure(const Entity entt) {
+                const auto pos = std::size_t(to_integer(entt) & traits_type::entity_mask);
 
-// #include "storage.hpp"
-#ifndef ENTT_ENTITY_STORAGE_HPP
-#define ENTT_ENTITY_STORAGE_HPP
+                if (!(pos < owner.size())) {
+                    owner.resize(pos + 1u, null{});
+                    bytes.resize(owner.size() * stride);
+                }
 
+                auto* data = bytes.data() + pos * stride;
 
-#include <algorithm>
-#include <iterator>
-#include <numeric>
-#include <utility>
-#include <vector>
-#include <cstddef>
-#include <type_traits>
-// #include "../config/config.h"
+                if (owner[pos] != entt) {
+                    owner[pos] = entt;
+                    std::fill(data, data + stride, std::uint8_t{});
+                }
 
-// #include "../core/algorithm.hpp"
+                return data;
+            }
 
-// #include "sparse_set.hpp"
+            void erase(const Entity entt) ENTT_NOEXCEPT {
+                if (contains(entt)) {
+                    owner[std::size_t(to_integer(entt) & traits_type::entity_mask)] = null{};
+                }
+            }
 
-// #include "entity.hpp"
+            std::uint64_t version{};
+            std::size_t stride{};
+            std::vector<Entity> owner{};
+            std::vector<std::uint8_t> bytes{};
+        };
 
 
+        template<typename Entity>
+        class remote_map {
+            using traits_type = entt_traits<std::underlying_type_t<Entity>>;
 
-namespace entt {
+        public:
+            struct entry {
+                Entity remote{ null{} };
+                Entity local{ null{} };
+                bool dirty{};
+            };
 
+        private:
+            static constexpr auto per_page = ENTT_PAGE_SIZE / sizeof(entry);
 
-    /**
-     * @brief Basic storage implementation.
-     *
-     * This class is a refinement of a sparse set that associates an object to an
-     * entity. The main purpose of this class is to extend sparse sets to store
-     * components in a registry. It guarantees fast access both to the elements and
-     * to the entities.
-     *
-     * @note
-     * Entities and objects have the same order. It's guaranteed both in case of raw
-     * access (either to entities or objects) and when using random or input access
-     * iterators.
-     *
-     * @note
-     * Internal data structures arrange elements to maximize performance. Because of
-     * that, there are no guarantees that elements have the expected order when
-     * iterate directly the internal packed array (see `raw` and `size` member
-     * functions for that). Use `begin` and `end` instead.
-     *
-     * @warning
-     * Empty types aren't explicitly instantiated. Temporary objects are returned in
-     * place of the instances of the components and raw access isn't available for
-     * them.
-     *
-     * @sa sparse_set<Entity>
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
-     * @tparam Type Type of objects assigned to the entities.
-     */
-    template<typename Entity, typename Type, typename = std::void_t<>>
-    class basic_storage : public sparse_set<Entity> {
-        using underlying_type = sparse_set<Entity>;
-        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+        public:
+            entry* find(const Entity remote) const ENTT_NOEXCEPT {
+                const auto pos = std::size_t(to_integer(remote) & traits_type::entity_mask);
+                const auto page = pos / per_page;
+                entry* elem = nullptr;
+
+                if (page < pages.size() && pages[page]) {
+                    auto& candidate = pages[page][pos % per_page];
+                    elem = (candidate.remote == remote) ? &candidate : nullptr;
+                }
 
-        template<bool Const>
-        class iterator {
-            friend class basic_storage<Entity, Type>;
+                return elem;
+            }
 
-            using instance_type = std::conditional_t<Const, const std::vector<Type>, std::vector<Type>>;
-            using index_type = typename traits_type::difference_type;
+            // an entry left behind by an older version of the same remote is handed back as is
+            entry& assure(const Entity remote) {
+                const auto pos = std::size_t(to_integer(remote) & traits_type::entity_mask);
+                const auto page = pos / per_page;
 
-            iterator(instance_type* ref, const index_type idx) ENTT_NOEXCEPT
-                : instances{ ref }, index{ idx }
-            {}
+                if (!(page < pages.size())) {
+                    pages.resize(page + 1);
+                }
 
-        public:
-            using difference_type = index_type;
-            using value_type = Type;
-            using pointer = std::conditional_t<Const, const value_type*, value_type*>;
-            using reference = std::conditional_t<Const, const value_type&, value_type&>;
-            using iterator_category = std::random_access_iterator_tag;
+                if (!pages[page]) {
+                    pages[page] = std::make_unique<entry[]>(per_page);
+                }
 
-            iterator() ENTT_NOEXCEPT = default;
+                auto& elem = pages[page][pos % per_page];
+                count += (elem.remote == null{});
+                return elem;
+            }
 
-            iterator& operator++() ENTT_NOEXCEPT {
-                return --index, * this;
+            void erase(entry& elem) ENTT_NOEXCEPT {
+                elem = {};
+                --count;
             }
 
-            iterator operator++(int) ENTT_NOEXCEPT {
-                iterator orig = *this;
-                return ++(*this), orig;
+            template<typename Func>
+            void each(Func func) {
+                for (auto&& page : pages) {
+                    if (page) {
+                        for (auto pos = per_page; pos; --pos) {
+                            if (auto& elem = page[pos - 1]; elem.remote != null{}) {
+                                func(elem);
+                            }
+                        }
+                    }
+                }
             }
 
-            iterator& operator--() ENTT_NOEXCEPT {
-                return ++index, * this;
+            std::size_t size() const ENTT_NOEXCEPT {
+                return count;
             }
 
-            iterator operator--(int) ENTT_NOEXCEPT {
-                iterator orig = *this;
-                return --(*this), orig;
-            }
+        private:
+            std::vector<std::unique_ptr<entry[]>> pages{};
+            std::size_t count{};
+        };
 
-            iterator& operator+=(const difference_type value) ENTT_NOEXCEPT {
-                index -= value;
-                return *this;
-            }
 
-            iterator operator+(const difference_type value) const ENTT_NOEXCEPT {
-                return iterator{ instances, index - value };
-            }
+    }
 
-            iterator& operator-=(const difference_type value) ENTT_NOEXCEPT {
-                return (*this += -value);
-            }
 
-            iterator operator-(const difference_type value) const ENTT_NOEXCEPT {
-                return (*this + -value);
-            }
+    /**
+     * Internal details not to be documented.
+     * @endcond TURN_OFF_DOXYGEN
+     */
 
-            difference_type operator-(const iterator& other) const ENTT_NOEXCEPT {
-                return other.index - index;
-            }
 
-            reference operator[](const difference_type value) const ENTT_NOEXCEPT {
-                const auto pos = size_type(index - value - 1);
-                return (*instances)[pos];
-            }
+    /**
+     * @brief Utility class to create snapshots from a registry.
+     *
+     * A _snapshot_ can be either a dump of the entire registry or a narrower
+     * selection of components of interest.<br/>
+     * This type can be used in both cases if provided with a correctly configured
+     * output archive.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     */
+    template<typename Entity>
+    class basic_snapshot {
+        /*! @brief A registry is allowed to create snapshots. */
+        friend class basic_registry<Entity>;
 
-            bool operator==(const iterator& other) const ENTT_NOEXCEPT {
-                return other.index == index;
-            }
+        using follow_fn_type = Entity(const basic_registry<Entity>&, const Entity);
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
 
-            bool operator!=(const iterator& other) const ENTT_NOEXCEPT {
-                return !(*this == other);
-            }
+        basic_snapshot(const basic_registry<Entity>* source, Entity init, follow_fn_type* fn) ENTT_NOEXCEPT
+            : reg{ source },
+            seed{ init },
+            follow{ fn }
+        {}
 
-            bool operator<(const iterator& other) const ENTT_NOEXCEPT {
-                return index > other.index;
-            }
+        template<typename Component, typename Archive>
+        void block(Archive& archive, std::size_t sz, const Entity* entities, const Component* instances) const {
+            archive(typename traits_type::entity_type(sz), internal::block_type<Component>(), std::uint32_t(sizeof(Component)));
+            archive.block(entities, sz);
+            internal::align(archive, internal::instance_alignment_v<Component>);
+            archive.block(instances, sz);
+        }
 
-            bool operator>(const iterator& other) const ENTT_NOEXCEPT {
-                return index < other.index;
-            }
+        template<typename Component, typename Archive, typename It>
+        void get(Archive& archive, std::size_t sz, It first, It last) const {
+            if constexpr (internal::is_block_v<Archive, Component>) {
+                std::vector<Entity> entities;
+                std::vector<Component> instances;
+                entities.reserve(sz);
+                instances.reserve(sz);
+
+                while (first != last) {
+                    const auto entt = *(first++);
+
+                    if (reg->template has<Component>(entt)) {
+                        entities.push_back(entt);
+                        instances.push_back(reg->template get<Component>(entt));
+                    }
+                }
 
-            bool operator<=(const iterator& other) const ENTT_NOEXCEPT {
-                return !(*this > other);
+                block(archive, sz, entities.data(), instances.data());
+                return;
             }
 
-            bool operator>=(const iterator& other) const ENTT_NOEXCEPT {
-                return !(*this < other);
-            }
+            archive(typename traits_type::entity_type(sz));
 
-            pointer operator->() const ENTT_NOEXCEPT {
-                const auto pos = size_type(index - 1);
-                return &(*instances)[pos];
+            while (first != last) {
+                const auto entt = *(first++);
+
+                if (reg->template has<Component>(entt)) {
+                    if constexpr (std::is_empty_v<Component>) {
+                        archive(entt);
+                    }
+                    else {
+                        archive(entt, reg->template get<Component>(entt));
+                    }
+                }
             }
+        }
 
-            reference operator*() const ENTT_NOEXCEPT {
-                return *operator->();
+        template<typename... Component, typename Archive, typename It, std::size_t... Indexes>
+        void component(Archive& archive, It first, It last, std::index_sequence<Indexes...>) const {
+            std::array<std::size_t, sizeof...(Indexes)> size{};
+            auto begin = first;
+
+            while (begin != last) {
+                const auto entt = *(begin++);
+                ((reg->template has<Component>(entt) ? ++size[Indexes] : size[Indexes]), ...);
             }
 
-        private:
-            instance_type* instances;
-            index_type index;
-        };
+            (get<Component>(archive, size[Indexes], first, last), ...);
+        }
 
     public:
-        /*! @brief Type of the objects associated with the entities. */
-        using object_type = Type;
-        /*! @brief Underlying entity identifier. */
-        using entity_type = Entity;
-        /*! @brief Unsigned integer type. */
-        using size_type = std::size_t;
-        /*! @brief Random access iterator type. */
-        using iterator_type = iterator<false>;
-        /*! @brief Constant random access iterator type. */
-        using const_iterator_type = iterator<true>;
+        /*! @brief Default move constructor. */
+        basic_snapshot(basic_snapshot&&) = default;
+
+        /*! @brief Default move assignment operator. @return This snapshot. */
+        basic_snapshot& operator=(basic_snapshot&&) = default;
 
         /**
-         * @brief Increases the capacity of a storage.
+         * @brief Puts aside all the entities that are still in use.
          *
-         * If the new capacity is greater than the current capacity, new storage is
-         * allocated, otherwise the method does nothing.
+         * Entities are serialized along with their versions. Destroyed entities are
+         * not taken in consideration by this function.
          *
-         * @param cap Desired capacity.
+         * @tparam Archive Type of output archive.
+         * @param archive A valid reference to an output archive.
+         * @return An object of this type to continue creating the snapshot.
          */
-        void reserve(const size_type cap) {
-            underlying_type::reserve(cap);
-            instances.reserve(cap);
-        }
-
-        /*! @brief Requests the removal of unused capacity. */
-        void shrink_to_fit() {
-            underlying_type::shrink_to_fit();
-            instances.shrink_to_fit();
+        template<typename Archive>
+        const basic_snapshot& entities(Archive& archive) const {
+            archive(typename traits_type::entity_type(reg->alive()));
+            reg->each([&archive](const auto entt) { archive(entt); });
+            return *this;
         }
 
         /**
-         * @brief Direct access to the array of objects.
-         *
-         * The returned pointer is such that range `[raw(), raw() + size()]` is
-         * always a valid range, even if the container is empty.
+         * @brief Puts aside destroyed entities.
          *
-         * @note
-         * There are no guarantees on the order, even though either `sort` or
-         * `respect` has been previously invoked. Internal data structures arrange
-         * elements to maximize performance. Accessing them directly gives a
-         * performance boost but less guarantees. Use `begin` and `end` if you want
-         * to iterate the storage in the expected order.
+         * Entities are serialized along with their versions. Entities that are
+         * still in use are not taken in consideration by this function.
          *
-         * @return A pointer to the array of objects.
+         * @tparam Archive Type of output archive.
+         * @param archive A valid reference to an output archive.
+         * @return An object of this type to continue creating the snapshot.
          */
-        const object_type* raw() const ENTT_NOEXCEPT {
-            return instances.data();
-        }
+        template<typename Archive>
+        const basic_snapshot& destroyed(Archive& archive) const {
+            auto size = reg->size() - reg->alive();
+            archive(typename traits_type::entity_type(size));
 
-        /*! @copydoc raw */
-        object_type* raw() ENTT_NOEXCEPT {
-            return const_cast<object_type*>(std::as_const(*this).raw());
+            if (size) {
+                auto curr = seed;
+                archive(curr);
+
+                for (--size; size; --size) {
+                    curr = follow(*reg, curr);
+                    archive(curr);
+                }
+            }
+
+            return *this;
         }
 
         /**
-         * @brief Returns an iterator to the beginning.
-         *
-         * The returned iterator points to the first instance of the given type. If
-         * the storage is empty, the returned iterator will be equal to `end()`.
+         * @brief Puts aside the given components.
          *
-         * @note
-         * Random access iterators stay true to the order imposed by a call to
-         * either `sort` or `respect`.
+         * Each instance is serialized together with the entity to which it belongs.
+         * Entities are serialized along with their versions.<br/>
+         * If the archive offers a `block` member function and a component is
+         * trivially copyable, the whole pool is written as a header followed by
+         * the array of entities and the array of instances.<br/>
+         * The header identifies the type through its named type identifier if
+         * any, otherwise through a hash of its name as spelled by the compiler.
+         * The latter is only stable across builds made with the same compiler.
          *
-         * @return An iterator to the first instance of the given type.
+         * @tparam Component Types of components to serialize.
+         * @tparam Archive Type of output archive.
+         * @param archive A valid reference to an output archive.
+         * @return An object of this type to continue creating the snapshot.
          */
-        const_iterator_type cbegin() const ENTT_NOEXCEPT {
-            const typename traits_type::difference_type pos = underlying_type::size();
-            return const_iterator_type{ &instances, pos };
-        }
+        template<typename... Component, typename Archive>
+        const basic_snapshot& component(Archive& archive) const {
+            if constexpr (sizeof...(Component) == 1) {
+                const auto sz = reg->template size<Component...>();
+                const auto* entities = reg->template data<Component...>();
 
-        /*! @copydoc cbegin */
-        const_iterator_type begin() const ENTT_NOEXCEPT {
-            return cbegin();
-        }
+                if constexpr (internal::is_block_v<Archive, Component...>) {
+                    if constexpr ((internal::instance_page_v<Component> + ...)) {
+                        // paged pools have no single array to write, gather them first
+                        get<Component...>(archive, sz, entities, entities + sz);
+                    }
+                    else {
+                        block(archive, sz, entities, reg->template raw<Component...>());
+                    }
+                }
+                else {
+                    archive(typename traits_type::entity_type(sz));
 
-        /*! @copydoc begin */
-        iterator_type begin() ENTT_NOEXCEPT {
-            const typename traits_type::difference_type pos = underlying_type::size();
-            return iterator_type{ &instances, pos };
+                    for (std::remove_const_t<decltype(sz)> pos{}; pos < sz; ++pos) {
+                        const auto entt = entities[pos];
+
+                        if constexpr (std::is_empty_v<Component...>) {
+                            archive(entt);
+                        }
+                        else {
+                            archive(entt, reg->template get<Component...>(entt));
+                        }
+                    };
+                }
+            }
+            else {
+                (component<Component>(archive), ...);
+            }
+
+            return *this;
         }
 
         /**
-         * @brief Returns an iterator to the end.
-         *
-         * The returned iterator points to the element following the last instance
-         * of the given type. Attempting to dereference the returned iterator
-         * results in undefined behavior.
+         * @brief Puts aside the given components for the entities in a range.
          *
-         * @note
-         * Random access iterators stay true to the order imposed by a call to
-         * either `sort` or `respect`.
+         * Each instance is serialized together with the entity to which it belongs.
+         * Entities are serialized along with their versions.
          *
-         * @return An iterator to the element following the last instance of the
-         * given type.
+         * @tparam Component Types of components to serialize.
+         * @tparam Archive Type of output archive.
+         * @tparam It Type of input iterator.
+         * @param archive A valid reference to an output archive.
+         * @param first An iterator to the first element of the range to serialize.
+         * @param last An iterator past the last element of the range to serialize.
+         * @return An object of this type to continue creating the snapshot.
          */
-        const_iterator_type cend() const ENTT_NOEXCEPT {
-            return const_iterator_type{ &instances, {} };
+        template<typename... Component, typename Archive, typename It>
+        const basic_snapshot& component(Archive& archive, It first, It last) const {
+            component<Component...>(archive, first, last, std::make_index_sequence<sizeof...(Component)>{});
+            return *this;
         }
 
-        /*! @copydoc cend */
-        const_iterator_type end() const ENTT_NOEXCEPT {
-            return cend();
-        }
+    private:
+        const basic_registry<Entity>* reg;
+        const Entity seed;
+        follow_fn_type* follow;
+    };
 
-        /*! @copydoc end */
-        iterator_type end() ENTT_NOEXCEPT {
-            return iterator_type{ &instances, {} };
-        }
 
-        /**
-         * @brief Returns the object associated with an entity.
-         *
-         * @warning
-         * Attempting to use an entity that doesn't belong to the storage results in
-         * undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * storage doesn't contain the given entity.
-         *
-         * @param entt A valid entity identifier.
-         * @return The object associated with the entity.
-         */
-        const object_type& get(const entity_type entt) const ENTT_NOEXCEPT {
-            return instances[underlying_type::index(entt)];
-        }
+    /**
+     * @brief Utility class to create delta snapshots from a registry.
+     *
+     * A _delta snapshot_ contains only what changed since a baseline: entities
+     * created and destroyed, components removed and components assigned or
+     * modified. Each delta is identified by a token that is the baseline of the
+     * following one. A delta against any baseline other than the token of the
+     * previous delta taken with the same object, zero included, is a full
+     * snapshot that replaces whatever the other side had.<br/>
+     * Changed components are encoded as runs of bytes XORed with the previous
+     * state, so that unchanged parts of a component take almost no space.
+     *
+     * Modifications are found through the write stamps of the pools, that is
+     * those made in place through `get`, views, groups and queries are captured
+     * as well as those made through `replace`. Pages of paged pools that weren't
+     * accessed for writing since the baseline are skipped without being visited,
+     * as well as whole pools for the other storage classes.
+     *
+     * The snapshot keeps a shadow copy of every pool it serializes, indexed by
+     * entity, to compute the deltas. This costs as much memory as the pools
+     * themselves and a page accessed for writing is compared against its copy
+     * as a whole, that is one `memcmp` per component regardless of how many of
+     * them were actually modified. The same goes for the copy kept by the
+     * continuous loader on the other side.
+     *
+     * @warning
+     * A write through a reference obtained before a delta was taken isn't
+     * stamped. Use `touch` for modifications made that way.
+     *
+     * @note
+     * Deltas must be applied in order with the `delta_entities` and
+     * `delta_component` member functions of a continuous loader.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     */
+    template<typename Entity>
+    class basic_delta_snapshot {
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+        using baseline_type = internal::delta_baseline<Entity>;
 
-        /*! @copydoc get */
-        object_type& get(const entity_type entt) ENTT_NOEXCEPT {
-            return const_cast<object_type&>(std::as_const(*this).get(entt));
+        template<typename Archive>
+        void put(Archive& archive, const std::vector<Entity>& list) const {
+            archive(typename traits_type::entity_type(list.size()));
+            internal::write_block(archive, list.data(), list.size());
         }
 
-        /**
-         * @brief Returns a pointer to the object associated with an entity, if any.
-         * @param entt A valid entity identifier.
-         * @return The object associated with the entity, if any.
-         */
-        const object_type* try_get(const entity_type entt) const ENTT_NOEXCEPT {
-            return underlying_type::has(entt) ? (instances.data() + underlying_type::index(entt)) : nullptr;
-        }
+        template<typename Component, typename Archive>
+        void delta(Archive& archive) {
+            static_assert(std::is_trivially_copyable_v<Component>);
 
-        /*! @copydoc try_get */
-        object_type* try_get(const entity_type entt) ENTT_NOEXCEPT {
-            return const_cast<object_type*>(std::as_const(*this).try_get(entt));
-        }
+            auto& base = pools[to_integer(reg->template type<Component>())];
+            const auto version = reg->template version<Component>();
+            const bool moved = base.version != version;
 
-        /**
-         * @brief Assigns an entity to a storage and constructs its object.
-         *
-         * This version accept both types that can be constructed in place directly
-         * and types like aggregates that do not work well with a placement new as
-         * performed usually under the hood during an _emplace back_.
-         *
-         * @warning
-         * Attempting to use an entity that already belongs to the storage results
-         * in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * storage already contains the given entity.
-         *
-         * @tparam Args Types of arguments to use to construct the object.
-         * @param entt A valid entity identifier.
-         * @param args Parameters to use to construct an object for the entity.
-         * @return The object associated with the entity.
-         */
-        template<typename... Args>
-        object_type& construct(const entity_type entt, Args&& ... args) {
-            if constexpr (std::is_aggregate_v<object_type>) {
-                instances.emplace_back(Type{ std::forward<Args>(args)... });
+            removed.clear();
+            changed.clear();
+            buffer.clear();
+
+            base.version = version;
+            base.stride = std::is_empty_v<Component> ? 0u : sizeof(Component);
+
+            if (moved) {
+                for (auto& entt : base.owner) {
+                    if (entt != null && !(reg->valid(entt) && reg->template has<Component>(entt))) {
+                        removed.push_back(entt);
+                        entt = null;
+                    }
+                }
             }
-            else {
-                instances.emplace_back(std::forward<Args>(args)...);
+
+            if (moved || !std::is_empty_v<Component>) {
+                constexpr auto page = internal::instance_page_v<Component>;
+                const auto sz = reg->template size<Component>();
+                const auto* entities = reg->template data<Component>();
+
+                for (std::remove_const_t<decltype(sz)> pos{}, last{}; pos < sz; pos = last) {
+                    last = page ? std::min(sz, pos + page) : sz;
+
+                    if constexpr (!std::is_empty_v<Component>) {
+                        // assignments and removals write to the pages they touch, only whole arrays need the version
+                        if (!(moved && !page) && reg->template written<Component>(pos) < since) {
+                            continue;
+                        }
+                    }
+
+                    for (; pos < last; ++pos) {
+                        const auto entt = entities[pos];
+                        const bool added = !base.contains(entt);
+                        auto* prev = base.assure(entt);
+
+                        if constexpr (std::is_empty_v<Component>) {
+                            if (added) {
+                                changed.push_back(entt);
+                            }
+                        }
+                        else {
+                            const Component* instance = nullptr;
+
+                            if constexpr (internal::instance_page_v<Component>) {
+                                instance = &reg->template get<Component>(entt);
+                            }
+                            else {
+                                instance = reg->template raw<Component>() + pos;
+                            }
+
+                            const auto* curr = reinterpret_cast<const std::uint8_t*>(instance);
+
+                            if (added || std::memcmp(prev, curr, sizeof(Component))) {
+                                internal::encode_delta(prev, curr, sizeof(Component), buffer);
+                                std::memcpy(prev, curr, sizeof(Component));
+                                changed.push_back(entt);
+                            }
+                        }
+                    }
+                }
             }
 
-            // entity goes after component in case constructor throws
-            underlying_type::construct(entt);
-            return instances.back();
+            put(archive, removed);
+            put(archive, changed);
+            archive(std::uint32_t(buffer.size()));
+            internal::write_block(archive, buffer.data(), buffer.size());
         }
 
-        /**
-         * @brief Assigns one or more entities to a storage and default constructs
-         * their objects.
-         *
-         * The object type must be at least move and default insertable.
-         *
-         * @warning
-         * Attempting to assign an entity that already belongs to the storage
-         * results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * storage already contains the given entity.
-         *
-         * @tparam It Type of forward iterator.
-         * @param first An iterator to the first element of the range of entities.
-         * @param last An iterator past the last element of the range of entities.
-         * @return An iterator to the list of instances just created and sorted the
-         * same of the entities.
-         */
-        template<typename It>
-        iterator_type batch(It first, It last) {
-            instances.resize(instances.size() + std::distance(first, last));
-            // entity goes after component in case constructor throws
-            underlying_type::batch(first, last);
-            return begin();
-        }
+    public:
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
 
         /**
-         * @brief Assigns one or more entities to a storage and copy constructs
-         * their objects.
-         *
-         * The object type must be at least move and copy insertable.
-         *
-         * @sa batch
-         *
-         * @tparam It Type of forward iterator.
-         * @param first An iterator to the first element of the range of entities.
-         * @param last An iterator past the last element of the range of entities.
-         * @param value The value to initialize the new objects with.
-         * @return An iterator to the list of instances just created and sorted the
-         * same of the entities.
+         * @brief Constructs a delta snapshot that is bound to a given registry.
+         * @param source A valid reference to a registry.
          */
-        template<typename It>
-        iterator_type batch(It first, It last, const object_type& value) {
-            instances.resize(instances.size() + std::distance(first, last), value);
-            // entity goes after component in case constructor throws
-            underlying_type::batch(first, last);
-            return begin();
-        }
+        basic_delta_snapshot(const basic_registry<entity_type>& source) ENTT_NOEXCEPT
+            : reg{ &source }
+        {}
+
+        /*! @brief Default move constructor. */
+        basic_delta_snapshot(basic_delta_snapshot&&) = default;
+
+        /*! @brief Default move assignment operator. @return This snapshot. */
+        basic_delta_snapshot& operator=(basic_delta_snapshot&&) = default;
 
         /**
-         * @brief Removes an entity from a storage and destroys its object.
-         *
-         * @warning
-         * Attempting to use an entity that doesn't belong to the storage results in
-         * undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * storage doesn't contain the given entity.
-         *
-         * @param entt A valid entity identifier.
+         * @brief Returns the token of the last delta taken.
+         * @return The baseline of the next delta, zero if none was taken yet.
          */
-        void destroy(const entity_type entt) {
-            auto other = std::move(instances.back());
-            instances[underlying_type::index(entt)] = std::move(other);
-            instances.pop_back();
-            underlying_type::destroy(entt);
+        std::uint64_t baseline() const ENTT_NOEXCEPT {
+            return token;
         }
 
         /**
-         * @brief Swaps entities and objects in the internal packed arrays.
+         * @brief Puts aside entities destroyed and created since the previous
+         * delta.
          *
-         * @warning
-         * Attempting to swap entities that don't belong to the sparse set results
-         * in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * sparse set doesn't contain the given entities.
+         * Entities are serialized along with their versions. A recycled entity is
+         * reported both as destroyed and as created.
          *
-         * @param lhs A valid position within the sparse set.
-         * @param rhs A valid position within the sparse set.
+         * @tparam Archive Type of output archive.
+         * @param archive A valid reference to an output archive.
+         * @return A non-const reference to this snapshot.
          */
-        void swap(const size_type lhs, const size_type rhs) ENTT_NOEXCEPT override {
-            ENTT_ASSERT(lhs < instances.size());
-            ENTT_ASSERT(rhs < instances.size());
-            std::swap(instances[lhs], instances[rhs]);
-            underlying_type::swap(lhs, rhs);
+        template<typename Archive>
+        basic_delta_snapshot& entities(Archive& archive) {
+            return entities(archive, token);
         }
 
         /**
-         * @brief Sort elements according to the given comparison function.
-         *
-         * Sort the elements so that iterating the range with a couple of iterators
-         * returns them in the expected order. See `begin` and `end` for more
-         * details.
-         *
-         * The comparison function object must return `true` if the first element
-         * is _less_ than the second one, `false` otherwise. The signature of the
-         * comparison function should be equivalent to one of the following:
-         *
-         * @code{.cpp}
-         * bool(const Entity, const Entity);
-         * bool(const Type &, const Type &);
-         * @endcode
-         *
-         * Moreover, the comparison function object shall induce a
-         * _strict weak ordering_ on the values.
-         *
-         * The sort function oject must offer a member function template
-         * `operator()` that accepts three arguments:
-         *
-         * * An iterator to the first element of the range to sort.
-         * * An iterator past the last element of the range to sort.
-         * * A comparison function to use to compare the elements.
+         * @brief Puts aside entities destroyed and created since a baseline.
          *
-         * The comparison function object received by the sort function object
-         * hasn't necessarily the type of the one passed along with the other
-         * parameters to this member function.
+         * Starts a new delta. The baseline is usually the token of the last delta
+         * the other side applied, as returned by its continuous loader. If it
+         * isn't the token of the previous delta taken with this object, the delta
+         * is a full snapshot instead.
          *
-         * @note
-         * Attempting to iterate elements using a raw pointer returned by a call to
-         * either `data` or `raw` gives no guarantees on the order, even though
-         * `sort` has been invoked.
+         * @sa entities
          *
-         * @tparam Compare Type of comparison function object.
-         * @tparam Sort Type of sort function object.
-         * @tparam Args Types of arguments to forward to the sort function object.
-         * @param first An iterator to the first element of the range to sort.
-         * @param last An iterator past the last element of the range to sort.
-         * @param compare A valid comparison function object.
-         * @param algo A valid sort function object.
-         * @param args Arguments to forward to the sort function object, if any.
+         * @tparam Archive Type of output archive.
+         * @param archive A valid reference to an output archive.
+         * @param from The token of the delta to start from.
+         * @return A non-const reference to this snapshot.
          */
-        template<typename Compare, typename Sort = std_sort, typename... Args>
-        void sort(iterator_type first, iterator_type last, Compare compare, Sort algo = Sort{}, Args&& ... args) {
-            ENTT_ASSERT(!(first > last));
+        template<typename Archive>
+        basic_delta_snapshot& entities(Archive& archive, const std::uint64_t from) {
+            if (from != token) {
+                // the other side doesn't have the state this object remembers, start over
+                alive.clear();
+                pools.clear();
+            }
 
-            const auto from = underlying_type::begin() + std::distance(begin(), first);
-            const auto to = from + std::distance(first, last);
+            since = (from == token) ? token : std::uint64_t{};
+            token = internal::write_clock().fetch_add(1u, std::memory_order_relaxed) + 1u;
+            archive(since, token);
 
-            if constexpr (std::is_invocable_v<Compare, const object_type&, const object_type&>) {
-                static_assert(!std::is_empty_v<object_type>);
+            removed.clear();
+            changed.clear();
 
-                underlying_type::sort(from, to, [this, compare = std::move(compare)](const auto lhs, const auto rhs) {
-                    return compare(std::as_const(instances[underlying_type::index(lhs)]), std::as_const(instances[underlying_type::index(rhs)]));
-                }, std::move(algo), std::forward<Args>(args)...);
-            }
-            else {
-                underlying_type::sort(from, to, std::move(compare), std::move(algo), std::forward<Args>(args)...);
+            for (auto& entt : alive) {
+                if (entt != null && !reg->valid(entt)) {
+                    removed.push_back(entt);
+                    entt = null;
+                }
             }
+
+            reg->each([this](const auto entt) {
+                const auto pos = std::size_t(to_integer(entt) & traits_type::entity_mask);
+
+                if (!(pos < alive.size())) {
+                    alive.resize(pos + 1u, null);
+                }
+
+                if (alive[pos] != entt) {
+                    alive[pos] = entt;
+                    changed.push_back(entt);
+                }
+            });
+
+            put(archive, removed);
+            put(archive, changed);
+            return *this;
         }
 
-        /*! @brief Resets a storage. */
-        void reset() {
-            underlying_type::reset();
-            instances.clear();
+        /**
+         * @brief Puts aside the given components that changed since the previous
+         * delta.
+         *
+         * Removed components are serialized as a list of entities. Assigned and
+         * modified ones are serialized as a list of entities followed by the
+         * encoded differences of their bytes.
+         *
+         * @tparam Component Types of components to serialize, trivially copyable.
+         * @tparam Archive Type of output archive.
+         * @param archive A valid reference to an output archive.
+         * @return A non-const reference to this snapshot.
+         */
+        template<typename... Component, typename Archive>
+        basic_delta_snapshot& component(Archive& archive) {
+            (delta<Component>(archive), ...);
+            return *this;
         }
 
     private:
-        std::vector<object_type> instances;
+        const basic_registry<entity_type>* reg;
+        std::uint64_t since{};
+        std::uint64_t token{};
+        std::vector<entity_type> alive{};
+        std::unordered_map<ENTT_ID_TYPE, baseline_type> pools{};
+        std::vector<entity_type> removed{};
+        std::vector<entity_type> changed{};
+        std::vector<std::uint8_t> buffer{};
     };
 
 
-    /*! @copydoc basic_storage */
-    template<typename Entity, typename Type>
-    class basic_storage<Entity, Type, std::enable_if_t<std::is_empty_v<Type>>> : public sparse_set<Entity> {
-        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
-        using underlying_type = sparse_set<Entity>;
-
-        class iterator {
-            friend class basic_storage<Entity, Type>;
-
-            using index_type = typename traits_type::difference_type;
-
-            iterator(const index_type idx) ENTT_NOEXCEPT
-                : index{ idx }
-            {}
-
-        public:
-            using difference_type = index_type;
-            using value_type = Type;
-            using pointer = const value_type*;
-            using reference = value_type;
-            using iterator_category = std::input_iterator_tag;
+    /**
+     * @brief Utility class to restore a snapshot as a whole.
+     *
+     * A snapshot loader requires that the destination registry be empty and loads
+     * all the data at once while keeping intact the identifiers that the entities
+     * originally had.<br/>
+     * An example of use is the implementation of a save/restore utility.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     */
+    template<typename Entity>
+    class basic_snapshot_loader {
+        /*! @brief A registry is allowed to create snapshot loaders. */
+        friend class basic_registry<Entity>;
 
-            iterator() ENTT_NOEXCEPT = default;
+        using force_fn_type = void(basic_registry<Entity>&, const Entity, const bool);
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
 
-            iterator& operator++() ENTT_NOEXCEPT {
-                return --index, * this;
-            }
+        basic_snapshot_loader(basic_registry<Entity>* source, force_fn_type* fn) ENTT_NOEXCEPT
+            : reg{ source },
+            force{ fn }
+        {
+            // to restore a snapshot as a whole requires a clean registry
+            ENTT_ASSERT(reg->empty());
+        }
 
-            iterator operator++(int) ENTT_NOEXCEPT {
-                iterator orig = *this;
-                return ++(*this), orig;
-            }
+        template<typename Archive>
+        void assure(Archive& archive, bool discard) const {
+            typename traits_type::entity_type length{};
+            archive(length);
 
-            iterator& operator--() ENTT_NOEXCEPT {
-                return ++index, * this;
+            while (length--) {
+                Entity entt{};
+                archive(entt);
+                force(*reg, entt, discard);
             }
+        }
 
-            iterator operator--(int) ENTT_NOEXCEPT {
-                iterator orig = *this;
-                return --(*this), orig;
-            }
+        template<typename Type, typename Archive, typename... Args>
+        void assign(Archive& archive, Args... args) const {
+            typename traits_type::entity_type length{};
+            archive(length);
 
-            iterator& operator+=(const difference_type value) ENTT_NOEXCEPT {
-                index -= value;
-                return *this;
-            }
+            if constexpr (sizeof...(Args) == 0 && internal::is_block_v<Archive, Type>) {
+                static constexpr auto discard = false;
+                ENTT_ID_TYPE type{};
+                std::uint32_t size{};
+                archive(type, size);
 
-            iterator operator+(const difference_type value) const ENTT_NOEXCEPT {
-                return iterator{ index - value };
-            }
+                if (!internal::good(archive)) {
+                    return;
+                }
 
-            iterator& operator-=(const difference_type value) ENTT_NOEXCEPT {
-                return (*this += -value);
-            }
+                // a pool of another type would be reinterpreted, the archive fails instead
+                if (type != internal::block_type<Type>() || size != sizeof(Type) || !internal::fits<Type>(archive, length, sizeof(Entity))) {
+                    internal::fail(archive);
+                    return;
+                }
 
-            iterator operator-(const difference_type value) const ENTT_NOEXCEPT {
-                return (*this + -value);
-            }
+                std::vector<Entity> entity_buffer;
+                const auto* entities = internal::block_data(archive, length, entity_buffer);
 
-            difference_type operator-(const iterator& other) const ENTT_NOEXCEPT {
-                return other.index - index;
-            }
+                if (!entities) {
+                    return;
+                }
 
-            reference operator[](const difference_type) const ENTT_NOEXCEPT {
-                return {};
-            }
+                internal::align(archive, internal::instance_alignment_v<Type>);
 
-            bool operator==(const iterator& other) const ENTT_NOEXCEPT {
-                return other.index == index;
-            }
+                if constexpr (internal::has_share<Archive, Type>::value) {
+                    if (auto instances = archive.template share<Type>(length); instances) {
+                        for (std::size_t pos{}; pos < length; ++pos) {
+                            force(*reg, entities[pos], discard);
+                        }
 
-            bool operator!=(const iterator& other) const ENTT_NOEXCEPT {
-                return !(*this == other);
-            }
+                        reg->template adopt<Type>(entities, entities + length, std::move(instances));
+                        return;
+                    }
+                }
 
-            bool operator<(const iterator& other) const ENTT_NOEXCEPT {
-                return index > other.index;
-            }
+                std::vector<Type> instance_buffer;
+                const auto* instances = internal::block_data(archive, length, instance_buffer);
 
-            bool operator>(const iterator& other) const ENTT_NOEXCEPT {
-                return index < other.index;
-            }
+                if (!instances || !internal::good(archive)) {
+                    return;
+                }
 
-            bool operator<=(const iterator& other) const ENTT_NOEXCEPT {
-                return !(*this > other);
-            }
+                for (std::size_t pos{}; pos < length; ++pos) {
+                    force(*reg, entities[pos], discard);
+                }
 
-            bool operator>=(const iterator& other) const ENTT_NOEXCEPT {
-                return !(*this < other);
+                reg->template insert<Type>(entities, entities + length, instances);
+                return;
             }
 
-            pointer operator->() const ENTT_NOEXCEPT {
-                return nullptr;
-            }
+            while (length--) {
+                static constexpr auto discard = false;
+                Entity entt{};
 
-            reference operator*() const ENTT_NOEXCEPT {
-                return {};
+                if constexpr (std::is_empty_v<Type>) {
+                    archive(entt);
+                    force(*reg, entt, discard);
+                    reg->template assign<Type>(args..., entt);
+                }
+                else {
+                    Type instance{};
+                    archive(entt, instance);
+                    force(*reg, entt, discard);
+                    reg->template assign<Type>(args..., entt, std::as_const(instance));
+                }
             }
-
-        private:
-            index_type index;
-        };
+        }
 
     public:
-        /*! @brief Type of the objects associated with the entities. */
-        using object_type = Type;
-        /*! @brief Underlying entity identifier. */
-        using entity_type = Entity;
-        /*! @brief Unsigned integer type. */
-        using size_type = std::size_t;
-        /*! @brief Random access iterator type. */
-        using iterator_type = iterator;
+        /*! @brief Default move constructor. */
+        basic_snapshot_loader(basic_snapshot_loader&&) = default;
+
+        /*! @brief Default move assignment operator. @return This loader. */
+        basic_snapshot_loader& operator=(basic_snapshot_loader&&) = default;
 
         /**
-         * @brief Returns an iterator to the beginning.
-         *
-         * The returned iterator points to the first instance of the given type. If
-         * the storage is empty, the returned iterator will be equal to `end()`.
+         * @brief Restores entities that were in use during serialization.
          *
-         * @note
-         * Input iterators stay true to the order imposed by a call to either `sort`
-         * or `respect`.
+         * This function restores the entities that were in use during serialization
+         * and gives them the versions they originally had.
          *
-         * @return An iterator to the first instance of the given type.
+         * @tparam Archive Type of input archive.
+         * @param archive A valid reference to an input archive.
+         * @return A valid loader to continue restoring data.
          */
-        iterator_type cbegin() const ENTT_NOEXCEPT {
-            const typename traits_type::difference_type pos = underlying_type::size();
-            return iterator_type{ pos };
-        }
-
-        /*! @copydoc cbegin */
-        iterator_type begin() const ENTT_NOEXCEPT {
-            return cbegin();
+        template<typename Archive>
+        const basic_snapshot_loader& entities(Archive& archive) const {
+            static constexpr auto discard = false;
+            assure(archive, discard);
+            return *this;
         }
 
         /**
-         * @brief Returns an iterator to the end.
-         *
-         * The returned iterator points to the element following the last instance
-         * of the given type. Attempting to dereference the returned iterator
-         * results in undefined behavior.
+         * @brief Restores entities that were destroyed during serialization.
          *
-         * @note
-         * Input iterators stay true to the order imposed by a call to either `sort`
-         * or `respect`.
+         * This function restores the entities that were destroyed during
+         * serialization and gives them the versions they originally had.
          *
-         * @return An iterator to the element following the last instance of the
-         * given type.
+         * @tparam Archive Type of input archive.
+         * @param archive A valid reference to an input archive.
+         * @return A valid loader to continue restoring data.
          */
-        iterator_type cend() const ENTT_NOEXCEPT {
-            return iterator_type{};
-        }
-
-        /*! @copydoc cend */
-        iterator_type end() const ENTT_NOEXCEPT {
-            return cend();
+        template<typename Archive>
+        const basic_snapshot_loader& destroyed(Archive& archive) const {
+            static constexpr auto discard = true;
+            assure(archive, discard);
+            return *this;
         }
 
         /**
-         * @brief Returns the object associated with an entity.
+         * @brief Restores components and assigns them to the right entities.
          *
-         * @note
-         * Empty types aren't explicitly instantiated. Therefore, this function
-         * always returns a temporary object.
+         * The template parameter list must be exactly the same used during
+         * serialization. In the event that the entity to which the component is
+         * assigned doesn't exist yet, the loader will take care to create it with
+         * the version it originally had.
          *
-         * @warning
-         * Attempting to use an entity that doesn't belong to the storage results in
-         * undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * storage doesn't contain the given entity.
+         * Pools written as a whole are checked against their header. A pool of
+         * another type or larger than the rest of the archive isn't loaded and
+         * fails the archive, if it offers a `fail` member function.<br/>
+         * Pools read from memory input archives constructed from shared memory
+         * are adopted by the registry as they are, see `basic_registry::adopt`.
          *
-         * @param entt A valid entity identifier.
-         * @return The object associated with the entity.
+         * @tparam Component Types of components to restore.
+         * @tparam Archive Type of input archive.
+         * @param archive A valid reference to an input archive.
+         * @return A valid loader to continue restoring data.
          */
-        object_type get([[maybe_unused]] const entity_type entt) const ENTT_NOEXCEPT {
-            ENTT_ASSERT(underlying_type::has(entt));
-            return {};
+        template<typename... Component, typename Archive>
+        const basic_snapshot_loader& component(Archive& archive) const {
+            (assign<Component>(archive), ...);
+            return *this;
         }
 
         /**
-         * @brief Assigns one or more entities to a storage.
-         *
-         * The object type must be at least default constructible.
+         * @brief Destroys those entities that have no components.
          *
-         * @warning
-         * Attempting to assign an entity that already belongs to the storage
-         * results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * storage already contains the given entity.
+         * In case all the entities were serialized but only part of the components
+         * was saved, it could happen that some of the entities have no components
+         * once restored.<br/>
+         * This functions helps to identify and destroy those entities.
          *
-         * @tparam It Type of forward iterator.
-         * @param first An iterator to the first element of the range of entities.
-         * @param last An iterator past the last element of the range of entities.
-         * @return An iterator to the list of instances just created and sorted the
-         * same of the entities.
+         * @return A valid loader to continue restoring data.
          */
-        template<typename It>
-        iterator_type batch(It first, It last, const object_type & = {}) {
-            underlying_type::batch(first, last);
-            return begin();
+        const basic_snapshot_loader& orphans() const {
+            reg->orphans([this](const auto entt) {
+                reg->destroy(entt);
+            });
+
+            return *this;
         }
+
+    private:
+        basic_registry<Entity>* reg;
+        force_fn_type* force;
     };
 
-    /*! @copydoc basic_storage */
-    template<typename Entity, typename Type>
-    struct storage : basic_storage<Entity, Type> {};
 
+    /**
+     * @brief Utility class for _continuous loading_.
+     *
+     * A _continuous loader_ is designed to load data from a source registry to a
+     * (possibly) non-empty destination. The loader can accomodate in a registry
+     * more than one snapshot in a sort of _continuous loading_ that updates the
+     * destination one step at a time.<br/>
+     * Identifiers that entities originally had are not transferred to the target.
+     * Instead, the loader maps remote identifiers to local ones while restoring a
+     * snapshot.<br/>
+     * An example of use is the implementation of a client-server applications with
+     * the requirement of transferring somehow parts of the representation side to
+     * side.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     */
+    template<typename Entity>
+    class basic_continuous_loader {
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+        using remote_type = internal::remote_map<Entity>;
 
-}
+        // takes over the entry, dropping the local counterpart of an older version if any
+        typename remote_type::entry& acquire(Entity entt) {
+            auto& elem = remloc.assure(entt);
 
+            if (elem.remote != entt && reg->valid(elem.local)) {
+                reg->destroy(elem.local);
+            }
 
-#endif // ENTT_ENTITY_STORAGE_HPP
+            elem.remote = entt;
+            elem.dirty = true;
+            return elem;
+        }
 
-// #include "utility.hpp"
-#ifndef ENTT_ENTITY_UTILITY_HPP
-#define ENTT_ENTITY_UTILITY_HPP
+        void destroy(Entity entt) {
+            if (!remloc.find(entt)) {
+                auto& elem = acquire(entt);
+                elem.local = reg->create();
+                reg->destroy(elem.local);
+            }
+        }
 
+        template<typename It>
+        void restore(It first, It last) {
+            missing.clear();
 
-// #include "../core/type_traits.hpp"
+            for (; first != last; ++first) {
+                auto* elem = remloc.find(*first);
 
+                if (!elem) {
+                    elem = &acquire(*first);
+                    elem->local = null;
+                }
 
+                elem->dirty = true;
 
-namespace entt {
+                if (!reg->valid(elem->local)) {
+                    missing.push_back(elem);
+                }
+            }
 
+            locals.resize(missing.size());
+            reg->create(locals.begin(), locals.end());
 
-    /**
-     * @brief Alias for exclusion lists.
-     * @tparam Type List of types.
-     */
-    template<typename... Type>
-    struct exclude_t : type_list<Type...> {};
+            for (auto pos = missing.size(); pos; --pos) {
+                missing[pos - 1]->local = locals[pos - 1];
+            }
+        }
 
+        void restore(Entity entt) {
+            restore(&entt, &entt + 1);
+        }
 
-    /**
-     * @brief Variable template for exclusion lists.
-     * @tparam Type List of types.
-     */
-    template<typename... Type>
-    constexpr exclude_t<Type...> exclude{};
+        template<typename Other, typename Type, typename Member>
+        void update(Other& instance, Member Type::* member) {
+            if constexpr (!std::is_same_v<Other, Type>) {
+                return;
+            }
+            else if constexpr (std::is_same_v<Member, Entity>) {
+                instance.*member = map(instance.*member);
+            }
+            else {
+                // maybe a container? let's try...
+                for (auto& entt : instance.*member) {
+                    entt = map(entt);
+                }
+            }
+        }
 
+        template<typename Other, typename Type, typename Member>
+        void update(Other* first, Other* last, Member Type::* member) {
+            if constexpr (std::is_same_v<Other, Type>) {
+                for (; first != last; ++first) {
+                    update(*first, member);
+                }
+            }
+        }
 
-    /**
-     * @brief Alias for lists of observed components.
-     * @tparam Type List of types.
-     */
-    template<typename... Type>
-    struct get_t : type_list<Type...> {};
+        template<typename Archive>
+        void assure(Archive& archive, void(basic_continuous_loader::* member)(Entity)) {
+            take(archive, buffer);
+            std::for_each(buffer.cbegin(), buffer.cend(), [this, member](const auto entt) { (this->*member)(entt); });
+        }
 
+        template<typename Component>
+        void reset() {
+            remloc.each([this](const auto& elem) {
+                if (reg->valid(elem.local)) {
+                    reg->template reset<Component>(elem.local);
+                }
+            });
+        }
 
-    /**
-     * @brief Variable template for lists of observed components.
-     * @tparam Type List of types.
-     */
-    template<typename... Type>
-    constexpr get_t<Type...> get{};
+        template<typename Other, typename Archive, typename... Type, typename... Member>
+        void assign(Archive& archive, [[maybe_unused]] Member Type::* ... member) {
+            typename traits_type::entity_type length{};
+            archive(length);
 
+            if constexpr (internal::is_block_v<Archive, Other>) {
+                ENTT_ID_TYPE type{};
+                std::uint32_t size{};
+                archive(type, size);
 
-}
+                if (!internal::good(archive)) {
+                    return;
+                }
 
+                // a pool of another type would be reinterpreted, the archive fails instead
+                if (type != internal::block_type<Other>() || size != sizeof(Other) || !internal::fits<Other>(archive, length, sizeof(Entity))) {
+                    internal::fail(archive);
+                    return;
+                }
 
-#endif // ENTT_ENTITY_UTILITY_HPP
+                std::vector<Entity> entity_buffer;
+                std::vector<Other> instance_buffer;
+                const auto* entities = internal::block_data(archive, length, entity_buffer);
+                const Other* instances = nullptr;
 
-// #include "entity.hpp"
+                if (!entities) {
+                    return;
+                }
 
-// #include "group.hpp"
-#ifndef ENTT_ENTITY_GROUP_HPP
-#define ENTT_ENTITY_GROUP_HPP
+                internal::align(archive, internal::instance_alignment_v<Other>);
 
+                if constexpr (sizeof...(Member) == 0) {
+                    instances = internal::block_data(archive, length, instance_buffer);
 
-#include <tuple>
-#include <utility>
-#include <type_traits>
-// #include "../config/config.h"
+                    if (!instances) {
+                        return;
+                    }
+                }
+                else {
+                    // members are patched in place, a mapped archive can't be used as is
+                    instance_buffer.resize(length);
+                    archive.block(instance_buffer.data(), instance_buffer.size());
+                    instances = instance_buffer.data();
+                }
 
-// #include "../core/type_traits.hpp"
+                if (!internal::good(archive)) {
+                    return;
+                }
 
-// #include "sparse_set.hpp"
+                // local counterparts first, so that members can refer to entities of the same batch
+                restore(entities, entities + length);
+                (update(instance_buffer.data(), instance_buffer.data() + instance_buffer.size(), member), ...);
 
-// #include "storage.hpp"
+                for (std::size_t pos{}; pos < length; ++pos) {
+                    reg->template assign_or_replace<Other>(map(entities[pos]), instances[pos]);
+                }
 
-// #include "utility.hpp"
+                return;
+            }
 
-// #include "fwd.hpp"
+            while (length--) {
+                Entity entt{};
 
+                if constexpr (std::is_empty_v<Other>) {
+                    archive(entt);
+                    restore(entt);
+                    reg->template assign_or_replace<Other>(map(entt));
+                }
+                else {
+                    Other instance{};
+                    archive(entt, instance);
+                    (update(instance, member), ...);
+                    restore(entt);
+                    reg->template assign_or_replace<Other>(map(entt), std::as_const(instance));
+                }
+            }
+        }
 
+        template<typename Archive>
+        void take(Archive& archive, std::vector<Entity>& list) const {
+            typename traits_type::entity_type length{};
+            archive(length);
+            list.resize(internal::fits<Entity>(archive, length) ? length : 0u);
+            internal::read_block(archive, list.data(), list.size());
+        }
 
-namespace entt {
+        template<typename Other, typename Archive, typename... Type, typename... Member>
+        void apply(Archive& archive, [[maybe_unused]] Member Type::* ... member) {
+            static_assert(std::is_trivially_copyable_v<Other>);
 
+            if (malformed) {
+                return;
+            }
 
-    /**
-     * @brief Group.
-     *
-     * Primary template isn't defined on purpose. All the specializations give a
-     * compile-time error, but for a few reasonable cases.
-     */
-    template<typename...>
-    class basic_group;
+            auto& base = deltas[to_integer(reg->template type<Other>())];
+            base.stride = std::is_empty_v<Other> ? 0u : sizeof(Other);
 
+            take(archive, buffer);
 
-    /**
-     * @brief Non-owning group.
-     *
-     * A non-owning group returns all the entities and only the entities that have
-     * at least the given components. Moreover, it's guaranteed that the entity list
-     * is tightly packed in memory for fast iterations.<br/>
-     * In general, non-owning groups don't stay true to the order of any set of
-     * components unless users explicitly sort them.
-     *
-     * @b Important
-     *
-     * Iterators aren't invalidated if:
-     *
-     * * New instances of the given components are created and assigned to entities.
-     * * The entity currently pointed is modified (as an example, if one of the
-     *   given components is removed from the entity to which the iterator points).
-     * * The entity currently pointed is destroyed.
-     *
-     * In all the other cases, modifying the pools of the given components in any
-     * way invalidates all the iterators and using them results in undefined
-     * behavior.
-     *
-     * @note
-     * Groups share references to the underlying data structures of the registry
-     * that generated them. Therefore any change to the entities and to the
-     * components made by means of the registry are immediately reflected by all the
-     * groups.<br/>
-     * Moreover, sorting a non-owning group affects all the instance of the same
-     * group (it means that users don't have to call `sort` on each instance to sort
-     * all of them because they share the set of entities).
-     *
-     * @warning
-     * Lifetime of a group must overcome the one of the registry that generated it.
-     * In any other case, attempting to use a group results in undefined behavior.
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
-     * @tparam Exclude Types of components used to filter the group.
-     * @tparam Get Type of component observed by the group.
-     * @tparam Other Other types of components observed by the group.
-     */
-    template<typename Entity, typename... Exclude, typename Get, typename... Other>
-    class basic_group<Entity, exclude_t<Exclude...>, get_t<Get, Other...>> {
-        /*! @brief A registry is allowed to create groups. */
-        friend class basic_registry<Entity>;
+            for (const auto entt : buffer) {
+                const auto local = map(entt);
+                base.erase(entt);
 
-        template<typename Component>
-        using pool_type = std::conditional_t<std::is_const_v<Component>, const storage<Entity, std::remove_const_t<Component>>, storage<Entity, Component>>;
+                if (reg->valid(local)) {
+                    reg->template reset<Other>(local);
+                }
+            }
 
-        // we could use pool_type<Type> *..., but vs complains about it and refuses to compile for unknown reasons (most likely a bug)
-        basic_group(sparse_set<Entity>* ref, storage<Entity, std::remove_const_t<Get>>* get, storage<Entity, std::remove_const_t<Other>>* ... other) ENTT_NOEXCEPT
-            : handler{ ref },
-            pools{ get, other... }
-        {}
+            take(archive, buffer);
 
-        template<typename Func, typename... Weak>
-        void traverse(Func func, type_list<Weak...>) const {
-            for (const auto entt : *handler) {
-                if constexpr (std::is_invocable_v < Func, decltype(get<Weak>({}))... > ) {
-                    func(std::get<pool_type<Weak>*>(pools)->get(entt)...);
+            std::uint32_t length{};
+            archive(length);
+
+            if (!internal::fits<std::uint8_t>(archive, length)) {
+                malformed = true;
+                return;
+            }
+
+            bytes.resize(length);
+            internal::read_block(archive, bytes.data(), bytes.size());
+            const auto* in = bytes.data();
+
+            for (const auto entt : buffer) {
+                if constexpr (std::is_empty_v<Other>) {
+                    base.assure(entt);
+                    restore(entt);
+                    reg->template assign_or_replace<Other>(map(entt));
                 }
                 else {
-                    func(entt, std::get<pool_type<Weak>*>(pools)->get(entt)...);
+                    const bool known = base.contains(entt);
+                    auto* data = base.assure(entt);
+
+                    if (!internal::decode_delta(in, bytes.data() + bytes.size(), data, sizeof(Other))) {
+                        if (!known) {
+                            base.erase(entt);
+                        }
+
+                        malformed = true;
+                        return;
+                    }
+
+                    restore(entt);
+                    Other instance;
+                    std::memcpy(&instance, data, sizeof(Other));
+                    (update(instance, member), ...);
+                    reg->template assign_or_replace<Other>(map(entt), std::as_const(instance));
                 }
-            };
+            }
         }
 
     public:
         /*! @brief Underlying entity identifier. */
-        using entity_type = typename sparse_set<Entity>::entity_type;
-        /*! @brief Unsigned integer type. */
-        using size_type = typename sparse_set<Entity>::size_type;
-        /*! @brief Input iterator type. */
-        using iterator_type = typename sparse_set<Entity>::iterator_type;
+        using entity_type = Entity;
 
         /**
-         * @brief Returns the number of existing components of the given type.
-         * @tparam Component Type of component of which to return the size.
-         * @return Number of existing components of the given type.
+         * @brief Constructs a loader that is bound to a given registry.
+         * @param source A valid reference to a registry.
          */
-        template<typename Component>
-        size_type size() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Component>*>(pools)->size();
-        }
-
-        /**
-         * @brief Returns the number of entities that have the given components.
-         * @return Number of entities that have the given components.
-         */
-        size_type size() const ENTT_NOEXCEPT {
-            return handler->size();
-        }
+        basic_continuous_loader(basic_registry<entity_type>& source) ENTT_NOEXCEPT
+            : reg{ &source }
+        {}
 
-        /**
-         * @brief Returns the number of elements that a group has currently
-         * allocated space for.
-         * @return Capacity of the group.
-         */
-        size_type capacity() const ENTT_NOEXCEPT {
-            return handler->capacity();
-        }
+        /*! @brief Default move constructor. */
+        basic_continuous_loader(basic_continuous_loader&&) = default;
 
-        /*! @brief Requests the removal of unused capacity. */
-        void shrink_to_fit() {
-            handler->shrink_to_fit();
-        }
+        /*! @brief Default move assignment operator. @return This loader. */
+        basic_continuous_loader& operator=(basic_continuous_loader&&) = default;
 
         /**
-         * @brief Checks whether the pool of a given component is empty.
-         * @tparam Component Type of component in which one is interested.
-         * @return True if the pool of the given component is empty, false
-         * otherwise.
+         * @brief Restores entities that were in use during serialization.
+         *
+         * This function restores the entities that were in use during serialization
+         * and creates local counterparts for them if required.
+         *
+         * @tparam Archive Type of input archive.
+         * @param archive A valid reference to an input archive.
+         * @return A non-const reference to this loader.
          */
-        template<typename Component>
-        bool empty() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Component>*>(pools)->empty();
+        template<typename Archive>
+        basic_continuous_loader& entities(Archive& archive) {
+            take(archive, buffer);
+            restore(buffer.cbegin(), buffer.cend());
+            return *this;
         }
 
         /**
-         * @brief Checks whether the group is empty.
-         * @return True if the group is empty, false otherwise.
+         * @brief Restores entities that were destroyed during serialization.
+         *
+         * This function restores the entities that were destroyed during
+         * serialization and creates local counterparts for them if required.
+         *
+         * @tparam Archive Type of input archive.
+         * @param archive A valid reference to an input archive.
+         * @return A non-const reference to this loader.
          */
-        bool empty() const ENTT_NOEXCEPT {
-            return handler->empty();
+        template<typename Archive>
+        basic_continuous_loader& destroyed(Archive& archive) {
+            assure(archive, &basic_continuous_loader::destroy);
+            return *this;
         }
 
         /**
-         * @brief Direct access to the list of components of a given pool.
+         * @brief Restores components and assigns them to the right entities.
          *
-         * The returned pointer is such that range
-         * `[raw<Component>(), raw<Component>() + size<Component>()]` is always a
-         * valid range, even if the container is empty.
+         * The template parameter list must be exactly the same used during
+         * serialization. In the event that the entity to which the component is
+         * assigned doesn't exist yet, the loader will take care to create a local
+         * counterpart for it.<br/>
+         * Members can be either data members of type entity_type or containers of
+         * entities. In both cases, the loader will visit them and update the
+         * entities by replacing each one with its local counterpart.
          *
-         * @note
-         * There are no guarantees on the order of the components. Use `begin` and
-         * `end` if you want to iterate the group in the expected order.
+         * Pools written as a whole are checked against their header. A pool of
+         * another type or larger than the rest of the archive isn't loaded and
+         * fails the archive, if it offers a `fail` member function.
          *
-         * @tparam Component Type of component in which one is interested.
-         * @return A pointer to the array of components.
+         * @tparam Component Type of component to restore.
+         * @tparam Archive Type of input archive.
+         * @tparam Type Types of components to update with local counterparts.
+         * @tparam Member Types of members to update with their local counterparts.
+         * @param archive A valid reference to an input archive.
+         * @param member Members to update with their local counterparts.
+         * @return A non-const reference to this loader.
          */
-        template<typename Component>
-        Component* raw() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Component>*>(pools)->raw();
+        template<typename... Component, typename Archive, typename... Type, typename... Member>
+        basic_continuous_loader& component(Archive& archive, Member Type::* ... member) {
+            (reset<Component>(), ...);
+            (assign<Component>(archive, member...), ...);
+            return *this;
         }
 
         /**
-         * @brief Direct access to the list of entities of a given pool.
+         * @brief Applies the entities part of a delta snapshot.
          *
-         * The returned pointer is such that range
-         * `[data<Component>(), data<Component>() + size<Component>()]` is always a
-         * valid range, even if the container is empty.
+         * Local counterparts of destroyed entities are destroyed, while created
+         * entities get a local counterpart if required.<br/>
+         * A full snapshot first destroys the local counterparts of all the
+         * entities the loader knows about and recovers a loader that met a
+         * malformed delta. A delta against a baseline other than the last one
+         * applied is considered malformed.
          *
-         * @note
-         * There are no guarantees on the order of the entities. Use `begin` and
-         * `end` if you want to iterate the group in the expected order.
+         * @sa basic_delta_snapshot
          *
-         * @tparam Component Type of component in which one is interested.
-         * @return A pointer to the array of entities.
+         * @tparam Archive Type of input archive.
+         * @param archive A valid reference to an input archive.
+         * @return A non-const reference to this loader.
          */
-        template<typename Component>
-        const entity_type* data() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Component>*>(pools)->data();
+        template<typename Archive>
+        basic_continuous_loader& delta_entities(Archive& archive) {
+            std::uint64_t since{};
+            std::uint64_t next{};
+            archive(since, next);
+
+            if (!since) {
+                remloc.each([this](auto& elem) {
+                    if (reg->valid(elem.local)) {
+                        reg->destroy(elem.local);
+                    }
+
+                    remloc.erase(elem);
+                });
+
+                deltas.clear();
+                malformed = false;
+            }
+            else if (since != token) {
+                malformed = true;
+            }
+
+            if (malformed || !internal::good(archive)) {
+                malformed = true;
+                return *this;
+            }
+
+            token = next;
+            take(archive, buffer);
+
+            for (const auto entt : buffer) {
+                if (auto* elem = remloc.find(entt); elem) {
+                    if (reg->valid(elem->local)) {
+                        reg->destroy(elem->local);
+                    }
+
+                    remloc.erase(*elem);
+                }
+
+                for (auto&& ref : deltas) {
+                    ref.second.erase(entt);
+                }
+            }
+
+            take(archive, buffer);
+            restore(buffer.cbegin(), buffer.cend());
+            return *this;
         }
 
         /**
-         * @brief Direct access to the list of entities.
+         * @brief Applies the components part of a delta snapshot.
          *
-         * The returned pointer is such that range `[data(), data() + size()]` is
-         * always a valid range, even if the container is empty.
+         * The template parameter list must be exactly the same used during
+         * serialization. Members are updated as in the case of `component`.<br/>
+         * The loader keeps a copy of the remote state of the components, so that
+         * the following deltas can be decoded.
          *
-         * @note
-         * There are no guarantees on the order of the entities. Use `begin` and
-         * `end` if you want to iterate the group in the expected order.
+         * A malformed delta is detected before it writes out of bounds. The
+         * loader stops applying components from then on, since the following
+         * deltas are relative to a state it no longer has (see `good`).
          *
-         * @return A pointer to the array of entities.
+         * @warning
+         * Deltas don't mention entities that didn't change. Therefore, `shrink`
+         * must not be invoked while applying deltas.
+         *
+         * @sa basic_delta_snapshot
+         *
+         * @tparam Component Types of components to restore.
+         * @tparam Archive Type of input archive.
+         * @tparam Type Types of components to update with local counterparts.
+         * @tparam Member Types of members to update with their local counterparts.
+         * @param archive A valid reference to an input archive.
+         * @param member Members to update with their local counterparts.
+         * @return A non-const reference to this loader.
          */
-        const entity_type* data() const ENTT_NOEXCEPT {
-            return handler->data();
+        template<typename... Component, typename Archive, typename... Type, typename... Member>
+        basic_continuous_loader& delta_component(Archive& archive, Member Type::* ... member) {
+            (apply<Component>(archive, member...), ...);
+            return *this;
         }
 
         /**
-         * @brief Returns an iterator to the first entity that has the given
-         * components.
-         *
-         * The returned iterator points to the first entity that has the given
-         * components. If the group is empty, the returned iterator will be equal to
-         * `end()`.
-         *
-         * @note
-         * Input iterators stay true to the order imposed to the underlying data
-         * structures.
-         *
-         * @return An iterator to the first entity that has the given components.
+         * @brief Checks whether all the deltas applied so far were well formed.
+         * @return False if a malformed delta was met, true otherwise.
          */
-        iterator_type begin() const ENTT_NOEXCEPT {
-            return handler->begin();
+        bool good() const ENTT_NOEXCEPT {
+            return !malformed;
         }
 
         /**
-         * @brief Returns an iterator that is past the last entity that has the
-         * given components.
+         * @brief Returns the token of the last delta applied.
          *
-         * The returned iterator points to the entity following the last entity that
-         * has the given components. Attempting to dereference the returned iterator
-         * results in undefined behavior.
-         *
-         * @note
-         * Input iterators stay true to the order imposed to the underlying data
-         * structures.
+         * Send it back to the other side as the baseline of the next delta. It's
+         * zero until a delta is applied or after a malformed one, that is when
+         * the next delta should be a full snapshot.
          *
-         * @return An iterator to the entity following the last entity that has the
-         * given components.
+         * @return The token of the last delta applied, if any.
          */
-        iterator_type end() const ENTT_NOEXCEPT {
-            return handler->end();
+        std::uint64_t baseline() const ENTT_NOEXCEPT {
+            return malformed ? std::uint64_t{} : token;
         }
 
         /**
-         * @brief Finds an entity.
-         * @param entt A valid entity identifier.
-         * @return An iterator to the given entity if it's found, past the end
-         * iterator otherwise.
+         * @brief Helps to purge entities that no longer have a conterpart.
+         *
+         * Users should invoke this member function after restoring each snapshot,
+         * unless they know exactly what they are doing.
+         *
+         * @return A non-const reference to this loader.
          */
-        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
-            const auto it = handler->find(entt);
-            return it != end() && *it == entt ? it : end();
+        basic_continuous_loader& shrink() {
+            remloc.each([this](auto& elem) {
+                if (elem.dirty) {
+                    elem.dirty = false;
+                }
+                else {
+                    if (reg->valid(elem.local)) {
+                        reg->destroy(elem.local);
+                    }
+
+                    remloc.erase(elem);
+                }
+            });
+
+            return *this;
         }
 
         /**
-         * @brief Returns the identifier that occupies the given position.
-         * @param pos Position of the element to return.
-         * @return The identifier that occupies the given position.
+         * @brief Destroys those entities that have no components.
+         *
+         * In case all the entities were serialized but only part of the components
+         * was saved, it could happen that some of the entities have no components
+         * once restored.<br/>
+         * This functions helps to identify and destroy those entities.
+         *
+         * @return A non-const reference to this loader.
          */
-        entity_type operator[](const size_type pos) const ENTT_NOEXCEPT {
-            return begin()[pos];
+        basic_continuous_loader& orphans() {
+            reg->orphans([this](const auto entt) {
+                reg->destroy(entt);
+            });
+
+            return *this;
         }
 
         /**
-         * @brief Checks if a group contains an entity.
-         * @param entt A valid entity identifier.
-         * @return True if the group contains the given entity, false otherwise.
+         * @brief Tests if a loader knows about a given entity.
+         * @param entt An entity identifier.
+         * @return True if `entity` is managed by the loader, false otherwise.
          */
-        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
-            return find(entt) != end();
+        bool has(entity_type entt) const ENTT_NOEXCEPT {
+            return (remloc.find(entt) != nullptr);
         }
 
         /**
-         * @brief Returns the components assigned to the given entity.
-         *
-         * Prefer this function instead of `registry::get` during iterations. It has
-         * far better performance than its companion function.
-         *
-         * @warning
-         * Attempting to use an invalid component type results in a compilation
-         * error. Attempting to use an entity that doesn't belong to the group
-         * results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * group doesn't contain the given entity.
-         *
-         * @tparam Component Types of components to get.
-         * @param entt A valid entity identifier.
-         * @return The components assigned to the entity.
+         * @brief Returns the identifier to which an entity refers.
+         * @param entt An entity identifier.
+         * @return The local identifier if any, the null entity otherwise.
          */
-        template<typename... Component>
-        decltype(auto) get([[maybe_unused]] const entity_type entt) const ENTT_NOEXCEPT {
-            ENTT_ASSERT(contains(entt));
+        entity_type map(entity_type entt) const ENTT_NOEXCEPT {
+            const auto* elem = remloc.find(entt);
+            entity_type other = null;
 
-            if constexpr (sizeof...(Component) == 1) {
-                return (std::get<pool_type<Component>*>(pools)->get(entt), ...);
+            if (elem) {
+                other = elem->local;
             }
-            else {
-                return std::tuple<decltype(get<Component>(entt))...>{get<Component>(entt)...};
+
+            return other;
+        }
+
+    private:
+        remote_type remloc;
+        std::unordered_map<ENTT_ID_TYPE, internal::delta_baseline<entity_type>> deltas;
+        std::vector<typename remote_type::entry*> missing;
+        std::vector<entity_type> locals;
+        std::vector<entity_type> buffer;
+        std::vector<std::uint8_t> bytes;
+        basic_registry<entity_type>* reg;
+        std::uint64_t token{};
+        bool malformed{};
+    };
+
+
+}
+
+
+#endif // ENTT_ENTITY_SNAPSHOT_HPP
+
+// #include "storage.hpp"
+#ifndef ENTT_ENTITY_STORAGE_HPP
+#define ENTT_ENTITY_STORAGE_HPP
+
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+// #include "../config/config.h"
+
+// #include "../core/algorithm.hpp"
+
+// #include "sparse_set.hpp"
+
+// #include "entity.hpp"
+
+
+
+namespace entt {
+
+
+    /**
+     * @brief Memory resource that backs large blocks with transparent huge pages.
+     *
+     * Blocks at least as large as the threshold are mapped directly and aligned
+     * to huge page boundaries, then advised with `MADV_HUGEPAGE` so that the
+     * kernel can serve them through huge pages. It cuts TLB misses when iterating
+     * large pools. Smaller blocks are served by the upstream resource.
+     *
+     * @note
+     * Huge pages are a Linux feature. On other platforms all the requests are
+     * forwarded to the upstream resource.
+     */
+    class huge_page_resource : public std::pmr::memory_resource {
+        static constexpr std::size_t huge_page = std::size_t{ 1u } << 21;
+
+        static std::size_t round(const std::size_t bytes) ENTT_NOEXCEPT {
+            return (bytes + huge_page - 1) & ~(huge_page - 1);
+        }
+
+        void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+#ifdef __linux__
+            if (!(bytes < threshold) && alignment <= huge_page) {
+                const auto length = round(bytes);
+                // over-map by a huge page and trim both ends to get an aligned block
+                auto* base = static_cast<char*>(mmap(nullptr, length + huge_page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+                if (base == MAP_FAILED) {
+                    throw std::bad_alloc{};
+                }
+
+                auto* block = reinterpret_cast<char*>(round(reinterpret_cast<std::uintptr_t>(base)));
+
+                if (const std::size_t head = block - base; head) {
+                    munmap(base, head);
+                }
+
+                if (const std::size_t tail = huge_page - (block - base); tail) {
+                    munmap(block + length, tail);
+                }
+
+                madvise(block, length, MADV_HUGEPAGE);
+                return block;
+            }
+#endif
+
+            return upstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* ptr, const std::size_t bytes, const std::size_t alignment) override {
+#ifdef __linux__
+            if (!(bytes < threshold) && alignment <= huge_page) {
+                munmap(ptr, round(bytes));
+                return;
             }
+#endif
+
+            upstream->deallocate(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const ENTT_NOEXCEPT override {
+            return this == &other;
         }
 
+    public:
         /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a set of references to all its components. The
-         * _constness_ of the components is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
-         *
-         * @code{.cpp}
-         * void(const entity_type, Get &, Other &...);
-         * void(Get &, Other &...);
-         * @endcode
-         *
-         * @note
-         * Empty types aren't explicitly instantiated. Therefore, temporary objects
-         * are returned during iterations. They can be caught only by copy or with
-         * const references.
-         *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @brief Constructs a resource with a given threshold.
+         * @param bytes Minimum size of the blocks mapped through huge pages.
+         * @param resource Resource to use for smaller blocks.
          */
-        template<typename Func>
-        void each(Func func) const {
-            traverse(std::move(func), type_list<Get, Other...>{});
+        explicit huge_page_resource(const std::size_t bytes = huge_page, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) ENTT_NOEXCEPT
+            : threshold{ bytes },
+            upstream{ resource }
+        {}
+
+    private:
+        const std::size_t threshold;
+        std::pmr::memory_resource* const upstream;
+    };
+
+
+    /**
+     * @brief Per-type customization point for storage classes.
+     *
+     * Specialize it for a component to route both its sparse pages and its packed
+     * arrays to a different memory resource, for example an arena or a
+     * huge_page_resource. The resource must outlive all the pools of the type.
+     *
+     * A specialization can also define a `static constexpr std::size_t
+     * instance_page` member, to store the objects in pages of that many elements
+     * rather than in a single array (see paged_vector for more details).<br/>
+     * The array or the pages are aligned to the larger of the alignment of the
+     * type and `ENTT_INSTANCE_ALIGNMENT` bytes, or to a `static constexpr
+     * std::size_t instance_alignment` member if any, so that chunks of objects
+     * that start at a multiple of a power of two elements are suitably aligned
+     * for SIMD loads (see the `each_chunk` member functions of views and
+     * groups).<br/>
+     * Similarly, a `static constexpr std::size_t sparse_page` member overrides
+     * the size in bytes of the sparse pages, `ENTT_PAGE_SIZE` otherwise. Rare
+     * components can use smaller pages or zero to select the compact mode of the
+     * sparse set.
+     * A `static constexpr bool presence` member set to true makes the pools
+     * maintain a presence bitset, that views and groups use to intersect pools a
+     * word at a time (see sparse_set::track_presence for more details).
+     *
+     * @tparam Type Type of objects assigned to the entities.
+     */
+    template<typename Type, typename>
+    struct storage_traits {
+        /**
+         * @brief Returns the memory resource to use for a new pool.
+         * @return A valid memory resource.
+         */
+        static std::pmr::memory_resource* resource() ENTT_NOEXCEPT {
+            return std::pmr::get_default_resource();
         }
+    };
+
+
+    /**
+     * @brief Non-owning view of elements laid out at a fixed distance in memory.
+     *
+     * Storage classes and groups return strided views of their packed arrays,
+     * that can be handed over as they are to anything that accepts a pointer, a
+     * size and a stride, for example to fill vertex or instance buffers without
+     * copying the elements one at a time. Views of a data member of each element
+     * are obtained from views of the elements.
+     *
+     * @tparam Type Type of elements, possibly const qualified.
+     */
+    template<typename Type>
+    class strided_view {
+        using byte_type = std::conditional_t<std::is_const_v<Type>, const std::byte, std::byte>;
+
+    public:
+        /*! @brief Type of elements. */
+        using value_type = Type;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+
+        /*! @brief Default constructor, an empty view. */
+        strided_view() ENTT_NOEXCEPT
+            : strided_view{ nullptr, 0u, sizeof(Type) }
+        {}
 
         /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a set of references to non-empty components. The
-         * _constness_ of the components is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
-         *
-         * @code{.cpp}
-         * void(const entity_type, Type &...);
-         * void(Type &...);
-         * @endcode
-         *
-         * @sa each
-         *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @brief Constructs a view of the given elements.
+         * @param ref A pointer to the first element, if any.
+         * @param sz Number of elements.
+         * @param step Distance in bytes between consecutive elements.
          */
-        template<typename Func>
-        void less(Func func) const {
-            using get_type_list = std::conditional_t<std::is_empty_v<Get>, type_list<>, type_list<Get>>;
-            using other_type_list = type_list_cat_t<std::conditional_t<std::is_empty_v<Other>, type_list<>, type_list<Other>>...>;
-            traverse(std::move(func), type_list_cat_t<get_type_list, other_type_list>{});
+        strided_view(Type* ref, const size_type sz, const size_type step) ENTT_NOEXCEPT
+            : first{ ref }, count{ sz }, distance{ step }
+        {}
+
+        /**
+         * @brief Converts a view of non-const elements to a view of const ones.
+         * @tparam Other Type of elements of the other view.
+         * @param other The view to convert.
+         */
+        template<typename Other, typename = std::enable_if_t<std::is_same_v<const Other, Type> && !std::is_same_v<Other, Type>>>
+        strided_view(const strided_view<Other>& other) ENTT_NOEXCEPT
+            : strided_view{ other.data(), other.size(), other.stride() }
+        {}
+
+        /**
+         * @brief Returns a view of a data member of each element.
+         * @tparam Member Type of the data member.
+         * @tparam Class Type of the class the member belongs to.
+         * @param ptr A pointer to the data member.
+         * @return A view with the same size and stride.
+         */
+        template<typename Member, typename Class>
+        auto member(Member Class::* ptr) const ENTT_NOEXCEPT {
+            static_assert(std::is_base_of_v<Class, std::remove_const_t<Type>>);
+            using member_type = std::conditional_t<std::is_const_v<Type>, const Member, Member>;
+            return strided_view<member_type>{ count ? &(first->*ptr) : nullptr, count, distance };
         }
 
         /**
-         * @brief Sort a group according to the given comparison function.
-         *
-         * Sort the group so that iterating it with a couple of iterators returns
-         * entities and components in the expected order. See `begin` and `end` for
-         * more details.
-         *
-         * The comparison function object must return `true` if the first element
-         * is _less_ than the second one, `false` otherwise. The signature of the
-         * comparison function should be equivalent to one of the following:
-         *
-         * @code{.cpp}
-         * bool(std::tuple<Component &...>, std::tuple<Component &...>);
-         * bool(const Component &..., const Component &...);
-         * bool(const Entity, const Entity);
-         * @endcode
-         *
-         * Where `Component` are such that they are iterated by the group.<br/>
-         * Moreover, the comparison function object shall induce a
-         * _strict weak ordering_ on the values.
-         *
-         * The sort function oject must offer a member function template
-         * `operator()` that accepts three arguments:
-         *
-         * * An iterator to the first element of the range to sort.
-         * * An iterator past the last element of the range to sort.
-         * * A comparison function to use to compare the elements.
-         *
-         * The comparison function object received by the sort function object
-         * hasn't necessarily the type of the one passed along with the other
-         * parameters to this member function.
-         *
-         * @note
-         * Attempting to iterate elements using a raw pointer returned by a call to
-         * either `data` or `raw` gives no guarantees on the order, even though
-         * `sort` has been invoked.
-         *
-         * @tparam Component Optional types of components to compare.
-         * @tparam Compare Type of comparison function object.
-         * @tparam Sort Type of sort function object.
-         * @tparam Args Types of arguments to forward to the sort function object.
-         * @param compare A valid comparison function object.
-         * @param algo A valid sort function object.
-         * @param args Arguments to forward to the sort function object, if any.
+         * @brief Returns a pointer to the first element.
+         * @return A pointer to the first element, if any.
          */
-        template<typename... Component, typename Compare, typename Sort = std_sort, typename... Args>
-        void sort(Compare compare, Sort algo = Sort{}, Args&& ... args) {
-            if constexpr (sizeof...(Component) == 0) {
-                static_assert(std::is_invocable_v<Compare, const entity_type, const entity_type>);
-                handler->sort(handler->begin(), handler->end(), std::move(compare), std::move(algo), std::forward<Args>(args)...);
-            }
-            else {
-                handler->sort(handler->begin(), handler->end(), [this, compare = std::move(compare)](const entity_type lhs, const entity_type rhs) {
-                    // useless this-> used to suppress a warning with clang
-                    return compare(this->get<Component...>(lhs), this->get<Component...>(rhs));
-                }, std::move(algo), std::forward<Args>(args)...);
-            }
+        Type* data() const ENTT_NOEXCEPT {
+            return first;
         }
 
         /**
-         * @brief Sort the shared pool of entities according to the given component.
-         *
-         * Non-owning groups of the same type share with the registry a pool of
-         * entities with  its own order that doesn't depend on the order of any pool
-         * of components. Users can order the underlying data structure so that it
-         * respects the order of the pool of the given component.
-         *
-         * @note
-         * The shared pool of entities and thus its order is affected by the changes
-         * to each and every pool that it tracks. Therefore changes to those pools
-         * can quickly ruin the order imposed to the pool of entities shared between
-         * the non-owning groups.
-         *
-         * @tparam Component Type of component to use to impose the order.
+         * @brief Returns the number of elements.
+         * @return Number of elements.
          */
-        template<typename Component>
-        void sort() const {
-            handler->respect(*std::get<pool_type<Component>*>(pools));
+        size_type size() const ENTT_NOEXCEPT {
+            return count;
+        }
+
+        /**
+         * @brief Returns the distance between consecutive elements.
+         * @return Distance in bytes.
+         */
+        size_type stride() const ENTT_NOEXCEPT {
+            return distance;
+        }
+
+        /**
+         * @brief Checks whether the view is empty.
+         * @return True if the view is empty, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return !count;
+        }
+
+        /**
+         * @brief Returns a reference to an element.
+         * @param pos A valid position.
+         * @return A reference to the element.
+         */
+        Type& operator[](const size_type pos) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(pos < count);
+            return *reinterpret_cast<Type*>(reinterpret_cast<byte_type*>(first) + pos * distance);
         }
 
     private:
-        sparse_set<entity_type>* handler;
-        const std::tuple<pool_type<Get>*, pool_type<Other>* ...> pools;
+        Type* first;
+        size_type count;
+        size_type distance;
     };
 
 
     /**
-     * @brief Owning group.
-     *
-     * Owning groups return all the entities and only the entities that have at
-     * least the given components. Moreover:
-     *
-     * * It's guaranteed that the entity list is tightly packed in memory for fast
-     *   iterations.
-     * * It's guaranteed that the lists of owned components are tightly packed in
-     *   memory for even faster iterations and to allow direct access.
-     * * They stay true to the order of the owned components and all the owned
-     *   components have the same order in memory.
+     * @brief Packed array made of fixed size pages allocated on demand.
      *
-     * The more types of components are owned by a group, the faster it is to
-     * iterate them.
+     * Elements never move when the array grows, so references stay valid and
+     * a bulk spawn doesn't pay for relocating the whole array once the capacity
+     * is exhausted. Indexed access remains constant time and each page is
+     * contiguous.
      *
-     * @b Important
+     * Copies of arrays of trivially copyable elements share their pages rather
+     * than copying them. A shared page is copied the first time it's accessed
+     * through a non-const member function of either array, so that copying an
+     * array costs as much as copying the list of its pages and the elements are
+     * copied only if and when they are modified.
      *
-     * Iterators aren't invalidated if:
+     * @warning
+     * The first non-const access to a shared page isn't thread safe, even if
+     * different elements are accessed. The last array to drop a page releases
+     * it, possibly on another thread, therefore the memory resource must be
+     * thread safe if copies are handed to other threads.
      *
-     * * New instances of the given components are created and assigned to entities.
-     * * The entity currently pointed is modified (as an example, if one of the
-     *   given components is removed from the entity to which the iterator points).
-     * * The entity currently pointed is destroyed.
-     *
-     * In all the other cases, modifying the pools of the given components in any
-     * way invalidates all the iterators and using them results in undefined
-     * behavior.
-     *
-     * @note
-     * Groups share references to the underlying data structures of the registry
-     * that generated them. Therefore any change to the entities and to the
-     * components made by means of the registry are immediately reflected by all the
-     * groups.
-     * Moreover, sorting an owning group affects all the instance of the same group
-     * (it means that users don't have to call `sort` on each instance to sort all
-     * of them because they share the underlying data structure).
-     *
-     * @warning
-     * Lifetime of a group must overcome the one of the registry that generated it.
-     * In any other case, attempting to use a group results in undefined behavior.
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
-     * @tparam Exclude Types of components used to filter the group.
-     * @tparam Get Types of components observed by the group.
-     * @tparam Owned Type of component owned by the group.
-     * @tparam Other Other types of components owned by the group.
+     * @tparam Type Type of elements.
+     * @tparam Page Number of elements per page, a power of two.
+     * @tparam Align Alignment of the pages, a power of two.
      */
-    template<typename Entity, typename... Exclude, typename... Get, typename Owned, typename... Other>
-    class basic_group<Entity, exclude_t<Exclude...>, get_t<Get...>, Owned, Other...> {
-        /*! @brief A registry is allowed to create groups. */
-        friend class basic_registry<Entity>;
+    template<typename Type, std::size_t Page, std::size_t Align = alignof(Type)>
+    class paged_vector {
+        static_assert(Page && ((Page & (Page - 1)) == 0));
+        static_assert(!(Align < alignof(Type)) && ((Align & (Align - 1)) == 0));
 
-        template<typename Component>
-        using pool_type = std::conditional_t<std::is_const_v<Component>, const storage<Entity, std::remove_const_t<Component>>, storage<Entity, Component>>;
+        static constexpr bool shareable = std::is_trivially_copyable_v<Type>;
 
-        template<typename Component>
-        using component_iterator_type = decltype(std::declval<pool_type<Component>>().begin());
+        struct page_deleter {
+            void operator()(Type* page) const {
+                resource->deallocate(page, Page * sizeof(Type), Align);
+            }
 
-        // we could use pool_type<Type> *..., but vs complains about it and refuses to compile for unknown reasons (most likely a bug)
-        basic_group(const typename basic_registry<Entity>::size_type* sz, storage<Entity, std::remove_const_t<Owned>>* owned, storage<Entity, std::remove_const_t<Other>>* ... other, storage<Entity, std::remove_const_t<Get>>* ... get) ENTT_NOEXCEPT
-            : length{ sz },
-            pools{ owned, other..., get... }
+            std::pmr::memory_resource* resource{};
+        };
+
+        struct page_type {
+            std::shared_ptr<Type> data{};
+            // copies share the page from then on, the first write takes a private copy
+            mutable bool exclusive{};
+            internal::write_stamp written{};
+        };
+
+        std::shared_ptr<Type> allocate() {
+            auto* mem = resource();
+            return { static_cast<Type*>(mem->allocate(Page * sizeof(Type), Align)), page_deleter{ mem }, std::pmr::polymorphic_allocator<std::byte>{ mem } };
+        }
+
+        Type* writable(const std::size_t page) {
+            auto& elem = pages[page];
+
+            if (!elem.exclusive) {
+                auto data = allocate();
+                const auto first = page * Page;
+                std::uninitialized_copy_n(elem.data.get(), count > first ? std::min(count - first, Page) : std::size_t{}, data.get());
+                elem.data = std::move(data);
+                elem.exclusive = true;
+            }
+
+            elem.written.touch();
+            return elem.data.get();
+        }
+
+    public:
+        /*! @brief Type of elements. */
+        using value_type = Type;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+
+        /*! @brief Number of elements per page. */
+        static constexpr size_type page_size = Page;
+        /*! @brief Alignment of the first element of each page. */
+        static constexpr size_type page_alignment = Align;
+
+        /**
+         * @brief Constructs an empty array that allocates from a resource.
+         * @param resource A valid memory resource.
+         */
+        explicit paged_vector(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : pages{ resource },
+            count{}
         {}
 
-        template<typename Func, typename... Strong, typename... Weak>
-        void traverse(Func func, type_list<Strong...>, type_list<Weak...>) const {
-            [[maybe_unused]] auto raw = std::make_tuple((std::get<pool_type<Strong>*>(pools)->end() - *length)...);
-            [[maybe_unused]] auto data = std::get<pool_type<Owned>*>(pools)->sparse_set<entity_type>::end() - *length;
+        /**
+         * @brief Copy constructor with a resource to allocate from.
+         *
+         * Pages of trivially copyable elements are shared with the original and
+         * still belong to the resource of the latter, only the pages allocated
+         * from now on come from the given resource.
+         *
+         * @param other The instance to copy from.
+         * @param resource A valid memory resource.
+         */
+        paged_vector(const paged_vector& other, std::pmr::memory_resource* resource)
+            : paged_vector{ resource }
+        {
+            if constexpr (shareable) {
+                pages.reserve(other.pages_size());
 
-            for (auto next = *length; next; --next) {
-                if constexpr (std::is_invocable_v < Func, decltype(get<Strong>({}))..., decltype(get<Weak>({}))... > ) {
-                    if constexpr (sizeof...(Weak) == 0) {
-                        func(*(std::get<component_iterator_type<Strong>>(raw)++)...);
-                    }
-                    else {
-                        const auto entt = *(data++);
-                        func(*(std::get<component_iterator_type<Strong>>(raw)++)..., std::get<pool_type<Weak>*>(pools)->get(entt)...);
-                    }
+                for (size_type page{}, last = other.pages_size(); page < last; ++page) {
+                    other.pages[page].exclusive = false;
+                    pages.push_back(page_type{ other.pages[page].data, false, other.pages[page].written });
                 }
-                else {
-                    const auto entt = *(data++);
-                    func(entt, *(std::get<component_iterator_type<Strong>>(raw)++)..., std::get<pool_type<Weak>*>(pools)->get(entt)...);
+
+                count = other.count;
+            }
+            else {
+                reserve(other.count);
+
+                for (size_type pos{}; pos < other.count; ++pos) {
+                    emplace_back(other[pos]);
                 }
             }
         }
 
-    public:
-        /*! @brief Underlying entity identifier. */
-        using entity_type = typename sparse_set<Entity>::entity_type;
-        /*! @brief Unsigned integer type. */
-        using size_type = typename sparse_set<Entity>::size_type;
-        /*! @brief Input iterator type. */
-        using iterator_type = typename sparse_set<Entity>::iterator_type;
+        /**
+         * @brief Copy constructor.
+         * @param other The instance to copy from.
+         */
+        paged_vector(const paged_vector& other)
+            : paged_vector{ other, other.resource() }
+        {}
 
         /**
-         * @brief Returns the number of existing components of the given type.
-         * @tparam Component Type of component of which to return the size.
-         * @return Number of existing components of the given type.
+         * @brief Move constructor.
+         * @param other The instance to move from.
          */
-        template<typename Component>
-        size_type size() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Component>*>(pools)->size();
+        paged_vector(paged_vector&& other) ENTT_NOEXCEPT
+            : pages{ std::move(other.pages) },
+            count{ std::exchange(other.count, 0) }
+        {}
+
+        /*! @brief Destroys the elements and releases the pages. */
+        ~paged_vector() {
+            clear();
         }
 
         /**
-         * @brief Returns the number of entities that have the given components.
-         * @return Number of entities that have the given components.
+         * @brief Copy assignment operator.
+         * @param other The instance to copy from.
+         * @return This array.
          */
-        size_type size() const ENTT_NOEXCEPT {
-            return *length;
+        paged_vector& operator=(const paged_vector& other) {
+            if (&other != this) {
+                auto tmp{ other };
+                *this = std::move(tmp);
+            }
+
+            return *this;
         }
 
         /**
-         * @brief Checks whether the pool of a given component is empty.
-         * @tparam Component Type of component in which one is interested.
-         * @return True if the pool of the given component is empty, false
-         * otherwise.
+         * @brief Move assignment operator.
+         * @param other The instance to move from.
+         * @return This array.
          */
-        template<typename Component>
-        bool empty() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Component>*>(pools)->empty();
+        paged_vector& operator=(paged_vector&& other) {
+            if (&other != this) {
+                clear();
+                pages = std::move(other.pages);
+                count = std::exchange(other.count, 0);
+                other.pages.clear();
+            }
+
+            return *this;
         }
 
         /**
-         * @brief Checks whether the group is empty.
-         * @return True if the group is empty, false otherwise.
+         * @brief Returns the memory resource used by the array.
+         * @return The memory resource in use.
          */
-        bool empty() const ENTT_NOEXCEPT {
-            return !*length;
+        std::pmr::memory_resource* resource() const ENTT_NOEXCEPT {
+            return pages.get_allocator().resource();
         }
 
         /**
-         * @brief Direct access to the list of components of a given pool.
-         *
-         * The returned pointer is such that range
-         * `[raw<Component>(), raw<Component>() + size<Component>()]` is always a
-         * valid range, even if the container is empty.<br/>
-         * Moreover, in case the group owns the given component, the range
-         * `[raw<Component>(), raw<Component>() + size()]` is such that it contains
-         * the instances that are part of the group itself.
-         *
-         * @note
-         * There are no guarantees on the order of the components. Use `begin` and
-         * `end` if you want to iterate the group in the expected order.
-         *
-         * @tparam Component Type of component in which one is interested.
-         * @return A pointer to the array of components.
+         * @brief Allocates pages until they can hold the given number of elements.
+         * @param cap Desired capacity.
          */
-        template<typename Component>
-        Component* raw() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Component>*>(pools)->raw();
+        void reserve(const size_type cap) {
+            while (capacity() < cap) {
+                pages.push_back(page_type{ allocate(), true });
+            }
         }
 
         /**
-         * @brief Direct access to the list of entities of a given pool.
-         *
-         * The returned pointer is such that range
-         * `[data<Component>(), data<Component>() + size<Component>()]` is always a
-         * valid range, even if the container is empty.<br/>
-         * Moreover, in case the group owns the given component, the range
-         * `[data<Component>(), data<Component>() + size()]` is such that it
-         * contains the entities that are part of the group itself.
-         *
-         * @note
-         * There are no guarantees on the order of the entities. Use `begin` and
-         * `end` if you want to iterate the group in the expected order.
-         *
-         * @tparam Component Type of component in which one is interested.
-         * @return A pointer to the array of entities.
+         * @brief Returns the number of elements the allocated pages can hold.
+         * @return Capacity of the array.
          */
-        template<typename Component>
-        const entity_type* data() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Component>*>(pools)->data();
+        size_type capacity() const ENTT_NOEXCEPT {
+            return pages.size() * Page;
+        }
+
+        /*! @brief Releases the pages past the last element. */
+        void shrink_to_fit() {
+            pages.resize((count + Page - 1) / Page);
+            pages.shrink_to_fit();
         }
 
         /**
-         * @brief Direct access to the list of entities.
-         *
-         * The returned pointer is such that range `[data(), data() + size()]` is
-         * always a valid range, even if the container is empty.
-         *
-         * @note
-         * There are no guarantees on the order of the entities. Use `begin` and
-         * `end` if you want to iterate the group in the expected order.
-         *
-         * @return A pointer to the array of entities.
+         * @brief Returns the number of elements in the array.
+         * @return Number of elements.
          */
-        const entity_type* data() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Owned>*>(pools)->data();
+        size_type size() const ENTT_NOEXCEPT {
+            return count;
         }
 
         /**
-         * @brief Returns an iterator to the first entity that has the given
-         * components.
-         *
-         * The returned iterator points to the first entity that has the given
-         * components. If the group is empty, the returned iterator will be equal to
-         * `end()`.
+         * @brief Checks whether the array is empty.
+         * @return True if the array is empty, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return !count;
+        }
+
+        /**
+         * @brief Returns the number of pages in use.
+         * @return Number of pages containing at least an element.
+         */
+        size_type pages_size() const ENTT_NOEXCEPT {
+            return (count + Page - 1) / Page;
+        }
+
+        /**
+         * @brief Returns the number of pages shared with other arrays.
          *
-         * @note
-         * Input iterators stay true to the order imposed to the underlying data
-         * structures.
+         * Pages are counted as shared from the moment they're copied to the
+         * first non-const access, even if the other arrays are already gone.
          *
-         * @return An iterator to the first entity that has the given components.
+         * @return Number of pages not yet copied since they were shared.
          */
-        iterator_type begin() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Owned>*>(pools)->sparse_set<entity_type>::end() - *length;
+        size_type shared_pages() const ENTT_NOEXCEPT {
+            return size_type(std::count_if(pages.cbegin(), pages.cend(), [](const auto& page) { return !page.exclusive; }));
         }
 
         /**
-         * @brief Returns an iterator that is past the last entity that has the
-         * given components.
+         * @brief Returns when a page was last accessed for writing.
          *
-         * The returned iterator points to the entity following the last entity that
-         * has the given components. Attempting to dereference the returned iterator
-         * results in undefined behavior.
-         *
-         * @note
-         * Input iterators stay true to the order imposed to the underlying data
-         * structures.
+         * Pages are stamped with the clock ticked by delta snapshots on every
+         * non-const access, whether they are actually modified or not.
          *
-         * @return An iterator to the entity following the last entity that has the
-         * given components.
+         * @param page A valid page index.
+         * @return The time of the last non-const access to the page.
          */
-        iterator_type end() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Owned>*>(pools)->sparse_set<entity_type>::end();
+        std::uint64_t written(const size_type page) const ENTT_NOEXCEPT {
+            return pages[page].written.get();
         }
 
         /**
-         * @brief Finds an entity.
-         * @param entt A valid entity identifier.
-         * @return An iterator to the given entity if it's found, past the end
-         * iterator otherwise.
+         * @brief Direct access to a page.
+         * @param page A valid page index.
+         * @return A pointer to the first element of the page.
          */
-        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
-            const auto it = std::get<pool_type<Owned>*>(pools)->find(entt);
-            return it != end() && it >= begin() && *it == entt ? it : end();
+        const Type* page_data(const size_type page) const ENTT_NOEXCEPT {
+            return pages[page].data.get();
+        }
+
+        /*! @copydoc page_data */
+        Type* page_data(const size_type page) {
+            return writable(page);
         }
 
         /**
-         * @brief Returns the identifier that occupies the given position.
-         * @param pos Position of the element to return.
-         * @return The identifier that occupies the given position.
+         * @brief Returns a reference to an element.
+         * @param pos A valid position.
+         * @return A reference to the element.
          */
-        entity_type operator[](const size_type pos) const ENTT_NOEXCEPT {
-            return begin()[pos];
+        const Type& operator[](const size_type pos) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(pos < count);
+            return pages[pos / Page].data.get()[pos & (Page - 1)];
+        }
+
+        /*! @copydoc operator[] */
+        Type& operator[](const size_type pos) {
+            ENTT_ASSERT(pos < count);
+            return writable(pos / Page)[pos & (Page - 1)];
         }
 
         /**
-         * @brief Checks if a group contains an entity.
-         * @param entt A valid entity identifier.
-         * @return True if the group contains the given entity, false otherwise.
+         * @brief Returns a reference to the last element.
+         * @return A reference to the last element.
          */
-        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
-            return find(entt) != end();
+        Type& back() {
+            return (*this)[count - 1];
         }
 
         /**
-         * @brief Returns the components assigned to the given entity.
-         *
-         * Prefer this function instead of `registry::get` during iterations. It has
-         * far better performance than its companion function.
-         *
-         * @warning
-         * Attempting to use an invalid component type results in a compilation
-         * error. Attempting to use an entity that doesn't belong to the group
-         * results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * group doesn't contain the given entity.
-         *
-         * @tparam Component Types of components to get.
-         * @param entt A valid entity identifier.
-         * @return The components assigned to the entity.
+         * @brief Constructs an element at the end of the array.
+         * @tparam Args Types of arguments to use to construct the element.
+         * @param args Parameters to use to construct the element.
+         * @return A reference to the newly created element.
          */
-        template<typename... Component>
-        decltype(auto) get([[maybe_unused]] const entity_type entt) const ENTT_NOEXCEPT {
-            ENTT_ASSERT(contains(entt));
+        template<typename... Args>
+        Type& emplace_back(Args&& ... args) {
+            reserve(count + 1);
+            auto* elem = new (writable(count / Page) + (count & (Page - 1))) Type(std::forward<Args>(args)...);
+            return ++count, * elem;
+        }
 
-            if constexpr (sizeof...(Component) == 1) {
-                return (std::get<pool_type<Component>*>(pools)->get(entt), ...);
-            }
-            else {
-                return std::tuple<decltype(get<Component>(entt))...>{get<Component>(entt)...};
+        /**
+         * @brief Appends copies of a range of elements.
+         * @tparam It Type of input iterator.
+         * @param first An iterator to the first element of the range.
+         * @param last An iterator past the last element of the range.
+         */
+        template<typename It>
+        void append(It first, It last) {
+            reserve(count + std::distance(first, last));
+
+            while (first != last) {
+                emplace_back(*(first++));
             }
         }
 
         /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a set of references to all its components. The
-         * _constness_ of the components is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
-         *
-         * @code{.cpp}
-         * void(const entity_type, Owned &, Other &..., Get &...);
-         * void(Owned &, Other &..., Get &...);
-         * @endcode
+         * @brief Appends elements that live in a block of memory owned elsewhere.
          *
-         * @note
-         * Empty types aren't explicitly instantiated. Therefore, temporary objects
-         * are returned during iterations. They can be caught only by copy or with
-         * const references.
+         * Pages are carved out of the block rather than allocated. They're shared
+         * with the block and copied on the first non-const access, as the pages
+         * of a copy are. Elements are copied instead if the array doesn't end on
+         * a page boundary or if the pages carved out of the block wouldn't be
+         * aligned as those allocated by the array.
          *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @param data A block of elements, kept alive as long as it's referred.
+         * @param sz Number of elements in the block.
          */
-        template<typename Func>
-        void each(Func func) const {
-            traverse(std::move(func), type_list<Owned, Other...>{}, type_list<Get...>{});
+        void adopt(const std::shared_ptr<const Type>& data, const size_type sz) {
+            static_assert(shareable);
+
+            if ((count & (Page - 1)) || ((Page * sizeof(Type)) % Align) || (reinterpret_cast<std::uintptr_t>(data.get()) % Align)) {
+                append(data.get(), data.get() + sz);
+            }
+            else {
+                pages.resize(count / Page);
+
+                for (size_type first{}; first < sz; first += Page) {
+                    // the block itself is never written, pages are copied first
+                    pages.push_back(page_type{ std::shared_ptr<Type>{ data, const_cast<Type*>(data.get() + first) }, false });
+                    pages.back().written.touch();
+                }
+
+                count += sz;
+            }
+        }
+
+        /*! @brief Destroys the last element. */
+        void pop_back() {
+            if constexpr (!std::is_trivially_destructible_v<Type>) {
+                back().~Type();
+            }
+
+            --count;
         }
 
         /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a set of references to non-empty components. The
-         * _constness_ of the components is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
-         *
-         * @code{.cpp}
-         * void(const entity_type, Type &...);
-         * void(Type &...);
-         * @endcode
-         *
-         * @sa each
-         *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @brief Resizes the array, copying a value in the new slots.
+         * @param sz New number of elements.
+         * @param value Value to copy in the new slots.
          */
-        template<typename Func>
-        void less(Func func) const {
-            using owned_type_list = std::conditional_t<std::is_empty_v<Owned>, type_list<>, type_list<Owned>>;
-            using other_type_list = type_list_cat_t<std::conditional_t<std::is_empty_v<Other>, type_list<>, type_list<Other>>...>;
-            using get_type_list = type_list_cat_t<std::conditional_t<std::is_empty_v<Get>, type_list<>, type_list<Get>>...>;
-            traverse(std::move(func), type_list_cat_t<owned_type_list, other_type_list>{}, get_type_list{});
+        void resize(const size_type sz, const Type& value) {
+            reserve(sz);
+
+            while (count < sz) {
+                emplace_back(value);
+            }
+
+            while (count > sz) {
+                pop_back();
+            }
         }
 
         /**
-         * @brief Sort a group according to the given comparison function.
-         *
-         * Sort the group so that iterating it with a couple of iterators returns
-         * entities and components in the expected order. See `begin` and `end` for
-         * more details.
-         *
-         * The comparison function object must return `true` if the first element
-         * is _less_ than the second one, `false` otherwise. The signature of the
-         * comparison function should be equivalent to one of the following:
-         *
-         * @code{.cpp}
-         * bool(std::tuple<Component &...>, std::tuple<Component &...>);
-         * bool(const Component &, const Component &);
-         * bool(const Entity, const Entity);
-         * @endcode
-         *
-         * Where `Component` are either owned types or not but still such that they
-         * are iterated by the group.<br/>
-         * Moreover, the comparison function object shall induce a
-         * _strict weak ordering_ on the values.
-         *
-         * The sort function oject must offer a member function template
-         * `operator()` that accepts three arguments:
-         *
-         * * An iterator to the first element of the range to sort.
-         * * An iterator past the last element of the range to sort.
-         * * A comparison function to use to compare the elements.
-         *
-         * The comparison function object received by the sort function object
-         * hasn't necessarily the type of the one passed along with the other
-         * parameters to this member function.
-         *
-         * @note
-         * Attempting to iterate elements using a raw pointer returned by a call to
-         * either `data` or `raw` gives no guarantees on the order, even though
-         * `sort` has been invoked.
-         *
-         * @tparam Component Optional types of components to compare.
-         * @tparam Compare Type of comparison function object.
-         * @tparam Sort Type of sort function object.
-         * @tparam Args Types of arguments to forward to the sort function object.
-         * @param compare A valid comparison function object.
-         * @param algo A valid sort function object.
-         * @param args Arguments to forward to the sort function object, if any.
+         * @brief Resizes the array, value initializing the new slots.
+         * @param sz New number of elements.
          */
-        template<typename... Component, typename Compare, typename Sort = std_sort, typename... Args>
-        void sort(Compare compare, Sort algo = Sort{}, Args&& ... args) {
-            auto* cpool = std::get<pool_type<Owned>*>(pools);
+        void resize(const size_type sz) {
+            reserve(sz);
 
-            if constexpr (sizeof...(Component) == 0) {
-                static_assert(std::is_invocable_v<Compare, const entity_type, const entity_type>);
-                cpool->sort(cpool->end() - *length, cpool->end(), std::move(compare), std::move(algo), std::forward<Args>(args)...);
+            while (count < sz) {
+                emplace_back();
             }
-            else {
-                cpool->sort(cpool->end() - *length, cpool->end(), [this, compare = std::move(compare)](const entity_type lhs, const entity_type rhs) {
-                    // useless this-> used to suppress a warning with clang
-                    return compare(this->get<Component...>(lhs), this->get<Component...>(rhs));
-                }, std::move(algo), std::forward<Args>(args)...);
+
+            while (count > sz) {
+                pop_back();
             }
+        }
 
-            for (auto next = *length; next; --next) {
-                const auto pos = next - 1;
-                const auto entt = cpool->data()[pos];
-                (std::get<pool_type<Other>*>(pools)->swap(pos, std::get<pool_type<Other>*>(pools)->index(entt)), ...);
+        /*! @brief Destroys all the elements, the pages are kept. */
+        void clear() {
+            if constexpr (std::is_trivially_destructible_v<Type>) {
+                count = {};
+            }
+            else {
+                while (count) {
+                    pop_back();
+                }
             }
         }
 
     private:
-        const typename basic_registry<Entity>::size_type* length;
-        const std::tuple<pool_type<Owned>*, pool_type<Other>* ..., pool_type<Get>* ...> pools;
+        std::pmr::vector<page_type> pages;
+        size_type count;
     };
 
 
-}
+    /**
+     * @cond TURN_OFF_DOXYGEN
+     * Internal details not to be documented.
+     */
 
 
-#endif // ENTT_ENTITY_GROUP_HPP
+    namespace internal {
 
-// #include "view.hpp"
-#ifndef ENTT_ENTITY_VIEW_HPP
-#define ENTT_ENTITY_VIEW_HPP
 
+        template<typename Type, std::size_t Align>
+        class aligned_allocator {
+            static_assert(!(Align < alignof(Type)) && ((Align & (Align - 1)) == 0));
 
-#include <iterator>
-#include <array>
-#include <tuple>
-#include <utility>
-#include <algorithm>
-#include <type_traits>
-// #include "../config/config.h"
+        public:
+            using value_type = Type;
 
-// #include "../core/type_traits.hpp"
+            template<typename Other>
+            struct rebind {
+                using other = aligned_allocator<Other, Align>;
+            };
 
-// #include "sparse_set.hpp"
+            // implicit on purpose, it stands in for a polymorphic allocator
+            aligned_allocator(std::pmr::memory_resource* ref = std::pmr::get_default_resource()) ENTT_NOEXCEPT
+                : mem{ ref }
+            {}
 
-// #include "storage.hpp"
+            template<typename Other>
+            aligned_allocator(const aligned_allocator<Other, Align>& other) ENTT_NOEXCEPT
+                : mem{ other.resource() }
+            {}
 
-// #include "entity.hpp"
+            Type* allocate(const std::size_t count) {
+                return static_cast<Type*>(mem->allocate(count * sizeof(Type), Align));
+            }
 
-// #include "fwd.hpp"
+            void deallocate(Type* ptr, const std::size_t count) {
+                mem->deallocate(ptr, count * sizeof(Type), Align);
+            }
 
+            aligned_allocator select_on_container_copy_construction() const ENTT_NOEXCEPT {
+                return {};
+            }
 
+            std::pmr::memory_resource* resource() const ENTT_NOEXCEPT {
+                return mem;
+            }
 
-namespace entt {
+            template<typename Other>
+            bool operator==(const aligned_allocator<Other, Align>& other) const ENTT_NOEXCEPT {
+                return *mem == *other.resource();
+            }
 
+            template<typename Other>
+            bool operator!=(const aligned_allocator<Other, Align>& other) const ENTT_NOEXCEPT {
+                return !(*this == other);
+            }
 
-    /**
-     * @brief Multi component view.
-     *
-     * Multi component views iterate over those entities that have at least all the
-     * given components in their bags. During initialization, a multi component view
-     * looks at the number of entities available for each component and picks up a
-     * reference to the smallest set of candidate entities in order to get a
-     * performance boost when iterate.<br/>
-     * Order of elements during iterations are highly dependent on the order of the
-     * underlying data structures. See sparse_set and its specializations for more
-     * details.
-     *
-     * @b Important
-     *
-     * Iterators aren't invalidated if:
-     *
-     * * New instances of the given components are created and assigned to entities.
-     * * The entity currently pointed is modified (as an example, if one of the
-     *   given components is removed from the entity to which the iterator points).
-     * * The entity currently pointed is destroyed.
-     *
-     * In all the other cases, modifying the pools of the given components in any
-     * way invalidates all the iterators and using them results in undefined
-     * behavior.
-     *
-     * @note
-     * Views share references to the underlying data structures of the registry that
-     * generated them. Therefore any change to the entities and to the components
-     * made by means of the registry are immediately reflected by views.
-     *
-     * @warning
-     * Lifetime of a view must overcome the one of the registry that generated it.
-     * In any other case, attempting to use a view results in undefined behavior.
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
-     * @tparam Component Types of components iterated by the view.
-     */
-    template<typename Entity, typename... Component>
-    class basic_view {
-        static_assert(sizeof...(Component) > 1);
+        private:
+            std::pmr::memory_resource* mem;
+        };
 
-        /*! @brief A registry is allowed to create views. */
-        friend class basic_registry<Entity>;
 
-        template<typename Comp>
-        using pool_type = std::conditional_t<std::is_const_v<Comp>, const storage<Entity, std::remove_const_t<Comp>>, storage<Entity, Comp>>;
+        template<typename Source>
+        class chunk_range {
+            using size_type = typename Source::size_type;
 
-        template<typename Comp>
-        using component_iterator_type = decltype(std::declval<pool_type<Comp>>().begin());
+            class chunk_iterator {
+                friend class chunk_range<Source>;
 
-        using underlying_iterator_type = typename sparse_set<Entity>::iterator_type;
-        using unchecked_type = std::array<const sparse_set<Entity>*, (sizeof...(Component) - 1)>;
-        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+                chunk_iterator(const Source& ref, const size_type from, const size_type len) ENTT_NOEXCEPT
+                    : source{ ref }, pos{ from }, chunk{ len }
+                {}
 
-        class iterator {
-            friend class basic_view<Entity, Component...>;
+            public:
+                using difference_type = std::ptrdiff_t;
+                using value_type = decltype(std::declval<const Source&>().chunk_at(size_type{}, size_type{}));
+                using pointer = void;
+                using reference = value_type;
+                using iterator_category = std::input_iterator_tag;
 
-            iterator(unchecked_type other, underlying_iterator_type first, underlying_iterator_type last) ENTT_NOEXCEPT
-                : unchecked{ other },
-                begin{ first },
-                end{ last }
-            {
-                if (begin != end && !valid()) {
-                    ++(*this);
+                chunk_iterator& operator++() {
+                    return pos += std::get<std::tuple_size_v<value_type> - 1>(**this), * this;
                 }
-            }
 
-            bool valid() const ENTT_NOEXCEPT {
-                return std::all_of(unchecked.cbegin(), unchecked.cend(), [this](const sparse_set<Entity>* view) {
-                    return view->has(*begin);
-                });
-            }
+                chunk_iterator operator++(int) {
+                    chunk_iterator orig = *this;
+                    return ++(*this), orig;
+                }
 
-        public:
-            using difference_type = typename underlying_iterator_type::difference_type;
-            using value_type = typename underlying_iterator_type::value_type;
-            using pointer = typename underlying_iterator_type::pointer;
-            using reference = typename underlying_iterator_type::reference;
-            using iterator_category = std::forward_iterator_tag;
+                bool operator==(const chunk_iterator& other) const ENTT_NOEXCEPT {
+                    return other.pos == pos;
+                }
+
+                bool operator!=(const chunk_iterator& other) const ENTT_NOEXCEPT {
+                    return !(*this == other);
+                }
+
+                reference operator*() const {
+                    return source.chunk_at(pos, chunk);
+                }
+
+            private:
+                // views and groups are handles, copies keep temporaries out of the picture
+                Source source;
+                size_type pos;
+                size_type chunk;
+            };
+
+        public:
+            using iterator_type = chunk_iterator;
+
+            chunk_range(const Source& ref, const size_type len) ENTT_NOEXCEPT
+                : source{ ref }, chunk{ len }
+            {}
+
+            iterator_type begin() const ENTT_NOEXCEPT {
+                return { source, 0u, chunk };
+            }
+
+            iterator_type end() const ENTT_NOEXCEPT {
+                return { source, source.size(), chunk };
+            }
+
+        private:
+            Source source;
+            size_type chunk;
+        };
+
+
+    }
+
+
+    /**
+     * Internal details not to be documented.
+     * @endcond TURN_OFF_DOXYGEN
+     */
+
+
+    /**
+     * @brief Basic storage implementation.
+     *
+     * This class is a refinement of a sparse set that associates an object to an
+     * entity. The main purpose of this class is to extend sparse sets to store
+     * components in a registry. It guarantees fast access both to the elements and
+     * to the entities.
+     *
+     * @note
+     * Entities and objects have the same order. It's guaranteed both in case of raw
+     * access (either to entities or objects) and when using random or input access
+     * iterators.
+     *
+     * @note
+     * Internal data structures arrange elements to maximize performance. Because of
+     * that, there are no guarantees that elements have the expected order when
+     * iterate directly the internal packed array (see `raw` and `size` member
+     * functions for that). Use `begin` and `end` instead.
+     *
+     * @warning
+     * Empty types aren't explicitly instantiated. Temporary objects are returned in
+     * place of the instances of the components and raw access isn't available for
+     * them.
+     *
+     * @sa sparse_set<Entity>
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * @tparam Type Type of objects assigned to the entities.
+     */
+    template<typename Entity, typename Type, typename = std::void_t<>>
+    class basic_storage : public sparse_set<Entity> {
+        using underlying_type = sparse_set<Entity>;
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+
+        static constexpr auto instance_page = internal::instance_page_v<Type>;
+        static constexpr auto instance_alignment = internal::instance_alignment_v<Type>;
+        using container_type = std::conditional_t<instance_page == 0, std::vector<Type, internal::aligned_allocator<Type, instance_alignment>>, paged_vector<Type, instance_page, instance_alignment>>;
+
+        template<bool Const>
+        class iterator {
+            friend class basic_storage<Entity, Type>;
+
+            using instance_type = std::conditional_t<Const, const container_type, container_type>;
+            using index_type = typename traits_type::difference_type;
+
+            iterator(instance_type* ref, const index_type idx) ENTT_NOEXCEPT
+                : instances{ ref }, index{ idx }
+            {}
+
+        public:
+            using difference_type = index_type;
+            using value_type = Type;
+            using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+            using reference = std::conditional_t<Const, const value_type&, value_type&>;
+            using iterator_category = std::random_access_iterator_tag;
 
             iterator() ENTT_NOEXCEPT = default;
 
             iterator& operator++() ENTT_NOEXCEPT {
-                return (++begin != end && !valid()) ? ++(*this) : *this;
+                return --index, * this;
             }
 
             iterator operator++(int) ENTT_NOEXCEPT {
@@ -6544,2714 +7616,6586 @@ namespace entt {
                 return ++(*this), orig;
             }
 
-            bool operator==(const iterator& other) const ENTT_NOEXCEPT {
-                return other.begin == begin;
+            iterator& operator--() ENTT_NOEXCEPT {
+                return ++index, * this;
             }
 
-            bool operator!=(const iterator& other) const ENTT_NOEXCEPT {
-                return !(*this == other);
+            iterator operator--(int) ENTT_NOEXCEPT {
+                iterator orig = *this;
+                return --(*this), orig;
             }
 
-            pointer operator->() const ENTT_NOEXCEPT {
-                return begin.operator->();
+            iterator& operator+=(const difference_type value) ENTT_NOEXCEPT {
+                index -= value;
+                return *this;
             }
 
-            reference operator*() const ENTT_NOEXCEPT {
-                return *operator->();
+            iterator operator+(const difference_type value) const ENTT_NOEXCEPT {
+                return iterator{ instances, index - value };
             }
 
-        private:
-            unchecked_type unchecked;
-            underlying_iterator_type begin;
-            underlying_iterator_type end;
-        };
+            iterator& operator-=(const difference_type value) ENTT_NOEXCEPT {
+                return (*this += -value);
+            }
 
-        // we could use pool_type<Component> *..., but vs complains about it and refuses to compile for unknown reasons (likely a bug)
-        basic_view(storage<Entity, std::remove_const_t<Component>>* ... ref) ENTT_NOEXCEPT
-            : pools{ ref... }
-        {}
+            iterator operator-(const difference_type value) const ENTT_NOEXCEPT {
+                return (*this + -value);
+            }
 
-        const sparse_set<Entity>* candidate() const ENTT_NOEXCEPT {
-            return std::min({ static_cast<const sparse_set<Entity>*>(std::get<pool_type<Component>*>(pools))... }, [](const auto* lhs, const auto* rhs) {
-                return lhs->size() < rhs->size();
-            });
-        }
+            difference_type operator-(const iterator& other) const ENTT_NOEXCEPT {
+                return other.index - index;
+            }
 
-        unchecked_type unchecked(const sparse_set<Entity>* view) const ENTT_NOEXCEPT {
-            unchecked_type other{};
-            typename unchecked_type::size_type pos{};
-            ((std::get<pool_type<Component>*>(pools) == view ? nullptr : (other[pos++] = std::get<pool_type<Component>*>(pools))), ...);
-            return other;
-        }
+            reference operator[](const difference_type value) const ENTT_NOEXCEPT {
+                const auto pos = size_type(index - value - 1);
+                return (*instances)[pos];
+            }
 
-        template<typename Comp, typename Other>
-        decltype(auto) get([[maybe_unused]] component_iterator_type<Comp> it, [[maybe_unused]] pool_type<Other>* cpool, [[maybe_unused]] const Entity entt) const ENTT_NOEXCEPT {
-            if constexpr (std::is_same_v<Comp, Other>) {
-                return *it;
+            bool operator==(const iterator& other) const ENTT_NOEXCEPT {
+                return other.index == index;
             }
-            else {
-                return cpool->get(entt);
+
+            bool operator!=(const iterator& other) const ENTT_NOEXCEPT {
+                return !(*this == other);
             }
-        }
 
-        template<typename Comp, typename Func, typename... Other, typename... Type>
-        void traverse(Func func, type_list<Other...>, type_list<Type...>) const {
-            const auto end = std::get<pool_type<Comp>*>(pools)->sparse_set<Entity>::end();
-            auto begin = std::get<pool_type<Comp>*>(pools)->sparse_set<Entity>::begin();
+            bool operator<(const iterator& other) const ENTT_NOEXCEPT {
+                return index > other.index;
+            }
 
-            if constexpr (std::disjunction_v<std::is_same<Comp, Type>...>) {
-                std::for_each(begin, end, [this, raw = std::get<pool_type<Comp>*>(pools)->begin(), &func](const auto entity) mutable {
-                    auto curr = raw++;
+            bool operator>(const iterator& other) const ENTT_NOEXCEPT {
+                return index < other.index;
+            }
 
-                    if ((std::get<pool_type<Other>*>(pools)->has(entity) && ...)) {
-                        if constexpr (std::is_invocable_v < Func, decltype(get<Type>({}))... > ) {
-                            func(get<Comp, Type>(curr, std::get<pool_type<Type>*>(pools), entity)...);
-                        }
-                        else {
-                            func(entity, get<Comp, Type>(curr, std::get<pool_type<Type>*>(pools), entity)...);
-                        }
-                    }
-                });
+            bool operator<=(const iterator& other) const ENTT_NOEXCEPT {
+                return !(*this > other);
             }
-            else {
-                std::for_each(begin, end, [this, &func](const auto entity) mutable {
-                    if ((std::get<pool_type<Other>*>(pools)->has(entity) && ...)) {
-                        if constexpr (std::is_invocable_v < Func, decltype(get<Type>({}))... > ) {
-                            func(std::get<pool_type<Type>*>(pools)->get(entity)...);
-                        }
-                        else {
-                            func(entity, std::get<pool_type<Type>*>(pools)->get(entity)...);
-                        }
-                    }
-                });
+
+            bool operator>=(const iterator& other) const ENTT_NOEXCEPT {
+                return !(*this < other);
             }
-        }
+
+            pointer operator->() const ENTT_NOEXCEPT {
+                const auto pos = size_type(index - 1);
+                return &(*instances)[pos];
+            }
+
+            reference operator*() const ENTT_NOEXCEPT {
+                return *operator->();
+            }
+
+        private:
+            instance_type* instances;
+            index_type index;
+        };
 
     public:
+        /*! @brief Type of the objects associated with the entities. */
+        using object_type = Type;
         /*! @brief Underlying entity identifier. */
         using entity_type = Entity;
         /*! @brief Unsigned integer type. */
         using size_type = std::size_t;
-        /*! @brief Input iterator type. */
-        using iterator_type = iterator;
+        /*! @brief Random access iterator type. */
+        using iterator_type = iterator<false>;
+        /*! @brief Constant random access iterator type. */
+        using const_iterator_type = iterator<true>;
 
-        /**
-         * @brief Returns the number of existing components of the given type.
-         * @tparam Comp Type of component of which to return the size.
-         * @return Number of existing components of the given type.
-         */
-        template<typename Comp>
-        size_type size() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Comp>*>(pools)->size();
-        }
+        /*! @brief Default constructor. */
+        basic_storage()
+            : basic_storage{ std::pmr::get_default_resource() }
+        {}
 
         /**
-         * @brief Estimates the number of entities that have the given components.
-         * @return Estimated number of entities that have the given components.
+         * @brief Constructs an empty storage that allocates from a resource.
+         * @param resource A valid memory resource.
+         * @param page Size in bytes of a sparse page, zero for the compact mode.
          */
-        size_type size() const ENTT_NOEXCEPT {
-            return std::min({ std::get<pool_type<Component>*>(pools)->size()... });
-        }
+        explicit basic_storage(std::pmr::memory_resource* resource, const size_type page = ENTT_PAGE_SIZE)
+            : underlying_type{ resource, page },
+            instances{ resource }
+        {}
 
         /**
-         * @brief Checks whether the pool of a given component is empty.
-         * @tparam Comp Type of component in which one is interested.
-         * @return True if the pool of the given component is empty, false
-         * otherwise.
+         * @brief Copy constructor.
+         *
+         * The copy allocates from the same memory resource as the original.
+         *
+         * @param other The instance to copy from.
          */
-        template<typename Comp>
-        bool empty() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Comp>*>(pools)->empty();
-        }
+        basic_storage(const basic_storage& other)
+            : underlying_type{ other },
+            instances{ other.instances, other.resource() },
+            stamp{ other.stamp }
+        {}
+
+        /*! @brief Default move constructor. */
+        basic_storage(basic_storage&&) = default;
 
         /**
-         * @brief Checks if the view is definitely empty.
-         * @return True if the view is definitely empty, false otherwise.
+         * @brief Copy assignment operator.
+         * @param other The instance to copy from.
+         * @return This storage.
          */
-        bool empty() const ENTT_NOEXCEPT {
-            return (std::get<pool_type<Component>*>(pools)->empty() || ...);
+        basic_storage& operator=(const basic_storage& other) {
+            if (&other != this) {
+                auto tmp{ other };
+                *this = std::move(tmp);
+            }
+
+            return *this;
         }
 
+        /*! @brief Default move assignment operator. @return This storage. */
+        basic_storage& operator=(basic_storage&&) = default;
+
         /**
-         * @brief Direct access to the list of components of a given pool.
-         *
-         * The returned pointer is such that range
-         * `[raw<Comp>(), raw<Comp>() + size<Comp>()]` is always a valid range, even
-         * if the container is empty.
+         * @brief Increases the capacity of a storage.
          *
-         * @note
-         * There are no guarantees on the order of the components. Use `begin` and
-         * `end` if you want to iterate the view in the expected order.
+         * If the new capacity is greater than the current capacity, new storage is
+         * allocated, otherwise the method does nothing.
          *
-         * @tparam Comp Type of component in which one is interested.
-         * @return A pointer to the array of components.
+         * @param cap Desired capacity.
          */
-        template<typename Comp>
-        Comp* raw() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Comp>*>(pools)->raw();
+        void reserve(const size_type cap) {
+            underlying_type::reserve(cap);
+            instances.reserve(cap);
+        }
+
+        /*! @brief Requests the removal of unused capacity. */
+        void shrink_to_fit() {
+            underlying_type::shrink_to_fit();
+            instances.shrink_to_fit();
         }
 
         /**
-         * @brief Direct access to the list of entities of a given pool.
-         *
-         * The returned pointer is such that range
-         * `[data<Comp>(), data<Comp>() + size<Comp>()]` is always a valid range,
-         * even if the container is empty.
+         * @brief Returns the number of objects that a storage has currently
+         * allocated space for.
          *
-         * @note
-         * There are no guarantees on the order of the entities. Use `begin` and
-         * `end` if you want to iterate the view in the expected order.
+         * It can differ from the capacity of the underlying sparse set, most
+         * notably for paged storage classes.
          *
-         * @tparam Comp Type of component in which one is interested.
-         * @return A pointer to the array of entities.
+         * @return Capacity of the array of objects.
          */
-        template<typename Comp>
-        const entity_type* data() const ENTT_NOEXCEPT {
-            return std::get<pool_type<Comp>*>(pools)->data();
+        size_type object_capacity() const ENTT_NOEXCEPT {
+            return instances.capacity();
         }
 
         /**
-         * @brief Returns an iterator to the first entity that has the given
-         * components.
+         * @brief Direct access to the array of objects.
          *
-         * The returned iterator points to the first entity that has the given
-         * components. If the view is empty, the returned iterator will be equal to
-         * `end()`.
+         * The returned pointer is such that range `[raw(), raw() + size()]` is
+         * always a valid range, even if the container is empty.
          *
          * @note
-         * Input iterators stay true to the order imposed to the underlying data
-         * structures.
+         * There are no guarantees on the order, even though either `sort` or
+         * `respect` has been previously invoked. Internal data structures arrange
+         * elements to maximize performance. Accessing them directly gives a
+         * performance boost but less guarantees. Use `begin` and `end` if you want
+         * to iterate the storage in the expected order.
          *
-         * @return An iterator to the first entity that has the given components.
+         * @warning
+         * Paged storage classes don't have a single array of objects and cannot
+         * offer this function.
+         *
+         * @return A pointer to the array of objects.
          */
-        iterator_type begin() const ENTT_NOEXCEPT {
-            const auto* view = candidate();
-            return iterator_type{ unchecked(view), view->begin(), view->end() };
+        const object_type* raw() const ENTT_NOEXCEPT {
+            static_assert(instance_page == 0);
+            return instances.data();
+        }
+
+        /*! @copydoc raw */
+        object_type* raw() ENTT_NOEXCEPT {
+            static_assert(instance_page == 0);
+            return mutate().data();
         }
 
         /**
-         * @brief Returns an iterator that is past the last entity that has the
-         * given components.
-         *
-         * The returned iterator points to the entity following the last entity that
-         * has the given components. Attempting to dereference the returned iterator
-         * results in undefined behavior.
+         * @brief Direct access to the object at a given position of the packed
+         * array.
          *
-         * @note
-         * Input iterators stay true to the order imposed to the underlying data
-         * structures.
+         * Unlike the overload without arguments, it's available for paged storage
+         * classes too. The returned pointer is such that range
+         * `[raw(pos), raw(pos) + contiguous(pos)]` is always a valid range.
          *
-         * @return An iterator to the entity following the last entity that has the
-         * given components.
+         * @param pos A valid position in the packed array.
+         * @return A pointer to the object at the given position.
          */
-        iterator_type end() const ENTT_NOEXCEPT {
-            const auto* view = candidate();
-            return iterator_type{ unchecked(view), view->end(), view->end() };
+        const object_type* raw(const size_type pos) const ENTT_NOEXCEPT {
+            return &instances[pos];
         }
 
-        /**
-         * @brief Finds an entity.
-         * @param entt A valid entity identifier.
-         * @return An iterator to the given entity if it's found, past the end
-         * iterator otherwise.
-         */
-        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
-            const auto* view = candidate();
-            iterator_type it{ unchecked(view), view->find(entt), view->end() };
-            return (it != end() && *it == entt) ? it : end();
+        /*! @copydoc raw */
+        object_type* raw(const size_type pos) {
+            return &mutate()[pos];
         }
 
         /**
-         * @brief Checks if a view contains an entity.
-         * @param entt A valid entity identifier.
-         * @return True if the view contains the given entity, false otherwise.
+         * @brief Returns the number of objects laid out contiguously from a given
+         * position of the packed array.
+         * @param pos A valid position in the packed array.
+         * @return Number of contiguous objects, the first one included.
          */
-        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
-            return find(entt) != end();
+        size_type contiguous(const size_type pos) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(pos < instances.size());
+
+            if constexpr (instance_page == 0) {
+                return instances.size() - pos;
+            }
+            else {
+                return std::min(instances.size() - pos, instance_page - (pos & (instance_page - 1)));
+            }
         }
 
         /**
-         * @brief Returns the components assigned to the given entity.
+         * @brief Returns a strided view of the objects laid out contiguously from
+         * a given position of the packed array.
          *
-         * Prefer this function instead of `registry::get` during iterations. It has
-         * far better performance than its companion function.
+         * The view covers `contiguous(pos)` objects, that is all of them from the
+         * given position unless the storage class is a paged one. Views of paged
+         * storage classes end where pages end, visit the whole array with:
          *
-         * @warning
-         * Attempting to use an invalid component type results in a compilation
-         * error. Attempting to use an entity that doesn't belong to the view
-         * results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * view doesn't contain the given entity.
+         * @code{.cpp}
+         * for(std::size_t pos{}; pos < storage.size(); pos += storage.strided(pos).size()) {
+         *     // ...
+         * }
+         * @endcode
          *
-         * @tparam Comp Types of components to get.
-         * @param entt A valid entity identifier.
-         * @return The components assigned to the entity.
+         * @param pos A valid position in the packed array, or zero.
+         * @return A view of the objects from the given position.
          */
-        template<typename... Comp>
-        decltype(auto) get([[maybe_unused]] const entity_type entt) const ENTT_NOEXCEPT {
-            ENTT_ASSERT(contains(entt));
+        strided_view<const object_type> strided(const size_type pos = 0u) const ENTT_NOEXCEPT {
+            return instances.size() ? strided_view<const object_type>{ raw(pos), contiguous(pos), sizeof(object_type) } : strided_view<const object_type>{};
+        }
 
-            if constexpr (sizeof...(Comp) == 1) {
-                return (std::get<pool_type<Comp>*>(pools)->get(entt), ...);
+        /*! @copydoc strided */
+        strided_view<object_type> strided(const size_type pos = 0u) {
+            return instances.size() ? strided_view<object_type>{ raw(pos), contiguous(pos), sizeof(object_type) } : strided_view<object_type>{};
+        }
+
+        /**
+         * @brief Returns when the objects around a given position of the packed
+         * array were last accessed for writing.
+         *
+         * Every non-const access to the objects is stamped with the clock ticked
+         * by delta snapshots, whether they are actually modified or not. Paged
+         * storage classes keep a stamp per page, the others one for all the
+         * objects.
+         *
+         * @param pos A valid position in the packed array.
+         * @return The time of the last non-const access to the objects.
+         */
+        std::uint64_t written([[maybe_unused]] const size_type pos) const ENTT_NOEXCEPT {
+            if constexpr (instance_page == 0) {
+                return stamp.get();
             }
             else {
-                return std::tuple<decltype(get<Comp>(entt))...>{get<Comp>(entt)...};
+                return instances.written(pos / instance_page);
             }
         }
 
         /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a set of references to all its components. The
-         * _constness_ of the components is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
+         * @brief Returns an iterator to the beginning.
          *
-         * @code{.cpp}
-         * void(const entity_type, Component &...);
-         * void(Component &...);
-         * @endcode
+         * The returned iterator points to the first instance of the given type. If
+         * the storage is empty, the returned iterator will be equal to `end()`.
          *
          * @note
-         * Empty types aren't explicitly instantiated. Therefore, temporary objects
-         * are returned during iterations. They can be caught only by copy or with
-         * const references.
+         * Random access iterators stay true to the order imposed by a call to
+         * either `sort` or `respect`.
          *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @return An iterator to the first instance of the given type.
          */
-        template<typename Func>
-        void each(Func func) const {
-            const auto* view = candidate();
-            ((std::get<pool_type<Component>*>(pools) == view ? each<Component>(std::move(func)) : void()), ...);
+        const_iterator_type cbegin() const ENTT_NOEXCEPT {
+            const typename traits_type::difference_type pos = underlying_type::size();
+            return const_iterator_type{ &instances, pos };
+        }
+
+        /*! @copydoc cbegin */
+        const_iterator_type begin() const ENTT_NOEXCEPT {
+            return cbegin();
+        }
+
+        /*! @copydoc begin */
+        iterator_type begin() ENTT_NOEXCEPT {
+            const typename traits_type::difference_type pos = underlying_type::size();
+            return iterator_type{ &mutate(), pos };
         }
 
         /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a set of references to all its components. The
-         * _constness_ of the components is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
-         *
-         * @code{.cpp}
-         * void(const entity_type, Component &...);
-         * void(Component &...);
-         * @endcode
+         * @brief Returns an iterator to the end.
          *
-         * The pool of the suggested component is used to lead the iterations. The
-         * returned entities will therefore respect the order of the pool associated
-         * with that type.<br/>
-         * It is no longer guaranteed that the performance is the best possible, but
-         * there will be greater control over the order of iteration.
+         * The returned iterator points to the element following the last instance
+         * of the given type. Attempting to dereference the returned iterator
+         * results in undefined behavior.
          *
          * @note
-         * Empty types aren't explicitly instantiated. Therefore, temporary objects
-         * are returned during iterations. They can be caught only by copy or with
-         * const references.
+         * Random access iterators stay true to the order imposed by a call to
+         * either `sort` or `respect`.
          *
-         * @tparam Comp Type of component to use to enforce the iteration order.
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @return An iterator to the element following the last instance of the
+         * given type.
          */
-        template<typename Comp, typename Func>
-        void each(Func func) const {
-            using other_type = type_list_cat_t<std::conditional_t<std::is_same_v<Comp, Component>, type_list<>, type_list<Component>>...>;
-            traverse<Comp>(std::move(func), other_type{}, type_list<Component...>{});
+        const_iterator_type cend() const ENTT_NOEXCEPT {
+            return const_iterator_type{ &instances, {} };
+        }
+
+        /*! @copydoc cend */
+        const_iterator_type end() const ENTT_NOEXCEPT {
+            return cend();
+        }
+
+        /*! @copydoc end */
+        iterator_type end() ENTT_NOEXCEPT {
+            return iterator_type{ &mutate(), {} };
         }
 
         /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a set of references to non-empty components. The
-         * _constness_ of the components is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
-         *
-         * @code{.cpp}
-         * void(const entity_type, Type &...);
-         * void(Type &...);
-         * @endcode
+         * @brief Returns the object associated with an entity.
          *
-         * @sa each
+         * @warning
+         * Attempting to use an entity that doesn't belong to the storage results in
+         * undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * storage doesn't contain the given entity.
          *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @param entt A valid entity identifier.
+         * @return The object associated with the entity.
          */
-        template<typename Func>
-        void less(Func func) const {
-            const auto* view = candidate();
-            ((std::get<pool_type<Component>*>(pools) == view ? less<Component>(std::move(func)) : void()), ...);
+        const object_type& get(const entity_type entt) const ENTT_NOEXCEPT {
+            return instances[underlying_type::index(entt)];
+        }
+
+        /*! @copydoc get */
+        object_type& get(const entity_type entt) {
+            return mutate()[underlying_type::index(entt)];
         }
 
         /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a set of references to non-empty components. The
-         * _constness_ of the components is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
-         *
-         * @code{.cpp}
-         * void(const entity_type, Type &...);
-         * void(Type &...);
-         * @endcode
-         *
-         * The pool of the suggested component is used to lead the iterations. The
-         * returned entities will therefore respect the order of the pool associated
-         * with that type.<br/>
-         * It is no longer guaranteed that the performance is the best possible, but
-         * there will be greater control over the order of iteration.
-         *
-         * @sa each
-         *
-         * @tparam Comp Type of component to use to enforce the iteration order.
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @brief Returns a pointer to the object associated with an entity, if any.
+         * @param entt A valid entity identifier.
+         * @return The object associated with the entity, if any.
          */
-        template<typename Comp, typename Func>
-        void less(Func func) const {
-            using other_type = type_list_cat_t<std::conditional_t<std::is_same_v<Comp, Component>, type_list<>, type_list<Component>>...>;
-            using non_empty_type = type_list_cat_t<std::conditional_t<std::is_empty_v<Component>, type_list<>, type_list<Component>>...>;
-            traverse<Comp>(std::move(func), other_type{}, non_empty_type{});
+        const object_type* try_get(const entity_type entt) const ENTT_NOEXCEPT {
+            return underlying_type::has(entt) ? &instances[underlying_type::index(entt)] : nullptr;
         }
 
-    private:
-        const std::tuple<pool_type<Component>* ...> pools;
-    };
-
-
-    /**
-     * @brief Single component view specialization.
-     *
-     * Single component views are specialized in order to get a boost in terms of
-     * performance. This kind of views can access the underlying data structure
-     * directly and avoid superfluous checks.<br/>
-     * Order of elements during iterations are highly dependent on the order of the
-     * underlying data structure. See sparse_set and its specializations for more
-     * details.
-     *
-     * @b Important
-     *
-     * Iterators aren't invalidated if:
-     *
-     * * New instances of the given component are created and assigned to entities.
-     * * The entity currently pointed is modified (as an example, the given
-     *   component is removed from the entity to which the iterator points).
-     * * The entity currently pointed is destroyed.
-     *
-     * In all the other cases, modifying the pool of the given component in any way
-     * invalidates all the iterators and using them results in undefined behavior.
-     *
-     * @note
-     * Views share a reference to the underlying data structure of the registry that
-     * generated them. Therefore any change to the entities and to the components
-     * made by means of the registry are immediately reflected by views.
-     *
-     * @warning
-     * Lifetime of a view must overcome the one of the registry that generated it.
-     * In any other case, attempting to use a view results in undefined behavior.
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
-     * @tparam Component Type of component iterated by the view.
-     */
-    template<typename Entity, typename Component>
-    class basic_view<Entity, Component> {
-        /*! @brief A registry is allowed to create views. */
-        friend class basic_registry<Entity>;
-
-        using pool_type = std::conditional_t<std::is_const_v<Component>, const storage<Entity, std::remove_const_t<Component>>, storage<Entity, Component>>;
-
-        basic_view(pool_type* ref) ENTT_NOEXCEPT
-            : pool{ ref }
-        {}
-
-    public:
-        /*! @brief Type of component iterated by the view. */
-        using raw_type = Component;
-        /*! @brief Underlying entity identifier. */
-        using entity_type = Entity;
-        /*! @brief Unsigned integer type. */
-        using size_type = std::size_t;
-        /*! @brief Input iterator type. */
-        using iterator_type = typename sparse_set<Entity>::iterator_type;
-
-        /**
-         * @brief Returns the number of entities that have the given component.
-         * @return Number of entities that have the given component.
-         */
-        size_type size() const ENTT_NOEXCEPT {
-            return pool->size();
+        /*! @copydoc try_get */
+        object_type* try_get(const entity_type entt) {
+            return underlying_type::has(entt) ? &mutate()[underlying_type::index(entt)] : nullptr;
         }
 
         /**
-         * @brief Checks whether the view is empty.
-         * @return True if the view is empty, false otherwise.
+         * @brief Assigns an entity to a storage and constructs its object.
+         *
+         * This version accept both types that can be constructed in place directly
+         * and types like aggregates that do not work well with a placement new as
+         * performed usually under the hood during an _emplace back_.
+         *
+         * @warning
+         * Attempting to use an entity that already belongs to the storage results
+         * in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * storage already contains the given entity.
+         *
+         * @tparam Args Types of arguments to use to construct the object.
+         * @param entt A valid entity identifier.
+         * @param args Parameters to use to construct an object for the entity.
+         * @return The object associated with the entity.
          */
-        bool empty() const ENTT_NOEXCEPT {
-            return pool->empty();
+        template<typename... Args>
+        object_type& construct(const entity_type entt, Args&& ... args) {
+            if constexpr (std::is_aggregate_v<object_type>) {
+                instances.emplace_back(Type{ std::forward<Args>(args)... });
+            }
+            else {
+                instances.emplace_back(std::forward<Args>(args)...);
+            }
+
+            // entity goes after component in case constructor throws
+            underlying_type::construct(entt);
+            return instances.back();
         }
 
         /**
-         * @brief Direct access to the list of components.
+         * @brief Assigns one or more entities to a storage and default constructs
+         * their objects.
          *
-         * The returned pointer is such that range `[raw(), raw() + size()]` is
-         * always a valid range, even if the container is empty.
+         * The object type must be at least move and default insertable.
          *
-         * @note
-         * There are no guarantees on the order of the components. Use `begin` and
-         * `end` if you want to iterate the view in the expected order.
+         * @warning
+         * Attempting to assign an entity that already belongs to the storage
+         * results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * storage already contains the given entity.
          *
-         * @return A pointer to the array of components.
+         * @tparam It Type of forward iterator.
+         * @param first An iterator to the first element of the range of entities.
+         * @param last An iterator past the last element of the range of entities.
+         * @return An iterator to the list of instances just created and sorted the
+         * same of the entities.
          */
-        raw_type* raw() const ENTT_NOEXCEPT {
-            return pool->raw();
+        template<typename It>
+        iterator_type batch(It first, It last) {
+            instances.resize(instances.size() + std::distance(first, last));
+            // entity goes after component in case constructor throws
+            underlying_type::batch(first, last);
+            return begin();
         }
 
         /**
-         * @brief Direct access to the list of entities.
+         * @brief Assigns one or more entities to a storage and copy constructs
+         * their objects.
          *
-         * The returned pointer is such that range `[data(), data() + size()]` is
-         * always a valid range, even if the container is empty.
+         * The object type must be at least move and copy insertable.
          *
-         * @note
-         * There are no guarantees on the order of the entities. Use `begin` and
-         * `end` if you want to iterate the view in the expected order.
+         * @sa batch
          *
-         * @return A pointer to the array of entities.
+         * @tparam It Type of forward iterator.
+         * @param first An iterator to the first element of the range of entities.
+         * @param last An iterator past the last element of the range of entities.
+         * @param value The value to initialize the new objects with.
+         * @return An iterator to the list of instances just created and sorted the
+         * same of the entities.
          */
-        const entity_type* data() const ENTT_NOEXCEPT {
-            return pool->data();
+        template<typename It>
+        iterator_type batch(It first, It last, const object_type& value) {
+            instances.resize(instances.size() + std::distance(first, last), value);
+            // entity goes after component in case constructor throws
+            underlying_type::batch(first, last);
+            return begin();
         }
 
         /**
-         * @brief Returns an iterator to the first entity that has the given
-         * component.
+         * @brief Assigns one or more entities to a storage and copy constructs
+         * their objects from a range of instances.
          *
-         * The returned iterator points to the first entity that has the given
-         * component. If the view is empty, the returned iterator will be equal to
-         * `end()`.
+         * The object type must be at least copy insertable. Trivially copyable
+         * types are copied as a single block, unless the storage is paged.
          *
-         * @note
-         * Input iterators stay true to the order imposed to the underlying data
-         * structures.
+         * @sa batch
          *
-         * @return An iterator to the first entity that has the given component.
+         * @tparam It Type of forward iterator.
+         * @tparam CIt Type of forward iterator.
+         * @param first An iterator to the first element of the range of entities.
+         * @param last An iterator past the last element of the range of entities.
+         * @param from An iterator to the first element of the range of objects.
+         * @return An iterator to the list of instances just created and sorted the
+         * same of the entities.
          */
-        iterator_type begin() const ENTT_NOEXCEPT {
-            return pool->sparse_set<Entity>::begin();
+        template<typename It, typename CIt>
+        iterator_type insert(It first, It last, CIt from) {
+            if constexpr (instance_page == 0) {
+                instances.insert(instances.end(), from, std::next(from, std::distance(first, last)));
+            }
+            else {
+                instances.append(from, std::next(from, std::distance(first, last)));
+            }
+
+            // entity goes after component in case constructor throws
+            underlying_type::batch(first, last);
+            return begin();
         }
 
         /**
-         * @brief Returns an iterator that is past the last entity that has the
-         * given component.
+         * @brief Assigns one or more entities to a storage and takes their
+         * objects over from a shared block of memory.
          *
-         * The returned iterator points to the entity following the last entity that
-         * has the given component. Attempting to dereference the returned iterator
-         * results in undefined behavior.
+         * Paged storage classes use the block as it is, its pages are copied only
+         * when first modified. Other storage classes copy the objects as
+         * `insert` does.
          *
-         * @note
-         * Input iterators stay true to the order imposed to the underlying data
-         * structures.
+         * @sa insert
          *
-         * @return An iterator to the entity following the last entity that has the
-         * given component.
+         * @tparam It Type of forward iterator.
+         * @param first An iterator to the first element of the range of entities.
+         * @param last An iterator past the last element of the range of entities.
+         * @param data A block of objects, as many as the entities.
+         * @return An iterator to the list of instances just created and sorted the
+         * same of the entities.
          */
-        iterator_type end() const ENTT_NOEXCEPT {
-            return pool->sparse_set<Entity>::end();
+        template<typename It>
+        iterator_type adopt(It first, It last, const std::shared_ptr<const object_type>& data) {
+            if constexpr (instance_page == 0) {
+                return insert(first, last, data.get());
+            }
+            else {
+                instances.adopt(data, size_type(std::distance(first, last)));
+                underlying_type::batch(first, last);
+                return begin();
+            }
         }
 
         /**
-         * @brief Finds an entity.
+         * @brief Removes an entity from a storage and destroys its object.
+         *
+         * @warning
+         * Attempting to use an entity that doesn't belong to the storage results in
+         * undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * storage doesn't contain the given entity.
+         *
          * @param entt A valid entity identifier.
-         * @return An iterator to the given entity if it's found, past the end
-         * iterator otherwise.
          */
-        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
-            const auto it = pool->find(entt);
-            return it != end() && *it == entt ? it : end();
+        void destroy(const entity_type entt) {
+            auto other = std::move(instances.back());
+            instances[underlying_type::index(entt)] = std::move(other);
+            instances.pop_back();
+            underlying_type::destroy(entt);
         }
 
         /**
-         * @brief Returns the identifier that occupies the given position.
-         * @param pos Position of the element to return.
-         * @return The identifier that occupies the given position.
+         * @brief Swaps entities and objects in the internal packed arrays.
+         *
+         * @warning
+         * Attempting to swap entities that don't belong to the sparse set results
+         * in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * sparse set doesn't contain the given entities.
+         *
+         * @param lhs A valid position within the sparse set.
+         * @param rhs A valid position within the sparse set.
          */
-        entity_type operator[](const size_type pos) const ENTT_NOEXCEPT {
-            return begin()[pos];
-        }
-
-        /**
-         * @brief Checks if a view contains an entity.
-         * @param entt A valid entity identifier.
-         * @return True if the view contains the given entity, false otherwise.
-         */
-        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
-            return find(entt) != end();
+        void swap(const size_type lhs, const size_type rhs) override {
+            ENTT_ASSERT(lhs < instances.size());
+            ENTT_ASSERT(rhs < instances.size());
+            std::swap(instances[lhs], instances[rhs]);
+            underlying_type::swap(lhs, rhs);
         }
 
         /**
-         * @brief Returns the component assigned to the given entity.
-         *
-         * Prefer this function instead of `registry::get` during iterations. It has
-         * far better performance than its companion function.
-         *
-         * @warning
-         * Attempting to use an entity that doesn't belong to the view results in
-         * undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * view doesn't contain the given entity.
+         * @brief Sort elements according to the given comparison function.
          *
-         * @param entt A valid entity identifier.
-         * @return The component assigned to the entity.
-         */
-        decltype(auto) get(const entity_type entt) const ENTT_NOEXCEPT {
-            ENTT_ASSERT(contains(entt));
-            return pool->get(entt);
-        }
-
-        /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
+         * Sort the elements so that iterating the range with a couple of iterators
+         * returns them in the expected order. See `begin` and `end` for more
+         * details.
          *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a reference to its component. The _constness_ of the
-         * component is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms:
+         * The comparison function object must return `true` if the first element
+         * is _less_ than the second one, `false` otherwise. The signature of the
+         * comparison function should be equivalent to one of the following:
          *
          * @code{.cpp}
-         * void(const entity_type, Component &);
-         * void(Component &);
+         * bool(const Entity, const Entity);
+         * bool(const Type &, const Type &);
          * @endcode
          *
-         * @note
-         * Empty types aren't explicitly instantiated. Therefore, temporary objects
-         * are returned during iterations. They can be caught only by copy or with
-         * const references.
-         *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
-         */
-        template<typename Func>
-        void each(Func func) const {
-            if constexpr (std::is_invocable_v < Func, decltype(get({})) > ) {
-                std::for_each(pool->begin(), pool->end(), std::move(func));
-            }
-            else {
-                std::for_each(pool->sparse_set<Entity>::begin(), pool->sparse_set<Entity>::end(), [&func, raw = pool->begin()](const auto entt) mutable {
-                    func(entt, *(raw++));
-                });
-            }
-        }
-
-        /**
-         * @brief Iterates entities and components and applies the given function
-         * object to them.
-         *
-         * The function object is invoked for each entity. It is provided with the
-         * entity itself and a reference to its component if it's a non-empty one.
-         * The _constness_ of the component is as requested.<br/>
-         * The signature of the function must be equivalent to one of the following
-         * forms in case the component isn't an empty one:
+         * Moreover, the comparison function object shall induce a
+         * _strict weak ordering_ on the values.
          *
-         * @code{.cpp}
-         * void(const entity_type, Component &);
-         * void(Component &);
-         * @endcode
+         * The sort function oject must offer a member function template
+         * `operator()` that accepts three arguments:
          *
-         * In case the component is an empty one instead, the following forms are
-         * accepted:
+         * * An iterator to the first element of the range to sort.
+         * * An iterator past the last element of the range to sort.
+         * * A comparison function to use to compare the elements.
          *
-         * @code{.cpp}
-         * void(const entity_type);
-         * void();
-         * @endcode
+         * The comparison function object received by the sort function object
+         * hasn't necessarily the type of the one passed along with the other
+         * parameters to this member function.
          *
-         * @sa each
+         * @note
+         * Attempting to iterate elements using a raw pointer returned by a call to
+         * either `data` or `raw` gives no guarantees on the order, even though
+         * `sort` has been invoked.
          *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @tparam Compare Type of comparison function object.
+         * @tparam Sort Type of sort function object.
+         * @tparam Args Types of arguments to forward to the sort function object.
+         * @param first An iterator to the first element of the range to sort.
+         * @param last An iterator past the last element of the range to sort.
+         * @param compare A valid comparison function object.
+         * @param algo A valid sort function object.
+         * @param args Arguments to forward to the sort function object, if any.
          */
-        template<typename Func>
-        void less(Func func) const {
-            if constexpr (std::is_empty_v<Component>) {
-                if constexpr (std::is_invocable_v<Func>) {
-                    for (auto pos = pool->size(); pos; --pos) {
-                        func();
-                    }
-                }
-                else {
-                    std::for_each(pool->sparse_set<Entity>::begin(), pool->sparse_set<Entity>::end(), std::move(func));
-                }
+        template<typename Compare, typename Sort = std_sort, typename... Args>
+        void sort(iterator_type first, iterator_type last, Compare compare, Sort algo = Sort{}, Args&& ... args) {
+            ENTT_ASSERT(!(first > last));
+
+            const auto from = underlying_type::begin() + std::distance(begin(), first);
+            const auto to = from + std::distance(first, last);
+
+            if constexpr (std::is_invocable_v<Compare, const object_type&, const object_type&>) {
+                static_assert(!std::is_empty_v<object_type>);
+
+                underlying_type::sort(from, to, [this, compare = std::move(compare)](const auto lhs, const auto rhs) {
+                    return compare(std::as_const(instances)[underlying_type::index(lhs)], std::as_const(instances)[underlying_type::index(rhs)]);
+                }, std::move(algo), std::forward<Args>(args)...);
             }
             else {
-                each(std::move(func));
+                underlying_type::sort(from, to, std::move(compare), std::move(algo), std::forward<Args>(args)...);
             }
         }
 
-    private:
-        pool_type* pool;
-    };
-
-
-}
+        /*! @brief Resets a storage. */
+        void reset() {
+            underlying_type::reset();
+            instances.clear();
+        }
 
+    private:
+        container_type& mutate() ENTT_NOEXCEPT {
+            // paged containers stamp their pages on their own
+            if constexpr (instance_page == 0) {
+                stamp.touch();
+            }
 
-#endif // ENTT_ENTITY_VIEW_HPP
+            return instances;
+        }
 
-// #include "fwd.hpp"
+        container_type instances;
+        internal::write_stamp stamp;
+    };
 
 
+    /*! @copydoc basic_storage */
+    template<typename Entity, typename Type>
+    class basic_storage<Entity, Type, std::enable_if_t<std::is_empty_v<Type>>> : public sparse_set<Entity> {
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+        using underlying_type = sparse_set<Entity>;
 
-namespace entt {
+        class iterator {
+            friend class basic_storage<Entity, Type>;
 
+            using index_type = typename traits_type::difference_type;
 
-    /**
-     * @brief Fast and reliable entity-component system.
-     *
-     * The registry is the core class of the entity-component framework.<br/>
-     * It stores entities and arranges pools of components on a per request basis.
-     * By means of a registry, users can manage entities and components and thus
-     * create views or groups to iterate them.
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
-     */
-    template<typename Entity>
-    class basic_registry {
-        using context_family = family<struct internal_registry_context_family>;
-        using component_family = family<struct internal_registry_component_family>;
-        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+            iterator(const index_type idx) ENTT_NOEXCEPT
+                : index{ idx }
+            {}
 
-        struct group_type {
-            std::size_t owned{};
-        };
+        public:
+            using difference_type = index_type;
+            using value_type = Type;
+            using pointer = const value_type*;
+            using reference = value_type;
+            using iterator_category = std::input_iterator_tag;
 
-        template<typename Component>
-        struct pool_handler : storage<Entity, Component> {
-            group_type* group{};
+            iterator() ENTT_NOEXCEPT = default;
 
-            pool_handler() ENTT_NOEXCEPT = default;
+            iterator& operator++() ENTT_NOEXCEPT {
+                return --index, * this;
+            }
 
-            pool_handler(const storage<Entity, Component>& other)
-                : storage<Entity, Component>{ other }
-            {}
+            iterator operator++(int) ENTT_NOEXCEPT {
+                iterator orig = *this;
+                return ++(*this), orig;
+            }
 
-            auto on_construct() ENTT_NOEXCEPT {
-                return sink{ construction };
+            iterator& operator--() ENTT_NOEXCEPT {
+                return ++index, * this;
             }
 
-            auto on_replace() ENTT_NOEXCEPT {
-                return sink{ update };
+            iterator operator--(int) ENTT_NOEXCEPT {
+                iterator orig = *this;
+                return --(*this), orig;
             }
 
-            auto on_destroy() ENTT_NOEXCEPT {
-                return sink{ destruction };
+            iterator& operator+=(const difference_type value) ENTT_NOEXCEPT {
+                index -= value;
+                return *this;
             }
 
-            template<typename... Args>
-            decltype(auto) assign(basic_registry& registry, const Entity entt, Args&& ... args) {
-                if constexpr (std::is_empty_v<Component>) {
-                    storage<Entity, Component>::construct(entt);
-                    construction.publish(entt, registry, Component{});
-                    return Component{ std::forward<Args>(args)... };
-                }
-                else {
-                    auto& component = storage<Entity, Component>::construct(entt, std::forward<Args>(args)...);
-                    construction.publish(entt, registry, component);
-                    return component;
-                }
+            iterator operator+(const difference_type value) const ENTT_NOEXCEPT {
+                return iterator{ index - value };
             }
 
-            template<typename It, typename... Comp>
-            auto batch(basic_registry& registry, It first, It last, const Comp& ... value) {
-                auto it = storage<Entity, Component>::batch(first, last, value...);
+            iterator& operator-=(const difference_type value) ENTT_NOEXCEPT {
+                return (*this += -value);
+            }
 
-                if (!construction.empty()) {
-                    std::for_each(first, last, [this, &registry, it](const auto entt) mutable {
-                        construction.publish(entt, registry, *(it++));
-                    });
-                }
+            iterator operator-(const difference_type value) const ENTT_NOEXCEPT {
+                return (*this + -value);
+            }
 
-                return it;
+            difference_type operator-(const iterator& other) const ENTT_NOEXCEPT {
+                return other.index - index;
             }
 
-            void remove(basic_registry& registry, const Entity entt) {
-                destruction.publish(entt, registry);
-                storage<Entity, Component>::destroy(entt);
+            reference operator[](const difference_type) const ENTT_NOEXCEPT {
+                return {};
             }
 
-            template<typename... Args>
-            decltype(auto) replace(basic_registry& registry, const Entity entt, Args&& ... args) {
-                if constexpr (std::is_empty_v<Component>) {
-                    ENTT_ASSERT((storage<Entity, Component>::has(entt)));
-                    update.publish(entt, registry, Component{});
-                    return Component{ std::forward<Args>(args)... };
-                }
-                else {
-                    Component component{ std::forward<Args>(args)... };
-                    update.publish(entt, registry, component);
-                    return (storage<Entity, Component>::get(entt) = std::move(component));
-                }
+            bool operator==(const iterator& other) const ENTT_NOEXCEPT {
+                return other.index == index;
             }
 
-        private:
-            using reference_type = std::conditional_t<std::is_empty_v<Component>, const Component&, Component&>;
-            sigh<void(const Entity, basic_registry&, reference_type)> construction{};
-            sigh<void(const Entity, basic_registry&, reference_type)> update{};
-            sigh<void(const Entity, basic_registry&)> destruction{};
-        };
-
-        template<typename Component>
-        using pool_type = pool_handler<std::decay_t<Component>>;
-
-        template<typename...>
-        struct group_handler;
+            bool operator!=(const iterator& other) const ENTT_NOEXCEPT {
+                return !(*this == other);
+            }
 
-        template<typename... Exclude, typename... Get>
-        struct group_handler<exclude_t<Exclude...>, get_t<Get...>> : sparse_set<Entity> {
-            std::tuple<pool_type<Get>* ..., pool_type<Exclude>* ...> cpools{};
+            bool operator<(const iterator& other) const ENTT_NOEXCEPT {
+                return index > other.index;
+            }
 
-            template<typename Component>
-            void maybe_valid_if(const Entity entt) {
-                if constexpr (std::disjunction_v<std::is_same<Get, Component>...>) {
-                    if (((std::is_same_v<Component, Get> || std::get<pool_type<Get>*>(cpools)->has(entt)) && ...)
-                        && !(std::get<pool_type<Exclude>*>(cpools)->has(entt) || ...))
-                    {
-                        this->construct(entt);
-                    }
-                }
-                else if constexpr (std::disjunction_v<std::is_same<Exclude, Component>...>) {
-                    if ((std::get<pool_type<Get>*>(cpools)->has(entt) && ...)
-                        && ((std::is_same_v<Exclude, Component> || !std::get<pool_type<Exclude>*>(cpools)->has(entt)) && ...)) {
-                        this->construct(entt);
-                    }
-                }
+            bool operator>(const iterator& other) const ENTT_NOEXCEPT {
+                return index < other.index;
             }
 
-            void discard_if(const Entity entt) {
-                if (this->has(entt)) {
-                    this->destroy(entt);
-                }
+            bool operator<=(const iterator& other) const ENTT_NOEXCEPT {
+                return !(*this > other);
             }
-        };
 
-        template<typename... Exclude, typename... Get, typename... Owned>
-        struct group_handler<exclude_t<Exclude...>, get_t<Get...>, Owned...> : group_type {
-            std::tuple<pool_type<Owned>* ..., pool_type<Get>* ..., pool_type<Exclude>* ...> cpools{};
+            bool operator>=(const iterator& other) const ENTT_NOEXCEPT {
+                return !(*this < other);
+            }
 
-            template<typename Component>
-            void maybe_valid_if(const Entity entt) {
-                if constexpr (std::disjunction_v<std::is_same<Owned, Component>..., std::is_same<Get, Component>...>) {
-                    if (((std::is_same_v<Component, Owned> || std::get<pool_type<Owned>*>(cpools)->has(entt)) && ...)
-                        && ((std::is_same_v<Component, Get> || std::get<pool_type<Get>*>(cpools)->has(entt)) && ...)
-                        && !(std::get<pool_type<Exclude>*>(cpools)->has(entt) || ...))
-                    {
-                        const auto pos = this->owned++;
-                        (std::get<pool_type<Owned>*>(cpools)->swap(std::get<pool_type<Owned>*>(cpools)->index(entt), pos), ...);
-                    }
-                }
-                else if constexpr (std::disjunction_v<std::is_same<Exclude, Component>...>) {
-                    if ((std::get<pool_type<Owned>*>(cpools)->has(entt) && ...)
-                        && (std::get<pool_type<Get>*>(cpools)->has(entt) && ...)
-                        && ((std::is_same_v<Exclude, Component> || !std::get<pool_type<Exclude>*>(cpools)->has(entt)) && ...))
-                    {
-                        const auto pos = this->owned++;
-                        (std::get<pool_type<Owned>*>(cpools)->swap(std::get<pool_type<Owned>*>(cpools)->index(entt), pos), ...);
-                    }
-                }
+            pointer operator->() const ENTT_NOEXCEPT {
+                return nullptr;
             }
 
-            void discard_if(const Entity entt) {
-                if (std::get<0>(cpools)->has(entt) && std::get<0>(cpools)->index(entt) < this->owned) {
-                    const auto pos = --this->owned;
-                    (std::get<pool_type<Owned>*>(cpools)->swap(std::get<pool_type<Owned>*>(cpools)->index(entt), pos), ...);
-                }
+            reference operator*() const ENTT_NOEXCEPT {
+                return {};
             }
-        };
 
-        struct pool_data {
-            std::unique_ptr<sparse_set<Entity>> pool;
-            void(*remove)(sparse_set<Entity>&, basic_registry&, const Entity);
-            std::unique_ptr<sparse_set<Entity>>(*clone)(const sparse_set<Entity>&);
-            void(*stomp)(const sparse_set<Entity>&, const Entity, basic_registry&, const Entity);
-            ENTT_ID_TYPE runtime_type;
+        private:
+            index_type index;
         };
 
-        struct group_data {
-            const std::size_t extent[3];
-            std::unique_ptr<void, void(*)(void*)> group;
-            bool(*const is_same)(const component*) ENTT_NOEXCEPT;
-        };
+    public:
+        /*! @brief Type of the objects associated with the entities. */
+        using object_type = Type;
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+        /*! @brief Random access iterator type. */
+        using iterator_type = iterator;
+
+        /*! @brief Default constructor. */
+        basic_storage() = default;
+
+        /**
+         * @brief Constructs an empty storage that allocates from a resource.
+         * @param resource A valid memory resource.
+         * @param page Size in bytes of a sparse page, zero for the compact mode.
+         */
+        explicit basic_storage(std::pmr::memory_resource* resource, const size_type page = ENTT_PAGE_SIZE)
+            : underlying_type{ resource, page }
+        {}
+
+        /**
+         * @brief Returns an iterator to the beginning.
+         *
+         * The returned iterator points to the first instance of the given type. If
+         * the storage is empty, the returned iterator will be equal to `end()`.
+         *
+         * @note
+         * Input iterators stay true to the order imposed by a call to either `sort`
+         * or `respect`.
+         *
+         * @return An iterator to the first instance of the given type.
+         */
+        iterator_type cbegin() const ENTT_NOEXCEPT {
+            const typename traits_type::difference_type pos = underlying_type::size();
+            return iterator_type{ pos };
+        }
+
+        /*! @copydoc cbegin */
+        iterator_type begin() const ENTT_NOEXCEPT {
+            return cbegin();
+        }
+
+        /**
+         * @brief Returns an iterator to the end.
+         *
+         * The returned iterator points to the element following the last instance
+         * of the given type. Attempting to dereference the returned iterator
+         * results in undefined behavior.
+         *
+         * @note
+         * Input iterators stay true to the order imposed by a call to either `sort`
+         * or `respect`.
+         *
+         * @return An iterator to the element following the last instance of the
+         * given type.
+         */
+        iterator_type cend() const ENTT_NOEXCEPT {
+            return iterator_type{};
+        }
+
+        /*! @copydoc cend */
+        iterator_type end() const ENTT_NOEXCEPT {
+            return cend();
+        }
+
+        /**
+         * @brief Returns the object associated with an entity.
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, this function
+         * always returns a temporary object.
+         *
+         * @warning
+         * Attempting to use an entity that doesn't belong to the storage results in
+         * undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * storage doesn't contain the given entity.
+         *
+         * @param entt A valid entity identifier.
+         * @return The object associated with the entity.
+         */
+        object_type get([[maybe_unused]] const entity_type entt) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(underlying_type::has(entt));
+            return {};
+        }
+
+        /**
+         * @brief Assigns one or more entities to a storage.
+         *
+         * The object type must be at least default constructible.
+         *
+         * @warning
+         * Attempting to assign an entity that already belongs to the storage
+         * results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * storage already contains the given entity.
+         *
+         * @tparam It Type of forward iterator.
+         * @param first An iterator to the first element of the range of entities.
+         * @param last An iterator past the last element of the range of entities.
+         * @return An iterator to the list of instances just created and sorted the
+         * same of the entities.
+         */
+        template<typename It>
+        iterator_type batch(It first, It last, const object_type & = {}) {
+            underlying_type::batch(first, last);
+            return begin();
+        }
+    };
+
+    /*! @copydoc basic_storage */
+    template<typename Entity, typename Type>
+    struct storage : basic_storage<Entity, Type> {
+        using basic_storage<Entity, Type>::basic_storage;
+    };
+
+
+}
+
+
+#endif // ENTT_ENTITY_STORAGE_HPP
+
+// #include "utility.hpp"
+#ifndef ENTT_ENTITY_UTILITY_HPP
+#define ENTT_ENTITY_UTILITY_HPP
+
+
+// #include "../core/type_traits.hpp"
+
+
+
+namespace entt {
+
+
+    /**
+     * @brief Alias for exclusion lists.
+     * @tparam Type List of types.
+     */
+    template<typename... Type>
+    struct exclude_t : type_list<Type...> {};
+
+
+    /**
+     * @brief Variable template for exclusion lists.
+     * @tparam Type List of types.
+     */
+    template<typename... Type>
+    constexpr exclude_t<Type...> exclude{};
+
+
+    /**
+     * @brief Alias for lists of observed components.
+     * @tparam Type List of types.
+     */
+    template<typename... Type>
+    struct get_t : type_list<Type...> {};
+
+
+    /**
+     * @brief Variable template for lists of observed components.
+     * @tparam Type List of types.
+     */
+    template<typename... Type>
+    constexpr get_t<Type...> get{};
+
+
+    /**
+     * @brief Alias for lists of optional components.
+     * @tparam Type List of types.
+     */
+    template<typename... Type>
+    struct optional_t : type_list<Type...> {};
+
+
+    /**
+     * @brief Variable template for lists of optional components.
+     * @tparam Type List of types.
+     */
+    template<typename... Type>
+    constexpr optional_t<Type...> optional{};
+
+
+}
+
+
+#endif // ENTT_ENTITY_UTILITY_HPP
+
+// #include "entity.hpp"
+
+// #include "group.hpp"
+#ifndef ENTT_ENTITY_GROUP_HPP
+#define ENTT_ENTITY_GROUP_HPP
+
+
+#include <tuple>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+// #include "../config/config.h"
+
+// #include "../core/type_traits.hpp"
+
+// #include "sparse_set.hpp"
+
+// #include "storage.hpp"
+
+// #include "utility.hpp"
+
+// #include "fwd.hpp"
+
+
+
+namespace entt {
+
+
+    /**
+     * @brief Group.
+     *
+     * Primary template isn't defined on purpose. All the specializations give a
+     * compile-time error, but for a few reasonable cases.
+     */
+    template<typename...>
+    class basic_group;
+
+
+    /**
+     * @brief Non-owning group.
+     *
+     * A non-owning group returns all the entities and only the entities that have
+     * at least the given components. Moreover, it's guaranteed that the entity list
+     * is tightly packed in memory for fast iterations.<br/>
+     * In general, non-owning groups don't stay true to the order of any set of
+     * components unless users explicitly sort them.
+     *
+     * @b Important
+     *
+     * Iterators aren't invalidated if:
+     *
+     * * New instances of the given components are created and assigned to entities.
+     * * The entity currently pointed is modified (as an example, if one of the
+     *   given components is removed from the entity to which the iterator points).
+     * * The entity currently pointed is destroyed.
+     *
+     * In all the other cases, modifying the pools of the given components in any
+     * way invalidates all the iterators and using them results in undefined
+     * behavior.
+     *
+     * @note
+     * Groups share references to the underlying data structures of the registry
+     * that generated them. Therefore any change to the entities and to the
+     * components made by means of the registry are immediately reflected by all the
+     * groups.<br/>
+     * Moreover, sorting a non-owning group affects all the instance of the same
+     * group (it means that users don't have to call `sort` on each instance to sort
+     * all of them because they share the set of entities).
+     *
+     * @warning
+     * Lifetime of a group must overcome the one of the registry that generated it.
+     * In any other case, attempting to use a group results in undefined behavior.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * @tparam Exclude Types of components used to filter the group.
+     * @tparam Get Type of component observed by the group.
+     * @tparam Other Other types of components observed by the group.
+     */
+    template<typename Entity, typename... Exclude, typename Get, typename... Other>
+    class basic_group<Entity, exclude_t<Exclude...>, get_t<Get, Other...>> {
+        /*! @brief A registry is allowed to create groups. */
+        friend class basic_registry<Entity>;
+
+        template<typename Component>
+        using pool_type = std::conditional_t<std::is_const_v<Component>, const storage<Entity, std::remove_const_t<Component>>, storage<Entity, Component>>;
+
+        // we could use pool_type<Type> *..., but vs complains about it and refuses to compile for unknown reasons (most likely a bug)
+        basic_group(sparse_set<Entity>* ref, storage<Entity, std::remove_const_t<Get>>* get, storage<Entity, std::remove_const_t<Other>>* ... other) ENTT_NOEXCEPT
+            : handler{ ref },
+            pools{ get, other... }
+        {}
+
+        template<typename Func, typename... Weak>
+        void traverse(Func func, type_list<Weak...>) const {
+            for (const auto entt : *handler) {
+                if constexpr (std::is_invocable_v < Func, decltype(get<Weak>({}))... > ) {
+                    func(std::get<pool_type<Weak>*>(pools)->get(entt)...);
+                }
+                else {
+                    func(entt, std::get<pool_type<Weak>*>(pools)->get(entt)...);
+                }
+            };
+        }
+
+    public:
+        /*! @brief Underlying entity identifier. */
+        using entity_type = typename sparse_set<Entity>::entity_type;
+        /*! @brief Unsigned integer type. */
+        using size_type = typename sparse_set<Entity>::size_type;
+        /*! @brief Input iterator type. */
+        using iterator_type = typename sparse_set<Entity>::iterator_type;
+
+        /**
+         * @brief Returns the number of existing components of the given type.
+         * @tparam Component Type of component of which to return the size.
+         * @return Number of existing components of the given type.
+         */
+        template<typename Component>
+        size_type size() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Component>*>(pools)->size();
+        }
+
+        /**
+         * @brief Returns the number of entities that have the given components.
+         * @return Number of entities that have the given components.
+         */
+        size_type size() const ENTT_NOEXCEPT {
+            return handler->size();
+        }
+
+        /**
+         * @brief Returns the number of elements that a group has currently
+         * allocated space for.
+         * @return Capacity of the group.
+         */
+        size_type capacity() const ENTT_NOEXCEPT {
+            return handler->capacity();
+        }
+
+        /*! @brief Requests the removal of unused capacity. */
+        void shrink_to_fit() {
+            handler->shrink_to_fit();
+        }
+
+        /**
+         * @brief Checks whether the pool of a given component is empty.
+         * @tparam Component Type of component in which one is interested.
+         * @return True if the pool of the given component is empty, false
+         * otherwise.
+         */
+        template<typename Component>
+        bool empty() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Component>*>(pools)->empty();
+        }
+
+        /**
+         * @brief Checks whether the group is empty.
+         * @return True if the group is empty, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return handler->empty();
+        }
+
+        /**
+         * @brief Direct access to the list of components of a given pool.
+         *
+         * The returned pointer is such that range
+         * `[raw<Component>(), raw<Component>() + size<Component>()]` is always a
+         * valid range, even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the components. Use `begin` and
+         * `end` if you want to iterate the group in the expected order.
+         *
+         * @tparam Component Type of component in which one is interested.
+         * @return A pointer to the array of components.
+         */
+        template<typename Component>
+        Component* raw() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Component>*>(pools)->raw();
+        }
+
+        /**
+         * @brief Direct access to the list of entities of a given pool.
+         *
+         * The returned pointer is such that range
+         * `[data<Component>(), data<Component>() + size<Component>()]` is always a
+         * valid range, even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the entities. Use `begin` and
+         * `end` if you want to iterate the group in the expected order.
+         *
+         * @tparam Component Type of component in which one is interested.
+         * @return A pointer to the array of entities.
+         */
+        template<typename Component>
+        const entity_type* data() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Component>*>(pools)->data();
+        }
+
+        /**
+         * @brief Direct access to the list of entities.
+         *
+         * The returned pointer is such that range `[data(), data() + size()]` is
+         * always a valid range, even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the entities. Use `begin` and
+         * `end` if you want to iterate the group in the expected order.
+         *
+         * @return A pointer to the array of entities.
+         */
+        const entity_type* data() const ENTT_NOEXCEPT {
+            return handler->data();
+        }
+
+        /**
+         * @brief Returns an iterator to the first entity that has the given
+         * components.
+         *
+         * The returned iterator points to the first entity that has the given
+         * components. If the group is empty, the returned iterator will be equal to
+         * `end()`.
+         *
+         * @note
+         * Input iterators stay true to the order imposed to the underlying data
+         * structures.
+         *
+         * @return An iterator to the first entity that has the given components.
+         */
+        iterator_type begin() const ENTT_NOEXCEPT {
+            return handler->begin();
+        }
+
+        /**
+         * @brief Returns an iterator that is past the last entity that has the
+         * given components.
+         *
+         * The returned iterator points to the entity following the last entity that
+         * has the given components. Attempting to dereference the returned iterator
+         * results in undefined behavior.
+         *
+         * @note
+         * Input iterators stay true to the order imposed to the underlying data
+         * structures.
+         *
+         * @return An iterator to the entity following the last entity that has the
+         * given components.
+         */
+        iterator_type end() const ENTT_NOEXCEPT {
+            return handler->end();
+        }
+
+        /**
+         * @brief Finds an entity.
+         * @param entt A valid entity identifier.
+         * @return An iterator to the given entity if it's found, past the end
+         * iterator otherwise.
+         */
+        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
+            const auto it = handler->find(entt);
+            return it != end() && *it == entt ? it : end();
+        }
+
+        /**
+         * @brief Returns the identifier that occupies the given position.
+         * @param pos Position of the element to return.
+         * @return The identifier that occupies the given position.
+         */
+        entity_type operator[](const size_type pos) const ENTT_NOEXCEPT {
+            return begin()[pos];
+        }
+
+        /**
+         * @brief Checks if a group contains an entity.
+         * @param entt A valid entity identifier.
+         * @return True if the group contains the given entity, false otherwise.
+         */
+        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
+            return find(entt) != end();
+        }
+
+        /**
+         * @brief Returns the components assigned to the given entity.
+         *
+         * Prefer this function instead of `registry::get` during iterations. It has
+         * far better performance than its companion function.
+         *
+         * @warning
+         * Attempting to use an invalid component type results in a compilation
+         * error. Attempting to use an entity that doesn't belong to the group
+         * results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * group doesn't contain the given entity.
+         *
+         * @tparam Component Types of components to get.
+         * @param entt A valid entity identifier.
+         * @return The components assigned to the entity.
+         */
+        template<typename... Component>
+        decltype(auto) get([[maybe_unused]] const entity_type entt) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(contains(entt));
+
+            if constexpr (sizeof...(Component) == 1) {
+                return (std::get<pool_type<Component>*>(pools)->get(entt), ...);
+            }
+            else {
+                return std::tuple<decltype(get<Component>(entt))...>{get<Component>(entt)...};
+            }
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to all its components. The
+         * _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Get &, Other &...);
+         * void(Get &, Other &...);
+         * @endcode
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned during iterations. They can be caught only by copy or with
+         * const references.
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void each(Func func) const {
+            traverse(std::move(func), type_list<Get, Other...>{});
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to non-empty components. The
+         * _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Type &...);
+         * void(Type &...);
+         * @endcode
+         *
+         * @sa each
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void less(Func func) const {
+            using get_type_list = std::conditional_t<std::is_empty_v<Get>, type_list<>, type_list<Get>>;
+            using other_type_list = type_list_cat_t<std::conditional_t<std::is_empty_v<Other>, type_list<>, type_list<Other>>...>;
+            traverse(std::move(func), type_list_cat_t<get_type_list, other_type_list>{});
+        }
+
+        /**
+         * @brief Sort a group according to the given comparison function.
+         *
+         * Sort the group so that iterating it with a couple of iterators returns
+         * entities and components in the expected order. See `begin` and `end` for
+         * more details.
+         *
+         * The comparison function object must return `true` if the first element
+         * is _less_ than the second one, `false` otherwise. The signature of the
+         * comparison function should be equivalent to one of the following:
+         *
+         * @code{.cpp}
+         * bool(std::tuple<Component &...>, std::tuple<Component &...>);
+         * bool(const Component &..., const Component &...);
+         * bool(const Entity, const Entity);
+         * @endcode
+         *
+         * Where `Component` are such that they are iterated by the group.<br/>
+         * Moreover, the comparison function object shall induce a
+         * _strict weak ordering_ on the values.
+         *
+         * The sort function oject must offer a member function template
+         * `operator()` that accepts three arguments:
+         *
+         * * An iterator to the first element of the range to sort.
+         * * An iterator past the last element of the range to sort.
+         * * A comparison function to use to compare the elements.
+         *
+         * The comparison function object received by the sort function object
+         * hasn't necessarily the type of the one passed along with the other
+         * parameters to this member function.
+         *
+         * @note
+         * Attempting to iterate elements using a raw pointer returned by a call to
+         * either `data` or `raw` gives no guarantees on the order, even though
+         * `sort` has been invoked.
+         *
+         * @tparam Component Optional types of components to compare.
+         * @tparam Compare Type of comparison function object.
+         * @tparam Sort Type of sort function object.
+         * @tparam Args Types of arguments to forward to the sort function object.
+         * @param compare A valid comparison function object.
+         * @param algo A valid sort function object.
+         * @param args Arguments to forward to the sort function object, if any.
+         */
+        template<typename... Component, typename Compare, typename Sort = std_sort, typename... Args>
+        void sort(Compare compare, Sort algo = Sort{}, Args&& ... args) {
+            if constexpr (sizeof...(Component) == 0) {
+                static_assert(std::is_invocable_v<Compare, const entity_type, const entity_type>);
+                handler->sort(handler->begin(), handler->end(), std::move(compare), std::move(algo), std::forward<Args>(args)...);
+            }
+            else {
+                handler->sort(handler->begin(), handler->end(), [this, compare = std::move(compare)](const entity_type lhs, const entity_type rhs) {
+                    // useless this-> used to suppress a warning with clang
+                    return compare(this->get<Component...>(lhs), this->get<Component...>(rhs));
+                }, std::move(algo), std::forward<Args>(args)...);
+            }
+        }
+
+        /**
+         * @brief Sort the shared pool of entities according to the given component.
+         *
+         * Non-owning groups of the same type share with the registry a pool of
+         * entities with  its own order that doesn't depend on the order of any pool
+         * of components. Users can order the underlying data structure so that it
+         * respects the order of the pool of the given component.
+         *
+         * @note
+         * The shared pool of entities and thus its order is affected by the changes
+         * to each and every pool that it tracks. Therefore changes to those pools
+         * can quickly ruin the order imposed to the pool of entities shared between
+         * the non-owning groups.
+         *
+         * @tparam Component Type of component to use to impose the order.
+         */
+        template<typename Component>
+        void sort() const {
+            handler->respect(*std::get<pool_type<Component>*>(pools));
+        }
+
+    private:
+        sparse_set<entity_type>* handler;
+        const std::tuple<pool_type<Get>*, pool_type<Other>* ...> pools;
+    };
+
+
+    /**
+     * @brief Owning group.
+     *
+     * Owning groups return all the entities and only the entities that have at
+     * least the given components. Moreover:
+     *
+     * * It's guaranteed that the entity list is tightly packed in memory for fast
+     *   iterations.
+     * * It's guaranteed that the lists of owned components are tightly packed in
+     *   memory for even faster iterations and to allow direct access.
+     * * They stay true to the order of the owned components and all the owned
+     *   components have the same order in memory.
+     *
+     * The more types of components are owned by a group, the faster it is to
+     * iterate them.
+     *
+     * @b Important
+     *
+     * Iterators aren't invalidated if:
+     *
+     * * New instances of the given components are created and assigned to entities.
+     * * The entity currently pointed is modified (as an example, if one of the
+     *   given components is removed from the entity to which the iterator points).
+     * * The entity currently pointed is destroyed.
+     *
+     * In all the other cases, modifying the pools of the given components in any
+     * way invalidates all the iterators and using them results in undefined
+     * behavior.
+     *
+     * @note
+     * Groups share references to the underlying data structures of the registry
+     * that generated them. Therefore any change to the entities and to the
+     * components made by means of the registry are immediately reflected by all the
+     * groups.
+     * Moreover, sorting an owning group affects all the instance of the same group
+     * (it means that users don't have to call `sort` on each instance to sort all
+     * of them because they share the underlying data structure).
+     *
+     * @warning
+     * Lifetime of a group must overcome the one of the registry that generated it.
+     * In any other case, attempting to use a group results in undefined behavior.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * @tparam Exclude Types of components used to filter the group.
+     * @tparam Get Types of components observed by the group.
+     * @tparam Owned Type of component owned by the group.
+     * @tparam Other Other types of components owned by the group.
+     */
+    template<typename Entity, typename... Exclude, typename... Get, typename Owned, typename... Other>
+    class basic_group<Entity, exclude_t<Exclude...>, get_t<Get...>, Owned, Other...> {
+        /*! @brief A registry is allowed to create groups. */
+        friend class basic_registry<Entity>;
+        /*! @brief Chunk ranges are allowed to visit groups. */
+        friend class internal::chunk_range<basic_group>;
+
+        template<typename Component>
+        using pool_type = std::conditional_t<std::is_const_v<Component>, const storage<Entity, std::remove_const_t<Component>>, storage<Entity, Component>>;
+
+        template<typename Component>
+        using component_iterator_type = decltype(std::declval<pool_type<Component>>().begin());
+
+        // we could use pool_type<Type> *..., but vs complains about it and refuses to compile for unknown reasons (most likely a bug)
+        basic_group(const typename basic_registry<Entity>::size_type* sz, storage<Entity, std::remove_const_t<Owned>>* owned, storage<Entity, std::remove_const_t<Other>>* ... other, storage<Entity, std::remove_const_t<Get>>* ... get) ENTT_NOEXCEPT
+            : length{ sz },
+            pools{ owned, other..., get... }
+        {}
+
+        template<typename Func, typename... Strong, typename... Weak>
+        void traverse(Func func, type_list<Strong...>, type_list<Weak...>) const {
+            [[maybe_unused]] auto raw = std::make_tuple((std::get<pool_type<Strong>*>(pools)->end() - *length)...);
+            [[maybe_unused]] auto data = std::get<pool_type<Owned>*>(pools)->sparse_set<entity_type>::end() - *length;
+
+            for (auto next = *length; next; --next) {
+                if constexpr (std::is_invocable_v < Func, decltype(get<Strong>({}))..., decltype(get<Weak>({}))... > ) {
+                    if constexpr (sizeof...(Weak) == 0) {
+                        func(*(std::get<component_iterator_type<Strong>>(raw)++)...);
+                    }
+                    else {
+                        const auto entt = *(data++);
+                        func(*(std::get<component_iterator_type<Strong>>(raw)++)..., std::get<pool_type<Weak>*>(pools)->get(entt)...);
+                    }
+                }
+                else {
+                    const auto entt = *(data++);
+                    func(entt, *(std::get<component_iterator_type<Strong>>(raw)++)..., std::get<pool_type<Weak>*>(pools)->get(entt)...);
+                }
+            }
+        }
+
+        template<typename... Strong>
+        auto chunk_at(const std::size_t pos, const std::size_t chunk, type_list<Strong...>) const {
+            auto count = std::min(*length - pos, chunk - pos % chunk);
+            ((count = std::min(count, std::get<pool_type<Strong>*>(pools)->contiguous(pos))), ...);
+            return std::make_tuple(std::get<pool_type<Owned>*>(pools)->data() + pos, std::get<pool_type<Strong>*>(pools)->raw(pos)..., count);
+        }
+
+        auto chunk_at(const std::size_t pos, const std::size_t chunk) const {
+            using owned_type_list = std::conditional_t<std::is_empty_v<Owned>, type_list<>, type_list<Owned>>;
+            using other_type_list = type_list_cat_t<std::conditional_t<std::is_empty_v<Other>, type_list<>, type_list<Other>>...>;
+            return chunk_at(pos, chunk, type_list_cat_t<owned_type_list, other_type_list>{});
+        }
+
+    public:
+        /*! @brief Underlying entity identifier. */
+        using entity_type = typename sparse_set<Entity>::entity_type;
+        /*! @brief Unsigned integer type. */
+        using size_type = typename sparse_set<Entity>::size_type;
+        /*! @brief Input iterator type. */
+        using iterator_type = typename sparse_set<Entity>::iterator_type;
+
+        /**
+         * @brief Returns the number of existing components of the given type.
+         * @tparam Component Type of component of which to return the size.
+         * @return Number of existing components of the given type.
+         */
+        template<typename Component>
+        size_type size() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Component>*>(pools)->size();
+        }
+
+        /**
+         * @brief Returns the number of entities that have the given components.
+         * @return Number of entities that have the given components.
+         */
+        size_type size() const ENTT_NOEXCEPT {
+            return *length;
+        }
+
+        /**
+         * @brief Checks whether the pool of a given component is empty.
+         * @tparam Component Type of component in which one is interested.
+         * @return True if the pool of the given component is empty, false
+         * otherwise.
+         */
+        template<typename Component>
+        bool empty() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Component>*>(pools)->empty();
+        }
+
+        /**
+         * @brief Checks whether the group is empty.
+         * @return True if the group is empty, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return !*length;
+        }
+
+        /**
+         * @brief Direct access to the list of components of a given pool.
+         *
+         * The returned pointer is such that range
+         * `[raw<Component>(), raw<Component>() + size<Component>()]` is always a
+         * valid range, even if the container is empty.<br/>
+         * Moreover, in case the group owns the given component, the range
+         * `[raw<Component>(), raw<Component>() + size()]` is such that it contains
+         * the instances that are part of the group itself.
+         *
+         * @note
+         * There are no guarantees on the order of the components. Use `begin` and
+         * `end` if you want to iterate the group in the expected order.
+         *
+         * @tparam Component Type of component in which one is interested.
+         * @return A pointer to the array of components.
+         */
+        template<typename Component>
+        Component* raw() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Component>*>(pools)->raw();
+        }
+
+        /**
+         * @brief Returns a strided view of the instances of an owned component
+         * that are part of the group.
+         *
+         * Instances are in the same order as with `raw`, starting at the given
+         * position. Views of paged storage classes end where pages end, visit
+         * all the instances with:
+         *
+         * @code{.cpp}
+         * for(std::size_t pos{}; pos < group.size(); pos += group.template strided<Component>(pos).size()) {
+         *     // ...
+         * }
+         * @endcode
+         *
+         * Views of different owned components at the same position have the
+         * same length only if the components are either all paged with pages of
+         * the same size or all not paged. Use `chunks` otherwise.
+         *
+         * A const view of a component owned for writing doesn't count as a write
+         * to its instances, as opposed to `raw`.
+         *
+         * @tparam Component Type of owned component in which one is interested.
+         * @param pos A valid position in the group, or zero.
+         * @return A view of the instances from the given position.
+         */
+        template<typename Component>
+        strided_view<Component> strided(const size_type pos = 0u) const ENTT_NOEXCEPT {
+            using raw_type = std::remove_const_t<Component>;
+            static_assert(std::disjunction_v<std::is_same<raw_type, std::remove_const_t<Owned>>, std::is_same<raw_type, std::remove_const_t<Other>>...> && !std::is_empty_v<Component>);
+            using owned_type = std::conditional_t<std::disjunction_v<std::is_same<raw_type, Owned>, std::is_same<raw_type, Other>...>, raw_type, const raw_type>;
+            std::conditional_t<std::is_const_v<Component>, const pool_type<owned_type>, pool_type<owned_type>>* cpool = std::get<pool_type<owned_type>*>(pools);
+            return *length ? strided_view<Component>{ cpool->raw(pos), std::min(*length - pos, cpool->contiguous(pos)), sizeof(Component) } : strided_view<Component>{};
+        }
+
+        /**
+         * @brief Direct access to the list of entities of a given pool.
+         *
+         * The returned pointer is such that range
+         * `[data<Component>(), data<Component>() + size<Component>()]` is always a
+         * valid range, even if the container is empty.<br/>
+         * Moreover, in case the group owns the given component, the range
+         * `[data<Component>(), data<Component>() + size()]` is such that it
+         * contains the entities that are part of the group itself.
+         *
+         * @note
+         * There are no guarantees on the order of the entities. Use `begin` and
+         * `end` if you want to iterate the group in the expected order.
+         *
+         * @tparam Component Type of component in which one is interested.
+         * @return A pointer to the array of entities.
+         */
+        template<typename Component>
+        const entity_type* data() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Component>*>(pools)->data();
+        }
+
+        /**
+         * @brief Direct access to the list of entities.
+         *
+         * The returned pointer is such that range `[data(), data() + size()]` is
+         * always a valid range, even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the entities. Use `begin` and
+         * `end` if you want to iterate the group in the expected order.
+         *
+         * @return A pointer to the array of entities.
+         */
+        const entity_type* data() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Owned>*>(pools)->data();
+        }
+
+        /**
+         * @brief Returns an iterator to the first entity that has the given
+         * components.
+         *
+         * The returned iterator points to the first entity that has the given
+         * components. If the group is empty, the returned iterator will be equal to
+         * `end()`.
+         *
+         * @note
+         * Input iterators stay true to the order imposed to the underlying data
+         * structures.
+         *
+         * @return An iterator to the first entity that has the given components.
+         */
+        iterator_type begin() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Owned>*>(pools)->sparse_set<entity_type>::end() - *length;
+        }
+
+        /**
+         * @brief Returns an iterator that is past the last entity that has the
+         * given components.
+         *
+         * The returned iterator points to the entity following the last entity that
+         * has the given components. Attempting to dereference the returned iterator
+         * results in undefined behavior.
+         *
+         * @note
+         * Input iterators stay true to the order imposed to the underlying data
+         * structures.
+         *
+         * @return An iterator to the entity following the last entity that has the
+         * given components.
+         */
+        iterator_type end() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Owned>*>(pools)->sparse_set<entity_type>::end();
+        }
+
+        /**
+         * @brief Finds an entity.
+         * @param entt A valid entity identifier.
+         * @return An iterator to the given entity if it's found, past the end
+         * iterator otherwise.
+         */
+        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
+            const auto it = std::get<pool_type<Owned>*>(pools)->find(entt);
+            return it != end() && it >= begin() && *it == entt ? it : end();
+        }
+
+        /**
+         * @brief Returns the identifier that occupies the given position.
+         * @param pos Position of the element to return.
+         * @return The identifier that occupies the given position.
+         */
+        entity_type operator[](const size_type pos) const ENTT_NOEXCEPT {
+            return begin()[pos];
+        }
+
+        /**
+         * @brief Checks if a group contains an entity.
+         * @param entt A valid entity identifier.
+         * @return True if the group contains the given entity, false otherwise.
+         */
+        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
+            return find(entt) != end();
+        }
+
+        /**
+         * @brief Returns the components assigned to the given entity.
+         *
+         * Prefer this function instead of `registry::get` during iterations. It has
+         * far better performance than its companion function.
+         *
+         * @warning
+         * Attempting to use an invalid component type results in a compilation
+         * error. Attempting to use an entity that doesn't belong to the group
+         * results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * group doesn't contain the given entity.
+         *
+         * @tparam Component Types of components to get.
+         * @param entt A valid entity identifier.
+         * @return The components assigned to the entity.
+         */
+        template<typename... Component>
+        decltype(auto) get([[maybe_unused]] const entity_type entt) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(contains(entt));
+
+            if constexpr (sizeof...(Component) == 1) {
+                return (std::get<pool_type<Component>*>(pools)->get(entt), ...);
+            }
+            else {
+                return std::tuple<decltype(get<Component>(entt))...>{get<Component>(entt)...};
+            }
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to all its components. The
+         * _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Owned &, Other &..., Get &...);
+         * void(Owned &, Other &..., Get &...);
+         * @endcode
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned during iterations. They can be caught only by copy or with
+         * const references.
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void each(Func func) const {
+            traverse(std::move(func), type_list<Owned, Other...>{}, type_list<Get...>{});
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to non-empty components. The
+         * _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Type &...);
+         * void(Type &...);
+         * @endcode
+         *
+         * @sa each
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void less(Func func) const {
+            using owned_type_list = std::conditional_t<std::is_empty_v<Owned>, type_list<>, type_list<Owned>>;
+            using other_type_list = type_list_cat_t<std::conditional_t<std::is_empty_v<Other>, type_list<>, type_list<Other>>...>;
+            using get_type_list = type_list_cat_t<std::conditional_t<std::is_empty_v<Get>, type_list<>, type_list<Get>>...>;
+            traverse(std::move(func), type_list_cat_t<owned_type_list, other_type_list>{}, get_type_list{});
+        }
+
+        /**
+         * @brief Iterates entities and owned components in chunks and applies the
+         * given function object to them.
+         *
+         * The function object is invoked once per chunk. It is provided with a
+         * pointer to the entities of the chunk, a pointer to the owned non-empty
+         * components of the same entities, in the same order, and the length of
+         * the chunk. The _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to the following form:
+         *
+         * @code{.cpp}
+         * void(const entity_type *, Owned *, Other *..., size_type);
+         * @endcode
+         *
+         * Chunks start at multiples of the given length in the packed arrays or
+         * where pages of paged storage classes begin. Arrays and pages are aligned
+         * to `ENTT_INSTANCE_ALIGNMENT` bytes unless storage_traits say otherwise,
+         * thus the components of every chunk are that aligned as long as the
+         * given length times their size is a multiple of the alignment, as it is
+         * for lengths that are large enough powers of two. Shorter chunks are
+         * produced at the end of the group and where pages end.
+         *
+         * @note
+         * Unlike `each`, chunks are returned in the order of the packed arrays.
+         * Types that aren't owned by the group cannot be iterated in chunks, since
+         * their instances aren't laid out contiguously.
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         * @param chunk Maximum length of the chunks.
+         */
+        template<typename Func>
+        void each_chunk(Func func, const size_type chunk = (std::numeric_limits<size_type>::max)()) const {
+            for (auto&& args : chunks(chunk)) {
+                std::apply(func, args);
+            }
+        }
+
+        /**
+         * @brief Returns an iterable object to visit the group in chunks.
+         *
+         * Chunks are the same as those of `each_chunk`. Each element of the range
+         * is a tuple of the arguments that `each_chunk` passes to its function
+         * object:
+         *
+         * @code{.cpp}
+         * for(auto [entities, owned, other, count]: group.chunks(256)) {
+         *     // ...
+         * }
+         * @endcode
+         *
+         * The range contains a copy of the group and is invalidated as the
+         * latter is.
+         *
+         * @param chunk Maximum length of the chunks.
+         * @return An iterable object to use to visit the group in chunks.
+         */
+        auto chunks(const size_type chunk = (std::numeric_limits<size_type>::max)()) const {
+            ENTT_ASSERT(chunk);
+            return internal::chunk_range<basic_group>{ *this, chunk };
+        }
+
+        /**
+         * @brief Sort a group according to the given comparison function.
+         *
+         * Sort the group so that iterating it with a couple of iterators returns
+         * entities and components in the expected order. See `begin` and `end` for
+         * more details.
+         *
+         * The comparison function object must return `true` if the first element
+         * is _less_ than the second one, `false` otherwise. The signature of the
+         * comparison function should be equivalent to one of the following:
+         *
+         * @code{.cpp}
+         * bool(std::tuple<Component &...>, std::tuple<Component &...>);
+         * bool(const Component &, const Component &);
+         * bool(const Entity, const Entity);
+         * @endcode
+         *
+         * Where `Component` are either owned types or not but still such that they
+         * are iterated by the group.<br/>
+         * Moreover, the comparison function object shall induce a
+         * _strict weak ordering_ on the values.
+         *
+         * The sort function oject must offer a member function template
+         * `operator()` that accepts three arguments:
+         *
+         * * An iterator to the first element of the range to sort.
+         * * An iterator past the last element of the range to sort.
+         * * A comparison function to use to compare the elements.
+         *
+         * The comparison function object received by the sort function object
+         * hasn't necessarily the type of the one passed along with the other
+         * parameters to this member function.
+         *
+         * @note
+         * Attempting to iterate elements using a raw pointer returned by a call to
+         * either `data` or `raw` gives no guarantees on the order, even though
+         * `sort` has been invoked.
+         *
+         * @tparam Component Optional types of components to compare.
+         * @tparam Compare Type of comparison function object.
+         * @tparam Sort Type of sort function object.
+         * @tparam Args Types of arguments to forward to the sort function object.
+         * @param compare A valid comparison function object.
+         * @param algo A valid sort function object.
+         * @param args Arguments to forward to the sort function object, if any.
+         */
+        template<typename... Component, typename Compare, typename Sort = std_sort, typename... Args>
+        void sort(Compare compare, Sort algo = Sort{}, Args&& ... args) {
+            auto* cpool = std::get<pool_type<Owned>*>(pools);
+
+            if constexpr (sizeof...(Component) == 0) {
+                static_assert(std::is_invocable_v<Compare, const entity_type, const entity_type>);
+                cpool->sort(cpool->end() - *length, cpool->end(), std::move(compare), std::move(algo), std::forward<Args>(args)...);
+            }
+            else {
+                cpool->sort(cpool->end() - *length, cpool->end(), [this, compare = std::move(compare)](const entity_type lhs, const entity_type rhs) {
+                    // useless this-> used to suppress a warning with clang
+                    return compare(this->get<Component...>(lhs), this->get<Component...>(rhs));
+                }, std::move(algo), std::forward<Args>(args)...);
+            }
+
+            for (auto next = *length; next; --next) {
+                const auto pos = next - 1;
+                const auto entt = cpool->data()[pos];
+                (std::get<pool_type<Other>*>(pools)->swap(pos, std::get<pool_type<Other>*>(pools)->index(entt)), ...);
+            }
+        }
+
+    private:
+        const typename basic_registry<Entity>::size_type* length;
+        const std::tuple<pool_type<Owned>*, pool_type<Other>* ..., pool_type<Get>* ...> pools;
+    };
+
+
+}
+
+
+#endif // ENTT_ENTITY_GROUP_HPP
+
+// #include "view.hpp"
+#ifndef ENTT_ENTITY_VIEW_HPP
+#define ENTT_ENTITY_VIEW_HPP
+
+
+#include <iterator>
+#include <limits>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+// #include "../config/config.h"
+
+// #include "../core/type_traits.hpp"
+
+// #include "sparse_set.hpp"
+
+// #include "storage.hpp"
+
+// #include "entity.hpp"
+
+// #include "fwd.hpp"
+
+
+
+namespace entt {
+
+
+    /**
+     * @brief Multi component view.
+     *
+     * Multi component views iterate over those entities that have at least all the
+     * given components in their bags. During initialization, a multi component view
+     * looks at the number of entities available for each component and picks up a
+     * reference to the smallest set of candidate entities in order to get a
+     * performance boost when iterate.<br/>
+     * Order of elements during iterations are highly dependent on the order of the
+     * underlying data structures. See sparse_set and its specializations for more
+     * details.
+     *
+     * @b Important
+     *
+     * Iterators aren't invalidated if:
+     *
+     * * New instances of the given components are created and assigned to entities.
+     * * The entity currently pointed is modified (as an example, if one of the
+     *   given components is removed from the entity to which the iterator points).
+     * * The entity currently pointed is destroyed.
+     *
+     * In all the other cases, modifying the pools of the given components in any
+     * way invalidates all the iterators and using them results in undefined
+     * behavior.
+     *
+     * @note
+     * Views share references to the underlying data structures of the registry that
+     * generated them. Therefore any change to the entities and to the components
+     * made by means of the registry are immediately reflected by views.
+     *
+     * @warning
+     * Lifetime of a view must overcome the one of the registry that generated it.
+     * In any other case, attempting to use a view results in undefined behavior.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * @tparam Component Types of components iterated by the view.
+     */
+    template<typename Entity, typename... Component>
+    class basic_view {
+        static_assert(sizeof...(Component) > 1);
+
+        /*! @brief A registry is allowed to create views. */
+        friend class basic_registry<Entity>;
+
+        template<typename Comp>
+        using pool_type = std::conditional_t<std::is_const_v<Comp>, const storage<Entity, std::remove_const_t<Comp>>, storage<Entity, Comp>>;
+
+        template<typename Comp>
+        using component_iterator_type = decltype(std::declval<pool_type<Comp>>().begin());
+
+        using underlying_iterator_type = typename sparse_set<Entity>::iterator_type;
+        using unchecked_type = std::array<const sparse_set<Entity>*, (sizeof...(Component) - 1)>;
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+
+        class iterator {
+            friend class basic_view<Entity, Component...>;
+
+            iterator(unchecked_type other, underlying_iterator_type first, underlying_iterator_type last) ENTT_NOEXCEPT
+                : unchecked{ other },
+                begin{ first },
+                end{ last }
+            {
+                if (begin != end && !valid()) {
+                    ++(*this);
+                }
+            }
+
+            bool valid() const ENTT_NOEXCEPT {
+                return std::all_of(unchecked.cbegin(), unchecked.cend(), [this](const sparse_set<Entity>* view) {
+                    return view->has(*begin);
+                });
+            }
+
+        public:
+            using difference_type = typename underlying_iterator_type::difference_type;
+            using value_type = typename underlying_iterator_type::value_type;
+            using pointer = typename underlying_iterator_type::pointer;
+            using reference = typename underlying_iterator_type::reference;
+            using iterator_category = std::forward_iterator_tag;
+
+            iterator() ENTT_NOEXCEPT = default;
+
+            iterator& operator++() ENTT_NOEXCEPT {
+                return (++begin != end && !valid()) ? ++(*this) : *this;
+            }
+
+            iterator operator++(int) ENTT_NOEXCEPT {
+                iterator orig = *this;
+                return ++(*this), orig;
+            }
+
+            bool operator==(const iterator& other) const ENTT_NOEXCEPT {
+                return other.begin == begin;
+            }
+
+            bool operator!=(const iterator& other) const ENTT_NOEXCEPT {
+                return !(*this == other);
+            }
+
+            pointer operator->() const ENTT_NOEXCEPT {
+                return begin.operator->();
+            }
+
+            reference operator*() const ENTT_NOEXCEPT {
+                return *operator->();
+            }
+
+        private:
+            unchecked_type unchecked;
+            underlying_iterator_type begin;
+            underlying_iterator_type end;
+        };
+
+        // we could use pool_type<Component> *..., but vs complains about it and refuses to compile for unknown reasons (likely a bug)
+        basic_view(storage<Entity, std::remove_const_t<Component>>* ... ref) ENTT_NOEXCEPT
+            : pools{ ref... }
+        {}
+
+        const sparse_set<Entity>* candidate() const ENTT_NOEXCEPT {
+            return std::min({ static_cast<const sparse_set<Entity>*>(std::get<pool_type<Component>*>(pools))... }, [](const auto* lhs, const auto* rhs) {
+                return lhs->size() < rhs->size();
+            });
+        }
+
+        unchecked_type unchecked(const sparse_set<Entity>* view) const ENTT_NOEXCEPT {
+            unchecked_type other{};
+            typename unchecked_type::size_type pos{};
+            ((std::get<pool_type<Component>*>(pools) == view ? nullptr : (other[pos++] = std::get<pool_type<Component>*>(pools))), ...);
+            return other;
+        }
+
+        template<typename Comp, typename Other>
+        decltype(auto) get([[maybe_unused]] component_iterator_type<Comp> it, [[maybe_unused]] pool_type<Other>* cpool, [[maybe_unused]] const Entity entt) const ENTT_NOEXCEPT {
+            if constexpr (std::is_same_v<Comp, Other>) {
+                return *it;
+            }
+            else {
+                return cpool->get(entt);
+            }
+        }
+
+        template<typename Comp, typename Func, typename... Other, typename... Type>
+        void traverse(Func func, type_list<Other...>, type_list<Type...>) const {
+            const auto end = std::get<pool_type<Comp>*>(pools)->sparse_set<Entity>::end();
+            auto begin = std::get<pool_type<Comp>*>(pools)->sparse_set<Entity>::begin();
+
+            if constexpr (std::disjunction_v<std::is_same<Comp, Type>...>) {
+                std::for_each(begin, end, [this, raw = std::get<pool_type<Comp>*>(pools)->begin(), &func](const auto entity) mutable {
+                    auto curr = raw++;
+
+                    if ((std::get<pool_type<Other>*>(pools)->has(entity) && ...)) {
+                        if constexpr (std::is_invocable_v < Func, decltype(get<Type>({}))... > ) {
+                            func(get<Comp, Type>(curr, std::get<pool_type<Type>*>(pools), entity)...);
+                        }
+                        else {
+                            func(entity, get<Comp, Type>(curr, std::get<pool_type<Type>*>(pools), entity)...);
+                        }
+                    }
+                });
+            }
+            else {
+                std::for_each(begin, end, [this, &func](const auto entity) mutable {
+                    if ((std::get<pool_type<Other>*>(pools)->has(entity) && ...)) {
+                        if constexpr (std::is_invocable_v < Func, decltype(get<Type>({}))... > ) {
+                            func(std::get<pool_type<Type>*>(pools)->get(entity)...);
+                        }
+                        else {
+                            func(entity, std::get<pool_type<Type>*>(pools)->get(entity)...);
+                        }
+                    }
+                });
+            }
+        }
+
+        bool intersectable() const ENTT_NOEXCEPT {
+            return (std::get<pool_type<Component>*>(pools)->tracks_presence() && ...);
+        }
+
+        template<typename Func, typename... Type>
+        void intersect(Func func, type_list<Type...>) const {
+            const std::array<const sparse_set<Entity>*, sizeof...(Component)> cpools{ std::get<pool_type<Component>*>(pools)... };
+
+            internal::intersect_presence(cpools, std::array<const sparse_set<Entity>*, 0>{}, [this, &cpools, &func](const auto id) {
+                const auto entity = cpools[0]->resolve(id);
+
+                if constexpr (std::is_invocable_v < Func, decltype(get<Type>({}))... > ) {
+                    func(std::get<pool_type<Type>*>(pools)->get(entity)...);
+                }
+                else {
+                    func(entity, std::get<pool_type<Type>*>(pools)->get(entity)...);
+                }
+            });
+        }
+
+    public:
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+        /*! @brief Input iterator type. */
+        using iterator_type = iterator;
+
+        /**
+         * @brief Returns the number of existing components of the given type.
+         * @tparam Comp Type of component of which to return the size.
+         * @return Number of existing components of the given type.
+         */
+        template<typename Comp>
+        size_type size() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Comp>*>(pools)->size();
+        }
+
+        /**
+         * @brief Estimates the number of entities that have the given components.
+         * @return Estimated number of entities that have the given components.
+         */
+        size_type size() const ENTT_NOEXCEPT {
+            return std::min({ std::get<pool_type<Component>*>(pools)->size()... });
+        }
+
+        /**
+         * @brief Checks whether the pool of a given component is empty.
+         * @tparam Comp Type of component in which one is interested.
+         * @return True if the pool of the given component is empty, false
+         * otherwise.
+         */
+        template<typename Comp>
+        bool empty() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Comp>*>(pools)->empty();
+        }
+
+        /**
+         * @brief Checks if the view is definitely empty.
+         * @return True if the view is definitely empty, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return (std::get<pool_type<Component>*>(pools)->empty() || ...);
+        }
+
+        /**
+         * @brief Direct access to the list of components of a given pool.
+         *
+         * The returned pointer is such that range
+         * `[raw<Comp>(), raw<Comp>() + size<Comp>()]` is always a valid range, even
+         * if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the components. Use `begin` and
+         * `end` if you want to iterate the view in the expected order.
+         *
+         * @tparam Comp Type of component in which one is interested.
+         * @return A pointer to the array of components.
+         */
+        template<typename Comp>
+        Comp* raw() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Comp>*>(pools)->raw();
+        }
+
+        /**
+         * @brief Direct access to the list of entities of a given pool.
+         *
+         * The returned pointer is such that range
+         * `[data<Comp>(), data<Comp>() + size<Comp>()]` is always a valid range,
+         * even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the entities. Use `begin` and
+         * `end` if you want to iterate the view in the expected order.
+         *
+         * @tparam Comp Type of component in which one is interested.
+         * @return A pointer to the array of entities.
+         */
+        template<typename Comp>
+        const entity_type* data() const ENTT_NOEXCEPT {
+            return std::get<pool_type<Comp>*>(pools)->data();
+        }
+
+        /**
+         * @brief Returns an iterator to the first entity that has the given
+         * components.
+         *
+         * The returned iterator points to the first entity that has the given
+         * components. If the view is empty, the returned iterator will be equal to
+         * `end()`.
+         *
+         * @note
+         * Input iterators stay true to the order imposed to the underlying data
+         * structures.
+         *
+         * @return An iterator to the first entity that has the given components.
+         */
+        iterator_type begin() const ENTT_NOEXCEPT {
+            const auto* view = candidate();
+            return iterator_type{ unchecked(view), view->begin(), view->end() };
+        }
+
+        /**
+         * @brief Returns an iterator that is past the last entity that has the
+         * given components.
+         *
+         * The returned iterator points to the entity following the last entity that
+         * has the given components. Attempting to dereference the returned iterator
+         * results in undefined behavior.
+         *
+         * @note
+         * Input iterators stay true to the order imposed to the underlying data
+         * structures.
+         *
+         * @return An iterator to the entity following the last entity that has the
+         * given components.
+         */
+        iterator_type end() const ENTT_NOEXCEPT {
+            const auto* view = candidate();
+            return iterator_type{ unchecked(view), view->end(), view->end() };
+        }
+
+        /**
+         * @brief Finds an entity.
+         * @param entt A valid entity identifier.
+         * @return An iterator to the given entity if it's found, past the end
+         * iterator otherwise.
+         */
+        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
+            const auto* view = candidate();
+            iterator_type it{ unchecked(view), view->find(entt), view->end() };
+            return (it != end() && *it == entt) ? it : end();
+        }
+
+        /**
+         * @brief Checks if a view contains an entity.
+         * @param entt A valid entity identifier.
+         * @return True if the view contains the given entity, false otherwise.
+         */
+        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
+            return find(entt) != end();
+        }
+
+        /**
+         * @brief Returns the components assigned to the given entity.
+         *
+         * Prefer this function instead of `registry::get` during iterations. It has
+         * far better performance than its companion function.
+         *
+         * @warning
+         * Attempting to use an invalid component type results in a compilation
+         * error. Attempting to use an entity that doesn't belong to the view
+         * results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * view doesn't contain the given entity.
+         *
+         * @tparam Comp Types of components to get.
+         * @param entt A valid entity identifier.
+         * @return The components assigned to the entity.
+         */
+        template<typename... Comp>
+        decltype(auto) get([[maybe_unused]] const entity_type entt) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(contains(entt));
+
+            if constexpr (sizeof...(Comp) == 1) {
+                return (std::get<pool_type<Comp>*>(pools)->get(entt), ...);
+            }
+            else {
+                return std::tuple<decltype(get<Comp>(entt))...>{get<Comp>(entt)...};
+            }
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to all its components. The
+         * _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Component &...);
+         * void(Component &...);
+         * @endcode
+         *
+         * When all the pools track their presence, the view intersects their
+         * presence bitsets rather than probing the pools entity by entity. Empty
+         * ranges are skipped as a whole and entities are returned in the order of
+         * their identifiers in this case.
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned during iterations. They can be caught only by copy or with
+         * const references.
+         *
+         * @sa sparse_set::track_presence
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void each(Func func) const {
+            if (intersectable()) {
+                intersect(std::move(func), type_list<Component...>{});
+            }
+            else {
+                const auto* view = candidate();
+                ((std::get<pool_type<Component>*>(pools) == view ? each<Component>(std::move(func)) : void()), ...);
+            }
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to all its components. The
+         * _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Component &...);
+         * void(Component &...);
+         * @endcode
+         *
+         * The pool of the suggested component is used to lead the iterations. The
+         * returned entities will therefore respect the order of the pool associated
+         * with that type.<br/>
+         * It is no longer guaranteed that the performance is the best possible, but
+         * there will be greater control over the order of iteration.
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned during iterations. They can be caught only by copy or with
+         * const references.
+         *
+         * @tparam Comp Type of component to use to enforce the iteration order.
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Comp, typename Func>
+        void each(Func func) const {
+            using other_type = type_list_cat_t<std::conditional_t<std::is_same_v<Comp, Component>, type_list<>, type_list<Component>>...>;
+            traverse<Comp>(std::move(func), other_type{}, type_list<Component...>{});
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to non-empty components. The
+         * _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Type &...);
+         * void(Type &...);
+         * @endcode
+         *
+         * @sa each
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void less(Func func) const {
+            if (intersectable()) {
+                using non_empty_type = type_list_cat_t<std::conditional_t<std::is_empty_v<Component>, type_list<>, type_list<Component>>...>;
+                intersect(std::move(func), non_empty_type{});
+            }
+            else {
+                const auto* view = candidate();
+                ((std::get<pool_type<Component>*>(pools) == view ? less<Component>(std::move(func)) : void()), ...);
+            }
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to non-empty components. The
+         * _constness_ of the components is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Type &...);
+         * void(Type &...);
+         * @endcode
+         *
+         * The pool of the suggested component is used to lead the iterations. The
+         * returned entities will therefore respect the order of the pool associated
+         * with that type.<br/>
+         * It is no longer guaranteed that the performance is the best possible, but
+         * there will be greater control over the order of iteration.
+         *
+         * @sa each
+         *
+         * @tparam Comp Type of component to use to enforce the iteration order.
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Comp, typename Func>
+        void less(Func func) const {
+            using other_type = type_list_cat_t<std::conditional_t<std::is_same_v<Comp, Component>, type_list<>, type_list<Component>>...>;
+            using non_empty_type = type_list_cat_t<std::conditional_t<std::is_empty_v<Component>, type_list<>, type_list<Component>>...>;
+            traverse<Comp>(std::move(func), other_type{}, non_empty_type{});
+        }
+
+    private:
+        const std::tuple<pool_type<Component>* ...> pools;
+    };
+
+
+    /**
+     * @brief Single component view specialization.
+     *
+     * Single component views are specialized in order to get a boost in terms of
+     * performance. This kind of views can access the underlying data structure
+     * directly and avoid superfluous checks.<br/>
+     * Order of elements during iterations are highly dependent on the order of the
+     * underlying data structure. See sparse_set and its specializations for more
+     * details.
+     *
+     * @b Important
+     *
+     * Iterators aren't invalidated if:
+     *
+     * * New instances of the given component are created and assigned to entities.
+     * * The entity currently pointed is modified (as an example, the given
+     *   component is removed from the entity to which the iterator points).
+     * * The entity currently pointed is destroyed.
+     *
+     * In all the other cases, modifying the pool of the given component in any way
+     * invalidates all the iterators and using them results in undefined behavior.
+     *
+     * @note
+     * Views share a reference to the underlying data structure of the registry that
+     * generated them. Therefore any change to the entities and to the components
+     * made by means of the registry are immediately reflected by views.
+     *
+     * @warning
+     * Lifetime of a view must overcome the one of the registry that generated it.
+     * In any other case, attempting to use a view results in undefined behavior.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * @tparam Component Type of component iterated by the view.
+     */
+    template<typename Entity, typename Component>
+    class basic_view<Entity, Component> {
+        /*! @brief A registry is allowed to create views. */
+        friend class basic_registry<Entity>;
+        /*! @brief Chunk ranges are allowed to visit views. */
+        friend class internal::chunk_range<basic_view>;
+
+        using pool_type = std::conditional_t<std::is_const_v<Component>, const storage<Entity, std::remove_const_t<Component>>, storage<Entity, Component>>;
+
+        basic_view(pool_type* ref) ENTT_NOEXCEPT
+            : pool{ ref }
+        {}
+
+    public:
+        /*! @brief Type of component iterated by the view. */
+        using raw_type = Component;
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+        /*! @brief Input iterator type. */
+        using iterator_type = typename sparse_set<Entity>::iterator_type;
+
+        /**
+         * @brief Returns the number of entities that have the given component.
+         * @return Number of entities that have the given component.
+         */
+        size_type size() const ENTT_NOEXCEPT {
+            return pool->size();
+        }
+
+        /**
+         * @brief Checks whether the view is empty.
+         * @return True if the view is empty, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return pool->empty();
+        }
+
+        /**
+         * @brief Direct access to the list of components.
+         *
+         * The returned pointer is such that range `[raw(), raw() + size()]` is
+         * always a valid range, even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the components. Use `begin` and
+         * `end` if you want to iterate the view in the expected order.
+         *
+         * @return A pointer to the array of components.
+         */
+        raw_type* raw() const ENTT_NOEXCEPT {
+            return pool->raw();
+        }
+
+        /**
+         * @brief Direct access to the list of entities.
+         *
+         * The returned pointer is such that range `[data(), data() + size()]` is
+         * always a valid range, even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the entities. Use `begin` and
+         * `end` if you want to iterate the view in the expected order.
+         *
+         * @return A pointer to the array of entities.
+         */
+        const entity_type* data() const ENTT_NOEXCEPT {
+            return pool->data();
+        }
+
+        /**
+         * @brief Returns an iterator to the first entity that has the given
+         * component.
+         *
+         * The returned iterator points to the first entity that has the given
+         * component. If the view is empty, the returned iterator will be equal to
+         * `end()`.
+         *
+         * @note
+         * Input iterators stay true to the order imposed to the underlying data
+         * structures.
+         *
+         * @return An iterator to the first entity that has the given component.
+         */
+        iterator_type begin() const ENTT_NOEXCEPT {
+            return pool->sparse_set<Entity>::begin();
+        }
+
+        /**
+         * @brief Returns an iterator that is past the last entity that has the
+         * given component.
+         *
+         * The returned iterator points to the entity following the last entity that
+         * has the given component. Attempting to dereference the returned iterator
+         * results in undefined behavior.
+         *
+         * @note
+         * Input iterators stay true to the order imposed to the underlying data
+         * structures.
+         *
+         * @return An iterator to the entity following the last entity that has the
+         * given component.
+         */
+        iterator_type end() const ENTT_NOEXCEPT {
+            return pool->sparse_set<Entity>::end();
+        }
+
+        /**
+         * @brief Finds an entity.
+         * @param entt A valid entity identifier.
+         * @return An iterator to the given entity if it's found, past the end
+         * iterator otherwise.
+         */
+        iterator_type find(const entity_type entt) const ENTT_NOEXCEPT {
+            const auto it = pool->find(entt);
+            return it != end() && *it == entt ? it : end();
+        }
+
+        /**
+         * @brief Returns the identifier that occupies the given position.
+         * @param pos Position of the element to return.
+         * @return The identifier that occupies the given position.
+         */
+        entity_type operator[](const size_type pos) const ENTT_NOEXCEPT {
+            return begin()[pos];
+        }
+
+        /**
+         * @brief Checks if a view contains an entity.
+         * @param entt A valid entity identifier.
+         * @return True if the view contains the given entity, false otherwise.
+         */
+        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
+            return find(entt) != end();
+        }
+
+        /**
+         * @brief Returns the component assigned to the given entity.
+         *
+         * Prefer this function instead of `registry::get` during iterations. It has
+         * far better performance than its companion function.
+         *
+         * @warning
+         * Attempting to use an entity that doesn't belong to the view results in
+         * undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * view doesn't contain the given entity.
+         *
+         * @param entt A valid entity identifier.
+         * @return The component assigned to the entity.
+         */
+        decltype(auto) get(const entity_type entt) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(contains(entt));
+            return pool->get(entt);
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a reference to its component. The _constness_ of the
+         * component is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Component &);
+         * void(Component &);
+         * @endcode
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned during iterations. They can be caught only by copy or with
+         * const references.
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void each(Func func) const {
+            if constexpr (std::is_invocable_v < Func, decltype(get({})) > ) {
+                std::for_each(pool->begin(), pool->end(), std::move(func));
+            }
+            else {
+                std::for_each(pool->sparse_set<Entity>::begin(), pool->sparse_set<Entity>::end(), [&func, raw = pool->begin()](const auto entt) mutable {
+                    func(entt, *(raw++));
+                });
+            }
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a reference to its component if it's a non-empty one.
+         * The _constness_ of the component is as requested.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms in case the component isn't an empty one:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Component &);
+         * void(Component &);
+         * @endcode
+         *
+         * In case the component is an empty one instead, the following forms are
+         * accepted:
+         *
+         * @code{.cpp}
+         * void(const entity_type);
+         * void();
+         * @endcode
+         *
+         * @sa each
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void less(Func func) const {
+            if constexpr (std::is_empty_v<Component>) {
+                if constexpr (std::is_invocable_v<Func>) {
+                    for (auto pos = pool->size(); pos; --pos) {
+                        func();
+                    }
+                }
+                else {
+                    std::for_each(pool->sparse_set<Entity>::begin(), pool->sparse_set<Entity>::end(), std::move(func));
+                }
+            }
+            else {
+                each(std::move(func));
+            }
+        }
+
+        /**
+         * @brief Iterates entities and components in chunks and applies the given
+         * function object to them.
+         *
+         * The function object is invoked once per chunk. It is provided with a
+         * pointer to the entities of the chunk, a pointer to their components if
+         * the component isn't an empty one and the length of the chunk. The
+         * _constness_ of the component is as requested.<br/>
+         * The signature of the function must be equivalent to the following form
+         * in case the component isn't an empty one:
+         *
+         * @code{.cpp}
+         * void(const entity_type *, Component *, size_type);
+         * @endcode
+         *
+         * In case the component is an empty one instead, the following form is
+         * accepted:
+         *
+         * @code{.cpp}
+         * void(const entity_type *, size_type);
+         * @endcode
+         *
+         * Chunks start at multiples of the given length in the packed arrays or
+         * where pages of paged storage classes begin. Arrays and pages are aligned
+         * to `ENTT_INSTANCE_ALIGNMENT` bytes unless storage_traits say otherwise,
+         * thus the components of every chunk are that aligned as long as the
+         * given length times their size is a multiple of the alignment, as it is
+         * for lengths that are large enough powers of two. Shorter chunks are
+         * produced at the end of the view and where pages end.
+         *
+         * @note
+         * Unlike `each`, chunks are returned in the order of the packed arrays.
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         * @param chunk Maximum length of the chunks.
+         */
+        template<typename Func>
+        void each_chunk(Func func, const size_type chunk = (std::numeric_limits<size_type>::max)()) const {
+            for (auto&& args : chunks(chunk)) {
+                std::apply(func, args);
+            }
+        }
+
+        /**
+         * @brief Returns an iterable object to visit the view in chunks.
+         *
+         * Chunks are the same as those of `each_chunk`. Each element of the range
+         * is a tuple of the arguments that `each_chunk` passes to its function
+         * object:
+         *
+         * @code{.cpp}
+         * for(auto [entities, instances, count]: registry.view<position>().chunks(256)) {
+         *     // ...
+         * }
+         * @endcode
+         *
+         * The range contains a copy of the view and is invalidated as the latter
+         * is.
+         *
+         * @param chunk Maximum length of the chunks.
+         * @return An iterable object to use to visit the view in chunks.
+         */
+        auto chunks(const size_type chunk = (std::numeric_limits<size_type>::max)()) const {
+            ENTT_ASSERT(chunk);
+            return internal::chunk_range<basic_view>{ *this, chunk };
+        }
+
+    private:
+        auto chunk_at(const size_type pos, const size_type chunk) const {
+            const auto count = std::min(pool->size() - pos, chunk - pos % chunk);
+
+            if constexpr (std::is_empty_v<Component>) {
+                return std::make_tuple(pool->data() + pos, count);
+            }
+            else {
+                return std::make_tuple(pool->data() + pos, pool->raw(pos), std::min(count, pool->contiguous(pos)));
+            }
+        }
+
+        pool_type* pool;
+    };
+
+
+}
+
+
+#endif // ENTT_ENTITY_VIEW_HPP
+
+// #include "query.hpp"
+#ifndef ENTT_ENTITY_QUERY_HPP
+#define ENTT_ENTITY_QUERY_HPP
+
+
+#include <array>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <type_traits>
+// #include "../config/config.h"
+
+// #include "../core/type_traits.hpp"
+
+// #include "sparse_set.hpp"
+
+// #include "storage.hpp"
+
+// #include "utility.hpp"
+
+// #include "fwd.hpp"
+
+
+
+namespace entt {
+
+
+    /**
+     * @brief Persistent query.
+     *
+     * A query returns all the entities and only the entities that have at least
+     * the given components and none of the excluded ones. Optional components are
+     * returned when available and don't affect the set of entities.
+     *
+     * Queries are registered once and then kept up-to-date by the registry, that
+     * moves entities in and out of them as components are assigned and removed.
+     * For each entity, a query also stores the positions of its components within
+     * their pools. Therefore, iterating a query is a walk over two dense arrays and
+     * never looks up entities in the sparse arrays of the pools.<br/>
+     * Positions are refreshed by the registry when the query is requested, if
+     * pools have been sorted or rearranged by owning groups in the meantime.
+     *
+     * @b Important
+     *
+     * Iterators aren't invalidated if:
+     *
+     * * New instances of the given components are created and assigned to entities.
+     * * The entity currently pointed is modified (as an example, if one of the
+     *   given components is removed from the entity to which the iterator points).
+     * * The entity currently pointed is destroyed.
+     *
+     * In all the other cases, modifying the pools of the given components in any
+     * way invalidates all the iterators and using them results in undefined
+     * behavior.<br/>
+     * Sorting pools or creating groups that own the given components also
+     * invalidates the positions cached by a query. Request it again to the registry
+     * rather than storing it.
+     *
+     * @note
+     * Queries share references to the underlying data structures of the registry
+     * that generated them. Therefore any change to the entities and to the
+     * components made by means of the registry are immediately reflected by all the
+     * queries.
+     *
+     * @warning
+     * Lifetime of a query must overcome the one of the registry that generated it.
+     * In any other case, attempting to use a query results in undefined behavior.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * @tparam Exclude Types of components used to filter the query.
+     * @tparam Optional Types of components returned when available.
+     * @tparam Get Types of components iterated by the query.
+     */
+    template<typename Entity, typename... Exclude, typename... Optional, typename... Get>
+    class basic_query<Entity, exclude_t<Exclude...>, optional_t<Optional...>, Get...> {
+        /*! @brief A registry is allowed to create queries. */
+        friend class basic_registry<Entity>;
+
+        static_assert(!std::disjunction_v<std::is_empty<Optional>...>);
+
+        template<typename Component>
+        using pool_type = std::conditional_t<std::is_const_v<Component>, const storage<Entity, std::remove_const_t<Component>>, storage<Entity, Component>>;
+
+        using index_type = std::array<std::size_t, sizeof...(Get) + sizeof...(Optional)>;
+
+        static constexpr auto null = (std::numeric_limits<std::size_t>::max)();
+
+        basic_query(sparse_set<Entity>* ref, const std::vector<index_type>* idx, pool_type<Get>* ... gpool, pool_type<Optional>* ... opool) ENTT_NOEXCEPT
+            : handler{ ref },
+            indices{ idx },
+            pools{ gpool..., opool... }
+        {}
+
+        template<typename Component>
+        auto fetch([[maybe_unused]] const std::size_t pos) const {
+            if constexpr (std::disjunction_v<std::is_same<Component, Optional>...>) {
+                return std::make_tuple(pos == null ? nullptr : std::get<pool_type<Component>*>(pools)->raw(pos));
+            }
+            else if constexpr (std::is_empty_v<Component>) {
+                return std::make_tuple(std::remove_const_t<Component>{});
+            }
+            else {
+                return std::forward_as_tuple(*std::get<pool_type<Component>*>(pools)->raw(pos));
+            }
+        }
+
+        template<typename Func, typename... Args>
+        static constexpr bool with_entity(std::tuple<Args...>*) ENTT_NOEXCEPT {
+            return std::is_invocable_v<Func, const Entity, Args...>;
+        }
+
+        template<typename Func, std::size_t... GIndex, std::size_t... OIndex>
+        void traverse(Func func, std::index_sequence<GIndex...>, std::index_sequence<OIndex...>) const {
+            using args_type = decltype(std::tuple_cat(fetch<Get>({})..., fetch<Optional>({})...));
+            const auto* entities = handler->data();
+
+            // backwards, so that the current entity can be safely removed
+            for (auto pos = handler->size(); pos; --pos) {
+                const auto& row = (*indices)[pos - 1];
+
+                if constexpr (with_entity<Func>(static_cast<args_type*>(nullptr))) {
+                    std::apply(func, std::tuple_cat(std::make_tuple(entities[pos - 1]), fetch<Get>(row[GIndex])..., fetch<Optional>(row[sizeof...(Get) + OIndex])...));
+                }
+                else {
+                    std::apply(func, std::tuple_cat(fetch<Get>(row[GIndex])..., fetch<Optional>(row[sizeof...(Get) + OIndex])...));
+                }
+            }
+        }
+
+    public:
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+        /*! @brief Input iterator type. */
+        using iterator_type = typename sparse_set<Entity>::iterator_type;
+
+        /**
+         * @brief Returns the number of entities that match the query.
+         * @return Number of entities that match the query.
+         */
+        size_type size() const ENTT_NOEXCEPT {
+            return handler->size();
+        }
+
+        /**
+         * @brief Checks whether a query is empty.
+         * @return True if the query is empty, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return handler->empty();
+        }
+
+        /**
+         * @brief Direct access to the list of entities.
+         *
+         * The returned pointer is such that range `[data(), data() + size()]` is
+         * always a valid range, even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the entities. Use `begin` and
+         * `end` if you want to iterate the query in the expected order.
+         *
+         * @return A pointer to the array of entities.
+         */
+        const entity_type* data() const ENTT_NOEXCEPT {
+            return handler->data();
+        }
+
+        /**
+         * @brief Returns an iterator to the first entity that matches the query.
+         *
+         * The returned iterator points to the first entity that matches the query.
+         * If the query is empty, the returned iterator will be equal to `end()`.
+         *
+         * @return An iterator to the first entity that matches the query.
+         */
+        iterator_type begin() const ENTT_NOEXCEPT {
+            return handler->begin();
+        }
+
+        /**
+         * @brief Returns an iterator that is past the last entity that matches
+         * the query.
+         *
+         * The returned iterator points to the entity following the last entity that
+         * matches the query. Attempting to dereference the returned iterator results
+         * in undefined behavior.
+         *
+         * @return An iterator to the entity following the last entity that matches
+         * the query.
+         */
+        iterator_type end() const ENTT_NOEXCEPT {
+            return handler->end();
+        }
+
+        /**
+         * @brief Checks if a query contains an entity.
+         * @param entt A valid entity identifier.
+         * @return True if the query contains the given entity, false otherwise.
+         */
+        bool contains(const entity_type entt) const ENTT_NOEXCEPT {
+            return handler->has(entt);
+        }
+
+        /**
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
+         *
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself, a reference to each component iterated by the query and a
+         * pointer to each optional component, that is null if the entity doesn't
+         * have it.<br/>
+         * The signature of the function must be equivalent to one of the following
+         * forms:
+         *
+         * @code{.cpp}
+         * void(const entity_type, Get &..., Optional *...);
+         * void(Get &..., Optional *...);
+         * @endcode
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned during iterations. They can be caught only by copy or with
+         * const references.
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
+         */
+        template<typename Func>
+        void each(Func func) const {
+            traverse(std::move(func), std::index_sequence_for<Get...>{}, std::index_sequence_for<Optional...>{});
+        }
+
+    private:
+        sparse_set<entity_type>* handler;
+        const std::vector<index_type>* indices;
+        const std::tuple<pool_type<Get>*..., pool_type<Optional>*...> pools;
+    };
+
+
+}
+
+
+#endif // ENTT_ENTITY_QUERY_HPP
+
+// #include "fwd.hpp"
+
+
+
+namespace entt {
+
+
+    /**
+     * @brief Memory and occupancy of a pool of components.
+     *
+     * The packed part is made of the arrays of entities and objects, the sparse
+     * part of the pages that map entities to positions in the packed arrays.
+     */
+    struct pool_statistics {
+        /*! @brief Runtime identifier of the type of component. */
+        ENTT_ID_TYPE type;
+        /*! @brief Number of entities assigned the component. */
+        std::size_t size;
+        /*! @brief Number of entities the packed arrays have room for. */
+        std::size_t capacity;
+        /*! @brief Bytes reserved by the packed arrays. */
+        std::size_t dense_bytes;
+        /*! @brief Bytes reserved by the packed arrays but not in use. */
+        std::size_t slack_bytes;
+        /*! @brief Size in bytes of a sparse page, zero in compact mode. */
+        std::size_t page_size;
+        /*! @brief Number of sparse pages allocated. */
+        std::size_t sparse_pages;
+        /*! @brief Number of sparse pages allocated but empty. */
+        std::size_t sparse_empty;
+        /*! @brief Bytes used by the sparse array and its bookkeeping. */
+        std::size_t sparse_bytes;
+        /*! @brief Number of listeners connected to the construction signal. */
+        std::size_t on_construct;
+        /*! @brief Number of listeners connected to the update signal. */
+        std::size_t on_replace;
+        /*! @brief Number of listeners connected to the destruction signal. */
+        std::size_t on_destroy;
+        /*! @brief True if the pool is owned by a group, false otherwise. */
+        bool owned;
+    };
+
+
+    /**
+     * @brief Memory and occupancy of the parts of a registry other than pools.
+     */
+    struct registry_statistics {
+        /*! @brief Number of entities created so far. */
+        std::size_t entities;
+        /*! @brief Number of entities still in use. */
+        std::size_t alive;
+        /*! @brief Bytes reserved for the entity identifiers. */
+        std::size_t entity_bytes;
+        /*! @brief Number of pools of components. */
+        std::size_t pools;
+        /*! @brief Number of groups. */
+        std::size_t groups;
+        /*! @brief Number of context variables. */
+        std::size_t context;
+    };
+
+
+    /**
+     * @brief Fast and reliable entity-component system.
+     *
+     * The registry is the core class of the entity-component framework.<br/>
+     * It stores entities and arranges pools of components on a per request basis.
+     * By means of a registry, users can manage entities and components and thus
+     * create views or groups to iterate them.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     */
+    template<typename Entity>
+    class basic_registry {
+        using context_family = family<struct internal_registry_context_family>;
+        using component_family = family<struct internal_registry_component_family>;
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+
+        struct group_type {
+            std::size_t owned{};
+        };
+
+        template<typename Component>
+        struct pool_handler : storage<Entity, Component> {
+            group_type* group{};
+            std::atomic<std::uint64_t> version{};
+            std::uint64_t layout{};
+
+            // progress of an incremental sort against another pool
+            struct {
+                ENTT_ID_TYPE leader{};
+                bool running{};
+                bool synced{};
+                std::size_t next{};
+                std::size_t last{};
+                std::size_t swaps{};
+            } follow{};
+
+            pool_handler(std::pmr::memory_resource* resource, const std::size_t page)
+                : storage<Entity, Component>{ resource, page }
+            {}
+
+            pool_handler(const storage<Entity, Component>& other)
+                : storage<Entity, Component>{ other }
+            {}
+
+            // listeners and groups belong to the registry, they aren't copied
+            pool_handler(const pool_handler& other)
+                : storage<Entity, Component>{ other },
+                version{ other.version.load(std::memory_order_relaxed) }
+            {}
+
+            auto on_construct() ENTT_NOEXCEPT {
+                return sink{ construction };
+            }
+
+            auto on_replace() ENTT_NOEXCEPT {
+                return sink{ update };
+            }
+
+            auto on_destroy() ENTT_NOEXCEPT {
+                return sink{ destruction };
+            }
+
+            auto on_construct_batch() ENTT_NOEXCEPT {
+                return sink{ construction_batch };
+            }
+
+            // sorting and owning groups rearrange pools only through here
+            void swap(const std::size_t lhs, const std::size_t rhs) override {
+                ++layout;
+                storage<Entity, Component>::swap(lhs, rhs);
+            }
+
+            auto on_destroy_batch() ENTT_NOEXCEPT {
+                return sink{ destruction_batch };
+            }
+
+            void describe(pool_statistics& stats) const {
+                const auto size = storage<Entity, Component>::size();
+                const auto capacity = storage<Entity, Component>::capacity();
+                stats.size = size;
+                stats.capacity = capacity;
+
+                if constexpr (std::is_empty_v<Component>) {
+                    stats.dense_bytes = capacity * sizeof(Entity);
+                    stats.slack_bytes = (capacity - size) * sizeof(Entity);
+                }
+                else {
+                    const auto objects = storage<Entity, Component>::object_capacity();
+                    stats.dense_bytes = capacity * sizeof(Entity) + objects * sizeof(Component);
+                    stats.slack_bytes = (capacity - size) * sizeof(Entity) + (objects - size) * sizeof(Component);
+                }
+
+                stats.page_size = storage<Entity, Component>::page_size();
+                stats.sparse_pages = storage<Entity, Component>::pages();
+                stats.sparse_empty = storage<Entity, Component>::empty_pages();
+                stats.sparse_bytes = storage<Entity, Component>::sparse_bytes();
+                stats.on_construct = construction.size() + construction_batch.size();
+                stats.on_replace = update.size();
+                stats.on_destroy = destruction.size() + destruction_batch.size();
+                stats.owned = group != nullptr;
+            }
+
+            template<typename... Args>
+            decltype(auto) assign(basic_registry& registry, const Entity entt, Args&& ... args) {
+                version.fetch_add(1u, std::memory_order_relaxed);
+
+                if constexpr (std::is_empty_v<Component>) {
+                    storage<Entity, Component>::construct(entt);
+                    publish_construction(registry, storage<Entity, Component>::size() - 1);
+                    construction.publish(entt, registry, Component{});
+                    return Component{ std::forward<Args>(args)... };
+                }
+                else {
+                    auto& component = storage<Entity, Component>::construct(entt, std::forward<Args>(args)...);
+                    publish_construction(registry, storage<Entity, Component>::size() - 1);
+                    construction.publish(entt, registry, component);
+                    return component;
+                }
+            }
+
+            template<typename It, typename... Comp>
+            auto batch(basic_registry& registry, It first, It last, const Comp& ... value) {
+                version.fetch_add(1u, std::memory_order_relaxed);
+                const auto offset = storage<Entity, Component>::size();
+                auto it = storage<Entity, Component>::batch(first, last, value...);
+                publish_construction(registry, offset);
+
+                if (!construction.empty()) {
+                    std::for_each(first, last, [this, &registry, it](const auto entt) mutable {
+                        construction.publish(entt, registry, *(it++));
+                    });
+                }
+
+                return it;
+            }
+
+            template<typename It, typename CIt>
+            auto insert(basic_registry& registry, It first, It last, CIt from) {
+                version.fetch_add(1u, std::memory_order_relaxed);
+                const auto offset = storage<Entity, Component>::size();
+                auto it = storage<Entity, Component>::insert(first, last, from);
+                publish_construction(registry, offset);
+
+                if (!construction.empty()) {
+                    std::for_each(first, last, [this, &registry](const auto entt) {
+                        construction.publish(entt, registry, storage<Entity, Component>::get(entt));
+                    });
+                }
+
+                return it;
+            }
+
+            template<typename It>
+            auto adopt(basic_registry& registry, It first, It last, const std::shared_ptr<const Component>& data) {
+                version.fetch_add(1u, std::memory_order_relaxed);
+                const auto offset = storage<Entity, Component>::size();
+                auto it = storage<Entity, Component>::adopt(first, last, data);
+                publish_construction(registry, offset);
+
+                if (!construction.empty()) {
+                    std::for_each(first, last, [this, &registry](const auto entt) {
+                        construction.publish(entt, registry, storage<Entity, Component>::get(entt));
+                    });
+                }
+
+                return it;
+            }
+
+            void remove(basic_registry& registry, const Entity entt) {
+                version.fetch_add(1u, std::memory_order_relaxed);
+                destruction_batch.publish(registry, &entt, std::size_t{ 1u });
+                destruction.publish(entt, registry);
+                storage<Entity, Component>::destroy(entt);
+            }
+
+            void remove(basic_registry& registry, const Entity* entities, const std::size_t count) {
+                version.fetch_add(1u, std::memory_order_relaxed);
+                destruction_batch.publish(registry, entities, count);
+
+                for (std::size_t pos{}; pos < count; ++pos) {
+                    destruction.publish(entities[pos], registry);
+                    storage<Entity, Component>::destroy(entities[pos]);
+                }
+            }
+
+            template<typename... Args>
+            decltype(auto) replace(basic_registry& registry, const Entity entt, Args&& ... args) {
+                version.fetch_add(1u, std::memory_order_relaxed);
+
+                if constexpr (std::is_empty_v<Component>) {
+                    ENTT_ASSERT((storage<Entity, Component>::has(entt)));
+                    update.publish(entt, registry, Component{});
+                    return Component{ std::forward<Args>(args)... };
+                }
+                else {
+                    Component component{ std::forward<Args>(args)... };
+                    update.publish(entt, registry, component);
+                    return (storage<Entity, Component>::get(entt) = std::move(component));
+                }
+            }
+
+        private:
+            // entities and objects from the given position on, in contiguous runs
+            // published before single listeners, owning groups move new elements from there
+            void publish_construction(basic_registry& registry, std::size_t pos) {
+                if (!construction_batch.empty()) {
+                    const auto* entities = storage<Entity, Component>::data();
+
+                    for (const auto last = storage<Entity, Component>::size(); pos < last;) {
+                        if constexpr (std::is_empty_v<Component>) {
+                            construction_batch.publish(registry, entities + pos, nullptr, last - pos);
+                            pos = last;
+                        }
+                        else {
+                            const auto count = storage<Entity, Component>::contiguous(pos);
+                            construction_batch.publish(registry, entities + pos, storage<Entity, Component>::raw(pos), count);
+                            pos += count;
+                        }
+                    }
+                }
+            }
+
+            using reference_type = std::conditional_t<std::is_empty_v<Component>, const Component&, Component&>;
+            sigh<void(const Entity, basic_registry&, reference_type)> construction{};
+            sigh<void(const Entity, basic_registry&, reference_type)> update{};
+            sigh<void(const Entity, basic_registry&)> destruction{};
+            sigh<void(basic_registry&, const Entity*, Component*, std::size_t)> construction_batch{};
+            sigh<void(basic_registry&, const Entity*, std::size_t)> destruction_batch{};
+        };
+
+        template<typename Component>
+        using pool_type = pool_handler<std::decay_t<Component>>;
+
+        template<typename...>
+        struct group_handler;
+
+        template<typename... Exclude, typename... Get>
+        struct group_handler<exclude_t<Exclude...>, get_t<Get...>> : sparse_set<Entity> {
+            std::tuple<pool_type<Get>* ..., pool_type<Exclude>* ...> cpools{};
+
+            template<typename Component>
+            void maybe_valid_if(const Entity entt) {
+                if constexpr (std::disjunction_v<std::is_same<Get, Component>...>) {
+                    if (((std::is_same_v<Component, Get> || std::get<pool_type<Get>*>(cpools)->has(entt)) && ...)
+                        && !(std::get<pool_type<Exclude>*>(cpools)->has(entt) || ...))
+                    {
+                        this->construct(entt);
+                    }
+                }
+                else if constexpr (std::disjunction_v<std::is_same<Exclude, Component>...>) {
+                    if ((std::get<pool_type<Get>*>(cpools)->has(entt) && ...)
+                        && ((std::is_same_v<Exclude, Component> || !std::get<pool_type<Exclude>*>(cpools)->has(entt)) && ...)) {
+                        this->construct(entt);
+                    }
+                }
+            }
+
+            void discard_if(const Entity entt) {
+                if (this->has(entt)) {
+                    this->destroy(entt);
+                }
+            }
+        };
+
+        template<typename... Exclude, typename... Get, typename... Owned>
+        struct group_handler<exclude_t<Exclude...>, get_t<Get...>, Owned...> : group_type {
+            std::tuple<pool_type<Owned>* ..., pool_type<Get>* ..., pool_type<Exclude>* ...> cpools{};
+
+            template<typename Component>
+            void maybe_valid_if(const Entity entt) {
+                if constexpr (std::disjunction_v<std::is_same<Owned, Component>..., std::is_same<Get, Component>...>) {
+                    if (((std::is_same_v<Component, Owned> || std::get<pool_type<Owned>*>(cpools)->has(entt)) && ...)
+                        && ((std::is_same_v<Component, Get> || std::get<pool_type<Get>*>(cpools)->has(entt)) && ...)
+                        && !(std::get<pool_type<Exclude>*>(cpools)->has(entt) || ...))
+                    {
+                        const auto pos = this->owned++;
+                        (std::get<pool_type<Owned>*>(cpools)->swap(std::get<pool_type<Owned>*>(cpools)->index(entt), pos), ...);
+                    }
+                }
+                else if constexpr (std::disjunction_v<std::is_same<Exclude, Component>...>) {
+                    if ((std::get<pool_type<Owned>*>(cpools)->has(entt) && ...)
+                        && (std::get<pool_type<Get>*>(cpools)->has(entt) && ...)
+                        && ((std::is_same_v<Exclude, Component> || !std::get<pool_type<Exclude>*>(cpools)->has(entt)) && ...))
+                    {
+                        const auto pos = this->owned++;
+                        (std::get<pool_type<Owned>*>(cpools)->swap(std::get<pool_type<Owned>*>(cpools)->index(entt), pos), ...);
+                    }
+                }
+            }
+
+            void discard_if(const Entity entt) {
+                if (std::get<0>(cpools)->has(entt) && std::get<0>(cpools)->index(entt) < this->owned) {
+                    const auto pos = --this->owned;
+                    (std::get<pool_type<Owned>*>(cpools)->swap(std::get<pool_type<Owned>*>(cpools)->index(entt), pos), ...);
+                }
+            }
+        };
+
+        template<typename...>
+        struct query_handler;
+
+        template<typename... Exclude, typename... Optional, typename... Get>
+        struct query_handler<exclude_t<Exclude...>, optional_t<Optional...>, Get...> : sparse_set<Entity> {
+            using index_type = std::array<std::size_t, sizeof...(Get) + sizeof...(Optional)>;
+            static constexpr auto null = (std::numeric_limits<std::size_t>::max)();
+
+            std::tuple<pool_type<Get>* ..., pool_type<Optional>* ..., pool_type<Exclude>* ...> cpools{};
+            std::array<std::uint64_t, sizeof...(Get) + sizeof...(Optional)> layout{};
+            std::vector<index_type> indices{};
+
+            template<typename Component>
+            static constexpr std::size_t column() ENTT_NOEXCEPT {
+                constexpr bool match[]{ std::is_same_v<Component, Get>..., std::is_same_v<Component, Optional>... };
+                std::size_t pos{};
+                while (!match[pos]) { ++pos; }
+                return pos;
+            }
+
+            template<typename Component>
+            std::size_t position(const Entity entt) const {
+                const auto* cpool = std::get<pool_type<Component>*>(cpools);
+                return cpool->has(entt) ? cpool->index(entt) : null;
+            }
+
+            void insert(const Entity entt) {
+                this->construct(entt);
+                indices.push_back({ position<Get>(entt)..., position<Optional>(entt)... });
+            }
+
+            void erase(const Entity entt) {
+                indices[this->index(entt)] = indices.back();
+                indices.pop_back();
+                this->destroy(entt);
+            }
+
+            template<typename Component>
+            void maybe_valid_if(const Entity entt) {
+                if constexpr (std::disjunction_v<std::is_same<Optional, Component>...>) {
+                    if (this->has(entt)) {
+                        indices[this->index(entt)][column<Component>()] = std::get<pool_type<Component>*>(cpools)->index(entt);
+                    }
+                }
+                else if (!this->has(entt)
+                    && ((std::is_same_v<Component, Get> || std::get<pool_type<Get>*>(cpools)->has(entt)) && ...)
+                    && ((std::is_same_v<Component, Exclude> || !std::get<pool_type<Exclude>*>(cpools)->has(entt)) && ...))
+                {
+                    insert(entt);
+                }
+            }
+
+            template<typename Component>
+            void discard_if(const Entity entt) {
+                if constexpr (std::disjunction_v<std::is_same<Optional, Component>...>) {
+                    if (this->has(entt)) {
+                        indices[this->index(entt)][column<Component>()] = null;
+                    }
+                }
+                else if (this->has(entt)) {
+                    erase(entt);
+                }
+
+                if constexpr (!std::disjunction_v<std::is_same<Exclude, Component>...>) {
+                    // the last element of the pool is about to take the place of the one removed
+                    const auto* cpool = std::get<pool_type<Component>*>(cpools);
+
+                    if (const auto last = cpool->data()[cpool->size() - 1u]; last != entt && this->has(last)) {
+                        indices[this->index(last)][column<Component>()] = cpool->index(entt);
+                    }
+                }
+            }
+
+            template<typename Component>
+            void refresh() {
+                constexpr auto col = column<Component>();
+
+                if (const auto* cpool = std::get<pool_type<Component>*>(cpools); layout[col] != cpool->layout) {
+                    const auto* entities = this->data();
+
+                    for (std::size_t pos{}, last = this->size(); pos < last; ++pos) {
+                        indices[pos][col] = position<Component>(entities[pos]);
+                    }
+
+                    layout[col] = cpool->layout;
+                }
+            }
+        };
+
+        struct pool_data {
+            std::unique_ptr<sparse_set<Entity>> pool;
+            void(*remove)(sparse_set<Entity>&, basic_registry&, const Entity);
+            void(*remove_range)(sparse_set<Entity>&, basic_registry&, const Entity*, const std::size_t);
+            std::unique_ptr<sparse_set<Entity>>(*clone)(const sparse_set<Entity>&);
+            void(*stomp)(const sparse_set<Entity>&, const Entity, basic_registry&, const Entity);
+            void(*describe)(const sparse_set<Entity>&, pool_statistics&);
+            ENTT_ID_TYPE runtime_type;
+        };
+
+        struct group_data {
+            const std::size_t extent[3];
+            std::unique_ptr<void, void(*)(void*)> group;
+            bool(*const is_same)(const component*) ENTT_NOEXCEPT;
+        };
+
+        struct ctx_variable {
+            // small singletons live in the slot itself, larger ones on the heap
+            static constexpr std::size_t inline_size = 64;
+
+            ctx_variable() = default;
+            ctx_variable(const ctx_variable&) = delete;
+            ctx_variable& operator=(const ctx_variable&) = delete;
+
+            ~ctx_variable() {
+                reset();
+            }
+
+            template<typename Type, typename... Args>
+            Type& emplace(const ENTT_ID_TYPE ctype, Args&& ... args) {
+                if constexpr (sizeof(Type) <= inline_size && alignof(Type) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Type>) {
+                    // arguments may refer to the current value, it goes away only once they are consumed
+                    Type instance{ std::forward<Args>(args)... };
+                    reset();
+                    // braces would wrap the instance in a container that has an initializer list constructor
+                    value = new (&buffer) Type(std::move(instance));
+                    destroy = [](void* ptr) { static_cast<Type*>(ptr)->~Type(); };
+                }
+                else {
+                    auto* instance = new Type{ std::forward<Args>(args)... };
+                    reset();
+                    value = instance;
+                    destroy = [](void* ptr) { delete static_cast<Type*>(ptr); };
+                }
+
+                runtime_type = ctype;
+                return *static_cast<Type*>(value);
+            }
+
+            void reset() {
+                if (value) {
+                    destroy(value);
+                    value = nullptr;
+                }
+            }
+
+            std::aligned_storage_t<inline_size, alignof(std::max_align_t)> buffer;
+            void* value{};
+            void(*destroy)(void*) {};
+            ENTT_ID_TYPE runtime_type{};
+        };
+
+        static constexpr std::size_t ctx_per_page = 32;
+
+        // open addressing from the runtime types of named pools to their offset
+        // past the family pools, named pools are only ever appended
+        struct named_index {
+            static constexpr auto npos = std::size_t(-1);
+
+            std::size_t find(const ENTT_ID_TYPE ctype) const ENTT_NOEXCEPT {
+                if (!slots.empty()) {
+                    const auto mask = slots.size() - 1;
+
+                    for (auto pos = std::size_t(ctype) & mask; slots[pos].second; pos = (pos + 1) & mask) {
+                        if (slots[pos].first == ctype) {
+                            return slots[pos].second - 1;
+                        }
+                    }
+                }
+
+                return npos;
+            }
+
+            void insert(const ENTT_ID_TYPE ctype, const std::size_t offset) {
+                if (!((count + 1) * 2 < slots.size())) {
+                    std::vector<std::pair<ENTT_ID_TYPE, std::size_t>> prev(std::max<std::size_t>(slots.size() * 2, 8u));
+                    prev.swap(slots);
+                    count = 0;
+
+                    for (const auto& slot : prev) {
+                        if (slot.second) {
+                            insert(slot.first, slot.second - 1);
+                        }
+                    }
+                }
+
+                auto pos = std::size_t(ctype) & (slots.size() - 1);
+
+                while (slots[pos].second) {
+                    pos = (pos + 1) & (slots.size() - 1);
+                }
+
+                // zero marks an empty slot
+                slots[pos] = { ctype, offset + 1 };
+                ++count;
+            }
+
+            void clear() ENTT_NOEXCEPT {
+                slots.clear();
+                count = 0;
+            }
+
+            std::vector<std::pair<ENTT_ID_TYPE, std::size_t>> slots{};
+            std::size_t count{};
+        };
+
+        template<typename Type, typename Family>
+        static ENTT_ID_TYPE runtime_type() ENTT_NOEXCEPT {
+            if constexpr (is_named_type_v<Type>) {
+                return named_type_traits<Type>::value;
+            }
+            else {
+                return Family::template type<Type>;
+            }
+        }
+
+        void release(const Entity entity) {
+            // lengthens the implicit list of destroyed entities
+            const auto entt = to_integer(entity) & traits_type::entity_mask;
+            const auto version = ((to_integer(entity) >> traits_type::entity_shift) + 1) << traits_type::entity_shift;
+            const auto node = to_integer(destroyed) | version;
+            entities[entt] = Entity{ node };
+            destroyed = Entity{ entt };
+        }
+
+        template<typename Type>
+        const ctx_variable* ctx_slot() const ENTT_NOEXCEPT {
+            if constexpr (is_named_type_v<Type>) {
+                const auto it = std::find_if(named_vars.cbegin(), named_vars.cend(), [](const auto& var) {
+                    return var->runtime_type == runtime_type<Type, context_family>();
+                });
+
+                return it == named_vars.cend() ? nullptr : it->get();
+            }
+            else {
+                const auto ctype = context_family::template type<Type>;
+                const auto page = ctype / ctx_per_page;
+                return (page < vars.size() && vars[page]) ? &vars[page][ctype % ctx_per_page] : nullptr;
+            }
+        }
+
+        template<typename Type>
+        ctx_variable& ctx_assure() {
+            if constexpr (is_named_type_v<Type>) {
+                if (auto* slot = ctx_slot<Type>(); slot) {
+                    return const_cast<ctx_variable&>(*slot);
+                }
+
+                return *named_vars.emplace_back(std::make_unique<ctx_variable>());
+            }
+            else {
+                const auto ctype = context_family::template type<Type>;
+                const auto page = ctype / ctx_per_page;
+
+                if (!(page < vars.size())) {
+                    vars.resize(page + 1);
+                }
+
+                if (!vars[page]) {
+                    // pages never move, references to the values stay valid
+                    vars[page] = std::make_unique<ctx_variable[]>(ctx_per_page);
+                }
+
+                return vars[page][ctype % ctx_per_page];
+            }
+        }
+
+        template<typename Component>
+        const pool_type<Component>* pool() const ENTT_NOEXCEPT {
+            const auto ctype = to_integer(type<Component>());
+
+            if constexpr (is_named_type_v<Component>) {
+                const auto offset = named_pools.find(ctype);
+                return offset == named_index::npos ? nullptr : static_cast<const pool_type<Component>*>(pools[skip_family_pools + offset].pool.get());
+            }
+            else {
+                return ctype < skip_family_pools ? static_cast<const pool_type<Component>*>(pools[ctype].pool.get()) : nullptr;
+            }
+        }
+
+        template<typename Component>
+        pool_type<Component>* pool() ENTT_NOEXCEPT {
+            return const_cast<pool_type<Component>*>(std::as_const(*this).template pool<Component>());
+        }
+
+        template<typename Component>
+        pool_type<Component>* assure() {
+            const auto ctype = to_integer(type<Component>());
+            pool_data* pdata = nullptr;
+
+            if constexpr (is_named_type_v<Component>) {
+                if (const auto offset = named_pools.find(ctype); offset == named_index::npos) {
+                    named_pools.insert(ctype, pools.size() - skip_family_pools);
+                    pdata = &pools.emplace_back();
+                }
+                else {
+                    pdata = &pools[skip_family_pools + offset];
+                }
+            }
+            else {
+                if (!(ctype < skip_family_pools)) {
+                    pools.reserve(pools.size() + ctype - skip_family_pools + 1);
+
+                    while (!(ctype < skip_family_pools)) {
+                        pools.emplace(pools.begin() + (skip_family_pools++), pool_data{});
+                    }
+                }
+
+                pdata = &pools[ctype];
+            }
+
+            if (!pdata->pool) {
+                pdata->runtime_type = ctype;
+                pdata->pool = std::make_unique<pool_type<Component>>(storage_traits<Component>::resource(), internal::sparse_page_v<Component>);
+
+                if constexpr (internal::presence_v<Component>) {
+                    pdata->pool->track_presence(true);
+                }
+
+                pdata->remove = [](sparse_set<Entity>& cpool, basic_registry& registry, const Entity entt) {
+                    static_cast<pool_type<Component>&>(cpool).remove(registry, entt);
+                };
+
+                pdata->remove_range = [](sparse_set<Entity>& cpool, basic_registry& registry, const Entity* entities, const std::size_t count) {
+                    static_cast<pool_type<Component>&>(cpool).remove(registry, entities, count);
+                };
+
+                if constexpr (std::is_copy_constructible_v<std::decay_t<Component>>) {
+                    pdata->clone = [](const sparse_set<Entity>& cpool) -> std::unique_ptr<sparse_set<Entity>> {
+                        return std::make_unique<pool_type<Component>>(static_cast<const pool_type<Component>&>(cpool));
+                    };
+
+                    pdata->stomp = [](const sparse_set<Entity>& cpool, const Entity from, basic_registry& other, const Entity to) {
+                        other.assign_or_replace<Component>(to, static_cast<const pool_type<Component>&>(cpool).get(from));
+                    };
+                }
+                else {
+                    pdata->clone = nullptr;
+                    pdata->stomp = nullptr;
+                }
+
+                pdata->describe = [](const sparse_set<Entity>& cpool, pool_statistics& stats) {
+                    static_cast<const pool_type<Component>&>(cpool).describe(stats);
+                };
+            }
+
+            return static_cast<pool_type<Component>*>(pdata->pool.get());
+        }
+
+    public:
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
+        /*! @brief Underlying version type. */
+        using version_type = typename traits_type::version_type;
+        /*! @brief Unsigned integer type. */
+        using size_type = typename sparse_set<Entity>::size_type;
+
+        /*! @brief Default constructor. */
+        basic_registry() ENTT_NOEXCEPT = default;
+
+        /*! @brief Default move constructor. */
+        basic_registry(basic_registry&&) = default;
+
+        /*! @brief Default move assignment operator. @return This registry. */
+        basic_registry& operator=(basic_registry&&) = default;
+
+        /**
+         * @brief Returns the opaque identifier of a component.
+         *
+         * The given component doesn't need to be necessarily in use.<br/>
+         * Do not use this functionality to generate numeric identifiers for types
+         * at runtime. They aren't guaranteed to be stable between different runs.
+         *
+         * @tparam Component Type of component to query.
+         * @return Runtime the opaque identifier of the given type of component.
+         */
+        template<typename Component>
+        static component type() ENTT_NOEXCEPT {
+            return component{ runtime_type<Component, component_family>() };
+        }
+
+        /**
+         * @brief Returns the number of existing components of the given type.
+         * @tparam Component Type of component of which to return the size.
+         * @return Number of existing components of the given type.
+         */
+        template<typename Component>
+        size_type size() const ENTT_NOEXCEPT {
+            const auto* cpool = pool<Component>();
+            return cpool ? cpool->size() : size_type{};
+        }
+
+        /**
+         * @brief Returns the change version of the pool of the given component.
+         *
+         * The version is incremented every time a component of the given type is
+         * assigned, replaced, touched or removed. Modifications made in place
+         * through `get` aren't tracked, see `written` for those.
+         *
+         * @tparam Component Type of component of which to return the version.
+         * @return Change version of the pool of the given component.
+         */
+        template<typename Component>
+        std::uint64_t version() const ENTT_NOEXCEPT {
+            const auto* cpool = pool<Component>();
+            return cpool ? cpool->version.load(std::memory_order_relaxed) : std::uint64_t{};
+        }
+
+        /**
+         * @brief Returns when the components around a given position of a pool
+         * were last accessed for writing.
+         *
+         * Unlike the change version, it also accounts for modifications made in
+         * place through `get`, views, groups and queries. Any non-const access
+         * counts as a write. Pools of paged storage classes are stamped page by
+         * page, the others as a whole.
+         *
+         * @sa basic_storage::written
+         *
+         * @tparam Component Type of component of which to return the stamp.
+         * @param pos A valid position in the pool of the given component.
+         * @return The time of the last non-const access to the components.
+         */
+        template<typename Component>
+        std::uint64_t written(const size_type pos) const ENTT_NOEXCEPT {
+            static_assert(!std::is_empty_v<Component>);
+            return pool<Component>()->written(pos);
+        }
+
+        /**
+         * @brief Returns the number of entities created so far.
+         * @return Number of entities created so far.
+         */
+        size_type size() const ENTT_NOEXCEPT {
+            return entities.size();
+        }
+
+        /**
+         * @brief Returns the number of entities still in use.
+         * @return Number of entities still in use.
+         */
+        size_type alive() const ENTT_NOEXCEPT {
+            auto curr = destroyed;
+            size_type cnt{};
+
+            while (curr != null) {
+                curr = entities[to_integer(curr) & traits_type::entity_mask];
+                ++cnt;
+            }
+
+            return entities.size() - cnt;
+        }
+
+        /**
+         * @brief Increases the capacity of the pool for the given component.
+         *
+         * If the new capacity is greater than the current capacity, new storage is
+         * allocated, otherwise the method does nothing.
+         *
+         * @tparam Component Type of component for which to reserve storage.
+         * @param cap Desired capacity.
+         */
+        template<typename Component>
+        void reserve(const size_type cap) {
+            assure<Component>()->reserve(cap);
+        }
+
+        /**
+         * @brief Increases the capacity of a registry in terms of entities.
+         *
+         * If the new capacity is greater than the current capacity, new storage is
+         * allocated, otherwise the method does nothing.
+         *
+         * @param cap Desired capacity.
+         */
+        void reserve(const size_type cap) {
+            entities.reserve(cap);
+        }
+
+        /**
+         * @brief Returns the capacity of the pool for the given component.
+         * @tparam Component Type of component in which one is interested.
+         * @return Capacity of the pool of the given component.
+         */
+        template<typename Component>
+        size_type capacity() const ENTT_NOEXCEPT {
+            const auto* cpool = pool<Component>();
+            return cpool ? cpool->capacity() : size_type{};
+        }
+
+        /**
+         * @brief Returns the number of entities that a registry has currently
+         * allocated space for.
+         * @return Capacity of the registry.
+         */
+        size_type capacity() const ENTT_NOEXCEPT {
+            return entities.capacity();
+        }
+
+        /**
+         * @brief Requests the removal of unused capacity for a given component.
+         * @tparam Component Type of component for which to reclaim unused capacity.
+         */
+        template<typename Component>
+        void shrink_to_fit() {
+            assure<Component>()->shrink_to_fit();
+        }
+
+        /**
+         * @brief Checks whether the pool of a given component is empty.
+         * @tparam Component Type of component in which one is interested.
+         * @return True if the pool of the given component is empty, false
+         * otherwise.
+         */
+        template<typename Component>
+        bool empty() const ENTT_NOEXCEPT {
+            const auto* cpool = pool<Component>();
+            return cpool ? cpool->empty() : true;
+        }
+
+        /**
+         * @brief Checks if there exists at least an entity still in use.
+         * @return True if at least an entity is still in use, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return !alive();
+        }
+
+        /**
+         * @brief Direct access to the list of components of a given pool.
+         *
+         * The returned pointer is such that range
+         * `[raw<Component>(), raw<Component>() + size<Component>()]` is always a
+         * valid range, even if the container is empty.
+         *
+         * There are no guarantees on the order of the components. Use a view if you
+         * want to iterate entities and components in the expected order.
+         *
+         * @note
+         * Empty components aren't explicitly instantiated. Only one instance of the
+         * given type is created. Therefore, this function always returns a pointer
+         * to that instance.
+         *
+         * @tparam Component Type of component in which one is interested.
+         * @return A pointer to the array of components of the given type.
+         */
+        template<typename Component>
+        const Component* raw() const ENTT_NOEXCEPT {
+            const auto* cpool = pool<Component>();
+            return cpool ? cpool->raw() : nullptr;
+        }
+
+        /*! @copydoc raw */
+        template<typename Component>
+        Component* raw() ENTT_NOEXCEPT {
+            return const_cast<Component*>(std::as_const(*this).template raw<Component>());
+        }
+
+        /**
+         * @brief Returns a strided view of the components of a given pool.
+         *
+         * Components are in the same order as with `raw`, starting at the given
+         * position. Pools of paged storage classes are returned a page at a time
+         * (see basic_storage::strided for more details).
+         *
+         * @tparam Component Type of component in which one is interested.
+         * @param pos A valid position in the pool of the given component, or zero.
+         * @return A view of the components from the given position, empty if the
+         * pool doesn't exist.
+         */
+        template<typename Component>
+        strided_view<const Component> strided(const size_type pos = 0u) const ENTT_NOEXCEPT {
+            static_assert(!std::is_empty_v<Component>);
+            const auto* cpool = pool<Component>();
+            return cpool ? cpool->strided(pos) : strided_view<const Component>{};
+        }
+
+        /*! @copydoc strided */
+        template<typename Component>
+        strided_view<Component> strided(const size_type pos = 0u) {
+            static_assert(!std::is_empty_v<Component>);
+            auto* cpool = pool<Component>();
+            return cpool ? cpool->strided(pos) : strided_view<Component>{};
+        }
+
+        /**
+         * @brief Direct access to the list of entities of a given pool.
+         *
+         * The returned pointer is such that range
+         * `[data<Component>(), data<Component>() + size<Component>()]` is always a
+         * valid range, even if the container is empty.
+         *
+         * There are no guarantees on the order of the entities. Use a view if you
+         * want to iterate entities and components in the expected order.
+         *
+         * @tparam Component Type of component in which one is interested.
+         * @return A pointer to the array of entities.
+         */
+        template<typename Component>
+        const entity_type* data() const ENTT_NOEXCEPT {
+            const auto* cpool = pool<Component>();
+            return cpool ? cpool->data() : nullptr;
+        }
+
+        /**
+         * @brief Checks if an entity identifier refers to a valid entity.
+         * @param entity An entity identifier, either valid or not.
+         * @return True if the identifier is valid, false otherwise.
+         */
+        bool valid(const entity_type entity) const ENTT_NOEXCEPT {
+            const auto pos = size_type(to_integer(entity) & traits_type::entity_mask);
+            return (pos < entities.size() && entities[pos] == entity);
+        }
+
+        /**
+         * @brief Returns the entity identifier without the version.
+         * @param entity An entity identifier, either valid or not.
+         * @return The entity identifier without the version.
+         */
+        static entity_type entity(const entity_type entity) ENTT_NOEXCEPT {
+            return entity_type{ to_integer(entity) & traits_type::entity_mask };
+        }
+
+        /**
+         * @brief Returns the version stored along with an entity identifier.
+         * @param entity An entity identifier, either valid or not.
+         * @return The version stored along with the given entity identifier.
+         */
+        static version_type version(const entity_type entity) ENTT_NOEXCEPT {
+            return version_type(to_integer(entity) >> traits_type::entity_shift);
+        }
+
+        /**
+         * @brief Returns the actual version for an entity identifier.
+         *
+         * @warning
+         * Attempting to use an entity that doesn't belong to the registry results
+         * in undefined behavior. An entity belongs to the registry even if it has
+         * been previously destroyed and/or recycled.<br/>
+         * An assertion will abort the execution at runtime in debug mode if the
+         * registry doesn't own the given entity.
+         *
+         * @param entity A valid entity identifier.
+         * @return Actual version for the given entity identifier.
+         */
+        version_type current(const entity_type entity) const ENTT_NOEXCEPT {
+            const auto pos = size_type(to_integer(entity) & traits_type::entity_mask);
+            ENTT_ASSERT(pos < entities.size());
+            return version_type(to_integer(entities[pos]) >> traits_type::entity_shift);
+        }
 
-        struct ctx_variable {
-            std::unique_ptr<void, void(*)(void*)> value;
-            ENTT_ID_TYPE runtime_type;
-        };
+        /**
+         * @brief Creates a new entity and returns it.
+         *
+         * There are two kinds of entity identifiers:
+         *
+         * * Newly created ones in case no entities have been previously destroyed.
+         * * Recycled ones with updated versions.
+         *
+         * Users should not care about the type of the returned entity identifier.
+         * In case entity identifers are stored around, the `valid` member
+         * function can be used to know if they are still valid or the entity has
+         * been destroyed and potentially recycled.<br/>
+         * The returned entity has assigned the given components, if any.
+         *
+         * The components must be at least default constructible. A compilation
+         * error will occur otherwhise.
+         *
+         * @tparam Component Types of components to assign to the entity.
+         * @return A valid entity identifier if the component list is empty, a tuple
+         * containing the entity identifier and the references to the components
+         * just created otherwise.
+         */
+        template<typename... Component>
+        auto create() {
+            entity_type entities[1]{};
 
-        template<typename Type, typename Family>
-        static ENTT_ID_TYPE runtime_type() ENTT_NOEXCEPT {
-            if constexpr (is_named_type_v<Type>) {
-                return named_type_traits<Type>::value;
+            if constexpr (sizeof...(Component) == 0) {
+                create<Component...>(std::begin(entities), std::end(entities));
+                return entities[0];
             }
             else {
-                return Family::template type<Type>;
+                auto it = create<Component...>(std::begin(entities), std::end(entities));
+                return std::tuple<entity_type, decltype(assign<Component>(entities[0]))...>{entities[0], * std::get<typename pool_type<Component>::iterator_type>(it)...};
             }
         }
 
-        void release(const Entity entity) {
-            // lengthens the implicit list of destroyed entities
-            const auto entt = to_integer(entity) & traits_type::entity_mask;
-            const auto version = ((to_integer(entity) >> traits_type::entity_shift) + 1) << traits_type::entity_shift;
-            const auto node = to_integer(destroyed) | version;
-            entities[entt] = Entity{ node };
-            destroyed = Entity{ entt };
-        }
+        /**
+         * @brief Assigns each element in a range an entity.
+         *
+         * @sa create
+         *
+         * The components must be at least move and default insertable. A
+         * compilation error will occur otherwhise.
+         *
+         * @tparam Component Types of components to assign to the entity.
+         * @tparam It Type of forward iterator.
+         * @param first An iterator to the first element of the range to generate.
+         * @param last An iterator past the last element of the range to generate.
+         * @return No return value if the component list is empty, a tuple
+         * containing the iterators to the lists of components just created and
+         * sorted the same of the entities otherwise.
+         */
+        template<typename... Component, typename It>
+        auto create(It first, It last) {
+            static_assert(std::is_convertible_v<entity_type, typename std::iterator_traits<It>::value_type>);
 
-        template<typename Component>
-        const pool_type<Component>* pool() const ENTT_NOEXCEPT {
-            const auto ctype = to_integer(type<Component>());
+            std::generate(first, last, [this]() {
+                entity_type curr;
 
-            if constexpr (is_named_type_v<Component>) {
-                const auto it = std::find_if(pools.begin() + skip_family_pools, pools.end(), [ctype](const auto& candidate) {
-                    return candidate.runtime_type == ctype;
-                });
+                if (destroyed == null) {
+                    curr = entities.emplace_back(entity_type(entities.size()));
+                    // traits_type::entity_mask is reserved to allow for null identifiers
+                    ENTT_ASSERT(to_integer(curr) < traits_type::entity_mask);
+                }
+                else {
+                    const auto entt = to_integer(destroyed);
+                    const auto version = to_integer(entities[entt]) & (traits_type::version_mask << traits_type::entity_shift);
+                    destroyed = entity_type{ to_integer(entities[entt]) & traits_type::entity_mask };
+                    curr = entity_type{ entt | version };
+                    entities[entt] = curr;
+                }
 
-                return it == pools.cend() ? nullptr : static_cast<const pool_type<Component>*>(it->pool.get());
-            }
-            else {
-                return ctype < skip_family_pools ? static_cast<const pool_type<Component>*>(pools[ctype].pool.get()) : nullptr;
+                return curr;
+            });
+
+            if constexpr (sizeof...(Component) > 0) {
+                // the reverse iterators guarantee the ordering between entities and components (hint: the pools return begin())
+                return std::make_tuple(assure<Component>()->batch(*this, std::make_reverse_iterator(last), std::make_reverse_iterator(first))...);
             }
         }
 
-        template<typename Component>
-        pool_type<Component>* pool() ENTT_NOEXCEPT {
-            return const_cast<pool_type<Component>*>(std::as_const(*this).template pool<Component>());
+        /**
+         * @brief Creates a new entity from a prototype entity.
+         *
+         * @sa create
+         *
+         * The components must be copyable for obvious reasons. The source entity
+         * must be a valid one.<br/>
+         * If no components are provided, the registry will try to copy all the
+         * existing types. The non-copyable ones will be ignored.
+         *
+         * @note
+         * Specifying the list of components is ways faster than an opaque copy.
+         *
+         * @tparam Component Types of components to copy.
+         * @tparam Exclude Types of components not to be copied.
+         * @param src A valid entity identifier to be copied.
+         * @param other The registry that owns the source entity.
+         * @return A valid entity identifier.
+         */
+        template<typename... Component, typename... Exclude>
+        auto create(entity_type src, basic_registry& other, exclude_t<Exclude...> = {}) {
+            entity_type entities[1]{};
+            create<Component...>(std::begin(entities), std::end(entities), src, other, exclude<Exclude...>);
+            return entities[0];
         }
 
-        template<typename Component>
-        pool_type<Component>* assure() {
-            const auto ctype = to_integer(type<Component>());
-            pool_data* pdata = nullptr;
-
-            if constexpr (is_named_type_v<Component>) {
-                const auto it = std::find_if(pools.begin() + skip_family_pools, pools.end(), [ctype](const auto& candidate) {
-                    return candidate.runtime_type == ctype;
-                });
+        /**
+         * @brief Assigns each element in a range an entity from a prototype entity.
+         *
+         * @sa create
+         *
+         * The components must be copyable for obvious reasons. The entities must be
+         * all valid.<br/>
+         * If no components are provided, the registry will try to copy all the
+         * existing types. The non-copyable ones will be ignored.
+         *
+         * @note
+         * Specifying the list of components is ways faster than an opaque copy and
+         * uses the batch creation under the hood.
+         *
+         * @tparam Component Types of components to copy.
+         * @tparam Exclude Types of components not to be copied.
+         * @param first An iterator to the first element of the range to generate.
+         * @param last An iterator past the last element of the range to generate.
+         * @param src A valid entity identifier to be copied.
+         * @param other The registry that owns the source entity.
+         */
+        template<typename... Component, typename It, typename... Exclude>
+        void create(It first, It last, entity_type src, basic_registry& other, exclude_t<Exclude...> = {}) {
+            create(first, last);
 
-                pdata = (it == pools.cend() ? &pools.emplace_back() : &(*it));
+            if constexpr (sizeof...(Component) == 0) {
+                stomp<Component...>(first, last, src, other, exclude<Exclude...>);
             }
             else {
-                if (!(ctype < skip_family_pools)) {
-                    pools.reserve(pools.size() + ctype - skip_family_pools + 1);
+                static_assert(sizeof...(Component) == 0 || sizeof...(Exclude) == 0);
+                (assure<Component>()->batch(*this, first, last, other.get<Component>(src)), ...);
+            }
+        }
 
-                    while (!(ctype < skip_family_pools)) {
-                        pools.emplace(pools.begin() + (skip_family_pools++), pool_data{});
-                    }
+        /**
+         * @brief Destroys an entity and lets the registry recycle the identifier.
+         *
+         * When an entity is destroyed, its version is updated and the identifier
+         * can be recycled at any time. In case entity identifers are stored around,
+         * the `valid` member function can be used to know if they are still valid
+         * or the entity has been destroyed and potentially recycled.
+         *
+         * @warning
+         * In case there are listeners that observe the destruction of components
+         * and assign other components to the entity in their bodies, the result of
+         * invoking this function may not be as expected. In the worst case, it
+         * could lead to undefined behavior. An assertion will abort the execution
+         * at runtime in debug mode if a violation is detected.
+         *
+         * @warning
+         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity.
+         *
+         * @param entity A valid entity identifier.
+         */
+        void destroy(const entity_type entity) {
+            ENTT_ASSERT(valid(entity));
+
+            for (auto pos = pools.size(); pos; --pos) {
+                if (auto& pdata = pools[pos - 1]; pdata.pool && pdata.pool->has(entity)) {
+                    pdata.remove(*pdata.pool, *this, entity);
                 }
+            };
 
-                pdata = &pools[ctype];
-            }
+            // just a way to protect users from listeners that attach components
+            ENTT_ASSERT(orphan(entity));
+            release(entity);
+        }
 
-            if (!pdata->pool) {
-                pdata->runtime_type = ctype;
-                pdata->pool = std::make_unique<pool_type<Component>>();
+        /**
+         * @brief Destroys all the entities in a range.
+         *
+         * @sa destroy
+         *
+         * @tparam It Type of input iterator.
+         * @param first An iterator to the first element of the range to generate.
+         * @param last An iterator past the last element of the range to generate.
+         */
+        template<typename It>
+        void destroy(It first, It last) {
+            const std::vector<entity_type> range(first, last);
+            std::vector<entity_type> owners;
+            owners.reserve(range.size());
 
-                pdata->remove = [](sparse_set<Entity>& cpool, basic_registry& registry, const Entity entt) {
-                    static_cast<pool_type<Component>&>(cpool).remove(registry, entt);
-                };
+            // pool by pool, such that batch listeners receive all the entities at once
+            for (auto pos = pools.size(); pos; --pos) {
+                if (auto& pdata = pools[pos - 1]; pdata.pool) {
+                    owners.clear();
 
-                if constexpr (std::is_copy_constructible_v<std::decay_t<Component>>) {
-                    pdata->clone = [](const sparse_set<Entity>& cpool) -> std::unique_ptr<sparse_set<Entity>> {
-                        return std::make_unique<pool_type<Component>>(static_cast<const pool_type<Component>&>(cpool));
-                    };
+                    std::copy_if(range.cbegin(), range.cend(), std::back_inserter(owners), [cpool = pdata.pool.get()](const auto entity) {
+                        return cpool->has(entity);
+                    });
 
-                    pdata->stomp = [](const sparse_set<Entity>& cpool, const Entity from, basic_registry& other, const Entity to) {
-                        other.assign_or_replace<Component>(to, static_cast<const pool_type<Component>&>(cpool).get(from));
-                    };
-                }
-                else {
-                    pdata->clone = nullptr;
-                    pdata->stomp = nullptr;
+                    if (!owners.empty()) {
+                        pdata.remove_range(*pdata.pool, *this, owners.data(), owners.size());
+                    }
                 }
             }
 
-            return static_cast<pool_type<Component>*>(pdata->pool.get());
+            for (const auto entity : range) {
+                ENTT_ASSERT(valid(entity));
+                // just a way to protect users from listeners that attach components
+                ENTT_ASSERT(orphan(entity));
+                release(entity);
+            }
+        }
+
+        /**
+         * @brief Assigns the given component to an entity.
+         *
+         * A new instance of the given component is created and initialized with the
+         * arguments provided (the component must have a proper constructor or be of
+         * aggregate type). Then the component is assigned to the given entity.
+         *
+         * @warning
+         * Attempting to use an invalid entity or to assign a component to an entity
+         * that already owns it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity or if the entity already owns an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to create.
+         * @tparam Args Types of arguments to use to construct the component.
+         * @param entity A valid entity identifier.
+         * @param args Parameters to use to initialize the component.
+         * @return A reference to the newly created component.
+         */
+        template<typename Component, typename... Args>
+        decltype(auto) assign(const entity_type entity, [[maybe_unused]] Args&& ... args) {
+            ENTT_ASSERT(valid(entity));
+            return assure<Component>()->assign(*this, entity, std::forward<Args>(args)...);
         }
 
-    public:
-        /*! @brief Underlying entity identifier. */
-        using entity_type = Entity;
-        /*! @brief Underlying version type. */
-        using version_type = typename traits_type::version_type;
-        /*! @brief Unsigned integer type. */
-        using size_type = typename sparse_set<Entity>::size_type;
-
-        /*! @brief Default constructor. */
-        basic_registry() ENTT_NOEXCEPT = default;
-
-        /*! @brief Default move constructor. */
-        basic_registry(basic_registry&&) = default;
+        /**
+         * @brief Assigns the given component to the entities in a range.
+         *
+         * Each entity receives a copy of the matching element of the range of
+         * components that starts at `from`. Trivially copyable components are
+         * copied as a whole block.
+         *
+         * @sa assign
+         *
+         * @warning
+         * Attempting to use invalid entities or to assign a component to entities
+         * that already own it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entities or if the entities already own an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to create.
+         * @tparam It Type of input iterator.
+         * @tparam CIt Type of input iterator.
+         * @param first An iterator to the first element of the range of entities.
+         * @param last An iterator past the last element of the range of entities.
+         * @param from An iterator to the first element of the range of components.
+         */
+        template<typename Component, typename It, typename CIt>
+        void insert(It first, It last, [[maybe_unused]] CIt from) {
+            ENTT_ASSERT(std::all_of(first, last, [this](const auto entity) { return valid(entity); }));
 
-        /*! @brief Default move assignment operator. @return This registry. */
-        basic_registry& operator=(basic_registry&&) = default;
+            if constexpr (std::is_empty_v<Component>) {
+                assure<Component>()->batch(*this, first, last);
+            }
+            else {
+                assure<Component>()->insert(*this, first, last, from);
+            }
+        }
 
         /**
-         * @brief Returns the opaque identifier of a component.
+         * @brief Assigns the given component to the entities in a range, taking
+         * the instances over from a shared block of memory.
          *
-         * The given component doesn't need to be necessarily in use.<br/>
-         * Do not use this functionality to generate numeric identifiers for types
-         * at runtime. They aren't guaranteed to be stable between different runs.
+         * Pools of paged storage classes use the block in place of their own
+         * pages, that are copied only when first modified. Other pools copy the
+         * instances as `insert` does.
          *
-         * @tparam Component Type of component to query.
-         * @return Runtime the opaque identifier of the given type of component.
+         * @sa insert
+         *
+         * @warning
+         * Attempting to use invalid entities or to assign a component to entities
+         * that already own it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entities or if the entities already own an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to create.
+         * @tparam It Type of input iterator.
+         * @param first An iterator to the first element of the range of entities.
+         * @param last An iterator past the last element of the range of entities.
+         * @param data A block of components, as many as the entities.
          */
-        template<typename Component>
-        static component type() ENTT_NOEXCEPT {
-            return component{ runtime_type<Component, component_family>() };
+        template<typename Component, typename It>
+        void adopt(It first, It last, const std::shared_ptr<const Component>& data) {
+            static_assert(std::is_trivially_copyable_v<Component> && !std::is_empty_v<Component>);
+            ENTT_ASSERT(std::all_of(first, last, [this](const auto entity) { return valid(entity); }));
+            assure<Component>()->adopt(*this, first, last, data);
         }
 
         /**
-         * @brief Returns the number of existing components of the given type.
-         * @tparam Component Type of component of which to return the size.
-         * @return Number of existing components of the given type.
+         * @brief Removes the given component from an entity.
+         *
+         * @warning
+         * Attempting to use an invalid entity or to remove a component from an
+         * entity that doesn't own it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity or if the entity doesn't own an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to remove.
+         * @param entity A valid entity identifier.
          */
         template<typename Component>
-        size_type size() const ENTT_NOEXCEPT {
-            const auto* cpool = pool<Component>();
-            return cpool ? cpool->size() : size_type{};
+        void remove(const entity_type entity) {
+            ENTT_ASSERT(valid(entity));
+            pool<Component>()->remove(*this, entity);
         }
 
         /**
-         * @brief Returns the number of entities created so far.
-         * @return Number of entities created so far.
+         * @brief Checks if an entity has all the given components.
+         *
+         * @warning
+         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity.
+         *
+         * @tparam Component Components for which to perform the check.
+         * @param entity A valid entity identifier.
+         * @return True if the entity has all the components, false otherwise.
          */
-        size_type size() const ENTT_NOEXCEPT {
-            return entities.size();
+        template<typename... Component>
+        bool has(const entity_type entity) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(valid(entity));
+            [[maybe_unused]] const auto cpools = std::make_tuple(pool<Component>()...);
+            return ((std::get<const pool_type<Component>*>(cpools) ? std::get<const pool_type<Component>*>(cpools)->has(entity) : false) && ...);
         }
 
         /**
-         * @brief Returns the number of entities still in use.
-         * @return Number of entities still in use.
+         * @brief Returns references to the given components for an entity.
+         *
+         * @warning
+         * Attempting to use an invalid entity or to get a component from an entity
+         * that doesn't own it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity or if the entity doesn't own an instance of the given
+         * component.
+         *
+         * @tparam Component Types of components to get.
+         * @param entity A valid entity identifier.
+         * @return References to the components owned by the entity.
          */
-        size_type alive() const ENTT_NOEXCEPT {
-            auto curr = destroyed;
-            size_type cnt{};
+        template<typename... Component>
+        decltype(auto) get([[maybe_unused]] const entity_type entity) const {
+            ENTT_ASSERT(valid(entity));
 
-            while (curr != null) {
-                curr = entities[to_integer(curr) & traits_type::entity_mask];
-                ++cnt;
+            if constexpr (sizeof...(Component) == 1) {
+                return (pool<Component>()->get(entity), ...);
             }
+            else {
+                return std::tuple<decltype(get<Component>(entity))...>{get<Component>(entity)...};
+            }
+        }
 
-            return entities.size() - cnt;
+        /*! @copydoc get */
+        template<typename... Component>
+        decltype(auto) get([[maybe_unused]] const entity_type entity) ENTT_NOEXCEPT {
+            ENTT_ASSERT(valid(entity));
+
+            if constexpr (sizeof...(Component) == 1) {
+                return (pool<Component>()->get(entity), ...);
+            }
+            else {
+                return std::tuple<decltype(get<Component>(entity))...>{get<Component>(entity)...};
+            }
         }
 
         /**
-         * @brief Increases the capacity of the pool for the given component.
+         * @brief Returns a reference to the given component for an entity.
          *
-         * If the new capacity is greater than the current capacity, new storage is
-         * allocated, otherwise the method does nothing.
+         * In case the entity doesn't own the component, the parameters provided are
+         * used to construct it.<br/>
+         * Equivalent to the following snippet (pseudocode):
          *
-         * @tparam Component Type of component for which to reserve storage.
-         * @param cap Desired capacity.
+         * @code{.cpp}
+         * auto &component = registry.has<Component>(entity) ? registry.get<Component>(entity) : registry.assign<Component>(entity, args...);
+         * @endcode
+         *
+         * Prefer this function anyway because it has slightly better performance.
+         *
+         * @warning
+         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity.
+         *
+         * @tparam Component Type of component to get.
+         * @tparam Args Types of arguments to use to construct the component.
+         * @param entity A valid entity identifier.
+         * @param args Parameters to use to initialize the component.
+         * @return Reference to the component owned by the entity.
          */
-        template<typename Component>
-        void reserve(const size_type cap) {
-            assure<Component>()->reserve(cap);
+        template<typename Component, typename... Args>
+        decltype(auto) get_or_assign(const entity_type entity, Args&& ... args) ENTT_NOEXCEPT {
+            ENTT_ASSERT(valid(entity));
+            auto* cpool = assure<Component>();
+            return cpool->has(entity) ? cpool->get(entity) : cpool->assign(*this, entity, std::forward<Args>(args)...);
         }
 
         /**
-         * @brief Increases the capacity of a registry in terms of entities.
+         * @brief Returns pointers to the given components for an entity.
          *
-         * If the new capacity is greater than the current capacity, new storage is
-         * allocated, otherwise the method does nothing.
+         * @warning
+         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity.
          *
-         * @param cap Desired capacity.
+         * @tparam Component Types of components to get.
+         * @param entity A valid entity identifier.
+         * @return Pointers to the components owned by the entity.
          */
-        void reserve(const size_type cap) {
-            entities.reserve(cap);
+        template<typename... Component>
+        auto try_get([[maybe_unused]] const entity_type entity) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(valid(entity));
+
+            if constexpr (sizeof...(Component) == 1) {
+                const auto cpools = std::make_tuple(pool<Component>()...);
+                return ((std::get<const pool_type<Component>*>(cpools) ? std::get<const pool_type<Component>*>(cpools)->try_get(entity) : nullptr), ...);
+            }
+            else {
+                return std::tuple<std::add_const_t<Component> * ...>{try_get<Component>(entity)...};
+            }
         }
 
-        /**
-         * @brief Returns the capacity of the pool for the given component.
-         * @tparam Component Type of component in which one is interested.
-         * @return Capacity of the pool of the given component.
-         */
-        template<typename Component>
-        size_type capacity() const ENTT_NOEXCEPT {
-            const auto* cpool = pool<Component>();
-            return cpool ? cpool->capacity() : size_type{};
+        /*! @copydoc try_get */
+        template<typename... Component>
+        auto try_get([[maybe_unused]] const entity_type entity) ENTT_NOEXCEPT {
+            if constexpr (sizeof...(Component) == 1) {
+                return (const_cast<Component*>(std::as_const(*this).template try_get<Component>(entity)), ...);
+            }
+            else {
+                return std::tuple<Component * ...>{try_get<Component>(entity)...};
+            }
         }
 
         /**
-         * @brief Returns the number of entities that a registry has currently
-         * allocated space for.
-         * @return Capacity of the registry.
+         * @brief Replaces the given component for an entity.
+         *
+         * A new instance of the given component is created and initialized with the
+         * arguments provided (the component must have a proper constructor or be of
+         * aggregate type). Then the component is assigned to the given entity.
+         *
+         * @warning
+         * Attempting to use an invalid entity or to replace a component of an
+         * entity that doesn't own it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity or if the entity doesn't own an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to replace.
+         * @tparam Args Types of arguments to use to construct the component.
+         * @param entity A valid entity identifier.
+         * @param args Parameters to use to initialize the component.
+         * @return A reference to the newly created component.
          */
-        size_type capacity() const ENTT_NOEXCEPT {
-            return entities.capacity();
+        template<typename Component, typename... Args>
+        decltype(auto) replace(const entity_type entity, Args&& ... args) {
+            ENTT_ASSERT(valid(entity));
+            return pool<Component>()->replace(*this, entity, std::forward<Args>(args)...);
         }
 
         /**
-         * @brief Requests the removal of unused capacity for a given component.
-         * @tparam Component Type of component for which to reclaim unused capacity.
+         * @brief Assigns or replaces the given component for an entity.
+         *
+         * Equivalent to the following snippet (pseudocode):
+         *
+         * @code{.cpp}
+         * auto &component = registry.has<Component>(entity) ? registry.replace<Component>(entity, args...) : registry.assign<Component>(entity, args...);
+         * @endcode
+         *
+         * Prefer this function anyway because it has slightly better performance.
+         *
+         * @warning
+         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity.
+         *
+         * @tparam Component Type of component to assign or replace.
+         * @tparam Args Types of arguments to use to construct the component.
+         * @param entity A valid entity identifier.
+         * @param args Parameters to use to initialize the component.
+         * @return A reference to the newly created component.
          */
-        template<typename Component>
-        void shrink_to_fit() {
-            assure<Component>()->shrink_to_fit();
+        template<typename Component, typename... Args>
+        decltype(auto) assign_or_replace(const entity_type entity, Args&& ... args) {
+            ENTT_ASSERT(valid(entity));
+            auto* cpool = assure<Component>();
+            return cpool->has(entity) ? cpool->replace(*this, entity, std::forward<Args>(args)...) : cpool->assign(*this, entity, std::forward<Args>(args)...);
         }
 
         /**
-         * @brief Checks whether the pool of a given component is empty.
-         * @tparam Component Type of component in which one is interested.
-         * @return True if the pool of the given component is empty, false
-         * otherwise.
+         * @brief Marks the given component of an entity as modified.
+         *
+         * Increments the change version of the pool, as if the component had
+         * been replaced. Useful after modifying a component in place through
+         * `get`.
+         *
+         * @warning
+         * Attempting to use an invalid entity or to touch a component that the
+         * entity doesn't own results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity or if the entity doesn't own an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to touch.
+         * @param entity A valid entity identifier.
          */
         template<typename Component>
-        bool empty() const ENTT_NOEXCEPT {
-            const auto* cpool = pool<Component>();
-            return cpool ? cpool->empty() : true;
-        }
+        void touch([[maybe_unused]] const entity_type entity) {
+            ENTT_ASSERT(valid(entity));
+            ENTT_ASSERT(has<Component>(entity));
+            auto* cpool = assure<Component>();
+            cpool->version.fetch_add(1u, std::memory_order_relaxed);
 
-        /**
-         * @brief Checks if there exists at least an entity still in use.
-         * @return True if at least an entity is still in use, false otherwise.
-         */
-        bool empty() const ENTT_NOEXCEPT {
-            return !alive();
+            if constexpr (!std::is_empty_v<Component>) {
+                // stamps the page as well, it may have been written through a pointer taken earlier
+                static_cast<void>(cpool->get(entity));
+            }
         }
 
         /**
-         * @brief Direct access to the list of components of a given pool.
+         * @brief Returns a sink object for the given component.
          *
-         * The returned pointer is such that range
-         * `[raw<Component>(), raw<Component>() + size<Component>()]` is always a
-         * valid range, even if the container is empty.
+         * A sink is an opaque object used to connect listeners to components.<br/>
+         * The sink returned by this function can be used to receive notifications
+         * whenever a new instance of the given component is created and assigned to
+         * an entity.
          *
-         * There are no guarantees on the order of the components. Use a view if you
-         * want to iterate entities and components in the expected order.
+         * The function type for a listener is equivalent to:
+         *
+         * @code{.cpp}
+         * void(Entity, registry<Entity> &, Component &);
+         * @endcode
+         *
+         * Listeners are invoked **after** the component has been assigned to the
+         * entity. The order of invocation of the listeners isn't guaranteed.
          *
          * @note
-         * Empty components aren't explicitly instantiated. Only one instance of the
-         * given type is created. Therefore, this function always returns a pointer
-         * to that instance.
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned through signals. They can be caught only by copy or with
+         * const references.
          *
-         * @tparam Component Type of component in which one is interested.
-         * @return A pointer to the array of components of the given type.
+         * @sa sink
+         *
+         * @tparam Component Type of component of which to get the sink.
+         * @return A temporary sink object.
          */
         template<typename Component>
-        const Component* raw() const ENTT_NOEXCEPT {
-            const auto* cpool = pool<Component>();
-            return cpool ? cpool->raw() : nullptr;
+        auto on_construct() ENTT_NOEXCEPT {
+            return assure<Component>()->on_construct();
         }
 
-        /*! @copydoc raw */
+        /**
+         * @brief Returns a sink object for the given component.
+         *
+         * A sink is an opaque object used to connect listeners to components.<br/>
+         * The sink returned by this function can be used to receive notifications
+         * whenever an instance of the given component is explicitly replaced.
+         *
+         * The function type for a listener is equivalent to:
+         *
+         * @code{.cpp}
+         * void(Entity, registry<Entity> &, Component &);
+         * @endcode
+         *
+         * Listeners are invoked **before** the component has been replaced. The
+         * order of invocation of the listeners isn't guaranteed.
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned through signals. They can be caught only by copy or with
+         * const references.
+         *
+         * @sa sink
+         *
+         * @tparam Component Type of component of which to get the sink.
+         * @return A temporary sink object.
+         */
         template<typename Component>
-        Component* raw() ENTT_NOEXCEPT {
-            return const_cast<Component*>(std::as_const(*this).template raw<Component>());
+        auto on_replace() ENTT_NOEXCEPT {
+            return assure<Component>()->on_replace();
         }
 
         /**
-         * @brief Direct access to the list of entities of a given pool.
+         * @brief Returns a sink object for the given component.
          *
-         * The returned pointer is such that range
-         * `[data<Component>(), data<Component>() + size<Component>()]` is always a
-         * valid range, even if the container is empty.
+         * A sink is an opaque object used to connect listeners to components.<br/>
+         * The sink returned by this function can be used to receive notifications
+         * whenever an instance of the given component is removed from an entity and
+         * thus destroyed.
          *
-         * There are no guarantees on the order of the entities. Use a view if you
-         * want to iterate entities and components in the expected order.
+         * The function type for a listener is equivalent to:
          *
-         * @tparam Component Type of component in which one is interested.
-         * @return A pointer to the array of entities.
+         * @code{.cpp}
+         * void(Entity, registry<Entity> &);
+         * @endcode
+         *
+         * Listeners are invoked **before** the component has been removed from the
+         * entity. The order of invocation of the listeners isn't guaranteed.
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, temporary objects
+         * are returned through signals. They can be caught only by copy or with
+         * const references.
+         *
+         * @sa sink
+         *
+         * @tparam Component Type of component of which to get the sink.
+         * @return A temporary sink object.
          */
         template<typename Component>
-        const entity_type* data() const ENTT_NOEXCEPT {
-            const auto* cpool = pool<Component>();
-            return cpool ? cpool->data() : nullptr;
+        auto on_destroy() ENTT_NOEXCEPT {
+            return assure<Component>()->on_destroy();
         }
 
         /**
-         * @brief Checks if an entity identifier refers to a valid entity.
-         * @param entity An entity identifier, either valid or not.
-         * @return True if the identifier is valid, false otherwise.
+         * @brief Returns a sink object to receive constructions in batches.
+         *
+         * The sink returned by this function can be used to receive notifications
+         * whenever instances of the given component are created and assigned to
+         * entities. Bulk assignments are delivered with as few calls as possible,
+         * single ones as batches of one element.
+         *
+         * The function type for a listener is equivalent to:
+         *
+         * @code{.cpp}
+         * void(registry<Entity> &, const Entity *, Component *, std::size_t);
+         * @endcode
+         *
+         * The arrays of entities and components have the same length and order.
+         * Listeners are invoked **after** the components have been assigned but
+         * **before** the listeners of `on_construct`, that can rearrange the pool
+         * (as an example, owning groups do).
+         *
+         * @note
+         * Empty types aren't explicitly instantiated. Therefore, the array of
+         * components is always a null pointer for them.
+         *
+         * @sa on_construct
+         *
+         * @tparam Component Type of component of which to get the sink.
+         * @return A temporary sink object.
          */
-        bool valid(const entity_type entity) const ENTT_NOEXCEPT {
-            const auto pos = size_type(to_integer(entity) & traits_type::entity_mask);
-            return (pos < entities.size() && entities[pos] == entity);
+        template<typename Component>
+        auto on_construct_batch() ENTT_NOEXCEPT {
+            return assure<Component>()->on_construct_batch();
         }
 
         /**
-         * @brief Returns the entity identifier without the version.
-         * @param entity An entity identifier, either valid or not.
-         * @return The entity identifier without the version.
+         * @brief Returns a sink object to receive destructions in batches.
+         *
+         * The sink returned by this function can be used to receive notifications
+         * whenever instances of the given component are removed from entities and
+         * thus destroyed. Destroying a range of entities or resetting a pool is
+         * delivered with a single call, other removals as batches of one element.
+         *
+         * The function type for a listener is equivalent to:
+         *
+         * @code{.cpp}
+         * void(registry<Entity> &, const Entity *, std::size_t);
+         * @endcode
+         *
+         * Listeners are invoked **before** the components have been removed and
+         * before the listeners of `on_destroy`. Therefore, the components can
+         * still be accessed through the registry.
+         *
+         * @sa on_destroy
+         *
+         * @tparam Component Type of component of which to get the sink.
+         * @return A temporary sink object.
          */
-        static entity_type entity(const entity_type entity) ENTT_NOEXCEPT {
-            return entity_type{ to_integer(entity) & traits_type::entity_mask };
+        template<typename Component>
+        auto on_destroy_batch() ENTT_NOEXCEPT {
+            return assure<Component>()->on_destroy_batch();
         }
 
         /**
-         * @brief Returns the version stored along with an entity identifier.
-         * @param entity An entity identifier, either valid or not.
-         * @return The version stored along with the given entity identifier.
+         * @brief Sorts the pool of entities for the given component.
+         *
+         * The order of the elements in a pool is highly affected by assignments
+         * of components to entities and deletions. Components are arranged to
+         * maximize the performance during iterations and users should not make any
+         * assumption on the order.<br/>
+         * This function can be used to impose an order to the elements in the pool
+         * of the given component. The order is kept valid until a component of the
+         * given type is assigned or removed from an entity.
+         *
+         * The comparison function object must return `true` if the first element
+         * is _less_ than the second one, `false` otherwise. The signature of the
+         * comparison function should be equivalent to one of the following:
+         *
+         * @code{.cpp}
+         * bool(const Entity, const Entity);
+         * bool(const Component &, const Component &);
+         * @endcode
+         *
+         * Moreover, the comparison function object shall induce a
+         * _strict weak ordering_ on the values.
+         *
+         * The sort function oject must offer a member function template
+         * `operator()` that accepts three arguments:
+         *
+         * * An iterator to the first element of the range to sort.
+         * * An iterator past the last element of the range to sort.
+         * * A comparison function to use to compare the elements.
+         *
+         * The comparison funtion object received by the sort function object hasn't
+         * necessarily the type of the one passed along with the other parameters to
+         * this member function.
+         *
+         * @warning
+         * Pools of components owned by a group are only partially sorted.<br/>
+         * In other words, only the elements that aren't part of the group are
+         * sorted by this function. Use the `sort` member function of a group to
+         * sort the other half of the pool.
+         *
+         * @tparam Component Type of components to sort.
+         * @tparam Compare Type of comparison function object.
+         * @tparam Sort Type of sort function object.
+         * @tparam Args Types of arguments to forward to the sort function object.
+         * @param compare A valid comparison function object.
+         * @param algo A valid sort function object.
+         * @param args Arguments to forward to the sort function object, if any.
          */
-        static version_type version(const entity_type entity) ENTT_NOEXCEPT {
-            return version_type(to_integer(entity) >> traits_type::entity_shift);
+        template<typename Component, typename Compare, typename Sort = std_sort, typename... Args>
+        void sort(Compare compare, Sort algo = Sort{}, Args&& ... args) {
+            if (auto * cpool = assure<Component>(); cpool->group) {
+                const auto last = cpool->end() - cpool->group->owned;
+                cpool->sort(cpool->begin(), last, std::move(compare), std::move(algo), std::forward<Args>(args)...);
+            }
+            else {
+                cpool->sort(cpool->begin(), cpool->end(), std::move(compare), std::move(algo), std::forward<Args>(args)...);
+            }
         }
 
         /**
-         * @brief Returns the actual version for an entity identifier.
+         * @brief Sorts two pools of components in the same way.
+         *
+         * The order of the elements in a pool is highly affected by assignments
+         * of components to entities and deletions. Components are arranged to
+         * maximize the performance during iterations and users should not make any
+         * assumption on the order.
+         *
+         * It happens that different pools of components must be sorted the same way
+         * because of runtime and/or performance constraints. This function can be
+         * used to order a pool of components according to the order between the
+         * entities in another pool of components.
+         *
+         * @b How @b it @b works
+         *
+         * Being `A` and `B` the two sets where `B` is the master (the one the order
+         * of which rules) and `A` is the slave (the one to sort), after a call to
+         * this function an iterator for `A` will return the entities according to
+         * the following rules:
+         *
+         * * All the entities in `A` that are also in `B` are returned first
+         *   according to the order they have in `B`.
+         * * All the entities in `A` that are not in `B` are returned in no
+         *   particular order after all the other entities.
+         *
+         * Any subsequent change to `B` won't affect the order in `A`.
          *
          * @warning
-         * Attempting to use an entity that doesn't belong to the registry results
-         * in undefined behavior. An entity belongs to the registry even if it has
-         * been previously destroyed and/or recycled.<br/>
-         * An assertion will abort the execution at runtime in debug mode if the
-         * registry doesn't own the given entity.
+         * Pools of components owned by a group cannot be sorted this way.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case
+         * the pool is owned by a group.
          *
-         * @param entity A valid entity identifier.
-         * @return Actual version for the given entity identifier.
+         * @tparam To Type of components to sort.
+         * @tparam From Type of components to use to sort.
          */
-        version_type current(const entity_type entity) const ENTT_NOEXCEPT {
-            const auto pos = size_type(to_integer(entity) & traits_type::entity_mask);
-            ENTT_ASSERT(pos < entities.size());
-            return version_type(to_integer(entities[pos]) >> traits_type::entity_shift);
+        template<typename To, typename From>
+        void sort() {
+            ENTT_ASSERT(!owned<To>());
+            assure<To>()->respect(*assure<From>());
         }
 
         /**
-         * @brief Creates a new entity and returns it.
-         *
-         * There are two kinds of entity identifiers:
+         * @brief Sorts a pool of components in the same way of another pool, a
+         * little at a time.
          *
-         * * Newly created ones in case no entities have been previously destroyed.
-         * * Recycled ones with updated versions.
+         * Incremental counterpart of `sort<To, From>`, meant to be invoked once
+         * per frame or whenever there is time left. Each invocation visits at most
+         * the given number of entities of `From` and resumes where the previous
+         * one stopped. Once the whole pool has been visited, the next invocation
+         * starts a new pass.<br/>
+         * Pools can change between invocations. Entities that move meanwhile are
+         * put in place by the following passes.
          *
-         * Users should not care about the type of the returned entity identifier.
-         * In case entity identifers are stored around, the `valid` member
-         * function can be used to know if they are still valid or the entity has
-         * been destroyed and potentially recycled.<br/>
-         * The returned entity has assigned the given components, if any.
+         * @warning
+         * Pools of components owned by a group cannot be sorted this way.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case
+         * the pool is owned by a group.
          *
-         * The components must be at least default constructible. A compilation
-         * error will occur otherwhise.
+         * @sa sort
+         * @sa divergence
          *
-         * @tparam Component Types of components to assign to the entity.
-         * @return A valid entity identifier if the component list is empty, a tuple
-         * containing the entity identifier and the references to the components
-         * just created otherwise.
+         * @tparam To Type of components to sort.
+         * @tparam From Type of components to use to sort.
+         * @param budget Maximum number of entities to visit.
+         * @return True if the last complete pass didn't move anything, false
+         * otherwise.
          */
-        template<typename... Component>
-        auto create() {
-            entity_type entities[1]{};
-
-            if constexpr (sizeof...(Component) == 0) {
-                create<Component...>(std::begin(entities), std::end(entities));
-                return entities[0];
+        template<typename To, typename From>
+        bool converge(const size_type budget) {
+            ENTT_ASSERT(!owned<To>());
+            auto* cpool = assure<To>();
+            const auto* leader = assure<From>();
+            auto& state = cpool->follow;
+
+            if (const auto id = to_integer(type<From>()); !state.running || state.leader != id) {
+                state.synced = (state.leader == id) && state.synced;
+                state.leader = id;
+                state.running = true;
+                state.next = leader->size();
+                state.last = cpool->size();
+                state.swaps = {};
+            }
+
+            state.next = std::min(state.next, leader->size());
+            state.last = std::min(state.last, cpool->size());
+
+            for (auto count = budget; count && state.next && state.last > 1u; --count) {
+                // same as respect, from the end of the packed arrays
+                if (const auto entt = leader->data()[--state.next]; cpool->has(entt)) {
+                    if (const auto pos = --state.last; cpool->data()[pos] != entt) {
+                        cpool->swap(pos, cpool->index(entt));
+                        ++state.swaps;
+                    }
+                }
             }
-            else {
-                auto it = create<Component...>(std::begin(entities), std::end(entities));
-                return std::tuple<entity_type, decltype(assign<Component>(entities[0]))...>{entities[0], * std::get<typename pool_type<Component>::iterator_type>(it)...};
+
+            if (!state.next || state.last <= 1u) {
+                state.synced = !state.swaps;
+                state.running = false;
             }
+
+            return state.synced;
         }
 
         /**
-         * @brief Assigns each element in a range an entity.
+         * @brief Measures how far the order of a pool is from that of another
+         * pool.
          *
-         * @sa create
+         * Entities that belong to both pools are visited in the order of `From`.
+         * Every time the next one isn't adjacent to the previous one in `To`, a
+         * multi component view walking `From` jumps elsewhere in memory.<br/>
+         * The result is the fraction of those jumps, from 0 if `To` is sorted
+         * as `From` to 1 if the two orders have nothing in common.
          *
-         * The components must be at least move and default insertable. A
-         * compilation error will occur otherwhise.
+         * @sa converge
          *
-         * @tparam Component Types of components to assign to the entity.
-         * @tparam It Type of forward iterator.
-         * @param first An iterator to the first element of the range to generate.
-         * @param last An iterator past the last element of the range to generate.
-         * @return No return value if the component list is empty, a tuple
-         * containing the iterators to the lists of components just created and
-         * sorted the same of the entities otherwise.
+         * @tparam To Type of components of the pool to measure.
+         * @tparam From Type of components of the pool that dictates the order.
+         * @return The divergence between the pools, in the range `[0, 1]`.
          */
-        template<typename... Component, typename It>
-        auto create(It first, It last) {
-            static_assert(std::is_convertible_v<entity_type, typename std::iterator_traits<It>::value_type>);
-
-            std::generate(first, last, [this]() {
-                entity_type curr;
-
-                if (destroyed == null) {
-                    curr = entities.emplace_back(entity_type(entities.size()));
-                    // traits_type::entity_mask is reserved to allow for null identifiers
-                    ENTT_ASSERT(to_integer(curr) < traits_type::entity_mask);
-                }
-                else {
-                    const auto entt = to_integer(destroyed);
-                    const auto version = to_integer(entities[entt]) & (traits_type::version_mask << traits_type::entity_shift);
-                    destroyed = entity_type{ to_integer(entities[entt]) & traits_type::entity_mask };
-                    curr = entity_type{ entt | version };
-                    entities[entt] = curr;
+        template<typename To, typename From>
+        double divergence() const {
+            const auto* cpool = pool<To>();
+            const auto* leader = pool<From>();
+            std::size_t shared{};
+            std::size_t breaks{};
+
+            if (cpool && leader) {
+                const auto* entities = leader->data();
+
+                for (auto pos = leader->size(), prev = pos; pos; --pos) {
+                    if (const auto entt = entities[pos - 1]; cpool->has(entt)) {
+                        const auto curr = cpool->index(entt);
+                        breaks += (shared++ && curr + 1u != prev);
+                        prev = curr;
+                    }
                 }
+            }
 
-                return curr;
-            });
+            return shared > 1u ? double(breaks) / double(shared - 1u) : 0.;
+        }
 
-            if constexpr (sizeof...(Component) > 0) {
-                // the reverse iterators guarantee the ordering between entities and components (hint: the pools return begin())
-                return std::make_tuple(assure<Component>()->batch(*this, std::make_reverse_iterator(last), std::make_reverse_iterator(first))...);
+        /**
+         * @brief Resets the given component for an entity.
+         *
+         * If the entity has an instance of the component, this function removes the
+         * component from the entity. Otherwise it does nothing.
+         *
+         * @warning
+         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity.
+         *
+         * @tparam Component Type of component to reset.
+         * @param entity A valid entity identifier.
+         */
+        template<typename Component>
+        void reset(const entity_type entity) {
+            ENTT_ASSERT(valid(entity));
+
+            if (auto * cpool = assure<Component>(); cpool->has(entity)) {
+                cpool->remove(*this, entity);
             }
         }
 
         /**
-         * @brief Creates a new entity from a prototype entity.
-         *
-         * @sa create
+         * @brief Resets the pool of the given component.
          *
-         * The components must be copyable for obvious reasons. The source entity
-         * must be a valid one.<br/>
-         * If no components are provided, the registry will try to copy all the
-         * existing types. The non-copyable ones will be ignored.
+         * For each entity that has an instance of the given component, the
+         * component itself is removed and thus destroyed.
          *
-         * @note
-         * Specifying the list of components is ways faster than an opaque copy.
+         * @tparam Component Type of component whose pool must be reset.
+         */
+        template<typename Component>
+        void reset() {
+            if (auto * cpool = assure<Component>(); cpool->on_destroy().empty() && cpool->on_destroy_batch().empty()) {
+                // no group set, otherwise the signal wouldn't be empty
+                cpool->reset();
+            }
+            else {
+                const sparse_set<entity_type>& entities = *cpool;
+                const std::vector<entity_type> range(entities.begin(), entities.end());
+                cpool->remove(*this, range.data(), range.size());
+            }
+        }
+
+        /**
+         * @brief Resets a whole registry.
          *
-         * @tparam Component Types of components to copy.
-         * @tparam Exclude Types of components not to be copied.
-         * @param src A valid entity identifier to be copied.
-         * @param other The registry that owns the source entity.
-         * @return A valid entity identifier.
+         * Destroys all the entities. After a call to `reset`, all the entities
+         * still in use are recycled with a new version number. In case entity
+         * identifers are stored around, the `valid` member function can be used
+         * to know if they are still valid.
          */
-        template<typename... Component, typename... Exclude>
-        auto create(entity_type src, basic_registry& other, exclude_t<Exclude...> = {}) {
-            entity_type entities[1]{};
-            create<Component...>(std::begin(entities), std::end(entities), src, other, exclude<Exclude...>);
-            return entities[0];
+        void reset() {
+            each([this](const auto entity) {
+                // useless this-> used to suppress a warning with clang
+                this->destroy(entity);
+            });
         }
 
         /**
-         * @brief Assigns each element in a range an entity from a prototype entity.
+         * @brief Iterates all the entities that are still in use.
          *
-         * @sa create
+         * The function object is invoked for each entity that is still in use.<br/>
+         * The signature of the function should be equivalent to the following:
          *
-         * The components must be copyable for obvious reasons. The entities must be
-         * all valid.<br/>
-         * If no components are provided, the registry will try to copy all the
-         * existing types. The non-copyable ones will be ignored.
+         * @code{.cpp}
+         * void(const Entity);
+         * @endcode
          *
-         * @note
-         * Specifying the list of components is ways faster than an opaque copy and
-         * uses the batch creation under the hood.
+         * This function is fairly slow and should not be used frequently. However,
+         * it's useful for iterating all the entities still in use, regardless of
+         * their components.
          *
-         * @tparam Component Types of components to copy.
-         * @tparam Exclude Types of components not to be copied.
-         * @param first An iterator to the first element of the range to generate.
-         * @param last An iterator past the last element of the range to generate.
-         * @param src A valid entity identifier to be copied.
-         * @param other The registry that owns the source entity.
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
          */
-        template<typename... Component, typename It, typename... Exclude>
-        void create(It first, It last, entity_type src, basic_registry& other, exclude_t<Exclude...> = {}) {
-            create(first, last);
+        template<typename Func>
+        void each(Func func) const {
+            static_assert(std::is_invocable_v<Func, entity_type>);
 
-            if constexpr (sizeof...(Component) == 0) {
-                stomp<Component...>(first, last, src, other, exclude<Exclude...>);
+            if (destroyed == null) {
+                for (auto pos = entities.size(); pos; --pos) {
+                    func(entities[pos - 1]);
+                }
             }
             else {
-                static_assert(sizeof...(Component) == 0 || sizeof...(Exclude) == 0);
-                (assure<Component>()->batch(*this, first, last, other.get<Component>(src)), ...);
+                for (auto pos = entities.size(); pos; --pos) {
+                    const auto curr = entity_type(pos - 1);
+                    const auto entity = entities[to_integer(curr)];
+                    const auto entt = entity_type{ to_integer(entity) & traits_type::entity_mask };
+
+                    if (curr == entt) {
+                        func(entity);
+                    }
+                }
             }
         }
 
         /**
-         * @brief Destroys an entity and lets the registry recycle the identifier.
-         *
-         * When an entity is destroyed, its version is updated and the identifier
-         * can be recycled at any time. In case entity identifers are stored around,
-         * the `valid` member function can be used to know if they are still valid
-         * or the entity has been destroyed and potentially recycled.
-         *
-         * @warning
-         * In case there are listeners that observe the destruction of components
-         * and assign other components to the entity in their bodies, the result of
-         * invoking this function may not be as expected. In the worst case, it
-         * could lead to undefined behavior. An assertion will abort the execution
-         * at runtime in debug mode if a violation is detected.
-         *
-         * @warning
-         * Attempting to use an invalid entity results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity.
-         *
+         * @brief Checks if an entity has components assigned.
          * @param entity A valid entity identifier.
+         * @return True if the entity has no components assigned, false otherwise.
          */
-        void destroy(const entity_type entity) {
+        bool orphan(const entity_type entity) const {
             ENTT_ASSERT(valid(entity));
+            bool orphan = true;
 
-            for (auto pos = pools.size(); pos; --pos) {
-                if (auto& pdata = pools[pos - 1]; pdata.pool && pdata.pool->has(entity)) {
-                    pdata.remove(*pdata.pool, *this, entity);
-                }
-            };
-
-            // just a way to protect users from listeners that attach components
-            ENTT_ASSERT(orphan(entity));
-            release(entity);
+            for (std::size_t pos{}, last = pools.size(); pos < last && orphan; ++pos) {
+                const auto& pdata = pools[pos];
+                orphan = !(pdata.pool && pdata.pool->has(entity));
+            }
+
+            return orphan;
         }
 
         /**
-         * @brief Destroys all the entities in a range.
+         * @brief Iterates orphans and applies them the given function object.
          *
-         * @sa destroy
+         * The function object is invoked for each entity that is still in use and
+         * has no components assigned.<br/>
+         * The signature of the function should be equivalent to the following:
          *
-         * @tparam It Type of input iterator.
-         * @param first An iterator to the first element of the range to generate.
-         * @param last An iterator past the last element of the range to generate.
+         * @code{.cpp}
+         * void(const Entity);
+         * @endcode
+         *
+         * This function can be very slow and should not be used frequently.
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
          */
-        template<typename It>
-        void destroy(It first, It last) {
-            // useless this-> used to suppress a warning with clang
-            std::for_each(first, last, [this](const auto entity) { this->destroy(entity); });
+        template<typename Func>
+        void orphans(Func func) const {
+            static_assert(std::is_invocable_v<Func, entity_type>);
+
+            each([this, &func](const auto entity) {
+                if (orphan(entity)) {
+                    func(entity);
+                }
+            });
         }
 
         /**
-         * @brief Assigns the given component to an entity.
+         * @brief Reports memory and occupancy of each pool to a function object.
          *
-         * A new instance of the given component is created and initialized with the
-         * arguments provided (the component must have a proper constructor or be of
-         * aggregate type). Then the component is assigned to the given entity.
+         * The signature of the function should be equivalent to the following:
          *
-         * @warning
-         * Attempting to use an invalid entity or to assign a component to an entity
-         * that already owns it results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity or if the entity already owns an instance of the given
-         * component.
+         * @code{.cpp}
+         * void(const pool_statistics &);
+         * @endcode
          *
-         * @tparam Component Type of component to create.
-         * @tparam Args Types of arguments to use to construct the component.
-         * @param entity A valid entity identifier.
-         * @param args Parameters to use to initialize the component.
-         * @return A reference to the newly created component.
+         * This function walks the sparse arrays and is meant for periodic
+         * inspection rather than for use within a frame.
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
          */
-        template<typename Component, typename... Args>
-        decltype(auto) assign(const entity_type entity, [[maybe_unused]] Args&& ... args) {
-            ENTT_ASSERT(valid(entity));
-            return assure<Component>()->assign(*this, entity, std::forward<Args>(args)...);
+        template<typename Func>
+        void statistics(Func func) const {
+            static_assert(std::is_invocable_v<Func, const pool_statistics&>);
+
+            for (const auto& pdata : pools) {
+                if (pdata.pool) {
+                    pool_statistics stats{};
+                    stats.type = pdata.runtime_type;
+                    pdata.describe(*pdata.pool, stats);
+                    func(std::as_const(stats));
+                }
+            }
         }
 
         /**
-         * @brief Removes the given component from an entity.
-         *
-         * @warning
-         * Attempting to use an invalid entity or to remove a component from an
-         * entity that doesn't own it results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity or if the entity doesn't own an instance of the given
-         * component.
-         *
-         * @tparam Component Type of component to remove.
-         * @param entity A valid entity identifier.
+         * @brief Returns memory and occupancy of the parts of a registry other
+         * than pools.
+         * @return The figures of the registry.
          */
-        template<typename Component>
-        void remove(const entity_type entity) {
-            ENTT_ASSERT(valid(entity));
-            pool<Component>()->remove(*this, entity);
+        registry_statistics statistics() const {
+            registry_statistics stats{};
+            stats.entities = entities.size();
+            stats.alive = alive();
+            stats.entity_bytes = entities.capacity() * sizeof(entity_type);
+            stats.pools = size_type(std::count_if(pools.cbegin(), pools.cend(), [](const auto& pdata) { return pdata.pool != nullptr; }));
+            stats.groups = groups.size();
+            stats.context = size_type(std::count_if(named_vars.cbegin(), named_vars.cend(), [](const auto& var) { return var->value != nullptr; }));
+
+            for (const auto& page : vars) {
+                for (std::size_t pos{}; page && pos < ctx_per_page; ++pos) {
+                    stats.context += (page[pos].value != nullptr);
+                }
+            }
+            return stats;
         }
 
         /**
-         * @brief Checks if an entity has all the given components.
+         * @brief Returns a view for the given components.
          *
-         * @warning
-         * Attempting to use an invalid entity results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity.
+         * This kind of objects are created on the fly and share with the registry
+         * its internal data structures.<br/>
+         * Feel free to discard a view after the use. Creating and destroying a view
+         * is an incredibly cheap operation because they do not require any type of
+         * initialization.<br/>
+         * As a rule of thumb, storing a view should never be an option.
          *
-         * @tparam Component Components for which to perform the check.
-         * @param entity A valid entity identifier.
-         * @return True if the entity has all the components, false otherwise.
-         */
-        template<typename... Component>
-        bool has(const entity_type entity) const ENTT_NOEXCEPT {
-            ENTT_ASSERT(valid(entity));
-            [[maybe_unused]] const auto cpools = std::make_tuple(pool<Component>()...);
-            return ((std::get<const pool_type<Component>*>(cpools) ? std::get<const pool_type<Component>*>(cpools)->has(entity) : false) && ...);
-        }
-
-        /**
-         * @brief Returns references to the given components for an entity.
+         * Views do their best to iterate the smallest set of candidate entities.
+         * In particular:
          *
-         * @warning
-         * Attempting to use an invalid entity or to get a component from an entity
-         * that doesn't own it results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity or if the entity doesn't own an instance of the given
-         * component.
+         * * Single component views are incredibly fast and iterate a packed array
+         *   of entities, all of which has the given component.
+         * * Multi component views look at the number of entities available for each
+         *   component and pick up a reference to the smallest set of candidates to
+         *   test for the given components.
          *
-         * @tparam Component Types of components to get.
-         * @param entity A valid entity identifier.
-         * @return References to the components owned by the entity.
+         * Views in no way affect the functionalities of the registry nor those of
+         * the underlying pools.
+         *
+         * @note
+         * Multi component views are pretty fast. However their performance tend to
+         * degenerate when the number of components to iterate grows up and the most
+         * of the entities have all the given components.<br/>
+         * To get a performance boost, consider using a group instead.
+         *
+         * @tparam Component Type of components used to construct the view.
+         * @return A newly created view.
          */
         template<typename... Component>
-        decltype(auto) get([[maybe_unused]] const entity_type entity) const {
-            ENTT_ASSERT(valid(entity));
-
-            if constexpr (sizeof...(Component) == 1) {
-                return (pool<Component>()->get(entity), ...);
-            }
-            else {
-                return std::tuple<decltype(get<Component>(entity))...>{get<Component>(entity)...};
-            }
+        entt::basic_view<Entity, Component...> view() {
+            return { assure<Component>()... };
         }
 
-        /*! @copydoc get */
+        /*! @copydoc view */
         template<typename... Component>
-        decltype(auto) get([[maybe_unused]] const entity_type entity) ENTT_NOEXCEPT {
-            ENTT_ASSERT(valid(entity));
+        entt::basic_view<Entity, Component...> view() const {
+            static_assert(std::conjunction_v<std::is_const<Component>...>);
+            return const_cast<basic_registry*>(this)->view<Component...>();
+        }
 
-            if constexpr (sizeof...(Component) == 1) {
-                return (pool<Component>()->get(entity), ...);
-            }
-            else {
-                return std::tuple<decltype(get<Component>(entity))...>{get<Component>(entity)...};
-            }
+        /**
+         * @brief Checks whether a given component belongs to a group.
+         * @tparam Component Type of component in which one is interested.
+         * @return True if the component belongs to a group, false otherwise.
+         */
+        template<typename Component>
+        bool owned() const ENTT_NOEXCEPT {
+            const auto* cpool = pool<Component>();
+            return cpool && cpool->group;
         }
 
         /**
-         * @brief Returns a reference to the given component for an entity.
-         *
-         * In case the entity doesn't own the component, the parameters provided are
-         * used to construct it.<br/>
-         * Equivalent to the following snippet (pseudocode):
+         * @brief Returns a group for the given components.
          *
-         * @code{.cpp}
-         * auto &component = registry.has<Component>(entity) ? registry.get<Component>(entity) : registry.assign<Component>(entity, args...);
-         * @endcode
+         * This kind of objects are created on the fly and share with the registry
+         * its internal data structures.<br/>
+         * Feel free to discard a group after the use. Creating and destroying a
+         * group is an incredibly cheap operation because they do not require any
+         * type of initialization, but for the first time they are requested.<br/>
+         * As a rule of thumb, storing a group should never be an option.
          *
-         * Prefer this function anyway because it has slightly better performance.
+         * Groups support exclusion lists and can own types of components. The more
+         * types are owned by a group, the faster it is to iterate entities and
+         * components.<br/>
+         * However, groups also affect some features of the registry such as the
+         * creation and destruction of components, which will consequently be
+         * slightly slower (nothing that can be noticed in most cases).
          *
-         * @warning
-         * Attempting to use an invalid entity results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity.
+         * @note
+         * Pools of components that are owned by a group cannot be sorted anymore.
+         * The group takes the ownership of the pools and arrange components so as
+         * to iterate them as fast as possible.
          *
-         * @tparam Component Type of component to get.
-         * @tparam Args Types of arguments to use to construct the component.
-         * @param entity A valid entity identifier.
-         * @param args Parameters to use to initialize the component.
-         * @return Reference to the component owned by the entity.
+         * @tparam Owned Types of components owned by the group.
+         * @tparam Get Types of components observed by the group.
+         * @tparam Exclude Types of components used to filter the group.
+         * @return A newly created group.
          */
-        template<typename Component, typename... Args>
-        decltype(auto) get_or_assign(const entity_type entity, Args&& ... args) ENTT_NOEXCEPT {
-            ENTT_ASSERT(valid(entity));
-            auto* cpool = assure<Component>();
-            return cpool->has(entity) ? cpool->get(entity) : cpool->assign(*this, entity, std::forward<Args>(args)...);
-        }
+        template<typename... Owned, typename... Get, typename... Exclude>
+        entt::basic_group<Entity, exclude_t<Exclude...>, get_t<Get...>, Owned...> group(get_t<Get...>, exclude_t<Exclude...> = {}) {
+            static_assert(sizeof...(Owned) + sizeof...(Get) > 0);
+            static_assert(sizeof...(Owned) + sizeof...(Get) + sizeof...(Exclude) > 1);
+
+            using handler_type = group_handler<exclude_t<Exclude...>, get_t<Get...>, Owned...>;
+
+            const std::size_t extent[] = { sizeof...(Owned), sizeof...(Get), sizeof...(Exclude) };
+            const component types[] = { type<Owned>()..., type<Get>()..., type<Exclude>()... };
+            handler_type* curr = nullptr;
+
+            if (auto it = std::find_if(groups.begin(), groups.end(), [&extent, &types](auto&& gdata) {
+                return std::equal(std::begin(extent), std::end(extent), gdata.extent) && gdata.is_same(types);
+            }); it != groups.cend())
+            {
+                curr = static_cast<handler_type*>(it->group.get());
+            }
+
+            if (!curr) {
+                groups.push_back(group_data{
+                    { sizeof...(Owned), sizeof...(Get), sizeof...(Exclude) },
+                    decltype(group_data::group){new handler_type{}, [](void* gptr) { delete static_cast<handler_type*>(gptr); }},
+                    [](const component* other) ENTT_NOEXCEPT {
+                        const component ctypes[] = { type<Owned>()..., type<Get>()..., type<Exclude>()... };
+                        return std::equal(std::begin(ctypes), std::end(ctypes), other);
+                    }
+                    });
+
+                curr = static_cast<handler_type*>(groups.back().group.get());
+
+                ((std::get<pool_type<Owned>*>(curr->cpools) = assure<Owned>()), ...);
+                ((std::get<pool_type<Get>*>(curr->cpools) = assure<Get>()), ...);
+                ((std::get<pool_type<Exclude>*>(curr->cpools) = assure<Exclude>()), ...);
+
+                ENTT_ASSERT((!std::get<pool_type<Owned>*>(curr->cpools)->group&& ...));
+
+                ((std::get<pool_type<Owned>*>(curr->cpools)->group = curr), ...);
+                (std::get<pool_type<Owned>*>(curr->cpools)->on_construct().template connect<&handler_type::template maybe_valid_if<Owned>>(*curr), ...);
+                (std::get<pool_type<Owned>*>(curr->cpools)->on_destroy().template connect<&handler_type::discard_if>(*curr), ...);
+
+                (std::get<pool_type<Get>*>(curr->cpools)->on_construct().template connect<&handler_type::template maybe_valid_if<Get>>(*curr), ...);
+                (std::get<pool_type<Get>*>(curr->cpools)->on_destroy().template connect<&handler_type::discard_if>(*curr), ...);
+
+                (std::get<pool_type<Exclude>*>(curr->cpools)->on_destroy().template connect<&handler_type::template maybe_valid_if<Exclude>>(*curr), ...);
+                (std::get<pool_type<Exclude>*>(curr->cpools)->on_construct().template connect<&handler_type::discard_if>(*curr), ...);
+
+                const auto* cpool = std::min({
+                    static_cast<sparse_set<Entity>*>(std::get<pool_type<Owned>*>(curr->cpools))...,
+                    static_cast<sparse_set<Entity>*>(std::get<pool_type<Get>*>(curr->cpools))...
+                    }, [](const auto* lhs, const auto* rhs) {
+                    return lhs->size() < rhs->size();
+                });
 
-        /**
-         * @brief Returns pointers to the given components for an entity.
-         *
-         * @warning
-         * Attempting to use an invalid entity results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity.
-         *
-         * @tparam Component Types of components to get.
-         * @param entity A valid entity identifier.
-         * @return Pointers to the components owned by the entity.
-         */
-        template<typename... Component>
-        auto try_get([[maybe_unused]] const entity_type entity) const ENTT_NOEXCEPT {
-            ENTT_ASSERT(valid(entity));
+                const auto accept = [curr](const auto entity) {
+                    if constexpr (sizeof...(Owned) == 0) {
+                        curr->construct(entity);
+                    }
+                    else {
+                        const auto pos = curr->owned++;
+                        // useless this-> used to suppress a warning with clang
+                        (std::get<pool_type<Owned>*>(curr->cpools)->swap(std::get<pool_type<Owned>*>(curr->cpools)->index(entity), pos), ...);
+                    }
+                };
 
-            if constexpr (sizeof...(Component) == 1) {
-                const auto cpools = std::make_tuple(pool<Component>()...);
-                return ((std::get<const pool_type<Component>*>(cpools) ? std::get<const pool_type<Component>*>(cpools)->try_get(entity) : nullptr), ...);
-            }
-            else {
-                return std::tuple<std::add_const_t<Component> * ...>{try_get<Component>(entity)...};
+                if ((std::get<pool_type<Owned>*>(curr->cpools)->tracks_presence() && ...)
+                    && (std::get<pool_type<Get>*>(curr->cpools)->tracks_presence() && ...)
+                    && (std::get<pool_type<Exclude>*>(curr->cpools)->tracks_presence() && ...))
+                {
+                    // swapping doesn't affect the bitsets, the order of the visit is irrelevant
+                    internal::intersect_presence<Entity>(
+                        std::array<const sparse_set<Entity>*, sizeof...(Owned) + sizeof...(Get)>{ std::get<pool_type<Owned>*>(curr->cpools)..., std::get<pool_type<Get>*>(curr->cpools)... },
+                        std::array<const sparse_set<Entity>*, sizeof...(Exclude)>{ std::get<pool_type<Exclude>*>(curr->cpools)... },
+                        [cpool, &accept](const auto id) { accept(cpool->resolve(id)); });
+                }
+                else {
+                    // we cannot iterate backwards because we want to leave behind valid entities in case of owned types
+                    std::for_each(cpool->data(), cpool->data() + cpool->size(), [curr, &accept](const auto entity) {
+                        if ((std::get<pool_type<Owned>*>(curr->cpools)->has(entity) && ...)
+                            && (std::get<pool_type<Get>*>(curr->cpools)->has(entity) && ...)
+                            && !(std::get<pool_type<Exclude>*>(curr->cpools)->has(entity) || ...))
+                        {
+                            accept(entity);
+                        }
+                    });
+                }
             }
-        }
 
-        /*! @copydoc try_get */
-        template<typename... Component>
-        auto try_get([[maybe_unused]] const entity_type entity) ENTT_NOEXCEPT {
-            if constexpr (sizeof...(Component) == 1) {
-                return (const_cast<Component*>(std::as_const(*this).template try_get<Component>(entity)), ...);
+            if constexpr (sizeof...(Owned) == 0) {
+                return { static_cast<sparse_set<Entity>*>(curr), std::get<pool_type<Get>*>(curr->cpools)... };
             }
             else {
-                return std::tuple<Component * ...>{try_get<Component>(entity)...};
+                return { &curr->owned, std::get<pool_type<Owned>*>(curr->cpools)... , std::get<pool_type<Get>*>(curr->cpools)... };
             }
         }
 
         /**
-         * @brief Replaces the given component for an entity.
-         *
-         * A new instance of the given component is created and initialized with the
-         * arguments provided (the component must have a proper constructor or be of
-         * aggregate type). Then the component is assigned to the given entity.
+         * @brief Returns a group for the given components.
          *
-         * @warning
-         * Attempting to use an invalid entity or to replace a component of an
-         * entity that doesn't own it results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity or if the entity doesn't own an instance of the given
-         * component.
+         * @sa group
          *
-         * @tparam Component Type of component to replace.
-         * @tparam Args Types of arguments to use to construct the component.
-         * @param entity A valid entity identifier.
-         * @param args Parameters to use to initialize the component.
-         * @return A reference to the newly created component.
+         * @tparam Owned Types of components owned by the group.
+         * @tparam Get Types of components observed by the group.
+         * @tparam Exclude Types of components used to filter the group.
+         * @return A newly created group.
          */
-        template<typename Component, typename... Args>
-        decltype(auto) replace(const entity_type entity, Args&& ... args) {
-            ENTT_ASSERT(valid(entity));
-            return pool<Component>()->replace(*this, entity, std::forward<Args>(args)...);
+        template<typename... Owned, typename... Get, typename... Exclude>
+        entt::basic_group<Entity, exclude_t<Exclude...>, get_t<Get...>, Owned...> group(get_t<Get...>, exclude_t<Exclude...> = {}) const {
+            static_assert(std::conjunction_v<std::is_const<Owned>..., std::is_const<Get>...>);
+            return const_cast<basic_registry*>(this)->group<Owned...>(entt::get<Get...>, exclude<Exclude...>);
         }
 
         /**
-         * @brief Assigns or replaces the given component for an entity.
-         *
-         * Equivalent to the following snippet (pseudocode):
-         *
-         * @code{.cpp}
-         * auto &component = registry.has<Component>(entity) ? registry.replace<Component>(entity, args...) : registry.assign<Component>(entity, args...);
-         * @endcode
-         *
-         * Prefer this function anyway because it has slightly better performance.
+         * @brief Returns a group for the given components.
          *
-         * @warning
-         * Attempting to use an invalid entity results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity.
+         * @sa group
          *
-         * @tparam Component Type of component to assign or replace.
-         * @tparam Args Types of arguments to use to construct the component.
-         * @param entity A valid entity identifier.
-         * @param args Parameters to use to initialize the component.
-         * @return A reference to the newly created component.
+         * @tparam Owned Types of components owned by the group.
+         * @tparam Exclude Types of components used to filter the group.
+         * @return A newly created group.
          */
-        template<typename Component, typename... Args>
-        decltype(auto) assign_or_replace(const entity_type entity, Args&& ... args) {
-            ENTT_ASSERT(valid(entity));
-            auto* cpool = assure<Component>();
-            return cpool->has(entity) ? cpool->replace(*this, entity, std::forward<Args>(args)...) : cpool->assign(*this, entity, std::forward<Args>(args)...);
+        template<typename... Owned, typename... Exclude>
+        entt::basic_group<Entity, exclude_t<Exclude...>, get_t<>, Owned...> group(exclude_t<Exclude...> = {}) {
+            return group<Owned...>(entt::get<>, exclude<Exclude...>);
         }
 
         /**
-         * @brief Returns a sink object for the given component.
-         *
-         * A sink is an opaque object used to connect listeners to components.<br/>
-         * The sink returned by this function can be used to receive notifications
-         * whenever a new instance of the given component is created and assigned to
-         * an entity.
-         *
-         * The function type for a listener is equivalent to:
-         *
-         * @code{.cpp}
-         * void(Entity, registry<Entity> &, Component &);
-         * @endcode
-         *
-         * Listeners are invoked **after** the component has been assigned to the
-         * entity. The order of invocation of the listeners isn't guaranteed.
-         *
-         * @note
-         * Empty types aren't explicitly instantiated. Therefore, temporary objects
-         * are returned through signals. They can be caught only by copy or with
-         * const references.
+         * @brief Returns a group for the given components.
          *
-         * @sa sink
+         * @sa group
          *
-         * @tparam Component Type of component of which to get the sink.
-         * @return A temporary sink object.
+         * @tparam Owned Types of components owned by the group.
+         * @tparam Exclude Types of components used to filter the group.
+         * @return A newly created group.
          */
-        template<typename Component>
-        auto on_construct() ENTT_NOEXCEPT {
-            return assure<Component>()->on_construct();
+        template<typename... Owned, typename... Exclude>
+        entt::basic_group<Entity, exclude_t<Exclude...>, get_t<>, Owned...> group(exclude_t<Exclude...> = {}) const {
+            static_assert(std::conjunction_v<std::is_const<Owned>...>);
+            return const_cast<basic_registry*>(this)->group<Owned...>(exclude<Exclude...>);
         }
 
         /**
-         * @brief Returns a sink object for the given component.
-         *
-         * A sink is an opaque object used to connect listeners to components.<br/>
-         * The sink returned by this function can be used to receive notifications
-         * whenever an instance of the given component is explicitly replaced.
-         *
-         * The function type for a listener is equivalent to:
-         *
-         * @code{.cpp}
-         * void(Entity, registry<Entity> &, Component &);
-         * @endcode
+         * @brief Returns a persistent query for the given components.
          *
-         * Listeners are invoked **before** the component has been replaced. The
-         * order of invocation of the listeners isn't guaranteed.
+         * Queries are registered the first time they are requested and kept
+         * up-to-date from then on, so that they never have to probe the pools to
+         * find the entities to iterate. Requesting the same query again is cheap
+         * and refreshes the positions it caches, if needed.<br/>
+         * As a rule of thumb, storing a query should never be an option.
          *
-         * @note
-         * Empty types aren't explicitly instantiated. Therefore, temporary objects
-         * are returned through signals. They can be caught only by copy or with
-         * const references.
+         * Unlike groups, queries don't own pools and don't prevent them from
+         * being sorted. However, they slightly slow down the creation and
+         * destruction of the given components, as groups do.
          *
-         * @sa sink
+         * @sa basic_query
          *
-         * @tparam Component Type of component of which to get the sink.
-         * @return A temporary sink object.
+         * @tparam Get Types of components iterated by the query.
+         * @tparam Exclude Types of components used to filter the query.
+         * @tparam Optional Types of components returned when available.
+         * @return A newly created query.
          */
-        template<typename Component>
-        auto on_replace() ENTT_NOEXCEPT {
-            return assure<Component>()->on_replace();
+        template<typename... Get, typename... Exclude, typename... Optional>
+        entt::basic_query<Entity, exclude_t<Exclude...>, optional_t<Optional...>, Get...> query(exclude_t<Exclude...> = {}, optional_t<Optional...> = {}) {
+            static_assert(sizeof...(Get) > 0);
+
+            using handler_type = query_handler<exclude_t<std::decay_t<Exclude>...>, optional_t<std::decay_t<Optional>...>, std::decay_t<Get>...>;
+
+            const std::size_t extent[] = { sizeof...(Get), sizeof...(Optional), sizeof...(Exclude) };
+            const component types[] = { type<Get>()..., type<Optional>()..., type<Exclude>()... };
+            handler_type* curr = nullptr;
+
+            if (auto it = std::find_if(queries.begin(), queries.end(), [&extent, &types](auto&& qdata) {
+                return std::equal(std::begin(extent), std::end(extent), qdata.extent) && qdata.is_same(types);
+            }); it != queries.cend())
+            {
+                curr = static_cast<handler_type*>(it->group.get());
+            }
+
+            if (!curr) {
+                queries.push_back(group_data{
+                    { sizeof...(Get), sizeof...(Optional), sizeof...(Exclude) },
+                    decltype(group_data::group){new handler_type{}, [](void* qptr) { delete static_cast<handler_type*>(qptr); }},
+                    [](const component* other) ENTT_NOEXCEPT {
+                        const component ctypes[] = { type<Get>()..., type<Optional>()..., type<Exclude>()... };
+                        return std::equal(std::begin(ctypes), std::end(ctypes), other);
+                    }
+                    });
+
+                curr = static_cast<handler_type*>(queries.back().group.get());
+
+                ((std::get<pool_type<Get>*>(curr->cpools) = assure<Get>()), ...);
+                ((std::get<pool_type<Optional>*>(curr->cpools) = assure<Optional>()), ...);
+                ((std::get<pool_type<Exclude>*>(curr->cpools) = assure<Exclude>()), ...);
+
+                (std::get<pool_type<Get>*>(curr->cpools)->on_construct().template connect<&handler_type::template maybe_valid_if<std::decay_t<Get>>>(*curr), ...);
+                (std::get<pool_type<Get>*>(curr->cpools)->on_destroy().template connect<&handler_type::template discard_if<std::decay_t<Get>>>(*curr), ...);
+
+                (std::get<pool_type<Optional>*>(curr->cpools)->on_construct().template connect<&handler_type::template maybe_valid_if<std::decay_t<Optional>>>(*curr), ...);
+                (std::get<pool_type<Optional>*>(curr->cpools)->on_destroy().template connect<&handler_type::template discard_if<std::decay_t<Optional>>>(*curr), ...);
+
+                (std::get<pool_type<Exclude>*>(curr->cpools)->on_destroy().template connect<&handler_type::template maybe_valid_if<std::decay_t<Exclude>>>(*curr), ...);
+                (std::get<pool_type<Exclude>*>(curr->cpools)->on_construct().template connect<&handler_type::template discard_if<std::decay_t<Exclude>>>(*curr), ...);
+
+                ((curr->layout[handler_type::template column<std::decay_t<Get>>()] = std::get<pool_type<Get>*>(curr->cpools)->layout), ...);
+                ((curr->layout[handler_type::template column<std::decay_t<Optional>>()] = std::get<pool_type<Optional>*>(curr->cpools)->layout), ...);
+
+                const auto* cpool = std::min({
+                    static_cast<sparse_set<Entity>*>(std::get<pool_type<Get>*>(curr->cpools))...
+                    }, [](const auto* lhs, const auto* rhs) {
+                    return lhs->size() < rhs->size();
+                });
+
+                std::for_each(cpool->data(), cpool->data() + cpool->size(), [curr](const auto entity) {
+                    if ((std::get<pool_type<Get>*>(curr->cpools)->has(entity) && ...)
+                        && !(std::get<pool_type<Exclude>*>(curr->cpools)->has(entity) || ...))
+                    {
+                        curr->insert(entity);
+                    }
+                });
+            }
+            else {
+                (curr->template refresh<std::decay_t<Get>>(), ...);
+                (curr->template refresh<std::decay_t<Optional>>(), ...);
+            }
+
+            return { curr, &curr->indices, std::get<pool_type<Get>*>(curr->cpools)..., std::get<pool_type<Optional>*>(curr->cpools)... };
+        }
+
+        /*! @copydoc query */
+        template<typename... Get, typename... Exclude, typename... Optional>
+        entt::basic_query<Entity, exclude_t<Exclude...>, optional_t<Optional...>, Get...> query(exclude_t<Exclude...> = {}, optional_t<Optional...> = {}) const {
+            static_assert(std::conjunction_v<std::is_const<Get>..., std::is_const<Optional>...>);
+            return const_cast<basic_registry*>(this)->query<Get...>(exclude<Exclude...>, optional<Optional...>);
         }
 
         /**
-         * @brief Returns a sink object for the given component.
+         * @brief Returns a persistent query for the given components.
          *
-         * A sink is an opaque object used to connect listeners to components.<br/>
-         * The sink returned by this function can be used to receive notifications
-         * whenever an instance of the given component is removed from an entity and
-         * thus destroyed.
+         * @sa query
          *
-         * The function type for a listener is equivalent to:
+         * @tparam Get Types of components iterated by the query.
+         * @tparam Optional Types of components returned when available.
+         * @return A newly created query.
+         */
+        template<typename... Get, typename... Optional>
+        entt::basic_query<Entity, exclude_t<>, optional_t<Optional...>, Get...> query(optional_t<Optional...>) {
+            return query<Get...>(exclude<>, optional<Optional...>);
+        }
+
+        /**
+         * @brief Returns a persistent query for the given components.
          *
-         * @code{.cpp}
-         * void(Entity, registry<Entity> &);
-         * @endcode
+         * @sa query
          *
-         * Listeners are invoked **before** the component has been removed from the
-         * entity. The order of invocation of the listeners isn't guaranteed.
+         * @tparam Get Types of components iterated by the query.
+         * @tparam Optional Types of components returned when available.
+         * @return A newly created query.
+         */
+        template<typename... Get, typename... Optional>
+        entt::basic_query<Entity, exclude_t<>, optional_t<Optional...>, Get...> query(optional_t<Optional...>) const {
+            static_assert(std::conjunction_v<std::is_const<Get>..., std::is_const<Optional>...>);
+            return const_cast<basic_registry*>(this)->query<Get...>(exclude<>, optional<Optional...>);
+        }
+
+        /**
+         * @brief Returns a runtime view for the given components.
          *
-         * @note
-         * Empty types aren't explicitly instantiated. Therefore, temporary objects
-         * are returned through signals. They can be caught only by copy or with
-         * const references.
+         * This kind of objects are created on the fly and share with the registry
+         * its internal data structures.<br/>
+         * Users should throw away the view after use. Fortunately, creating and
+         * destroying a runtime view is an incredibly cheap operation because they
+         * do not require any type of initialization.<br/>
+         * As a rule of thumb, storing a view should never be an option.
          *
-         * @sa sink
+         * Runtime views are to be used when users want to construct a view from
+         * some external inputs and don't know at compile-time what are the required
+         * components.<br/>
+         * This is particularly well suited to plugin systems and mods in general.
          *
-         * @tparam Component Type of component of which to get the sink.
-         * @return A temporary sink object.
+         * @tparam It Type of input iterator.
+         * @param first An iterator to the first element of the range of components.
+         * @param last An iterator past the last element of the range of components.
+         * @return A newly created runtime view.
          */
-        template<typename Component>
-        auto on_destroy() ENTT_NOEXCEPT {
-            return assure<Component>()->on_destroy();
+        template<typename It>
+        entt::basic_runtime_view<Entity> runtime_view(It first, It last) const {
+            static_assert(std::is_same_v<typename std::iterator_traits<It>::value_type, component>);
+            std::vector<const sparse_set<Entity>*> set(std::distance(first, last));
+
+            std::transform(first, last, set.begin(), [this](const component type) -> const sparse_set<Entity>* {
+                const auto ctype = to_integer(type);
+
+                if (ctype < skip_family_pools && pools[ctype].pool && pools[ctype].runtime_type == ctype) {
+                    return pools[ctype].pool.get();
+                }
+
+                const auto offset = named_pools.find(ctype);
+                return offset == named_index::npos ? nullptr : pools[skip_family_pools + offset].pool.get();
+            });
+
+            return { std::move(set) };
         }
 
         /**
-         * @brief Sorts the pool of entities for the given component.
-         *
-         * The order of the elements in a pool is highly affected by assignments
-         * of components to entities and deletions. Components are arranged to
-         * maximize the performance during iterations and users should not make any
-         * assumption on the order.<br/>
-         * This function can be used to impose an order to the elements in the pool
-         * of the given component. The order is kept valid until a component of the
-         * given type is assigned or removed from an entity.
-         *
-         * The comparison function object must return `true` if the first element
-         * is _less_ than the second one, `false` otherwise. The signature of the
-         * comparison function should be equivalent to one of the following:
+         * @brief Returns a full or partial copy of a registry.
          *
-         * @code{.cpp}
-         * bool(const Entity, const Entity);
-         * bool(const Component &, const Component &);
-         * @endcode
+         * The components must be copyable for obvious reasons. The entities
+         * maintain their versions once copied.<br/>
+         * If no components are provided, the registry will try to clone all the
+         * existing pools. The ones for non-copyable types won't be cloned.
          *
-         * Moreover, the comparison function object shall induce a
-         * _strict weak ordering_ on the values.
+         * This feature supports exclusion lists. The excluded types have higher
+         * priority than those indicated for cloning. An excluded type will never be
+         * cloned.
          *
-         * The sort function oject must offer a member function template
-         * `operator()` that accepts three arguments:
+         * @note
+         * There isn't an efficient way to know if all the entities are assigned at
+         * least one component once copied. Therefore, there may be orphans. It is
+         * up to the caller to clean up the registry if necessary.
          *
-         * * An iterator to the first element of the range to sort.
-         * * An iterator past the last element of the range to sort.
-         * * A comparison function to use to compare the elements.
+         * @note
+         * Listeners and groups aren't copied. It is up to the caller to connect the
+         * listeners of interest to the new registry and to set up groups.
          *
-         * The comparison funtion object received by the sort function object hasn't
-         * necessarily the type of the one passed along with the other parameters to
-         * this member function.
+         * @note
+         * Sparse pages and the pages of paged pools of trivially copyable types
+         * are shared between the two registries, either of them copies a page the
+         * first time it modifies it. A copy can therefore be taken on one thread
+         * and read on another one while the original is modified, as long as its
+         * pages are only accessed through const member functions.
          *
          * @warning
-         * Pools of components owned by a group are only partially sorted.<br/>
-         * In other words, only the elements that aren't part of the group are
-         * sorted by this function. Use the `sort` member function of a group to
-         * sort the other half of the pool.
+         * Attempting to clone components that aren't copyable results in unexpected
+         * behaviors.<br/>
+         * A static assertion will abort the compilation when the components
+         * provided aren't copy constructible. Otherwise, an assertion will abort
+         * the execution at runtime in debug mode in case one or more pools cannot
+         * be cloned.
          *
-         * @tparam Component Type of components to sort.
-         * @tparam Compare Type of comparison function object.
-         * @tparam Sort Type of sort function object.
-         * @tparam Args Types of arguments to forward to the sort function object.
-         * @param compare A valid comparison function object.
-         * @param algo A valid sort function object.
-         * @param args Arguments to forward to the sort function object, if any.
+         * @tparam Component Types of components to clone.
+         * @tparam Exclude Types of components not to be cloned.
+         * @return A fresh copy of the registry.
          */
-        template<typename Component, typename Compare, typename Sort = std_sort, typename... Args>
-        void sort(Compare compare, Sort algo = Sort{}, Args&& ... args) {
-            if (auto * cpool = assure<Component>(); cpool->group) {
-                const auto last = cpool->end() - cpool->group->owned;
-                cpool->sort(cpool->begin(), last, std::move(compare), std::move(algo), std::forward<Args>(args)...);
+        template<typename... Component, typename... Exclude>
+        basic_registry clone(exclude_t<Exclude...> = {}) const {
+            static_assert(std::conjunction_v<std::is_copy_constructible<Component>...>);
+            basic_registry other;
+
+            other.pools.resize(pools.size());
+
+            for (auto pos = pools.size(); pos; --pos) {
+                const auto& pdata = pools[pos - 1];
+                // only the requested pools must be copyable, the others are skipped
+                ENTT_ASSERT(!sizeof...(Component) || !pdata.pool || pdata.clone || ((pdata.runtime_type != to_integer(type<Component>())) && ...));
+
+                if (pdata.pool && pdata.clone
+                    && (!sizeof...(Component) || ... || (pdata.runtime_type == to_integer(type<Component>())))
+                    && ((pdata.runtime_type != to_integer(type<Exclude>())) && ...))
+                {
+                    auto& curr = other.pools[pos - 1];
+                    curr.remove = pdata.remove;
+                    curr.remove_range = pdata.remove_range;
+                    curr.clone = pdata.clone;
+                    curr.stomp = pdata.stomp;
+                    curr.describe = pdata.describe;
+                    curr.pool = pdata.clone ? pdata.clone(*pdata.pool) : nullptr;
+                    curr.runtime_type = pdata.runtime_type;
+                }
             }
-            else {
-                cpool->sort(cpool->begin(), cpool->end(), std::move(compare), std::move(algo), std::forward<Args>(args)...);
+
+            other.skip_family_pools = skip_family_pools;
+            other.destroyed = destroyed;
+            other.entities = entities;
+
+            other.pools.erase(std::remove_if(other.pools.begin() + skip_family_pools, other.pools.end(), [](const auto& pdata) {
+                return !pdata.pool;
+            }), other.pools.end());
+
+            for (auto pos = skip_family_pools; pos < other.pools.size(); ++pos) {
+                other.named_pools.insert(other.pools[pos].runtime_type, pos - skip_family_pools);
             }
+
+            return other;
         }
 
         /**
-         * @brief Sorts two pools of components in the same way.
-         *
-         * The order of the elements in a pool is highly affected by assignments
-         * of components to entities and deletions. Components are arranged to
-         * maximize the performance during iterations and users should not make any
-         * assumption on the order.
-         *
-         * It happens that different pools of components must be sorted the same way
-         * because of runtime and/or performance constraints. This function can be
-         * used to order a pool of components according to the order between the
-         * entities in another pool of components.
-         *
-         * @b How @b it @b works
-         *
-         * Being `A` and `B` the two sets where `B` is the master (the one the order
-         * of which rules) and `A` is the slave (the one to sort), after a call to
-         * this function an iterator for `A` will return the entities according to
-         * the following rules:
+         * @brief Stomps an entity and its components.
          *
-         * * All the entities in `A` that are also in `B` are returned first
-         *   according to the order they have in `B`.
-         * * All the entities in `A` that are not in `B` are returned in no
-         *   particular order after all the other entities.
+         * The components must be copyable for obvious reasons. The entities
+         * must be both valid.<br/>
+         * If no components are provided, the registry will try to copy all the
+         * existing types. The non-copyable ones will be ignored.
          *
-         * Any subsequent change to `B` won't affect the order in `A`.
+         * This feature supports exclusion lists as an alternative to component
+         * lists. An excluded type will never be copied.
          *
          * @warning
-         * Pools of components owned by a group cannot be sorted this way.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case
-         * the pool is owned by a group.
-         *
-         * @tparam To Type of components to sort.
-         * @tparam From Type of components to use to sort.
-         */
-        template<typename To, typename From>
-        void sort() {
-            ENTT_ASSERT(!owned<To>());
-            assure<To>()->respect(*assure<From>());
-        }
-
-        /**
-         * @brief Resets the given component for an entity.
-         *
-         * If the entity has an instance of the component, this function removes the
-         * component from the entity. Otherwise it does nothing.
+         * Attempting to copy components that aren't copyable results in unexpected
+         * behaviors.<br/>
+         * A static assertion will abort the compilation when the components
+         * provided aren't copy constructible. Otherwise, an assertion will abort
+         * the execution at runtime in debug mode in case one or more types cannot
+         * be copied.
          *
          * @warning
-         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * Attempting to use invalid entities results in undefined behavior.<br/>
          * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entity.
+         * invalid entities.
          *
-         * @tparam Component Type of component to reset.
-         * @param entity A valid entity identifier.
+         * @tparam Component Types of components to copy.
+         * @tparam Exclude Types of components not to be copied.
+         * @param dst A valid entity identifier to copy to.
+         * @param src A valid entity identifier to be copied.
+         * @param other The registry that owns the source entity.
          */
-        template<typename Component>
-        void reset(const entity_type entity) {
-            ENTT_ASSERT(valid(entity));
-
-            if (auto * cpool = assure<Component>(); cpool->has(entity)) {
-                cpool->remove(*this, entity);
-            }
+        template<typename... Component, typename... Exclude>
+        void stomp(const entity_type dst, const entity_type src, basic_registry& other, exclude_t<Exclude...> = {}) {
+            const entity_type entities[1]{ dst };
+            stomp<Component...>(std::begin(entities), std::end(entities), src, other, exclude<Exclude...>);
         }
 
         /**
-         * @brief Resets the pool of the given component.
+         * @brief Stomps the entities in a range and their components.
          *
-         * For each entity that has an instance of the given component, the
-         * component itself is removed and thus destroyed.
+         * @sa stomp
          *
-         * @tparam Component Type of component whose pool must be reset.
+         * @tparam Component Types of components to copy.
+         * @tparam Exclude Types of components not to be copied.
+         * @param first An iterator to the first element of the range to stomp.
+         * @param last An iterator past the last element of the range to stomp.
+         * @param src A valid entity identifier to be copied.
+         * @param other The registry that owns the source entity.
          */
-        template<typename Component>
-        void reset() {
-            if (auto * cpool = assure<Component>(); cpool->on_destroy().empty()) {
-                // no group set, otherwise the signal wouldn't be empty
-                cpool->reset();
-            }
-            else {
-                for (const auto entity : static_cast<const sparse_set<entity_type>&>(*cpool)) {
-                    cpool->remove(*this, entity);
+        template<typename... Component, typename It, typename... Exclude>
+        void stomp(It first, It last, const entity_type src, basic_registry& other, exclude_t<Exclude...> = {}) {
+            static_assert(sizeof...(Component) == 0 || sizeof...(Exclude) == 0);
+            static_assert(std::conjunction_v<std::is_copy_constructible<Component>...>);
+
+            for (auto pos = other.pools.size(); pos; --pos) {
+                const auto& pdata = other.pools[pos - 1];
+                ENTT_ASSERT(!sizeof...(Component) || !pdata.pool || pdata.stomp);
+
+                if (pdata.pool && pdata.stomp
+                    && (!sizeof...(Component) || ... || (pdata.runtime_type == to_integer(type<Component>())))
+                    && ((pdata.runtime_type != to_integer(type<Exclude>())) && ...)
+                    && pdata.pool->has(src))
+                {
+                    std::for_each(first, last, [this, &pdata, src](const auto entity) {
+                        pdata.stomp(*pdata.pool, src, *this, entity);
+                    });
                 }
             }
         }
 
         /**
-         * @brief Resets a whole registry.
+         * @brief Returns a temporary object to use to create snapshots.
          *
-         * Destroys all the entities. After a call to `reset`, all the entities
-         * still in use are recycled with a new version number. In case entity
-         * identifers are stored around, the `valid` member function can be used
-         * to know if they are still valid.
+         * A snapshot is either a full or a partial dump of a registry.<br/>
+         * It can be used to save and restore its internal state or to keep two or
+         * more instances of this class in sync, as an example in a client-server
+         * architecture.
+         *
+         * @return A temporary object to use to take snasphosts.
          */
-        void reset() {
-            each([this](const auto entity) {
-                // useless this-> used to suppress a warning with clang
-                this->destroy(entity);
-            });
+        entt::basic_snapshot<Entity> snapshot() const ENTT_NOEXCEPT {
+            using follow_fn_type = entity_type(const basic_registry&, const entity_type);
+
+            const auto head = to_integer(destroyed);
+            const entity_type seed = (destroyed == null) ? destroyed : entity_type{ head | (to_integer(entities[head]) & (traits_type::version_mask << traits_type::entity_shift)) };
+
+            follow_fn_type* follow = [](const basic_registry& reg, const entity_type entity) -> entity_type {
+                const auto& others = reg.entities;
+                const auto entt = to_integer(entity) & traits_type::entity_mask;
+                const auto curr = to_integer(others[entt]) & traits_type::entity_mask;
+                return entity_type{ curr | (to_integer(others[curr]) & (traits_type::version_mask << traits_type::entity_shift)) };
+            };
+
+            return { this, seed, follow };
         }
 
         /**
-         * @brief Iterates all the entities that are still in use.
-         *
-         * The function object is invoked for each entity that is still in use.<br/>
-         * The signature of the function should be equivalent to the following:
+         * @brief Returns a temporary object to use to load snapshots.
          *
-         * @code{.cpp}
-         * void(const Entity);
-         * @endcode
+         * A snapshot is either a full or a partial dump of a registry.<br/>
+         * It can be used to save and restore its internal state or to keep two or
+         * more instances of this class in sync, as an example in a client-server
+         * architecture.
          *
-         * This function is fairly slow and should not be used frequently. However,
-         * it's useful for iterating all the entities still in use, regardless of
-         * their components.
+         * @note
+         * The loader returned by this function requires that the registry be empty.
+         * In case it isn't, all the data will be automatically deleted before to
+         * return.
          *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @return A temporary object to use to load snasphosts.
          */
-        template<typename Func>
-        void each(Func func) const {
-            static_assert(std::is_invocable_v<Func, entity_type>);
+        basic_snapshot_loader<Entity> loader() ENTT_NOEXCEPT {
+            using force_fn_type = void(basic_registry&, const entity_type, const bool);
 
-            if (destroyed == null) {
-                for (auto pos = entities.size(); pos; --pos) {
-                    func(entities[pos - 1]);
-                }
-            }
-            else {
-                for (auto pos = entities.size(); pos; --pos) {
-                    const auto curr = entity_type(pos - 1);
-                    const auto entity = entities[to_integer(curr)];
-                    const auto entt = entity_type{ to_integer(entity) & traits_type::entity_mask };
+            force_fn_type* force = [](basic_registry& reg, const entity_type entity, const bool discard) {
+                const auto entt = to_integer(entity) & traits_type::entity_mask;
+                auto& others = reg.entities;
 
-                    if (curr == entt) {
-                        func(entity);
-                    }
+                if (!(entt < others.size())) {
+                    auto curr = others.size();
+                    others.resize(entt + 1);
+
+                    std::generate(others.data() + curr, others.data() + entt, [curr]() mutable {
+                        return entity_type(curr++);
+                    });
                 }
-            }
-        }
 
-        /**
-         * @brief Checks if an entity has components assigned.
-         * @param entity A valid entity identifier.
-         * @return True if the entity has no components assigned, false otherwise.
-         */
-        bool orphan(const entity_type entity) const {
-            ENTT_ASSERT(valid(entity));
-            bool orphan = true;
+                others[entt] = entity;
 
-            for (std::size_t pos{}, last = pools.size(); pos < last && orphan; ++pos) {
-                const auto& pdata = pools[pos];
-                orphan = !(pdata.pool && pdata.pool->has(entity));
-            }
+                if (discard) {
+                    reg.destroy(entity);
+                    const auto version = to_integer(entity) & (traits_type::version_mask << traits_type::entity_shift);
+                    others[entt] = entity_type{ (to_integer(others[entt]) & traits_type::entity_mask) | version };
+                }
+            };
 
-            return orphan;
+            reset();
+            entities.clear();
+            destroyed = null;
+
+            return { this, force };
         }
 
         /**
-         * @brief Iterates orphans and applies them the given function object.
-         *
-         * The function object is invoked for each entity that is still in use and
-         * has no components assigned.<br/>
-         * The signature of the function should be equivalent to the following:
-         *
-         * @code{.cpp}
-         * void(const Entity);
-         * @endcode
+         * @brief Binds an object to the context of the registry.
          *
-         * This function can be very slow and should not be used frequently.
+         * If the value already exists it is overwritten, otherwise a new instance
+         * of the given type is created and initialized with the arguments provided.
          *
-         * @tparam Func Type of the function object to invoke.
-         * @param func A valid function object.
+         * @tparam Type Type of object to set.
+         * @tparam Args Types of arguments to use to construct the object.
+         * @param args Parameters to use to initialize the value.
+         * @return A reference to the newly created object.
          */
-        template<typename Func>
-        void orphans(Func func) const {
-            static_assert(std::is_invocable_v<Func, entity_type>);
+        template<typename Type, typename... Args>
+        Type& set(Args&& ... args) {
+            return ctx_assure<Type>().template emplace<Type>(runtime_type<Type, context_family>(), std::forward<Args>(args)...);
+        }
 
-            each([this, &func](const auto entity) {
-                if (orphan(entity)) {
-                    func(entity);
-                }
-            });
+        /**
+         * @brief Unsets a context variable if it exists.
+         * @tparam Type Type of object to set.
+         */
+        template<typename Type>
+        void unset() {
+            if constexpr (is_named_type_v<Type>) {
+                named_vars.erase(std::remove_if(named_vars.begin(), named_vars.end(), [](const auto& var) {
+                    return var->runtime_type == runtime_type<Type, context_family>();
+                }), named_vars.end());
+            }
+            else if (auto* slot = ctx_slot<Type>(); slot) {
+                const_cast<ctx_variable*>(slot)->reset();
+            }
         }
 
         /**
-         * @brief Returns a view for the given components.
-         *
-         * This kind of objects are created on the fly and share with the registry
-         * its internal data structures.<br/>
-         * Feel free to discard a view after the use. Creating and destroying a view
-         * is an incredibly cheap operation because they do not require any type of
-         * initialization.<br/>
-         * As a rule of thumb, storing a view should never be an option.
-         *
-         * Views do their best to iterate the smallest set of candidate entities.
-         * In particular:
-         *
-         * * Single component views are incredibly fast and iterate a packed array
-         *   of entities, all of which has the given component.
-         * * Multi component views look at the number of entities available for each
-         *   component and pick up a reference to the smallest set of candidates to
-         *   test for the given components.
-         *
-         * Views in no way affect the functionalities of the registry nor those of
-         * the underlying pools.
+         * @brief Binds an object to the context of the registry.
          *
-         * @note
-         * Multi component views are pretty fast. However their performance tend to
-         * degenerate when the number of components to iterate grows up and the most
-         * of the entities have all the given components.<br/>
-         * To get a performance boost, consider using a group instead.
+         * In case the context doesn't contain the given object, the parameters
+         * provided are used to construct it.
          *
-         * @tparam Component Type of components used to construct the view.
-         * @return A newly created view.
+         * @tparam Type Type of object to set.
+         * @tparam Args Types of arguments to use to construct the object.
+         * @param args Parameters to use to initialize the object.
+         * @return Reference to the object.
          */
-        template<typename... Component>
-        entt::basic_view<Entity, Component...> view() {
-            return { assure<Component>()... };
-        }
-
-        /*! @copydoc view */
-        template<typename... Component>
-        entt::basic_view<Entity, Component...> view() const {
-            static_assert(std::conjunction_v<std::is_const<Component>...>);
-            return const_cast<basic_registry*>(this)->view<Component...>();
+        template<typename Type, typename... Args>
+        Type& ctx_or_set(Args&& ... args) {
+            auto* type = try_ctx<Type>();
+            return type ? *type : set<Type>(std::forward<Args>(args)...);
         }
 
         /**
-         * @brief Checks whether a given component belongs to a group.
-         * @tparam Component Type of component in which one is interested.
-         * @return True if the component belongs to a group, false otherwise.
+         * @brief Returns a pointer to an object in the context of the registry.
+         * @tparam Type Type of object to get.
+         * @return A pointer to the object if it exists in the context of the
+         * registry, a null pointer otherwise.
          */
-        template<typename Component>
-        bool owned() const ENTT_NOEXCEPT {
-            const auto* cpool = pool<Component>();
-            return cpool && cpool->group;
+        template<typename Type>
+        const Type* try_ctx() const ENTT_NOEXCEPT {
+            const auto* slot = ctx_slot<Type>();
+            return slot ? static_cast<const Type*>(slot->value) : nullptr;
+        }
+
+        /*! @copydoc try_ctx */
+        template<typename Type>
+        Type* try_ctx() ENTT_NOEXCEPT {
+            return const_cast<Type*>(std::as_const(*this).template try_ctx<Type>());
         }
 
         /**
-         * @brief Returns a group for the given components.
-         *
-         * This kind of objects are created on the fly and share with the registry
-         * its internal data structures.<br/>
-         * Feel free to discard a group after the use. Creating and destroying a
-         * group is an incredibly cheap operation because they do not require any
-         * type of initialization, but for the first time they are requested.<br/>
-         * As a rule of thumb, storing a group should never be an option.
-         *
-         * Groups support exclusion lists and can own types of components. The more
-         * types are owned by a group, the faster it is to iterate entities and
-         * components.<br/>
-         * However, groups also affect some features of the registry such as the
-         * creation and destruction of components, which will consequently be
-         * slightly slower (nothing that can be noticed in most cases).
+         * @brief Returns a reference to an object in the context of the registry.
          *
-         * @note
-         * Pools of components that are owned by a group cannot be sorted anymore.
-         * The group takes the ownership of the pools and arrange components so as
-         * to iterate them as fast as possible.
+         * @warning
+         * Attempting to get a context variable that doesn't exist results in
+         * undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid requests.
          *
-         * @tparam Owned Types of components owned by the group.
-         * @tparam Get Types of components observed by the group.
-         * @tparam Exclude Types of components used to filter the group.
-         * @return A newly created group.
+         * @tparam Type Type of object to get.
+         * @return A valid reference to the object in the context of the registry.
          */
-        template<typename... Owned, typename... Get, typename... Exclude>
-        entt::basic_group<Entity, exclude_t<Exclude...>, get_t<Get...>, Owned...> group(get_t<Get...>, exclude_t<Exclude...> = {}) {
-            static_assert(sizeof...(Owned) + sizeof...(Get) > 0);
-            static_assert(sizeof...(Owned) + sizeof...(Get) + sizeof...(Exclude) > 1);
+        template<typename Type>
+        const Type& ctx() const ENTT_NOEXCEPT {
+            const auto* instance = try_ctx<Type>();
+            ENTT_ASSERT(instance);
+            return *instance;
+        }
 
-            using handler_type = group_handler<exclude_t<Exclude...>, get_t<Get...>, Owned...>;
+        /*! @copydoc ctx */
+        template<typename Type>
+        Type& ctx() ENTT_NOEXCEPT {
+            return const_cast<Type&>(std::as_const(*this).template ctx<Type>());
+        }
 
-            const std::size_t extent[] = { sizeof...(Owned), sizeof...(Get), sizeof...(Exclude) };
-            const component types[] = { type<Owned>()..., type<Get>()..., type<Exclude>()... };
-            handler_type* curr = nullptr;
+    private:
+        std::size_t skip_family_pools{};
+        std::vector<pool_data> pools{};
+        named_index named_pools{};
+        std::vector<group_data> groups{};
+        std::vector<group_data> queries{};
+        std::vector<std::unique_ptr<ctx_variable[]>> vars{};
+        std::vector<std::unique_ptr<ctx_variable>> named_vars{};
+        std::vector<entity_type> entities{};
+        entity_type destroyed{ null };
+    };
 
-            if (auto it = std::find_if(groups.begin(), groups.end(), [&extent, &types](auto&& gdata) {
-                return std::equal(std::begin(extent), std::end(extent), gdata.extent) && gdata.is_same(types);
-            }); it != groups.cend())
-            {
-                curr = static_cast<handler_type*>(it->group.get());
-            }
 
-            if (!curr) {
-                groups.push_back(group_data{
-                    { sizeof...(Owned), sizeof...(Get), sizeof...(Exclude) },
-                    decltype(group_data::group){new handler_type{}, [](void* gptr) { delete static_cast<handler_type*>(gptr); }},
-                    [](const component* other) ENTT_NOEXCEPT {
-                        const component ctypes[] = { type<Owned>()..., type<Get>()..., type<Exclude>()... };
-                        return std::equal(std::begin(ctypes), std::end(ctypes), other);
-                    }
-                    });
+}
+
+
+#endif // ENTT_ENTITY_REGISTRY_HPP
+
+// #include "entity.hpp"
+
+// #include "fwd.hpp"
 
-                curr = static_cast<handler_type*>(groups.back().group.get());
 
-                ((std::get<pool_type<Owned>*>(curr->cpools) = assure<Owned>()), ...);
-                ((std::get<pool_type<Get>*>(curr->cpools) = assure<Get>()), ...);
-                ((std::get<pool_type<Exclude>*>(curr->cpools) = assure<Exclude>()), ...);
 
-                ENTT_ASSERT((!std::get<pool_type<Owned>*>(curr->cpools)->group&& ...));
+namespace entt {
 
-                ((std::get<pool_type<Owned>*>(curr->cpools)->group = curr), ...);
-                (std::get<pool_type<Owned>*>(curr->cpools)->on_construct().template connect<&handler_type::template maybe_valid_if<Owned>>(*curr), ...);
-                (std::get<pool_type<Owned>*>(curr->cpools)->on_destroy().template connect<&handler_type::discard_if>(*curr), ...);
 
-                (std::get<pool_type<Get>*>(curr->cpools)->on_construct().template connect<&handler_type::template maybe_valid_if<Get>>(*curr), ...);
-                (std::get<pool_type<Get>*>(curr->cpools)->on_destroy().template connect<&handler_type::discard_if>(*curr), ...);
+    /**
+     * @brief Dedicated to those who aren't confident with the
+     * entity-component-system architecture.
+     *
+     * Tiny wrapper around a registry, for all those users that aren't confident
+     * with entity-component-system architecture and prefer to iterate objects
+     * directly.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     */
+    template<typename Entity>
+    struct basic_actor {
+        /*! @brief Type of registry used internally. */
+        using registry_type = basic_registry<Entity>;
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
 
-                (std::get<pool_type<Exclude>*>(curr->cpools)->on_destroy().template connect<&handler_type::template maybe_valid_if<Exclude>>(*curr), ...);
-                (std::get<pool_type<Exclude>*>(curr->cpools)->on_construct().template connect<&handler_type::discard_if>(*curr), ...);
+        basic_actor() ENTT_NOEXCEPT
+            : entt{ entt::null }, reg{ nullptr }
+        {}
 
-                const auto* cpool = std::min({
-                    static_cast<sparse_set<Entity>*>(std::get<pool_type<Owned>*>(curr->cpools))...,
-                    static_cast<sparse_set<Entity>*>(std::get<pool_type<Get>*>(curr->cpools))...
-                    }, [](const auto* lhs, const auto* rhs) {
-                    return lhs->size() < rhs->size();
-                });
+        /**
+         * @brief Constructs an actor from a given registry.
+         * @param ref An instance of the registry class.
+         */
+        explicit basic_actor(registry_type& ref)
+            : entt{ ref.create() }, reg{ &ref }
+        {}
 
-                // we cannot iterate backwards because we want to leave behind valid entities in case of owned types
-                std::for_each(cpool->data(), cpool->data() + cpool->size(), [curr](const auto entity) {
-                    if ((std::get<pool_type<Owned>*>(curr->cpools)->has(entity) && ...)
-                        && (std::get<pool_type<Get>*>(curr->cpools)->has(entity) && ...)
-                        && !(std::get<pool_type<Exclude>*>(curr->cpools)->has(entity) || ...))
-                    {
-                        if constexpr (sizeof...(Owned) == 0) {
-                            curr->construct(entity);
-                        }
-                        else {
-                            const auto pos = curr->owned++;
-                            // useless this-> used to suppress a warning with clang
-                            (std::get<pool_type<Owned>*>(curr->cpools)->swap(std::get<pool_type<Owned>*>(curr->cpools)->index(entity), pos), ...);
-                        }
-                    }
-                });
-            }
+        /**
+         * @brief Constructs an actor from a given entity.
+         * @param entity A valid entity identifier.
+         * @param ref An instance of the registry class.
+         */
+        explicit basic_actor(entity_type entity, registry_type& ref)
+            : entt{ entity }, reg{ &ref }
+        {
+            ENTT_ASSERT(ref.valid(entity));
+        }
 
-            if constexpr (sizeof...(Owned) == 0) {
-                return { static_cast<sparse_set<Entity>*>(curr), std::get<pool_type<Get>*>(curr->cpools)... };
-            }
-            else {
-                return { &curr->owned, std::get<pool_type<Owned>*>(curr->cpools)... , std::get<pool_type<Get>*>(curr->cpools)... };
+        /*! @brief Default destructor. */
+        virtual ~basic_actor() {
+            if (*this) {
+                reg->destroy(entt);
             }
         }
 
         /**
-         * @brief Returns a group for the given components.
+         * @brief Move constructor.
          *
-         * @sa group
+         * After actor move construction, instances that have been moved from are
+         * placed in a valid but unspecified state. It's highly discouraged to
+         * continue using them.
          *
-         * @tparam Owned Types of components owned by the group.
-         * @tparam Get Types of components observed by the group.
-         * @tparam Exclude Types of components used to filter the group.
-         * @return A newly created group.
+         * @param other The instance to move from.
          */
-        template<typename... Owned, typename... Get, typename... Exclude>
-        entt::basic_group<Entity, exclude_t<Exclude...>, get_t<Get...>, Owned...> group(get_t<Get...>, exclude_t<Exclude...> = {}) const {
-            static_assert(std::conjunction_v<std::is_const<Owned>..., std::is_const<Get>...>);
-            return const_cast<basic_registry*>(this)->group<Owned...>(entt::get<Get...>, exclude<Exclude...>);
+        basic_actor(basic_actor&& other)
+            : entt{ other.entt }, reg{ other.reg }
+        {
+            other.entt = null;
         }
 
         /**
-         * @brief Returns a group for the given components.
+         * @brief Move assignment operator.
          *
-         * @sa group
+         * After actor move assignment, instances that have been moved from are
+         * placed in a valid but unspecified state. It's highly discouraged to
+         * continue using them.
          *
-         * @tparam Owned Types of components owned by the group.
-         * @tparam Exclude Types of components used to filter the group.
-         * @return A newly created group.
+         * @param other The instance to move from.
+         * @return This actor.
          */
-        template<typename... Owned, typename... Exclude>
-        entt::basic_group<Entity, exclude_t<Exclude...>, get_t<>, Owned...> group(exclude_t<Exclude...> = {}) {
-            return group<Owned...>(entt::get<>, exclude<Exclude...>);
+        basic_actor& operator=(basic_actor&& other) {
+            if (this != &other) {
+                auto tmp{ std::move(other) };
+                std::swap(reg, tmp.reg);
+                std::swap(entt, tmp.entt);
+            }
+
+            return *this;
         }
 
         /**
-         * @brief Returns a group for the given components.
+         * @brief Assigns the given component to an actor.
          *
-         * @sa group
+         * A new instance of the given component is created and initialized with the
+         * arguments provided (the component must have a proper constructor or be of
+         * aggregate type). Then the component is assigned to the actor.<br/>
+         * In case the actor already has a component of the given type, it's
+         * replaced with the new one.
          *
-         * @tparam Owned Types of components owned by the group.
-         * @tparam Exclude Types of components used to filter the group.
-         * @return A newly created group.
+         * @tparam Component Type of the component to create.
+         * @tparam Args Types of arguments to use to construct the component.
+         * @param args Parameters to use to initialize the component.
+         * @return A reference to the newly created component.
          */
-        template<typename... Owned, typename... Exclude>
-        entt::basic_group<Entity, exclude_t<Exclude...>, get_t<>, Owned...> group(exclude_t<Exclude...> = {}) const {
-            static_assert(std::conjunction_v<std::is_const<Owned>...>);
-            return const_cast<basic_registry*>(this)->group<Owned...>(exclude<Exclude...>);
+        template<typename Component, typename... Args>
+        decltype(auto) assign(Args&& ... args) {
+            return reg->template assign_or_replace<Component>(entt, std::forward<Args>(args)...);
         }
 
         /**
-         * @brief Returns a runtime view for the given components.
-         *
-         * This kind of objects are created on the fly and share with the registry
-         * its internal data structures.<br/>
-         * Users should throw away the view after use. Fortunately, creating and
-         * destroying a runtime view is an incredibly cheap operation because they
-         * do not require any type of initialization.<br/>
-         * As a rule of thumb, storing a view should never be an option.
-         *
-         * Runtime views are to be used when users want to construct a view from
-         * some external inputs and don't know at compile-time what are the required
-         * components.<br/>
-         * This is particularly well suited to plugin systems and mods in general.
-         *
-         * @tparam It Type of input iterator.
-         * @param first An iterator to the first element of the range of components.
-         * @param last An iterator past the last element of the range of components.
-         * @return A newly created runtime view.
+         * @brief Removes the given component from an actor.
+         * @tparam Component Type of the component to remove.
          */
-        template<typename It>
-        entt::basic_runtime_view<Entity> runtime_view(It first, It last) const {
-            static_assert(std::is_same_v<typename std::iterator_traits<It>::value_type, component>);
-            std::vector<const sparse_set<Entity>*> set(std::distance(first, last));
-
-            std::transform(first, last, set.begin(), [this](const component ctype) {
-                auto it = std::find_if(pools.begin(), pools.end(), [ctype = to_integer(ctype)](const auto& pdata) {
-                    return pdata.pool && pdata.runtime_type == ctype;
-                });
-
-                return it != pools.cend() && it->pool ? it->pool.get() : nullptr;
-            });
-
-            return { std::move(set) };
+        template<typename Component>
+        void remove() {
+            reg->template remove<Component>(entt);
         }
 
         /**
-         * @brief Returns a full or partial copy of a registry.
-         *
-         * The components must be copyable for obvious reasons. The entities
-         * maintain their versions once copied.<br/>
-         * If no components are provided, the registry will try to clone all the
-         * existing pools. The ones for non-copyable types won't be cloned.
-         *
-         * This feature supports exclusion lists. The excluded types have higher
-         * priority than those indicated for cloning. An excluded type will never be
-         * cloned.
-         *
-         * @note
-         * There isn't an efficient way to know if all the entities are assigned at
-         * least one component once copied. Therefore, there may be orphans. It is
-         * up to the caller to clean up the registry if necessary.
-         *
-         * @note
-         * Listeners and groups aren't copied. It is up to the caller to connect the
-         * listeners of interest to the new registry and to set up groups.
-         *
-         * @warning
-         * Attempting to clone components that aren't copyable results in unexpected
-         * behaviors.<br/>
-         * A static assertion will abort the compilation when the components
-         * provided aren't copy constructible. Otherwise, an assertion will abort
-         * the execution at runtime in debug mode in case one or more pools cannot
-         * be cloned.
-         *
-         * @tparam Component Types of components to clone.
-         * @tparam Exclude Types of components not to be cloned.
-         * @return A fresh copy of the registry.
+         * @brief Checks if an actor has the given components.
+         * @tparam Component Components for which to perform the check.
+         * @return True if the actor has all the components, false otherwise.
          */
-        template<typename... Component, typename... Exclude>
-        basic_registry clone(exclude_t<Exclude...> = {}) const {
-            static_assert(std::conjunction_v<std::is_copy_constructible<Component>...>);
-            basic_registry other;
-
-            other.pools.resize(pools.size());
+        template<typename... Component>
+        bool has() const ENTT_NOEXCEPT {
+            return (reg->template has<Component>(entt) && ...);
+        }
 
-            for (auto pos = pools.size(); pos; --pos) {
-                const auto& pdata = pools[pos - 1];
-                ENTT_ASSERT(!sizeof...(Component) || !pdata.pool || pdata.clone);
+        /**
+         * @brief Returns references to the given components for an actor.
+         * @tparam Component Types of components to get.
+         * @return References to the components owned by the actor.
+         */
+        template<typename... Component>
+        decltype(auto) get() const ENTT_NOEXCEPT {
+            return std::as_const(*reg).template get<Component...>(entt);
+        }
 
-                if (pdata.pool && pdata.clone
-                    && (!sizeof...(Component) || ... || (pdata.runtime_type == to_integer(type<Component>())))
-                    && ((pdata.runtime_type != to_integer(type<Exclude>())) && ...))
-                {
-                    auto& curr = other.pools[pos - 1];
-                    curr.remove = pdata.remove;
-                    curr.clone = pdata.clone;
-                    curr.stomp = pdata.stomp;
-                    curr.pool = pdata.clone ? pdata.clone(*pdata.pool) : nullptr;
-                    curr.runtime_type = pdata.runtime_type;
-                }
-            }
+        /*! @copydoc get */
+        template<typename... Component>
+        decltype(auto) get() ENTT_NOEXCEPT {
+            return reg->template get<Component...>(entt);
+        }
 
-            other.skip_family_pools = skip_family_pools;
-            other.destroyed = destroyed;
-            other.entities = entities;
+        /**
+         * @brief Returns pointers to the given components for an actor.
+         * @tparam Component Types of components to get.
+         * @return Pointers to the components owned by the actor.
+         */
+        template<typename... Component>
+        auto try_get() const ENTT_NOEXCEPT {
+            return std::as_const(*reg).template try_get<Component...>(entt);
+        }
 
-            other.pools.erase(std::remove_if(other.pools.begin() + skip_family_pools, other.pools.end(), [](const auto& pdata) {
-                return !pdata.pool;
-            }), other.pools.end());
+        /*! @copydoc try_get */
+        template<typename... Component>
+        auto try_get() ENTT_NOEXCEPT {
+            return reg->template try_get<Component...>(entt);
+        }
 
-            return other;
+        /**
+         * @brief Returns a reference to the underlying registry.
+         * @return A reference to the underlying registry.
+         */
+        const registry_type& backend() const ENTT_NOEXCEPT {
+            return *reg;
+        }
+
+        /*! @copydoc backend */
+        registry_type& backend() ENTT_NOEXCEPT {
+            return const_cast<registry_type&>(std::as_const(*this).backend());
         }
 
         /**
-         * @brief Stomps an entity and its components.
-         *
-         * The components must be copyable for obvious reasons. The entities
-         * must be both valid.<br/>
-         * If no components are provided, the registry will try to copy all the
-         * existing types. The non-copyable ones will be ignored.
-         *
-         * This feature supports exclusion lists as an alternative to component
-         * lists. An excluded type will never be copied.
-         *
-         * @warning
-         * Attempting to copy components that aren't copyable results in unexpected
-         * behaviors.<br/>
-         * A static assertion will abort the compilation when the components
-         * provided aren't copy constructible. Otherwise, an assertion will abort
-         * the execution at runtime in debug mode in case one or more types cannot
-         * be copied.
-         *
-         * @warning
-         * Attempting to use invalid entities results in undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid entities.
-         *
-         * @tparam Component Types of components to copy.
-         * @tparam Exclude Types of components not to be copied.
-         * @param dst A valid entity identifier to copy to.
-         * @param src A valid entity identifier to be copied.
-         * @param other The registry that owns the source entity.
+         * @brief Returns the entity associated with an actor.
+         * @return The entity associated with the actor.
          */
-        template<typename... Component, typename... Exclude>
-        void stomp(const entity_type dst, const entity_type src, basic_registry& other, exclude_t<Exclude...> = {}) {
-            const entity_type entities[1]{ dst };
-            stomp<Component...>(std::begin(entities), std::end(entities), src, other, exclude<Exclude...>);
+        entity_type entity() const ENTT_NOEXCEPT {
+            return entt;
         }
 
         /**
-         * @brief Stomps the entities in a range and their components.
-         *
-         * @sa stomp
-         *
-         * @tparam Component Types of components to copy.
-         * @tparam Exclude Types of components not to be copied.
-         * @param first An iterator to the first element of the range to stomp.
-         * @param last An iterator past the last element of the range to stomp.
-         * @param src A valid entity identifier to be copied.
-         * @param other The registry that owns the source entity.
+         * @brief Checks if an actor refers to a valid entity or not.
+         * @return True if the actor refers to a valid entity, false otherwise.
          */
-        template<typename... Component, typename It, typename... Exclude>
-        void stomp(It first, It last, const entity_type src, basic_registry& other, exclude_t<Exclude...> = {}) {
-            static_assert(sizeof...(Component) == 0 || sizeof...(Exclude) == 0);
-            static_assert(std::conjunction_v<std::is_copy_constructible<Component>...>);
+        explicit operator bool() const ENTT_NOEXCEPT {
+            return reg && reg->valid(entt);
+        }
 
-            for (auto pos = other.pools.size(); pos; --pos) {
-                const auto& pdata = other.pools[pos - 1];
-                ENTT_ASSERT(!sizeof...(Component) || !pdata.pool || pdata.stomp);
+    private:
+        entity_type entt;
+        registry_type* reg;
+    };
 
-                if (pdata.pool && pdata.stomp
-                    && (!sizeof...(Component) || ... || (pdata.runtime_type == to_integer(type<Component>())))
-                    && ((pdata.runtime_type != to_integer(type<Exclude>())) && ...)
-                    && pdata.pool->has(src))
-                {
-                    std::for_each(first, last, [this, &pdata, src](const auto entity) {
-                        pdata.stomp(*pdata.pool, src, *this, entity);
-                    });
-                }
-            }
-        }
+
+}
+
+
+#endif // ENTT_ENTITY_ACTOR_HPP
+
+// #include "entity/archetype.hpp"
+#ifndef ENTT_ENTITY_ARCHETYPE_HPP
+#define ENTT_ENTITY_ARCHETYPE_HPP
+
+
+#include <map>
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+// #include "../config/config.h"
+
+// #include "../core/family.hpp"
+
+// #include "entity.hpp"
+
+// #include "fwd.hpp"
+
+
+
+namespace entt {
+
+
+    /**
+     * @brief View of an archetype registry.
+     *
+     * Iterates the tables that contain at least the given components. Within a
+     * table, components are laid out in contiguous columns and are visited in
+     * order, without any lookup.
+     *
+     * @warning
+     * Lifetime of a view must overcome the one of the registry that generated it.
+     * In any other case, attempting to use a view results in undefined
+     * behavior.<br/>
+     * Assigning or removing components and creating or destroying entities while
+     * iterating a view results in undefined behavior.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     * @tparam Component Types of components iterated by the view.
+     */
+    template<typename Entity, typename... Component>
+    class basic_archetype_view {
+        /*! @brief An archetype registry is allowed to create views. */
+        friend class basic_archetype_registry<Entity>;
+
+        using registry_type = basic_archetype_registry<Entity>;
+
+        basic_archetype_view(registry_type* ref, const std::vector<std::size_t>* matches) ENTT_NOEXCEPT
+            : reg{ ref }, tables{ matches }
+        {}
+
+    public:
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
 
         /**
-         * @brief Returns a temporary object to use to create snapshots.
-         *
-         * A snapshot is either a full or a partial dump of a registry.<br/>
-         * It can be used to save and restore its internal state or to keep two or
-         * more instances of this class in sync, as an example in a client-server
-         * architecture.
-         *
-         * @return A temporary object to use to take snasphosts.
+         * @brief Returns the number of entities that have the given components.
+         * @return Number of entities that have the given components.
          */
-        entt::basic_snapshot<Entity> snapshot() const ENTT_NOEXCEPT {
-            using follow_fn_type = entity_type(const basic_registry&, const entity_type);
-
-            const auto head = to_integer(destroyed);
-            const entity_type seed = (destroyed == null) ? destroyed : entity_type{ head | (to_integer(entities[head]) & (traits_type::version_mask << traits_type::entity_shift)) };
+        size_type size() const ENTT_NOEXCEPT {
+            size_type sz{};
 
-            follow_fn_type* follow = [](const basic_registry& reg, const entity_type entity) -> entity_type {
-                const auto& others = reg.entities;
-                const auto entt = to_integer(entity) & traits_type::entity_mask;
-                const auto curr = to_integer(others[entt]) & traits_type::entity_mask;
-                return entity_type{ curr | (to_integer(others[curr]) & (traits_type::version_mask << traits_type::entity_shift)) };
-            };
+            for (const auto pos : *tables) {
+                sz += reg->tables[pos].entities.size();
+            }
 
-            return { this, seed, follow };
+            return sz;
         }
 
         /**
-         * @brief Returns a temporary object to use to load snapshots.
+         * @brief Iterates entities and components and applies the given function
+         * object to them.
          *
-         * A snapshot is either a full or a partial dump of a registry.<br/>
-         * It can be used to save and restore its internal state or to keep two or
-         * more instances of this class in sync, as an example in a client-server
-         * architecture.
+         * The function object is invoked for each entity. It is provided with the
+         * entity itself and a set of references to its components. The signature
+         * of the function must be equivalent to one of the following forms:
          *
-         * @note
-         * The loader returned by this function requires that the registry be empty.
-         * In case it isn't, all the data will be automatically deleted before to
-         * return.
+         * @code{.cpp}
+         * void(const entity_type, Component &...);
+         * void(Component &...);
+         * @endcode
          *
-         * @return A temporary object to use to load snasphosts.
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
          */
-        basic_snapshot_loader<Entity> loader() ENTT_NOEXCEPT {
-            using force_fn_type = void(basic_registry&, const entity_type, const bool);
+        template<typename Func>
+        void each(Func func) const {
+            for (const auto pos : *tables) {
+                auto& table = reg->tables[pos];
+                const auto* entities = table.entities.data();
+                const auto sz = table.entities.size();
+                auto data = std::make_tuple(reg->template column<Component>(table)...);
+
+                for (size_type row{}; row < sz; ++row) {
+                    if constexpr (std::is_invocable_v<Func, entity_type, Component&...>) {
+                        func(entities[row], std::get<Component*>(data)[row]...);
+                    }
+                    else {
+                        func(std::get<Component*>(data)[row]...);
+                    }
+                }
+            }
+        }
 
-            force_fn_type* force = [](basic_registry& reg, const entity_type entity, const bool discard) {
-                const auto entt = to_integer(entity) & traits_type::entity_mask;
-                auto& others = reg.entities;
+    private:
+        registry_type* reg;
+        const std::vector<std::size_t>* tables;
+    };
 
-                if (!(entt < others.size())) {
-                    auto curr = others.size();
-                    others.resize(entt + 1);
 
-                    std::generate(others.data() + curr, others.data() + entt, [curr]() mutable {
-                        return entity_type(curr++);
-                    });
-                }
+    /**
+     * @brief Alternative registry that stores components in archetype tables.
+     *
+     * Entities that own exactly the same set of components share a table, where
+     * each type of component has its own contiguous column. Iterating a view is
+     * therefore linear in all the columns involved, with no sparse lookups.<br/>
+     * The price is paid when components are assigned or removed: the entity and
+     * all its components move to another table. Transitions between tables are
+     * cached on both ends, so that a move doesn't require to look up the target
+     * table, and so are the tables that match each query.
+     *
+     * Prefer the sparse set registry when components come and go often, this one
+     * for wide queries over entities with stable sets of components.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     */
+    template<typename Entity>
+    class basic_archetype_registry {
+        template<typename, typename...>
+        friend class basic_archetype_view;
 
-                others[entt] = entity;
+        using traits_type = entt_traits<std::underlying_type_t<Entity>>;
+        using component_family = family<struct internal_archetype_registry_component_family>;
+        using signature_type = std::vector<ENTT_ID_TYPE>;
 
-                if (discard) {
-                    reg.destroy(entity);
-                    const auto version = to_integer(entity) & (traits_type::version_mask << traits_type::entity_shift);
-                    others[entt] = entity_type{ (to_integer(others[entt]) & traits_type::entity_mask) | version };
-                }
-            };
+        static constexpr auto npos = ~std::size_t{};
 
-            reset();
-            entities.clear();
-            destroyed = null;
+        struct basic_column {
+            virtual ~basic_column() = default;
+            virtual std::unique_ptr<basic_column> make() const = 0;
+            virtual void move_back(basic_column&, const std::size_t) = 0;
+            virtual void swap_and_pop(const std::size_t) = 0;
+        };
 
-            return { this, force };
-        }
+        template<typename Component>
+        struct column_type final: basic_column {
+            std::unique_ptr<basic_column> make() const override {
+                return std::make_unique<column_type>();
+            }
 
-        /**
-         * @brief Binds an object to the context of the registry.
-         *
-         * If the value already exists it is overwritten, otherwise a new instance
-         * of the given type is created and initialized with the arguments provided.
-         *
-         * @tparam Type Type of object to set.
-         * @tparam Args Types of arguments to use to construct the object.
-         * @param args Parameters to use to initialize the value.
-         * @return A reference to the newly created object.
-         */
-        template<typename Type, typename... Args>
-        Type& set(Args&& ... args) {
-            const auto ctype = runtime_type<Type, context_family>();
-            auto it = std::find_if(vars.begin(), vars.end(), [ctype](const auto& candidate) {
-                return candidate.runtime_type == ctype;
-            });
+            void move_back(basic_column& other, const std::size_t pos) override {
+                static_cast<column_type&>(other).instances.push_back(std::move(instances[pos]));
+            }
 
-            if (it == vars.cend()) {
-                vars.push_back({
-                    decltype(ctx_variable::value){new Type{std::forward<Args>(args)...}, [](void* ptr) { delete static_cast<Type*>(ptr); }},
-                    ctype
-                    });
+            void swap_and_pop(const std::size_t pos) override {
+                if (pos + 1 != instances.size()) {
+                    instances[pos] = std::move(instances.back());
+                }
 
-                it = std::prev(vars.end());
+                instances.pop_back();
             }
-            else {
-                it->value.reset(new Type{ std::forward<Args>(args)... });
+
+            std::vector<Component> instances;
+        };
+
+        struct table_type {
+            std::size_t index(const ENTT_ID_TYPE ctype) const ENTT_NOEXCEPT {
+                const auto it = std::lower_bound(types.cbegin(), types.cend(), ctype);
+                return (it != types.cend() && *it == ctype) ? std::size_t(it - types.cbegin()) : npos;
             }
 
-            return *static_cast<Type*>(it->value.get());
-        }
+            signature_type types;
+            std::vector<std::unique_ptr<basic_column>> columns;
+            std::vector<Entity> entities;
+            std::unordered_map<ENTT_ID_TYPE, std::size_t> add;
+            std::unordered_map<ENTT_ID_TYPE, std::size_t> remove;
+        };
 
-        /**
-         * @brief Unsets a context variable if it exists.
-         * @tparam Type Type of object to set.
-         */
-        template<typename Type>
-        void unset() {
-            vars.erase(std::remove_if(vars.begin(), vars.end(), [](auto& var) {
-                return var.runtime_type == runtime_type<Type, context_family>();
-            }), vars.end());
+        struct record_type {
+            std::size_t table;
+            std::size_t row;
+        };
+
+        struct query_type {
+            std::vector<std::size_t> tables;
+            std::size_t checked;
+        };
+
+        template<typename Component>
+        static ENTT_ID_TYPE type() ENTT_NOEXCEPT {
+            return component_family::template type<Component>;
         }
 
-        /**
-         * @brief Binds an object to the context of the registry.
-         *
-         * In case the context doesn't contain the given object, the parameters
-         * provided are used to construct it.
-         *
-         * @tparam Type Type of object to set.
-         * @tparam Args Types of arguments to use to construct the object.
-         * @param args Parameters to use to initialize the object.
-         * @return Reference to the object.
-         */
-        template<typename Type, typename... Args>
-        Type& ctx_or_set(Args&& ... args) {
-            auto* type = try_ctx<Type>();
-            return type ? *type : set<Type>(std::forward<Args>(args)...);
+        template<typename Component>
+        Component* column(table_type& table) const ENTT_NOEXCEPT {
+            return static_cast<column_type<Component>&>(*table.columns[table.index(type<Component>())]).instances.data();
         }
 
-        /**
-         * @brief Returns a pointer to an object in the context of the registry.
-         * @tparam Type Type of object to get.
-         * @return A pointer to the object if it exists in the context of the
-         * registry, a null pointer otherwise.
-         */
-        template<typename Type>
-        const Type* try_ctx() const ENTT_NOEXCEPT {
-            const auto it = std::find_if(vars.begin(), vars.end(), [](const auto& var) {
-                return var.runtime_type == runtime_type<Type, context_family>();
-            });
+        std::size_t assure(signature_type types, const std::size_t from, std::unique_ptr<basic_column> extra) {
+            if (const auto it = lookup.find(types); it != lookup.cend()) {
+                return it->second;
+            }
 
-            return (it == vars.cend()) ? nullptr : static_cast<const Type*>(it->value.get());
-        }
+            table_type table{};
 
-        /*! @copydoc try_ctx */
-        template<typename Type>
-        Type* try_ctx() ENTT_NOEXCEPT {
-            return const_cast<Type*>(std::as_const(*this).template try_ctx<Type>());
-        }
+            for (const auto ctype : types) {
+                const auto pos = tables[from].index(ctype);
+                table.columns.push_back(pos == npos ? std::move(extra) : tables[from].columns[pos]->make());
+            }
 
-        /**
-         * @brief Returns a reference to an object in the context of the registry.
-         *
-         * @warning
-         * Attempting to get a context variable that doesn't exist results in
-         * undefined behavior.<br/>
-         * An assertion will abort the execution at runtime in debug mode in case of
-         * invalid requests.
-         *
-         * @tparam Type Type of object to get.
-         * @return A valid reference to the object in the context of the registry.
-         */
-        template<typename Type>
-        const Type& ctx() const ENTT_NOEXCEPT {
-            const auto* instance = try_ctx<Type>();
-            ENTT_ASSERT(instance);
-            return *instance;
+            table.types = types;
+            tables.push_back(std::move(table));
+            lookup.emplace(std::move(types), tables.size() - 1);
+            return tables.size() - 1;
         }
 
-        /*! @copydoc ctx */
-        template<typename Type>
-        Type& ctx() ENTT_NOEXCEPT {
-            return const_cast<Type&>(std::as_const(*this).template ctx<Type>());
-        }
+        template<typename Component>
+        std::size_t with(const std::size_t from) {
+            const auto ctype = type<Component>();
 
-    private:
-        std::size_t skip_family_pools{};
-        std::vector<pool_data> pools{};
-        std::vector<group_data> groups{};
-        std::vector<ctx_variable> vars{};
-        std::vector<entity_type> entities{};
-        entity_type destroyed{ null };
-    };
+            if (const auto it = tables[from].add.find(ctype); it != tables[from].add.cend()) {
+                return it->second;
+            }
 
+            auto types = tables[from].types;
+            types.insert(std::upper_bound(types.begin(), types.end(), ctype), ctype);
+            const auto to = assure(std::move(types), from, std::make_unique<column_type<Component>>());
 
-}
+            tables[from].add.emplace(ctype, to);
+            tables[to].remove.emplace(ctype, from);
+            return to;
+        }
 
+        template<typename Component>
+        std::size_t without(const std::size_t from) {
+            const auto ctype = type<Component>();
 
-#endif // ENTT_ENTITY_REGISTRY_HPP
+            if (const auto it = tables[from].remove.find(ctype); it != tables[from].remove.cend()) {
+                return it->second;
+            }
 
-// #include "entity.hpp"
+            auto types = tables[from].types;
+            types.erase(std::lower_bound(types.begin(), types.end(), ctype));
+            const auto to = assure(std::move(types), from, nullptr);
 
-// #include "fwd.hpp"
+            tables[from].remove.emplace(ctype, to);
+            tables[to].add.emplace(ctype, from);
+            return to;
+        }
 
+        void erase(const std::size_t idx) {
+            auto& record = records[idx];
+            auto& table = tables[record.table];
 
+            for (auto&& column : table.columns) {
+                column->swap_and_pop(record.row);
+            }
 
-namespace entt {
+            const auto last = table.entities.back();
+            table.entities[record.row] = last;
+            table.entities.pop_back();
+            records[std::size_t(to_integer(last) & traits_type::entity_mask)].row = record.row;
+        }
 
+        // components the target table doesn't have are dropped, those it has and the source doesn't are up to the caller
+        void move(const Entity entity, const std::size_t to) {
+            const auto idx = std::size_t(to_integer(entity) & traits_type::entity_mask);
+            auto& src = tables[records[idx].table];
+            auto& dst = tables[to];
 
-    /**
-     * @brief Dedicated to those who aren't confident with the
-     * entity-component-system architecture.
-     *
-     * Tiny wrapper around a registry, for all those users that aren't confident
-     * with entity-component-system architecture and prefer to iterate objects
-     * directly.
-     *
-     * @tparam Entity A valid entity type (see entt_traits for more details).
-     */
-    template<typename Entity>
-    struct basic_actor {
-        /*! @brief Type of registry used internally. */
-        using registry_type = basic_registry<Entity>;
+            for (std::size_t pos{}, sz = src.types.size(); pos < sz; ++pos) {
+                if (const auto other = dst.index(src.types[pos]); other != npos) {
+                    src.columns[pos]->move_back(*dst.columns[other], records[idx].row);
+                }
+            }
+
+            erase(idx);
+            dst.entities.push_back(entity);
+            records[idx] = { to, dst.entities.size() - 1 };
+        }
+
+    public:
         /*! @brief Underlying entity identifier. */
         using entity_type = Entity;
+        /*! @brief Underlying version type. */
+        using version_type = typename traits_type::version_type;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
 
-        basic_actor() ENTT_NOEXCEPT
-            : entt{ entt::null }, reg{ nullptr }
+        /*! @brief Default constructor. */
+        basic_archetype_registry()
+            : tables(1), lookup{ { signature_type{}, 0u } }
         {}
 
-        /**
-         * @brief Constructs an actor from a given registry.
-         * @param ref An instance of the registry class.
-         */
-        explicit basic_actor(registry_type& ref)
-            : entt{ ref.create() }, reg{ &ref }
-        {}
+        /*! @brief Default move constructor. */
+        basic_archetype_registry(basic_archetype_registry&&) = default;
+
+        /*! @brief Default move assignment operator. @return This registry. */
+        basic_archetype_registry& operator=(basic_archetype_registry&&) = default;
 
         /**
-         * @brief Constructs an actor from a given entity.
-         * @param entity A valid entity identifier.
-         * @param ref An instance of the registry class.
+         * @brief Returns the number of tables created so far.
+         * @return Number of tables created so far.
          */
-        explicit basic_actor(entity_type entity, registry_type& ref)
-            : entt{ entity }, reg{ &ref }
-        {
-            ENTT_ASSERT(ref.valid(entity));
+        size_type tables_size() const ENTT_NOEXCEPT {
+            return tables.size();
         }
 
-        /*! @brief Default destructor. */
-        virtual ~basic_actor() {
-            if (*this) {
-                reg->destroy(entt);
-            }
+        /**
+         * @brief Checks if an entity identifier refers to a valid entity.
+         * @param entity An entity identifier, either valid or not.
+         * @return True if the identifier is valid, false otherwise.
+         */
+        bool valid(const entity_type entity) const ENTT_NOEXCEPT {
+            const auto idx = std::size_t(to_integer(entity) & traits_type::entity_mask);
+            return (idx < entities.size() && entities[idx] == entity && records[idx].table != npos);
         }
 
         /**
-         * @brief Move constructor.
-         *
-         * After actor move construction, instances that have been moved from are
-         * placed in a valid but unspecified state. It's highly discouraged to
-         * continue using them.
-         *
-         * @param other The instance to move from.
+         * @brief Creates a new entity with no components.
+         * @return A valid entity identifier.
          */
-        basic_actor(basic_actor&& other)
-            : entt{ other.entt }, reg{ other.reg }
-        {
-            other.entt = null;
+        entity_type create() {
+            entity_type entity;
+
+            if (available.empty()) {
+                entity = entities.emplace_back(entity_type(entities.size()));
+                records.emplace_back();
+                // traits_type::entity_mask is reserved to allow for null identifiers
+                ENTT_ASSERT(to_integer(entity) < traits_type::entity_mask);
+            }
+            else {
+                entity = entities[available.back()];
+                available.pop_back();
+            }
+
+            tables.front().entities.push_back(entity);
+            records[std::size_t(to_integer(entity) & traits_type::entity_mask)] = { 0u, tables.front().entities.size() - 1 };
+            return entity;
         }
 
         /**
-         * @brief Move assignment operator.
+         * @brief Destroys an entity and its components.
          *
-         * After actor move assignment, instances that have been moved from are
-         * placed in a valid but unspecified state. It's highly discouraged to
-         * continue using them.
+         * @warning
+         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity.
          *
-         * @param other The instance to move from.
-         * @return This actor.
+         * @param entity A valid entity identifier.
          */
-        basic_actor& operator=(basic_actor&& other) {
-            if (this != &other) {
-                auto tmp{ std::move(other) };
-                std::swap(reg, tmp.reg);
-                std::swap(entt, tmp.entt);
-            }
+        void destroy(const entity_type entity) {
+            ENTT_ASSERT(valid(entity));
+            const auto idx = std::size_t(to_integer(entity) & traits_type::entity_mask);
+            const auto version = (to_integer(entity) >> traits_type::entity_shift) + 1;
 
-            return *this;
+            erase(idx);
+            entities[idx] = entity_type(idx | (typename traits_type::entity_type(version) << traits_type::entity_shift));
+            records[idx].table = npos;
+            available.push_back(idx);
         }
 
         /**
-         * @brief Assigns the given component to an actor.
+         * @brief Assigns the given component to an entity.
          *
-         * A new instance of the given component is created and initialized with the
-         * arguments provided (the component must have a proper constructor or be of
-         * aggregate type). Then the component is assigned to the actor.<br/>
-         * In case the actor already has a component of the given type, it's
-         * replaced with the new one.
+         * The entity moves to the table of the entities that have the same
+         * components it had plus the given one.
          *
-         * @tparam Component Type of the component to create.
+         * @warning
+         * Attempting to use an invalid entity or to assign a component to an
+         * entity that already owns it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity or if the entity already owns an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to create.
          * @tparam Args Types of arguments to use to construct the component.
+         * @param entity A valid entity identifier.
          * @param args Parameters to use to initialize the component.
          * @return A reference to the newly created component.
          */
         template<typename Component, typename... Args>
-        decltype(auto) assign(Args&& ... args) {
-            return reg->template assign_or_replace<Component>(entt, std::forward<Args>(args)...);
-        }
-
-        /**
-         * @brief Removes the given component from an actor.
-         * @tparam Component Type of the component to remove.
-         */
-        template<typename Component>
-        void remove() {
-            reg->template remove<Component>(entt);
-        }
-
-        /**
-         * @brief Checks if an actor has the given components.
-         * @tparam Component Components for which to perform the check.
-         * @return True if the actor has all the components, false otherwise.
-         */
-        template<typename... Component>
-        bool has() const ENTT_NOEXCEPT {
-            return (reg->template has<Component>(entt) && ...);
-        }
+        Component& assign(const entity_type entity, Args&& ... args) {
+            ENTT_ASSERT(valid(entity));
+            ENTT_ASSERT(!has<Component>(entity));
+            const auto to = with<Component>(records[std::size_t(to_integer(entity) & traits_type::entity_mask)].table);
+            move(entity, to);
 
-        /**
-         * @brief Returns references to the given components for an actor.
-         * @tparam Component Types of components to get.
-         * @return References to the components owned by the actor.
-         */
-        template<typename... Component>
-        decltype(auto) get() const ENTT_NOEXCEPT {
-            return std::as_const(*reg).template get<Component...>(entt);
-        }
+            auto& instances = static_cast<column_type<Component>&>(*tables[to].columns[tables[to].index(type<Component>())]).instances;
 
-        /*! @copydoc get */
-        template<typename... Component>
-        decltype(auto) get() ENTT_NOEXCEPT {
-            return reg->template get<Component...>(entt);
+            if constexpr (std::is_aggregate_v<Component>) {
+                return instances.emplace_back(Component{ std::forward<Args>(args)... });
+            }
+            else {
+                return instances.emplace_back(std::forward<Args>(args)...);
+            }
         }
 
         /**
-         * @brief Returns pointers to the given components for an actor.
-         * @tparam Component Types of components to get.
-         * @return Pointers to the components owned by the actor.
+         * @brief Removes the given component from an entity.
+         *
+         * @warning
+         * Attempting to use an invalid entity or to remove a component from an
+         * entity that doesn't own it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity or if the entity doesn't own an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to remove.
+         * @param entity A valid entity identifier.
          */
-        template<typename... Component>
-        auto try_get() const ENTT_NOEXCEPT {
-            return std::as_const(*reg).template try_get<Component...>(entt);
-        }
-
-        /*! @copydoc try_get */
-        template<typename... Component>
-        auto try_get() ENTT_NOEXCEPT {
-            return reg->template try_get<Component...>(entt);
+        template<typename Component>
+        void remove(const entity_type entity) {
+            ENTT_ASSERT(valid(entity));
+            ENTT_ASSERT(has<Component>(entity));
+            move(entity, without<Component>(records[std::size_t(to_integer(entity) & traits_type::entity_mask)].table));
         }
 
         /**
-         * @brief Returns a reference to the underlying registry.
-         * @return A reference to the underlying registry.
+         * @brief Checks if an entity has all the given components.
+         *
+         * @warning
+         * Attempting to use an invalid entity results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity.
+         *
+         * @tparam Component Components for which to perform the check.
+         * @param entity A valid entity identifier.
+         * @return True if the entity has all the components, false otherwise.
          */
-        const registry_type& backend() const ENTT_NOEXCEPT {
-            return *reg;
-        }
-
-        /*! @copydoc backend */
-        registry_type& backend() ENTT_NOEXCEPT {
-            return const_cast<registry_type&>(std::as_const(*this).backend());
+        template<typename... Component>
+        bool has(const entity_type entity) const ENTT_NOEXCEPT {
+            ENTT_ASSERT(valid(entity));
+            const auto& table = tables[records[std::size_t(to_integer(entity) & traits_type::entity_mask)].table];
+            return ((table.index(type<Component>()) != npos) && ...);
         }
 
         /**
-         * @brief Returns the entity associated with an actor.
-         * @return The entity associated with the actor.
+         * @brief Returns a reference to the given component for an entity.
+         *
+         * @warning
+         * Attempting to use an invalid entity or to get a component from an entity
+         * that doesn't own it results in undefined behavior.<br/>
+         * An assertion will abort the execution at runtime in debug mode in case of
+         * invalid entity or if the entity doesn't own an instance of the given
+         * component.
+         *
+         * @tparam Component Type of component to get.
+         * @param entity A valid entity identifier.
+         * @return A reference to the component owned by the entity.
          */
-        entity_type entity() const ENTT_NOEXCEPT {
-            return entt;
+        template<typename Component>
+        Component& get(const entity_type entity) {
+            ENTT_ASSERT(valid(entity));
+            ENTT_ASSERT(has<Component>(entity));
+            const auto& record = records[std::size_t(to_integer(entity) & traits_type::entity_mask)];
+            return column<Component>(tables[record.table])[record.row];
         }
 
         /**
-         * @brief Checks if an actor refers to a valid entity or not.
-         * @return True if the actor refers to a valid entity, false otherwise.
+         * @brief Returns a view for the given components.
+         *
+         * Tables that match the query are cached and the cache is brought up to
+         * date with the tables created since the previous call.
+         *
+         * @tparam Component Type of components used to construct the view.
+         * @return A newly created view.
          */
-        explicit operator bool() const ENTT_NOEXCEPT {
-            return reg && reg->valid(entt);
+        template<typename... Component>
+        basic_archetype_view<Entity, Component...> view() {
+            signature_type types{ type<Component>()... };
+            std::sort(types.begin(), types.end());
+            auto& query = queries[types];
+
+            for (; query.checked < tables.size(); ++query.checked) {
+                const auto& candidate = tables[query.checked].types;
+
+                if (std::includes(candidate.cbegin(), candidate.cend(), types.cbegin(), types.cend())) {
+                    query.tables.push_back(query.checked);
+                }
+            }
+
+            return { this, &query.tables };
         }
 
     private:
-        entity_type entt;
-        registry_type* reg;
+        std::vector<table_type> tables;
+        std::map<signature_type, std::size_t> lookup;
+        std::map<signature_type, query_type> queries{};
+        std::vector<entity_type> entities{};
+        std::vector<record_type> records{};
+        std::vector<std::size_t> available{};
     };
 
 
 }
 
 
-#endif // ENTT_ENTITY_ACTOR_HPP
+#endif // ENTT_ENTITY_ARCHETYPE_HPP
 
 // #include "entity/entity.hpp"
 
@@ -9364,247 +14308,544 @@ namespace entt {
      * @tparam Entity A valid entity type (see entt_traits for more details).
      */
     template<typename Entity>
-    as_group(basic_registry<Entity>&) ENTT_NOEXCEPT->as_group<false, Entity>;
-
-
-    /*! @copydoc as_group */
-    template<typename Entity>
-    as_group(const basic_registry<Entity>&) ENTT_NOEXCEPT->as_group<true, Entity>;
+    as_group(basic_registry<Entity>&) ENTT_NOEXCEPT->as_group<false, Entity>;
+
+
+    /*! @copydoc as_group */
+    template<typename Entity>
+    as_group(const basic_registry<Entity>&) ENTT_NOEXCEPT->as_group<true, Entity>;
+
+
+    /**
+     * @brief Alias template to ease the assignment of tags to entities.
+     *
+     * If used in combination with hashed strings, it simplifies the assignment of
+     * tags to entities and the use of tags in general where a type would be
+     * required otherwise.<br/>
+     * As an example and where the user defined literal for hashed strings hasn't
+     * been changed:
+     * @code{.cpp}
+     * entt::registry registry;
+     * registry.assign<entt::tag<"enemy"_hs>>(entity);
+     * @endcode
+     *
+     * @note
+     * Tags are empty components and therefore candidates for the empty component
+     * optimization.
+     *
+     * @tparam Value The numeric representation of an instance of hashed string.
+     */
+    template<ENTT_ID_TYPE Value>
+    using tag = std::integral_constant<ENTT_ID_TYPE, Value>;
+
+
+}
+
+
+#endif // ENTT_ENTITY_HELPER_HPP
+
+// #include "entity/observer.hpp"
+#ifndef ENTT_ENTITY_OBSERVER_HPP
+#define ENTT_ENTITY_OBSERVER_HPP
+
+
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+// #include "../config/config.h"
+
+// #include "../core/type_traits.hpp"
+
+// #include "registry.hpp"
+
+// #include "storage.hpp"
+
+// #include "entity.hpp"
+
+// #include "fwd.hpp"
+
+
+
+namespace entt {
+
+
+    /*! @brief Grouping matcher. */
+    template<typename...>
+    struct matcher {};
+
+
+    /**
+     * @brief Collector.
+     *
+     * Primary template isn't defined on purpose. All the specializations give a
+     * compile-time error, but for a few reasonable cases.
+     */
+    template<typename...>
+    struct basic_collector;
+
+
+    /**
+     * @brief Collector.
+     *
+     * A collector contains a set of rules (literally, matchers) to use to track
+     * entities.<br/>
+     * Its main purpose is to generate a descriptor that allows an observer to know
+     * how to connect to a registry.
+     */
+    template<>
+    struct basic_collector<> {
+        /**
+         * @brief Adds a grouping matcher to the collector.
+         * @tparam AllOf Types of components tracked by the matcher.
+         * @tparam NoneOf Types of components used to filter out entities.
+         * @return The updated collector.
+         */
+        template<typename... AllOf, typename... NoneOf>
+        static constexpr auto group(exclude_t<NoneOf...> = {}) ENTT_NOEXCEPT {
+            return basic_collector<matcher<matcher<type_list<>, type_list<>>, type_list<NoneOf...>, type_list<AllOf...>>>{};
+        }
+
+        /**
+         * @brief Adds an observing matcher to the collector.
+         * @tparam AnyOf Type of component for which changes should be detected.
+         * @return The updated collector.
+         */
+        template<typename AnyOf>
+        static constexpr auto replace() ENTT_NOEXCEPT {
+            return basic_collector<matcher<matcher<type_list<>, type_list<>>, AnyOf>>{};
+        }
+    };
+
+    /**
+     * @brief Collector.
+     * @copydetails basic_collector<>
+     * @tparam AnyOf Types of components for which changes should be detected.
+     * @tparam Matcher Types of grouping matchers.
+     */
+    template<typename... Reject, typename... Require, typename... Rule, typename... Other>
+    struct basic_collector<matcher<matcher<type_list<Reject...>, type_list<Require...>>, Rule...>, Other...> {
+        /**
+         * @brief Adds a grouping matcher to the collector.
+         * @tparam AllOf Types of components tracked by the matcher.
+         * @tparam NoneOf Types of components used to filter out entities.
+         * @return The updated collector.
+         */
+        template<typename... AllOf, typename... NoneOf>
+        static constexpr auto group(exclude_t<NoneOf...> = {}) ENTT_NOEXCEPT {
+            using first = matcher<matcher<type_list<Reject...>, type_list<Require...>>, Rule...>;
+            return basic_collector<first, Other..., matcher<matcher<type_list<>, type_list<>>, type_list<NoneOf...>, type_list<AllOf...>>>{};
+        }
+
+        /**
+         * @brief Adds an observing matcher to the collector.
+         * @tparam AnyOf Type of component for which changes should be detected.
+         * @return The updated collector.
+         */
+        template<typename AnyOf>
+        static constexpr auto replace() ENTT_NOEXCEPT {
+            using first = matcher<matcher<type_list<Reject...>, type_list<Require...>>, Rule...>;
+            return basic_collector<first, Other..., matcher<matcher<type_list<>, type_list<>>, AnyOf>>{};
+        }
+
+        /**
+         * @brief Updates the filter of the last added matcher.
+         * @tparam AllOf Types of components required by the matcher.
+         * @tparam NoneOf Types of components used to filter out entities.
+         * @return The updated collector.
+         */
+        template<typename... AllOf, typename... NoneOf>
+        static constexpr auto where(exclude_t<NoneOf...> = {}) ENTT_NOEXCEPT {
+            return basic_collector<matcher<matcher<type_list<Reject..., NoneOf...>, type_list<Require..., AllOf...>>, Rule...>, Other...>{};
+        }
+    };
+
+
+    /*! @brief Variable template used to ease the definition of collectors. */
+    constexpr basic_collector<> collector{};
+
+
+    /**
+     * @brief Observer.
+     *
+     * An observer returns all the entities and only the entities that fit the
+     * requirements of at least one matcher. Moreover, it's guaranteed that the
+     * entity list is tightly packed in memory for fast iterations.<br/>
+     * In general, observers don't stay true to the order of any set of components.
+     *
+     * Observers work mainly with two types of matchers, provided through a
+     * collector:
+     *
+     * * Observing matcher: an observer will return at least all the living entities
+     *   for which one or more of the given components have been explicitly
+     *   replaced and not yet destroyed.
+     * * Grouping matcher: an observer will return at least all the living entities
+     *   that would have entered the given group if it existed and that would have
+     *   not yet left it.
+     *
+     * If an entity respects the requirements of multiple matchers, it will be
+     * returned once and only once by the observer in any case.
+     *
+     * Matchers support also filtering by means of a _where_ clause that accepts
+     * both a list of types and an exclusion list.<br/>
+     * Whenever a matcher finds that an entity matches its requirements, the
+     * condition of the filter is verified before to register the entity itself.
+     * Moreover, a registered entity isn't returned by the observer if the condition
+     * set by the filter is broken in the meantime.
+     *
+     * @b Important
+     *
+     * Iterators aren't invalidated if:
+     *
+     * * New instances of the given components are created and assigned to entities.
+     * * The entity currently pointed is modified (as an example, if one of the
+     *   given components is removed from the entity to which the iterator points).
+     * * The entity currently pointed is destroyed.
+     *
+     * In all the other cases, modifying the pools of the given components in any
+     * way invalidates all the iterators and using them results in undefined
+     * behavior.
+     *
+     * @warning
+     * Lifetime of an observer doesn't necessarily have to overcome the one of the
+     * registry to which it is connected. However, the observer must be disconnected
+     * from the registry before being destroyed to avoid crashes due to dangling
+     * pointers.
+     *
+     * @tparam Entity A valid entity type (see entt_traits for more details).
+     */
+    template<typename Entity>
+    class basic_observer {
+        using payload_type = std::uint32_t;
 
+        template<typename>
+        struct matcher_handler;
 
-    /**
-     * @brief Alias template to ease the assignment of tags to entities.
-     *
-     * If used in combination with hashed strings, it simplifies the assignment of
-     * tags to entities and the use of tags in general where a type would be
-     * required otherwise.<br/>
-     * As an example and where the user defined literal for hashed strings hasn't
-     * been changed:
-     * @code{.cpp}
-     * entt::registry registry;
-     * registry.assign<entt::tag<"enemy"_hs>>(entity);
-     * @endcode
-     *
-     * @note
-     * Tags are empty components and therefore candidates for the empty component
-     * optimization.
-     *
-     * @tparam Value The numeric representation of an instance of hashed string.
-     */
-    template<ENTT_ID_TYPE Value>
-    using tag = std::integral_constant<ENTT_ID_TYPE, Value>;
+        template<typename... Reject, typename... Require, typename AnyOf>
+        struct matcher_handler<matcher<matcher<type_list<Reject...>, type_list<Require...>>, AnyOf>> {
+            template<std::size_t Index>
+            static void maybe_valid_if(basic_observer& obs, const Entity entt, const basic_registry<Entity>& reg) {
+                if (reg.template has<Require...>(entt) && !(reg.template has<Reject>(entt) || ...)) {
+                    auto* comp = obs.view.try_get(entt);
+                    (comp ? *comp : obs.view.construct(entt)) |= (1 << Index);
+                }
+            }
 
+            template<std::size_t Index>
+            static void discard_if(basic_observer& obs, const Entity entt) {
+                if (auto * value = obs.view.try_get(entt); value && !(*value &= (~(1 << Index)))) {
+                    obs.view.destroy(entt);
+                }
+            }
 
-}
+            template<std::size_t Index>
+            static void connect(basic_observer& obs, basic_registry<Entity>& reg) {
+                (reg.template on_destroy<Require>().template connect<&discard_if<Index>>(obs), ...);
+                (reg.template on_construct<Reject>().template connect<&discard_if<Index>>(obs), ...);
+                reg.template on_replace<AnyOf>().template connect<&maybe_valid_if<Index>>(obs);
+                reg.template on_destroy<AnyOf>().template connect<&discard_if<Index>>(obs);
+            }
 
+            static void disconnect(basic_observer& obs, basic_registry<Entity>& reg) {
+                (reg.template on_destroy<Require>().disconnect(obs), ...);
+                (reg.template on_construct<Reject>().disconnect(obs), ...);
+                reg.template on_replace<AnyOf>().disconnect(obs);
+                reg.template on_destroy<AnyOf>().disconnect(obs);
+            }
+        };
 
-#endif // ENTT_ENTITY_HELPER_HPP
+        template<typename... Reject, typename... Require, typename... NoneOf, typename... AllOf>
+        struct matcher_handler<matcher<matcher<type_list<Reject...>, type_list<Require...>>, type_list<NoneOf...>, type_list<AllOf...>>> {
+            template<std::size_t Index>
+            static void maybe_valid_if(basic_observer& obs, const Entity entt, const basic_registry<Entity>& reg) {
+                if (reg.template has<AllOf...>(entt) && !(reg.template has<NoneOf>(entt) || ...)
+                    && reg.template has<Require...>(entt) && !(reg.template has<Reject>(entt) || ...))
+                {
+                    auto* comp = obs.view.try_get(entt);
+                    (comp ? *comp : obs.view.construct(entt)) |= (1 << Index);
+                }
+            }
 
-// #include "entity/observer.hpp"
-#ifndef ENTT_ENTITY_OBSERVER_HPP
-#define ENTT_ENTITY_OBSERVER_HPP
+            template<std::size_t Index>
+            static void discard_if(basic_observer& obs, const Entity entt) {
+                if (auto * value = obs.view.try_get(entt); value && !(*value &= (~(1 << Index)))) {
+                    obs.view.destroy(entt);
+                }
+            }
 
+            template<std::size_t Index>
+            static void connect(basic_observer& obs, basic_registry<Entity>& reg) {
+                (reg.template on_destroy<Require>().template connect<&discard_if<Index>>(obs), ...);
+                (reg.template on_construct<Reject>().template connect<&discard_if<Index>>(obs), ...);
+                (reg.template on_construct<AllOf>().template connect<&maybe_valid_if<Index>>(obs), ...);
+                (reg.template on_destroy<NoneOf>().template connect<&maybe_valid_if<Index>>(obs), ...);
+                (reg.template on_destroy<AllOf>().template connect<&discard_if<Index>>(obs), ...);
+                (reg.template on_construct<NoneOf>().template connect<&discard_if<Index>>(obs), ...);
+            }
 
-#include <limits>
-#include <cstddef>
-#include <cstdint>
-#include <utility>
-#include <algorithm>
-#include <type_traits>
-// #include "../config/config.h"
+            static void disconnect(basic_observer& obs, basic_registry<Entity>& reg) {
+                (reg.template on_destroy<Require>().disconnect(obs), ...);
+                (reg.template on_construct<Reject>().disconnect(obs), ...);
+                (reg.template on_construct<AllOf>().disconnect(obs), ...);
+                (reg.template on_destroy<NoneOf>().disconnect(obs), ...);
+                (reg.template on_destroy<AllOf>().disconnect(obs), ...);
+                (reg.template on_construct<NoneOf>().disconnect(obs), ...);
+            }
+        };
 
-// #include "../core/type_traits.hpp"
+        template<typename... Matcher>
+        static void disconnect(basic_observer& obs, basic_registry<Entity>& reg) {
+            (matcher_handler<Matcher>::disconnect(obs, reg), ...);
+        }
 
-// #include "registry.hpp"
+        template<typename... Matcher, std::size_t... Index>
+        void connect(basic_registry<Entity>& reg, std::index_sequence<Index...>) {
+            static_assert(sizeof...(Matcher) < std::numeric_limits<payload_type>::digits);
+            (matcher_handler<Matcher>::template connect<Index>(*this, reg), ...);
+            release = &basic_observer::disconnect<Matcher...>;
+        }
 
-// #include "storage.hpp"
+    public:
+        /*! @brief Underlying entity identifier. */
+        using entity_type = Entity;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+        /*! @brief Input iterator type. */
+        using iterator_type = typename sparse_set<Entity>::iterator_type;
 
-// #include "entity.hpp"
+        /*! @brief Default constructor. */
+        basic_observer() ENTT_NOEXCEPT
+            : target{}, release{}, view{}
+        {}
 
-// #include "fwd.hpp"
+        /*! @brief Default copy constructor, deleted on purpose. */
+        basic_observer(const basic_observer&) = delete;
+        /*! @brief Default move constructor, deleted on purpose. */
+        basic_observer(basic_observer&&) = delete;
 
+        /**
+         * @brief Creates an observer and connects it to a given registry.
+         * @tparam Matcher Types of matchers to use to initialize the observer.
+         * @param reg A valid reference to a registry.
+         */
+        template<typename... Matcher>
+        basic_observer(basic_registry<entity_type>& reg, basic_collector<Matcher...>) ENTT_NOEXCEPT
+            : target{ &reg },
+            release{},
+            view{}
+        {
+            connect<Matcher...>(reg, std::make_index_sequence<sizeof...(Matcher)>{});
+        }
 
+        /*! @brief Default destructor. */
+        ~basic_observer() = default;
 
-namespace entt {
+        /**
+         * @brief Default copy assignment operator, deleted on purpose.
+         * @return This observer.
+         */
+        basic_observer& operator=(const basic_observer&) = delete;
 
+        /**
+         * @brief Default move assignment operator, deleted on purpose.
+         * @return This observer.
+         */
+        basic_observer& operator=(basic_observer&&) = delete;
 
-    /*! @brief Grouping matcher. */
-    template<typename...>
-    struct matcher {};
+        /**
+         * @brief Connects an observer to a given registry.
+         * @tparam Matcher Types of matchers to use to initialize the observer.
+         * @param reg A valid reference to a registry.
+         */
+        template<typename... Matcher>
+        void connect(basic_registry<entity_type>& reg, basic_collector<Matcher...>) {
+            disconnect();
+            connect<Matcher...>(reg, std::make_index_sequence<sizeof...(Matcher)>{});
+            target = &reg;
+            view.reset();
+        }
 
+        /*! @brief Disconnects an observer from the registry it keeps track of. */
+        void disconnect() {
+            if (release) {
+                release(*this, *target);
+                release = nullptr;
+            }
+        }
 
-    /**
-     * @brief Collector.
-     *
-     * Primary template isn't defined on purpose. All the specializations give a
-     * compile-time error, but for a few reasonable cases.
-     */
-    template<typename...>
-    struct basic_collector;
+        /**
+         * @brief Returns the number of elements in an observer.
+         * @return Number of elements.
+         */
+        size_type size() const ENTT_NOEXCEPT {
+            return view.size();
+        }
 
+        /**
+         * @brief Checks whether an observer is empty.
+         * @return True if the observer is empty, false otherwise.
+         */
+        bool empty() const ENTT_NOEXCEPT {
+            return view.empty();
+        }
 
-    /**
-     * @brief Collector.
-     *
-     * A collector contains a set of rules (literally, matchers) to use to track
-     * entities.<br/>
-     * Its main purpose is to generate a descriptor that allows an observer to know
-     * how to connect to a registry.
-     */
-    template<>
-    struct basic_collector<> {
         /**
-         * @brief Adds a grouping matcher to the collector.
-         * @tparam AllOf Types of components tracked by the matcher.
-         * @tparam NoneOf Types of components used to filter out entities.
-         * @return The updated collector.
+         * @brief Direct access to the list of entities of the observer.
+         *
+         * The returned pointer is such that range `[data(), data() + size()]` is
+         * always a valid range, even if the container is empty.
+         *
+         * @note
+         * There are no guarantees on the order of the entities. Use `begin` and
+         * `end` if you want to iterate the observer in the expected order.
+         *
+         * @return A pointer to the array of entities.
          */
-        template<typename... AllOf, typename... NoneOf>
-        static constexpr auto group(exclude_t<NoneOf...> = {}) ENTT_NOEXCEPT {
-            return basic_collector<matcher<matcher<type_list<>, type_list<>>, type_list<NoneOf...>, type_list<AllOf...>>>{};
+        const entity_type* data() const ENTT_NOEXCEPT {
+            return view.data();
         }
 
         /**
-         * @brief Adds an observing matcher to the collector.
-         * @tparam AnyOf Type of component for which changes should be detected.
-         * @return The updated collector.
+         * @brief Returns an iterator to the first entity of the observer.
+         *
+         * The returned iterator points to the first entity of the observer. If the
+         * container is empty, the returned iterator will be equal to `end()`.
+         *
+         * @return An iterator to the first entity of the observer.
          */
-        template<typename AnyOf>
-        static constexpr auto replace() ENTT_NOEXCEPT {
-            return basic_collector<matcher<matcher<type_list<>, type_list<>>, AnyOf>>{};
+        iterator_type begin() const ENTT_NOEXCEPT {
+            return view.sparse_set<entity_type>::begin();
         }
-    };
 
-    /**
-     * @brief Collector.
-     * @copydetails basic_collector<>
-     * @tparam AnyOf Types of components for which changes should be detected.
-     * @tparam Matcher Types of grouping matchers.
-     */
-    template<typename... Reject, typename... Require, typename... Rule, typename... Other>
-    struct basic_collector<matcher<matcher<type_list<Reject...>, type_list<Require...>>, Rule...>, Other...> {
         /**
-         * @brief Adds a grouping matcher to the collector.
-         * @tparam AllOf Types of components tracked by the matcher.
-         * @tparam NoneOf Types of components used to filter out entities.
-         * @return The updated collector.
+         * @brief Returns an iterator that is past the last entity of the observer.
+         *
+         * The returned iterator points to the entity following the last entity of
+         * the observer. Attempting to dereference the returned iterator results in
+         * undefined behavior.
+         *
+         * @return An iterator to the entity following the last entity of the
+         * observer.
          */
-        template<typename... AllOf, typename... NoneOf>
-        static constexpr auto group(exclude_t<NoneOf...> = {}) ENTT_NOEXCEPT {
-            using first = matcher<matcher<type_list<Reject...>, type_list<Require...>>, Rule...>;
-            return basic_collector<first, Other..., matcher<matcher<type_list<>, type_list<>>, type_list<NoneOf...>, type_list<AllOf...>>>{};
+        iterator_type end() const ENTT_NOEXCEPT {
+            return view.sparse_set<entity_type>::end();
+        }
+
+        /*! @brief Resets the underlying container. */
+        void clear() {
+            view.reset();
         }
 
         /**
-         * @brief Adds an observing matcher to the collector.
-         * @tparam AnyOf Type of component for which changes should be detected.
-         * @return The updated collector.
+         * @brief Iterates entities and applies the given function object to them,
+         * then clears the observer.
+         *
+         * The function object is invoked for each entity.<br/>
+         * The signature of the function must be equivalent to the following form:
+         *
+         * @code{.cpp}
+         * void(const entity_type);
+         * @endcode
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
          */
-        template<typename AnyOf>
-        static constexpr auto replace() ENTT_NOEXCEPT {
-            using first = matcher<matcher<type_list<Reject...>, type_list<Require...>>, Rule...>;
-            return basic_collector<first, Other..., matcher<matcher<type_list<>, type_list<>>, AnyOf>>{};
+        template<typename Func>
+        void each(Func func) const {
+            static_assert(std::is_invocable_v<Func, entity_type>);
+            std::for_each(begin(), end(), std::move(func));
         }
 
         /**
-         * @brief Updates the filter of the last added matcher.
-         * @tparam AllOf Types of components required by the matcher.
-         * @tparam NoneOf Types of components used to filter out entities.
-         * @return The updated collector.
+         * @brief Iterates entities and applies the given function object to them,
+         * then clears the observer.
+         *
+         * The function object is invoked for each entity.<br/>
+         * The signature of the function must be equivalent to the following form:
+         *
+         * @code{.cpp}
+         * void(const entity_type);
+         * @endcode
+         *
+         * @tparam Func Type of the function object to invoke.
+         * @param func A valid function object.
          */
-        template<typename... AllOf, typename... NoneOf>
-        static constexpr auto where(exclude_t<NoneOf...> = {}) ENTT_NOEXCEPT {
-            return basic_collector<matcher<matcher<type_list<Reject..., NoneOf...>, type_list<Require..., AllOf...>>, Rule...>, Other...>{};
+        template<typename Func>
+        void each(Func func) {
+            std::as_const(*this).each(std::move(func));
+            clear();
         }
-    };
-
-
-    /*! @brief Variable template used to ease the definition of collectors. */
-    constexpr basic_collector<> collector{};
 
+    private:
+        basic_registry<entity_type>* target;
+        void(*release)(basic_observer&, basic_registry<entity_type>&);
+        storage<entity_type, payload_type> view;
+    };
 
     /**
-     * @brief Observer.
-     *
-     * An observer returns all the entities and only the entities that fit the
-     * requirements of at least one matcher. Moreover, it's guaranteed that the
-     * entity list is tightly packed in memory for fast iterations.<br/>
-     * In general, observers don't stay true to the order of any set of components.
-     *
-     * Observers work mainly with two types of matchers, provided through a
-     * collector:
-     *
-     * * Observing matcher: an observer will return at least all the living entities
-     *   for which one or more of the given components have been explicitly
-     *   replaced and not yet destroyed.
-     * * Grouping matcher: an observer will return at least all the living entities
-     *   that would have entered the given group if it existed and that would have
-     *   not yet left it.
+     * @brief Concurrent observer.
      *
-     * If an entity respects the requirements of multiple matchers, it will be
-     * returned once and only once by the observer in any case.
+     * A concurrent observer accepts the same collectors and returns the same
+     * entities as a plain observer, but it tolerates signals published from
+     * multiple threads at once, as it happens when worker threads replace
+     * components in parallel.<br/>
+     * Each thread appends what it receives to a buffer of its own, acquired once
+     * and then accessed without locks. Buffers are merged and deduplicated when
+     * `sync` is invoked, that is the only point where the registry is queried.
      *
-     * Matchers support also filtering by means of a _where_ clause that accepts
-     * both a list of types and an exclusion list.<br/>
-     * Whenever a matcher finds that an entity matches its requirements, the
-     * condition of the filter is verified before to register the entity itself.
-     * Moreover, a registered entity isn't returned by the observer if the condition
-     * set by the filter is broken in the meantime.
+     * Matchers are therefore evaluated at the sync point rather than when the
+     * events occur: after a sync, the observer contains the entities that
+     * triggered at least one of the matchers since the last time it was cleared
+     * and that still satisfy its requirements.
      *
      * @b Important
      *
-     * Iterators aren't invalidated if:
-     *
-     * * New instances of the given components are created and assigned to entities.
-     * * The entity currently pointed is modified (as an example, if one of the
-     *   given components is removed from the entity to which the iterator points).
-     * * The entity currently pointed is destroyed.
-     *
-     * In all the other cases, modifying the pools of the given components in any
-     * way invalidates all the iterators and using them results in undefined
-     * behavior.
+     * Signals must not be published while `sync` is running. The same applies to
+     * all the other member functions, they are meant to be used from a single
+     * thread once the parallel work has finished.
      *
      * @warning
-     * Lifetime of an observer doesn't necessarily have to overcome the one of the
-     * registry to which it is connected. However, the observer must be disconnected
-     * from the registry before being destroyed to avoid crashes due to dangling
-     * pointers.
+     * The observer must be disconnected from the registry before being destroyed
+     * to avoid crashes due to dangling pointers.
+     *
+     * @sa basic_observer
      *
      * @tparam Entity A valid entity type (see entt_traits for more details).
      */
     template<typename Entity>
-    class basic_observer {
+    class basic_concurrent_observer {
         using payload_type = std::uint32_t;
+        using condition_type = bool(const basic_registry<Entity>&, const Entity);
+
+        struct buffer_type {
+            std::vector<std::pair<Entity, payload_type>> matched;
+            std::vector<std::pair<Entity, payload_type>> discarded;
+        };
 
         template<typename>
         struct matcher_handler;
 
         template<typename... Reject, typename... Require, typename AnyOf>
         struct matcher_handler<matcher<matcher<type_list<Reject...>, type_list<Require...>>, AnyOf>> {
-            template<std::size_t Index>
-            static void maybe_valid_if(basic_observer& obs, const Entity entt, const basic_registry<Entity>& reg) {
-                if (reg.template has<Require...>(entt) && !(reg.template has<Reject>(entt) || ...)) {
-                    auto* comp = obs.view.try_get(entt);
-                    (comp ? *comp : obs.view.construct(entt)) |= (1 << Index);
-                }
+            static bool condition(const basic_registry<Entity>& reg, const Entity entt) {
+                return reg.valid(entt) && reg.template has<AnyOf, Require...>(entt) && !(reg.template has<Reject>(entt) || ...);
             }
 
             template<std::size_t Index>
-            static void discard_if(basic_observer& obs, const Entity entt) {
-                if (auto * value = obs.view.try_get(entt); value && !(*value &= (~(1 << Index)))) {
-                    obs.view.destroy(entt);
-                }
-            }
-
-            template<std::size_t Index>
-            static void connect(basic_observer& obs, basic_registry<Entity>& reg) {
-                (reg.template on_destroy<Require>().template connect<&discard_if<Index>>(obs), ...);
-                (reg.template on_construct<Reject>().template connect<&discard_if<Index>>(obs), ...);
-                reg.template on_replace<AnyOf>().template connect<&maybe_valid_if<Index>>(obs);
-                reg.template on_destroy<AnyOf>().template connect<&discard_if<Index>>(obs);
+            static void connect(basic_concurrent_observer& obs, basic_registry<Entity>& reg) {
+                (reg.template on_destroy<Require>().template connect<&discard<Index>>(obs), ...);
+                (reg.template on_construct<Reject>().template connect<&discard<Index>>(obs), ...);
+                reg.template on_replace<AnyOf>().template connect<&match<Index>>(obs);
+                reg.template on_destroy<AnyOf>().template connect<&discard<Index>>(obs);
             }
 
-            static void disconnect(basic_observer& obs, basic_registry<Entity>& reg) {
+            static void disconnect(basic_concurrent_observer& obs, basic_registry<Entity>& reg) {
                 (reg.template on_destroy<Require>().disconnect(obs), ...);
                 (reg.template on_construct<Reject>().disconnect(obs), ...);
                 reg.template on_replace<AnyOf>().disconnect(obs);
@@ -9614,34 +14855,22 @@ namespace entt {
 
         template<typename... Reject, typename... Require, typename... NoneOf, typename... AllOf>
         struct matcher_handler<matcher<matcher<type_list<Reject...>, type_list<Require...>>, type_list<NoneOf...>, type_list<AllOf...>>> {
-            template<std::size_t Index>
-            static void maybe_valid_if(basic_observer& obs, const Entity entt, const basic_registry<Entity>& reg) {
-                if (reg.template has<AllOf...>(entt) && !(reg.template has<NoneOf>(entt) || ...)
-                    && reg.template has<Require...>(entt) && !(reg.template has<Reject>(entt) || ...))
-                {
-                    auto* comp = obs.view.try_get(entt);
-                    (comp ? *comp : obs.view.construct(entt)) |= (1 << Index);
-                }
-            }
-
-            template<std::size_t Index>
-            static void discard_if(basic_observer& obs, const Entity entt) {
-                if (auto * value = obs.view.try_get(entt); value && !(*value &= (~(1 << Index)))) {
-                    obs.view.destroy(entt);
-                }
+            static bool condition(const basic_registry<Entity>& reg, const Entity entt) {
+                return reg.valid(entt) && reg.template has<AllOf..., Require...>(entt)
+                    && !(reg.template has<NoneOf>(entt) || ...) && !(reg.template has<Reject>(entt) || ...);
             }
 
             template<std::size_t Index>
-            static void connect(basic_observer& obs, basic_registry<Entity>& reg) {
-                (reg.template on_destroy<Require>().template connect<&discard_if<Index>>(obs), ...);
-                (reg.template on_construct<Reject>().template connect<&discard_if<Index>>(obs), ...);
-                (reg.template on_construct<AllOf>().template connect<&maybe_valid_if<Index>>(obs), ...);
-                (reg.template on_destroy<NoneOf>().template connect<&maybe_valid_if<Index>>(obs), ...);
-                (reg.template on_destroy<AllOf>().template connect<&discard_if<Index>>(obs), ...);
-                (reg.template on_construct<NoneOf>().template connect<&discard_if<Index>>(obs), ...);
+            static void connect(basic_concurrent_observer& obs, basic_registry<Entity>& reg) {
+                (reg.template on_destroy<Require>().template connect<&discard<Index>>(obs), ...);
+                (reg.template on_construct<Reject>().template connect<&discard<Index>>(obs), ...);
+                (reg.template on_construct<AllOf>().template connect<&match<Index>>(obs), ...);
+                (reg.template on_destroy<NoneOf>().template connect<&match<Index>>(obs), ...);
+                (reg.template on_destroy<AllOf>().template connect<&discard<Index>>(obs), ...);
+                (reg.template on_construct<NoneOf>().template connect<&discard<Index>>(obs), ...);
             }
 
-            static void disconnect(basic_observer& obs, basic_registry<Entity>& reg) {
+            static void disconnect(basic_concurrent_observer& obs, basic_registry<Entity>& reg) {
                 (reg.template on_destroy<Require>().disconnect(obs), ...);
                 (reg.template on_construct<Reject>().disconnect(obs), ...);
                 (reg.template on_construct<AllOf>().disconnect(obs), ...);
@@ -9651,8 +14880,28 @@ namespace entt {
             }
         };
 
+        static void append(std::vector<std::pair<Entity, payload_type>>& events, const Entity entt, const payload_type mask) {
+            // bursts on the same entity collapse into a single event
+            if (!events.empty() && events.back().first == entt) {
+                events.back().second |= mask;
+            }
+            else {
+                events.emplace_back(entt, mask);
+            }
+        }
+
+        template<std::size_t Index>
+        static void match(basic_concurrent_observer& obs, const Entity entt) {
+            append(obs.local().matched, entt, payload_type(1) << Index);
+        }
+
+        template<std::size_t Index>
+        static void discard(basic_concurrent_observer& obs, const Entity entt) {
+            append(obs.local().discarded, entt, payload_type(1) << Index);
+        }
+
         template<typename... Matcher>
-        static void disconnect(basic_observer& obs, basic_registry<Entity>& reg) {
+        static void disconnect(basic_concurrent_observer& obs, basic_registry<Entity>& reg) {
             (matcher_handler<Matcher>::disconnect(obs, reg), ...);
         }
 
@@ -9660,7 +14909,47 @@ namespace entt {
         void connect(basic_registry<Entity>& reg, std::index_sequence<Index...>) {
             static_assert(sizeof...(Matcher) < std::numeric_limits<payload_type>::digits);
             (matcher_handler<Matcher>::template connect<Index>(*this, reg), ...);
-            release = &basic_observer::disconnect<Matcher...>;
+            conditions = { &matcher_handler<Matcher>::condition... };
+            release = &basic_concurrent_observer::disconnect<Matcher...>;
+        }
+
+        struct cache_entry {
+            std::size_t owner;
+            buffer_type* buffer;
+            std::weak_ptr<buffer_type> alive;
+        };
+
+        buffer_type& local() {
+            // observers are told apart by identifier, addresses can be reused
+            thread_local std::vector<cache_entry> cache{};
+            thread_local std::size_t generation{};
+
+            // entries of destroyed observers are dropped once per destruction, lookups stay short
+            if (const auto current = retired().load(std::memory_order_acquire); current != generation) {
+                cache.erase(std::remove_if(cache.begin(), cache.end(), [](const auto& entry) { return entry.alive.expired(); }), cache.end());
+                generation = current;
+            }
+
+            for (auto&& entry : cache) {
+                if (entry.owner == identifier) {
+                    return *entry.buffer;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock{ mutex };
+            const auto& buffer = buffers.emplace_back(std::make_shared<buffer_type>());
+            cache.push_back(cache_entry{ identifier, buffer.get(), buffer });
+            return *buffer;
+        }
+
+        static std::size_t next() ENTT_NOEXCEPT {
+            static std::atomic<std::size_t> counter{};
+            return counter++;
+        }
+
+        static std::atomic<std::size_t>& retired() ENTT_NOEXCEPT {
+            static std::atomic<std::size_t> counter{};
+            return counter;
         }
 
     public:
@@ -9672,14 +14961,14 @@ namespace entt {
         using iterator_type = typename sparse_set<Entity>::iterator_type;
 
         /*! @brief Default constructor. */
-        basic_observer() ENTT_NOEXCEPT
-            : target{}, release{}, view{}
+        basic_concurrent_observer()
+            : target{}, release{}, identifier{ next() }, view{}
         {}
 
         /*! @brief Default copy constructor, deleted on purpose. */
-        basic_observer(const basic_observer&) = delete;
+        basic_concurrent_observer(const basic_concurrent_observer&) = delete;
         /*! @brief Default move constructor, deleted on purpose. */
-        basic_observer(basic_observer&&) = delete;
+        basic_concurrent_observer(basic_concurrent_observer&&) = delete;
 
         /**
          * @brief Creates an observer and connects it to a given registry.
@@ -9687,28 +14976,32 @@ namespace entt {
          * @param reg A valid reference to a registry.
          */
         template<typename... Matcher>
-        basic_observer(basic_registry<entity_type>& reg, basic_collector<Matcher...>) ENTT_NOEXCEPT
+        basic_concurrent_observer(basic_registry<entity_type>& reg, basic_collector<Matcher...>)
             : target{ &reg },
             release{},
+            identifier{ next() },
             view{}
         {
             connect<Matcher...>(reg, std::make_index_sequence<sizeof...(Matcher)>{});
         }
 
-        /*! @brief Default destructor. */
-        ~basic_observer() = default;
+        /*! @brief Releases the buffers of all threads. */
+        ~basic_concurrent_observer() {
+            buffers.clear();
+            retired().fetch_add(1u, std::memory_order_release);
+        }
 
         /**
          * @brief Default copy assignment operator, deleted on purpose.
          * @return This observer.
          */
-        basic_observer& operator=(const basic_observer&) = delete;
+        basic_concurrent_observer& operator=(const basic_concurrent_observer&) = delete;
 
         /**
          * @brief Default move assignment operator, deleted on purpose.
          * @return This observer.
          */
-        basic_observer& operator=(basic_observer&&) = delete;
+        basic_concurrent_observer& operator=(basic_concurrent_observer&&) = delete;
 
         /**
          * @brief Connects an observer to a given registry.
@@ -9720,7 +15013,7 @@ namespace entt {
             disconnect();
             connect<Matcher...>(reg, std::make_index_sequence<sizeof...(Matcher)>{});
             target = &reg;
-            view.reset();
+            clear();
         }
 
         /*! @brief Disconnects an observer from the registry it keeps track of. */
@@ -9731,6 +15024,50 @@ namespace entt {
             }
         }
 
+        /**
+         * @brief Merges the events collected by all threads into the observer.
+         *
+         * Events are deduplicated and each matcher is checked once per entity
+         * against the current state of the registry. Discarding events are
+         * applied first, so that an entity that left and then re-entered a
+         * matcher meanwhile is still returned.
+         *
+         * @warning
+         * No signals must be published while this function is running.
+         */
+        void sync() {
+            std::lock_guard<std::mutex> lock{ mutex };
+
+            for (auto&& buffer : buffers) {
+                for (const auto [entt, mask] : buffer->discarded) {
+                    if (auto * value = view.try_get(entt); value && !(*value &= ~mask)) {
+                        view.destroy(entt);
+                    }
+                }
+
+                buffer->discarded.clear();
+            }
+
+            for (auto&& buffer : buffers) {
+                for (const auto [entt, mask] : buffer->matched) {
+                    payload_type valid{};
+
+                    for (std::size_t pos{}, last = conditions.size(); pos < last; ++pos) {
+                        if ((mask & (payload_type(1) << pos)) && conditions[pos](*target, entt)) {
+                            valid |= payload_type(1) << pos;
+                        }
+                    }
+
+                    if (valid) {
+                        auto* value = view.try_get(entt);
+                        (value ? *value : view.construct(entt)) |= valid;
+                    }
+                }
+
+                buffer->matched.clear();
+            }
+        }
+
         /**
          * @brief Returns the number of elements in an observer.
          * @return Number of elements.
@@ -9789,14 +15126,20 @@ namespace entt {
             return view.sparse_set<entity_type>::end();
         }
 
-        /*! @brief Resets the underlying container. */
+        /*! @brief Resets the underlying container and drops pending events. */
         void clear() {
+            std::lock_guard<std::mutex> lock{ mutex };
+
+            for (auto&& buffer : buffers) {
+                buffer->matched.clear();
+                buffer->discarded.clear();
+            }
+
             view.reset();
         }
 
         /**
-         * @brief Iterates entities and applies the given function object to them,
-         * then clears the observer.
+         * @brief Iterates entities and applies the given function object to them.
          *
          * The function object is invoked for each entity.<br/>
          * The signature of the function must be equivalent to the following form:
@@ -9815,8 +15158,8 @@ namespace entt {
         }
 
         /**
-         * @brief Iterates entities and applies the given function object to them,
-         * then clears the observer.
+         * @brief Synchronizes the observer, iterates entities and applies the
+         * given function object to them, then clears the observer.
          *
          * The function object is invoked for each entity.<br/>
          * The signature of the function must be equivalent to the following form:
@@ -9830,13 +15173,18 @@ namespace entt {
          */
         template<typename Func>
         void each(Func func) {
+            sync();
             std::as_const(*this).each(std::move(func));
-            clear();
+            view.reset();
         }
 
     private:
         basic_registry<entity_type>* target;
-        void(*release)(basic_observer&, basic_registry<entity_type>&);
+        void(*release)(basic_concurrent_observer&, basic_registry<entity_type>&);
+        std::vector<condition_type*> conditions;
+        std::size_t identifier;
+        std::mutex mutex;
+        std::vector<std::shared_ptr<buffer_type>> buffers;
         storage<entity_type, payload_type> view;
     };
 
@@ -9906,6 +15254,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -10071,6 +15424,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -13220,6 +18578,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -13917,6 +19280,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -14422,6 +19790,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -14786,6 +20159,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)
@@ -14885,6 +20263,11 @@ namespace entt {
 #endif // ENTT_PAGE_SIZE
 
 
+#ifndef ENTT_INSTANCE_ALIGNMENT
+#define ENTT_INSTANCE_ALIGNMENT 64
+#endif // ENTT_INSTANCE_ALIGNMENT
+
+
 #ifndef ENTT_DISABLE_ASSERT
 #include <cassert>
 #define ENTT_ASSERT(condition) assert(condition)